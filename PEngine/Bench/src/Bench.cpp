@@ -0,0 +1,212 @@
+#include "Bench.h"
+
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PArray.h"
+#include "Core/PTime.h"
+#include "Core/PIntrinsics.h"
+#include "Core/PMath.h"
+#include "Core/PAlgorithm.h"
+#include "Core/PAssert.h"
+
+using Bench::Benchmark;
+using Bench::Result;
+using Bench::Suite;
+
+namespace {
+	// doubling stops here even when a sample is still too short
+	constexpr uint64_t MAX_ITERATION_COUNT{ 1ull << 32 };
+
+	// 1.4826 times the median absolute deviation estimates the standard
+	// deviation of normally distributed samples
+	constexpr double MAD_TO_DEVIATION{ 1.4826 };
+
+	// what the benchmarks return goes here, where the compiler can't see
+	// that it's never read
+	volatile uint64_t g_Sink;
+
+	// cycle counter ticks for one call
+	uint64_t timeSample(const Benchmark& benchmark, uint64_t iterationCount);
+
+	// insertion sort, there are only ever a few dozen samples
+	void sortSamples(double* samples, uint32_t count);
+
+	// samples must be sorted
+	double calcMedian(const double* samples, uint32_t count);
+}  // namespace
+
+Suite Bench::createSuite(
+	pstd::AllocationRegistry* pAllocRegistry, size_t size
+) {
+	ASSERT(pAllocRegistry);
+
+	Suite suite{
+		.pAllocRegistry = pAllocRegistry,
+		.arena = pstd::allocateArena(pAllocRegistry, size),
+	};
+	suite.benchmarks =
+		pstd::createArray<Benchmark>(&suite.arena, MAX_BENCHMARK_COUNT, 0);
+	return suite;
+}
+
+void Bench::destroySuite(Suite* pSuite) {
+	ASSERT(pSuite);
+
+	pstd::freeArena(pSuite->pAllocRegistry, &pSuite->arena);
+	*pSuite = Suite{};
+}
+
+void Bench::addBenchmark(
+	Suite* pSuite,
+	const char* name,
+	BenchFunction function,
+	void* pContext,
+	uint64_t bytesPerIteration
+) {
+	ASSERT(pSuite);
+	ASSERT(name);
+	ASSERT(function);
+
+	pstd::pushBack(
+		&pSuite->benchmarks,
+		Benchmark{
+			.name = name,
+			.function = function,
+			.pContext = pContext,
+			.bytesPerIteration = bytesPerIteration,
+		}
+	);
+}
+
+double Bench::calibrateCycleCounter(uint64_t calibrationNanoseconds) {
+	uint64_t frequency{ pstd::getTimeFrequency() };
+	uint64_t calibrationTicks{ max(
+		calibrationNanoseconds * frequency / 1000000000ull, 1ull
+	) };
+
+	uint64_t beginTime{ pstd::getTime() };
+	uint64_t beginCycles{ pstd::readCycleCounter() };
+	uint64_t endTime{ beginTime };
+	while (endTime - beginTime < calibrationTicks) {
+		endTime = pstd::getTime();
+	}
+	uint64_t endCycles{ pstd::readCycleCounter() };
+
+	double elapsedNanoseconds{ ncast<double>(endTime - beginTime) *
+							   1000000000.0 / ncast<double>(frequency) };
+	return ncast<double>(endCycles - beginCycles) / elapsedNanoseconds;
+}
+
+Result Bench::runBenchmark(
+	const Benchmark& benchmark,
+	const Config& config,
+	double cyclesPerNanosecond,
+	pstd::Arena scratchArena
+) {
+	ASSERT(benchmark.function);
+	ASSERT(config.sampleCount > 0);
+	ASSERT(cyclesPerNanosecond > 0.0);
+
+	double minSampleCycles{ ncast<double>(config.minSampleNanoseconds) *
+							cyclesPerNanosecond };
+	uint64_t iterationCount{ 1 };
+	while (iterationCount < MAX_ITERATION_COUNT &&
+		   ncast<double>(timeSample(benchmark, iterationCount)) <
+			   minSampleCycles) {
+		iterationCount *= 2;
+	}
+
+	for (uint32_t i{}; i < config.warmupSampleCount; i++) {
+		timeSample(benchmark, iterationCount);
+	}
+
+	// cycles per iteration
+	uint32_t sampleCount{ config.sampleCount };
+	double* samples{ pstd::alloc<double>(&scratchArena, sampleCount) };
+	for (uint32_t i{}; i < sampleCount; i++) {
+		samples[i] = ncast<double>(timeSample(benchmark, iterationCount)) /
+			ncast<double>(iterationCount);
+	}
+	sortSamples(samples, sampleCount);
+
+	double median{ calcMedian(samples, sampleCount) };
+	double* deviations{ pstd::alloc<double>(&scratchArena, sampleCount) };
+	for (uint32_t i{}; i < sampleCount; i++) {
+		deviations[i] = pstd::abs(samples[i] - median);
+	}
+	sortSamples(deviations, sampleCount);
+
+	// when more than half the samples are the same there is no spread to
+	// judge the rest by, so they are all kept
+	double limit{ config.outlierDeviations * MAD_TO_DEVIATION *
+				  calcMedian(deviations, sampleCount) };
+	uint32_t first{};
+	uint32_t end{ sampleCount };
+	if (limit > 0.0) {
+		while (samples[first] < median - limit) {
+			first++;
+		}
+		while (samples[end - 1] > median + limit) {
+			end--;
+		}
+	}
+
+	const double* kept{ samples + first };
+	uint32_t keptCount{ end - first };
+	double total{};
+	for (uint32_t i{}; i < keptCount; i++) {
+		total += kept[i];
+	}
+	double mean{ total / ncast<double>(keptCount) };
+	double squaredTotal{};
+	for (uint32_t i{}; i < keptCount; i++) {
+		squaredTotal += (kept[i] - mean) * (kept[i] - mean);
+	}
+	double variance{ squaredTotal / ncast<double>(keptCount) };
+
+	double keptMedian{ calcMedian(kept, keptCount) };
+	return Result{
+		.iterationCount = iterationCount,
+		.keptCount = keptCount,
+		.rejectedCount = sampleCount - keptCount,
+		.minimum = kept[0] / cyclesPerNanosecond,
+		.median = keptMedian / cyclesPerNanosecond,
+		.mean = mean / cyclesPerNanosecond,
+		.deviation = ncast<double>(pstd::sqrtf(ncast<float>(variance))) /
+			cyclesPerNanosecond,
+		.maximum = kept[keptCount - 1] / cyclesPerNanosecond,
+		.medianCycles = keptMedian,
+	};
+}
+
+namespace {
+	uint64_t timeSample(const Benchmark& benchmark, uint64_t iterationCount) {
+		uint64_t beginCycles{ pstd::readCycleCounter() };
+		uint64_t res{ benchmark.function(benchmark.pContext, iterationCount) };
+		uint64_t endCycles{ pstd::readCycleCounter() };
+
+		g_Sink = g_Sink + res;
+		return endCycles - beginCycles;
+	}
+
+	void sortSamples(double* samples, uint32_t count) {
+		for (uint32_t i{ 1 }; i < count; i++) {
+			double sample{ samples[i] };
+			uint32_t j{ i };
+			while (j > 0 && samples[j - 1] > sample) {
+				samples[j] = samples[j - 1];
+				j--;
+			}
+			samples[j] = sample;
+		}
+	}
+
+	double calcMedian(const double* samples, uint32_t count) {
+		ASSERT(count > 0);
+
+		if (count % 2 == 1) {
+			return samples[count / 2];
+		}
+		return (samples[count / 2 - 1] + samples[count / 2]) / 2.0;
+	}
+}  // namespace
@@ -0,0 +1,104 @@
+#pragma once
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PArray.h"
+#include "Core/PMemory.h"
+
+// the benchmark harness. a benchmark is a function that does its work
+// iterationCount times and returns something that depends on all of it, so
+// the work can't be optimized away. a sample times one call with the cycle
+// counter. the iteration count is doubled until a sample takes at least
+// minSampleNanoseconds, then warmup samples run and are thrown away, then
+// sampleCount samples are kept, minus the outliers.
+//
+// setup happens when a benchmark is added, its data goes in the suite's
+// arena, so only the loop is timed
+
+namespace Bench {
+	using BenchFunction = uint64_t (*)(void* pContext, uint64_t iterationCount);
+
+	struct Benchmark {
+		const char* name;  // group/name
+		BenchFunction function;
+		void* pContext;
+		uint64_t bytesPerIteration;	 // 0 when throughput means nothing
+	};
+
+	// samples further from the median than outlierDeviations times the
+	// median absolute deviation, scaled to a standard deviation, are
+	// rejected. interrupts and page faults only ever make a sample slower
+	struct Config {
+		uint32_t warmupSampleCount;
+		uint32_t sampleCount;
+		uint64_t minSampleNanoseconds;
+		double outlierDeviations;
+	};
+
+	constexpr Config DEFAULT_CONFIG{
+		.warmupSampleCount = 3,
+		.sampleCount = 30,
+		.minSampleNanoseconds = 1000 * 1000,
+		.outlierDeviations = 3.0,
+	};
+
+	constexpr uint32_t MAX_BENCHMARK_COUNT{ 128 };
+
+	struct Suite {
+		pstd::AllocationRegistry* pAllocRegistry;
+		pstd::Arena arena;
+		pstd::Array<Benchmark> benchmarks;
+	};
+
+	Suite createSuite(pstd::AllocationRegistry* pAllocRegistry, size_t size);
+	void destroySuite(Suite* pSuite);
+
+	void addBenchmark(
+		Suite* pSuite,
+		const char* name,
+		BenchFunction function,
+		void* pContext = nullptr,
+		uint64_t bytesPerIteration = 0
+	);
+
+	// splitmix64, for inputs that are the same from run to run
+	inline uint64_t nextRandom(uint64_t* pState) {
+		*pState += 0x9E3779B97F4A7C15ull;
+		uint64_t res{ *pState };
+		res = (res ^ (res >> 30)) * 0xBF58476D1CE4E5B9ull;
+		res = (res ^ (res >> 27)) * 0x94D049BB133111EBull;
+		return res ^ (res >> 31);
+	}
+
+	// each group adds its benchmarks, the engine ones expect Main to have
+	// started the systems they call into
+	void addCoreBenchmarks(Suite* pSuite);
+	void addTextBenchmarks(Suite* pSuite);
+	void addMathBenchmarks(Suite* pSuite);
+	void addEngineBenchmarks(Suite* pSuite);
+
+	// nanoseconds per iteration over the kept samples, and the median in
+	// cycle counter ticks
+	struct Result {
+		uint64_t iterationCount;  // per sample
+		uint32_t keptCount;
+		uint32_t rejectedCount;
+		double minimum;
+		double median;
+		double mean;
+		double deviation;
+		double maximum;
+		double medianCycles;
+	};
+
+	// cycle counter ticks per nanosecond, measured against PTime's clock
+	// for at least calibrationNanoseconds
+	double calibrateCycleCounter(uint64_t calibrationNanoseconds);
+
+	// the samples go in scratchArena
+	Result runBenchmark(
+		const Benchmark& benchmark,
+		const Config& config,
+		double cyclesPerNanosecond,
+		pstd::Arena scratchArena
+	);
+}  // namespace Bench
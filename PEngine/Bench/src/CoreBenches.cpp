@@ -0,0 +1,735 @@
+#include "Bench.h"
+
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PArray.h"
+#include "Core/PMemory.h"
+#include "Core/PCircularBuffer.h"
+#include "Core/PContainer.h"
+#include "Core/PScan.h"
+#include "Core/PHeap.h"
+#include "Core/PView.h"
+#include "Core/PGrid.h"
+#include "Core/PHash.h"
+#include "Core/PStringBuilder.h"
+#include "Core/PAtomic.h"
+#include "Core/PAssert.h"
+
+using Bench::Suite;
+
+namespace {
+	// 256KB of uint32_t, the working set stays in L2
+	constexpr uint32_t ELEMENT_COUNT{ 64 * 1024 };
+
+	// 4MB of uint32_t, searches miss the cache
+	constexpr uint32_t SEARCH_COUNT{ 1024 * 1024 };
+
+	// the container kernels run over the first count of this many random
+	// uint32_t, 400MB of them
+	constexpr size_t MAX_SWEEP_COUNT{ 100 * 1000 * 1000 };
+
+	struct SweepSize {
+		const char* name;
+		size_t count;
+	};
+
+	// from L1 out to well past the last level cache
+	constexpr SweepSize SWEEP_SIZES[]{
+		{ .name = "1K", .count = 1024 },
+		{ .name = "64K", .count = 64 * 1024 },
+		{ .name = "4M", .count = 4 * 1024 * 1024 },
+		{ .name = "100M", .count = MAX_SWEEP_COUNT },
+	};
+
+	// searches cycle through this many keys, a power of two
+	constexpr uint32_t KEY_COUNT{ 1024 };
+
+	constexpr uint32_t ARENA_SIZE{ 64 * 1024 };
+	constexpr uint32_t ALLOC_SIZE{ 16 };
+	constexpr uint32_t BUFFER_CAPACITY{ 1024 };
+	constexpr uint32_t HEAP_COUNT{ 4 * 1024 };
+	constexpr uint32_t GRID_SIZE{ 256 };
+	constexpr uint32_t HASH_KEY_SIZE{ 16 };
+
+	// 4KB stays in L1, 8MB streams from memory
+	struct HashSize {
+		const char* name;
+		size_t size;
+	};
+
+	constexpr HashSize HASH_SIZES[]{
+		{ .name = "4K", .size = 4 * 1024 },
+		{ .name = "8M", .size = 8 * 1024 * 1024 },
+	};
+	constexpr size_t MAX_HASH_SIZE{ 8 * 1024 * 1024 };
+
+	// the 16 byte keys cycle through this many bytes of the data
+	constexpr uint32_t HASH_KEY_SPAN{ 4 * 1024 };
+
+	struct CopySize {
+		const char* name;
+		size_t size;
+	};
+
+	constexpr CopySize COPY_SIZES[]{
+		{ .name = "memCpy/64", .size = 64 },
+		{ .name = "memCpy/4K", .size = 4 * 1024 },
+		{ .name = "memCpy/1M", .size = 1024 * 1024 },
+	};
+	constexpr size_t MAX_COPY_SIZE{ 1024 * 1024 };
+
+	struct CopyContext {
+		void* dst;
+		const void* src;
+		size_t size;
+	};
+
+	// values are 0 to ELEMENT_COUNT in random order
+	struct ArrayContext {
+		pstd::Array<uint32_t> values;
+		pstd::Array<uint32_t> scratch;
+	};
+
+	// the values are below 2^31 and key isn't, so find reads them all
+	struct SweepContext {
+		const uint32_t* values;
+		size_t count;
+		uint32_t key;
+	};
+
+	struct SearchContext {
+		pstd::Array<uint32_t> sorted;
+		pstd::EytzingerArray<uint32_t> eytzinger;
+		uint32_t* keys;
+	};
+
+	struct HeapContext {
+		pstd::Array<uint32_t> heap;
+		uint64_t randomState;
+	};
+
+	struct HashContext {
+		const uint8_t* data;
+		size_t size;
+	};
+
+	template<pstd::GridLayout layout>
+	struct GridContext {
+		pstd::Grid2D<float, layout> grid;
+	};
+
+	uint64_t benchArenaAlloc(void* pContext, uint64_t iterationCount);
+
+	// pushes into an empty array every call, committing as it grows
+	uint64_t benchDArrayPushBack(void* pContext, uint64_t iterationCount);
+
+	uint64_t benchCircularPush(void* pContext, uint64_t iterationCount);
+	uint64_t benchCircularPushPop(void* pContext, uint64_t iterationCount);
+	uint64_t benchMemCpy(void* pContext, uint64_t iterationCount);
+
+	// pstd's kernels and a plain loop of each for reference. the scalar
+	// ones load the pointer to the values again every iteration, so the
+	// loop over them can't be hoisted out
+	uint64_t benchFind(void* pContext, uint64_t iterationCount);
+	uint64_t benchCount(void* pContext, uint64_t iterationCount);
+	uint64_t benchMin(void* pContext, uint64_t iterationCount);
+	uint64_t benchMax(void* pContext, uint64_t iterationCount);
+	uint64_t benchSum(void* pContext, uint64_t iterationCount);
+	uint64_t benchScalarFind(void* pContext, uint64_t iterationCount);
+	uint64_t benchScalarCount(void* pContext, uint64_t iterationCount);
+	uint64_t benchScalarMin(void* pContext, uint64_t iterationCount);
+	uint64_t benchScalarMax(void* pContext, uint64_t iterationCount);
+	uint64_t benchScalarSum(void* pContext, uint64_t iterationCount);
+
+	struct SweepKernel {
+		const char* name;
+		Bench::BenchFunction function;
+	};
+
+	constexpr SweepKernel SWEEP_KERNELS[]{
+		{ .name = "find", .function = benchFind },
+		{ .name = "findScalar", .function = benchScalarFind },
+		{ .name = "count", .function = benchCount },
+		{ .name = "countScalar", .function = benchScalarCount },
+		{ .name = "calcMin", .function = benchMin },
+		{ .name = "calcMinScalar", .function = benchScalarMin },
+		{ .name = "calcMax", .function = benchMax },
+		{ .name = "calcMaxScalar", .function = benchScalarMax },
+		{ .name = "sum", .function = benchSum },
+		{ .name = "sumScalar", .function = benchScalarSum },
+	};
+
+	uint64_t benchLowerBound(void* pContext, uint64_t iterationCount);
+	uint64_t benchEytzingerLowerBound(
+		void* pContext, uint64_t iterationCount
+	);
+
+	uint64_t benchInclusiveScan(void* pContext, uint64_t iterationCount);
+	uint64_t benchCompactIf(void* pContext, uint64_t iterationCount);
+
+	// a filter and a transform summed lazily, against the same through a
+	// compacted copy
+	uint64_t benchViewSum(void* pContext, uint64_t iterationCount);
+	uint64_t benchMaterializedSum(void* pContext, uint64_t iterationCount);
+
+	// a pop and a push on a full heap
+	uint64_t benchHeapPushPop(void* pContext, uint64_t iterationCount);
+
+	// sums every cell's 8 neighbors, an iteration is the whole grid
+	template<pstd::GridLayout layout>
+	uint64_t benchGridStencil(void* pContext, uint64_t iterationCount);
+
+	uint64_t benchHash64(void* pContext, uint64_t iterationCount);
+	uint64_t benchHash64Key(void* pContext, uint64_t iterationCount);
+	uint64_t benchCrc32c(void* pContext, uint64_t iterationCount);
+
+	template<pstd::GridLayout layout>
+	void addGridBenchmark(Suite* pSuite, const char* name);
+
+	// named hash/<kernel>/<size>
+	void addHashBenchmark(
+		Suite* pSuite,
+		const char* kernel,
+		const HashSize& hashSize,
+		Bench::BenchFunction function,
+		HashContext* pHash
+	);
+}  // namespace
+
+void Bench::addCoreBenchmarks(Suite* pSuite) {
+	ASSERT(pSuite);
+
+	pstd::Arena* pArena{ &pSuite->arena };
+	uint64_t randomState{};
+
+	auto* pAllocArena{ pstd::alloc<pstd::Arena>(pArena) };
+	*pAllocArena = pstd::Arena{
+		.block = pstd::alloc<uint8_t>(pArena, ARENA_SIZE),
+		.size = ARENA_SIZE,
+	};
+	addBenchmark(pSuite, "arena/alloc16", benchArenaAlloc, pAllocArena);
+
+	addBenchmark(
+		pSuite,
+		"darray/pushBack",
+		benchDArrayPushBack,
+		pSuite->pAllocRegistry,
+		sizeof(uint32_t)
+	);
+
+	auto* pCircular{ pstd::alloc<pstd::CircularBuffer<uint32_t>>(pArena) };
+	*pCircular = pstd::CircularBuffer<uint32_t>{
+		.block = pstd::alloc<uint32_t>(pArena, BUFFER_CAPACITY),
+		.size = BUFFER_CAPACITY * sizeof(uint32_t),
+	};
+	addBenchmark(
+		pSuite, "circularBuffer/pushOverwrite", benchCircularPush, pCircular
+	);
+	addBenchmark(
+		pSuite, "circularBuffer/pushPop", benchCircularPushPop, pCircular
+	);
+
+	// one pair of buffers for every size, the small copies stay in L1
+	void* copyDst{ pstd::alloc(pArena, MAX_COPY_SIZE, 64) };
+	void* copySrc{ pstd::alloc(pArena, MAX_COPY_SIZE, 64) };
+	pstd::memSet(copySrc, 0x5A, MAX_COPY_SIZE);
+	for (const CopySize& copySize : COPY_SIZES) {
+		auto* pCopy{ pstd::alloc<CopyContext>(pArena) };
+		*pCopy = CopyContext{
+			.dst = copyDst,
+			.src = copySrc,
+			.size = copySize.size,
+		};
+		addBenchmark(
+			pSuite, copySize.name, benchMemCpy, pCopy, copySize.size
+		);
+	}
+
+	auto* pArrays{ pstd::alloc<ArrayContext>(pArena) };
+	*pArrays = ArrayContext{
+		.values = pstd::createArray<uint32_t>(pArena, ELEMENT_COUNT),
+		.scratch = pstd::createArray<uint32_t>(pArena, ELEMENT_COUNT),
+	};
+	for (uint32_t i{}; i < ELEMENT_COUNT; i++) {
+		pArrays->values[i] = i;
+	}
+	for (uint32_t i{ ELEMENT_COUNT - 1 }; i > 0; i--) {
+		auto j{ ncast<uint32_t>(nextRandom(&randomState) % (i + 1)) };
+		uint32_t value{ pArrays->values[i] };
+		pArrays->values[i] = pArrays->values[j];
+		pArrays->values[j] = value;
+	}
+	uint64_t arrayBytes{ ELEMENT_COUNT * sizeof(uint32_t) };
+	addBenchmark(
+		pSuite, "scan/inclusive", benchInclusiveScan, pArrays, arrayBytes
+	);
+	addBenchmark(pSuite, "scan/compactIf", benchCompactIf, pArrays, arrayBytes);
+	addBenchmark(pSuite, "view/filterTransform", benchViewSum, pArrays);
+	addBenchmark(
+		pSuite, "view/materialized", benchMaterializedSum, pArrays
+	);
+
+	auto* sweepValues{ pstd::alloc<uint32_t>(pArena, MAX_SWEEP_COUNT) };
+	for (size_t i{}; i < MAX_SWEEP_COUNT; i++) {
+		sweepValues[i] = ncast<uint32_t>(nextRandom(&randomState) >> 33);
+	}
+	for (const SweepSize& sweepSize : SWEEP_SIZES) {
+		auto* pSweep{ pstd::alloc<SweepContext>(pArena) };
+		*pSweep = SweepContext{
+			.values = sweepValues,
+			.count = sweepSize.count,
+			.key = 1u << 31,
+		};
+		for (const SweepKernel& kernel : SWEEP_KERNELS) {
+			pstd::StringBuilder nameBuilder{
+				pstd::createStringBuilder(pArena)
+			};
+			pstd::appendf(
+				&nameBuilder, "container/%m/%m", kernel.name, sweepSize.name
+			);
+			addBenchmark(
+				pSuite,
+				pstd::finishString(&nameBuilder, true).buffer,
+				kernel.function,
+				pSweep,
+				sweepSize.count * sizeof(uint32_t)
+			);
+		}
+	}
+
+	auto* pSearch{ pstd::alloc<SearchContext>(pArena) };
+	*pSearch = SearchContext{
+		.sorted = pstd::createArray<uint32_t>(pArena, SEARCH_COUNT),
+		.keys = pstd::alloc<uint32_t>(pArena, KEY_COUNT),
+	};
+	for (uint32_t i{}; i < SEARCH_COUNT; i++) {
+		pSearch->sorted[i] = 2 * i;
+	}
+	pSearch->eytzinger = pstd::createEytzingerArray(pArena, pSearch->sorted);
+	for (uint32_t i{}; i < KEY_COUNT; i++) {
+		pSearch->keys[i] =
+			ncast<uint32_t>(nextRandom(&randomState) % (2 * SEARCH_COUNT));
+	}
+	addBenchmark(pSuite, "search/lowerBound", benchLowerBound, pSearch);
+	addBenchmark(
+		pSuite, "search/eytzingerLowerBound", benchEytzingerLowerBound, pSearch
+	);
+
+	auto* pHeap{ pstd::alloc<HeapContext>(pArena) };
+	*pHeap = HeapContext{
+		.heap = pstd::createArray<uint32_t>(pArena, HEAP_COUNT, 0),
+		.randomState = randomState,
+	};
+	for (uint32_t i{}; i < HEAP_COUNT; i++) {
+		pstd::heapPush(
+			&pHeap->heap, ncast<uint32_t>(nextRandom(&randomState))
+		);
+	}
+	addBenchmark(pSuite, "heap/pushPop", benchHeapPushPop, pHeap);
+
+	addGridBenchmark<pstd::GridLayout::rowMajor>(
+		pSuite, "grid/stencilRowMajor"
+	);
+	addGridBenchmark<pstd::GridLayout::tiled>(pSuite, "grid/stencilTiled");
+	addGridBenchmark<pstd::GridLayout::morton>(pSuite, "grid/stencilMorton");
+
+	auto* hashData{ pstd::alloc<uint8_t>(pArena, MAX_HASH_SIZE) };
+	for (size_t i{}; i < MAX_HASH_SIZE; i++) {
+		hashData[i] = ncast<uint8_t>(nextRandom(&randomState));
+	}
+	for (const HashSize& hashSize : HASH_SIZES) {
+		auto* pHash{ pstd::alloc<HashContext>(pArena) };
+		*pHash = HashContext{ .data = hashData, .size = hashSize.size };
+		addHashBenchmark(pSuite, "hash64", hashSize, benchHash64, pHash);
+		addHashBenchmark(pSuite, "crc32c", hashSize, benchCrc32c, pHash);
+	}
+
+	auto* pKeys{ pstd::alloc<HashContext>(pArena) };
+	*pKeys = HashContext{ .data = hashData, .size = HASH_KEY_SPAN };
+	addBenchmark(pSuite, "hash/hash64Key16", benchHash64Key, pKeys);
+}
+
+namespace {
+	uint64_t benchArenaAlloc(void* pContext, uint64_t iterationCount) {
+		auto* pArena{ rcast<pstd::Arena*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			if (pArena->offset + ALLOC_SIZE > pArena->size) {
+				pstd::reset(pArena);
+			}
+			res += rcast<uintptr_t>(pstd::alloc(pArena, ALLOC_SIZE, 16));
+		}
+		return res;
+	}
+
+	uint64_t benchDArrayPushBack(void* pContext, uint64_t iterationCount) {
+		auto* pAllocRegistry{ rcast<pstd::AllocationRegistry*>(pContext) };
+
+		auto array{
+			pstd::createDArray<uint32_t>(pAllocRegistry, 0, iterationCount)
+		};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			pstd::pushBack(&array, ncast<uint32_t>(i));
+		}
+
+		uint64_t res{ array.count + array.data[iterationCount / 2] };
+		pstd::heapFree(pAllocRegistry, array.data);
+		return res;
+	}
+
+	uint64_t benchCircularPush(void* pContext, uint64_t iterationCount) {
+		auto* pBuffer{ rcast<pstd::CircularBuffer<uint32_t>*>(pContext) };
+
+		for (uint64_t i{}; i < iterationCount; i++) {
+			pstd::pushBackOverwrite(pBuffer, ncast<uint32_t>(i));
+		}
+		return pBuffer->headIndex;
+	}
+
+	uint64_t benchCircularPushPop(void* pContext, uint64_t iterationCount) {
+		auto* pBuffer{ rcast<pstd::CircularBuffer<uint32_t>*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			pstd::pushBackOverwrite(pBuffer, ncast<uint32_t>(i));
+			uint32_t value{};
+			pstd::popBack(pBuffer, &value);
+			res += value;
+		}
+		return res;
+	}
+
+	uint64_t benchMemCpy(void* pContext, uint64_t iterationCount) {
+		auto* pCopy{ rcast<CopyContext*>(pContext) };
+
+		for (uint64_t i{}; i < iterationCount; i++) {
+			pstd::memCpy(pCopy->dst, pCopy->src, pCopy->size);
+		}
+		return *rcast<const uint8_t*>(pCopy->dst);
+	}
+
+	uint64_t benchFind(void* pContext, uint64_t iterationCount) {
+		auto* pSweep{ rcast<SweepContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			res += pstd::find(pSweep->values, pSweep->count, pSweep->key);
+		}
+		return res;
+	}
+
+	uint64_t benchCount(void* pContext, uint64_t iterationCount) {
+		auto* pSweep{ rcast<SweepContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			res += pstd::count(
+				pSweep->values, pSweep->count, pSweep->values[0]
+			);
+		}
+		return res;
+	}
+
+	uint64_t benchMin(void* pContext, uint64_t iterationCount) {
+		auto* pSweep{ rcast<SweepContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			res += pstd::calcMin(pSweep->values, pSweep->count);
+		}
+		return res;
+	}
+
+	uint64_t benchMax(void* pContext, uint64_t iterationCount) {
+		auto* pSweep{ rcast<SweepContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			res += pstd::calcMax(pSweep->values, pSweep->count);
+		}
+		return res;
+	}
+
+	uint64_t benchSum(void* pContext, uint64_t iterationCount) {
+		auto* pSweep{ rcast<SweepContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			res += pstd::calcSum(pSweep->values, pSweep->count);
+		}
+		return res;
+	}
+
+	// MSVC would vectorize the loops without an early exit, the pragma
+	// keeps them scalar
+	uint64_t benchScalarFind(void* pContext, uint64_t iterationCount) {
+		auto* pSweep{ rcast<SweepContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			const uint32_t* values{ pstd::atomicLoad(&pSweep->values) };
+			size_t index{};
+			while (index < pSweep->count && values[index] != pSweep->key) {
+				index++;
+			}
+			res += index;
+		}
+		return res;
+	}
+
+	uint64_t benchScalarCount(void* pContext, uint64_t iterationCount) {
+		auto* pSweep{ rcast<SweepContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			const uint32_t* values{ pstd::atomicLoad(&pSweep->values) };
+			uint32_t key{ values[0] };
+#pragma loop(no_vector)
+			for (size_t j{}; j < pSweep->count; j++) {
+				res += values[j] == key;
+			}
+		}
+		return res;
+	}
+
+	uint64_t benchScalarMin(void* pContext, uint64_t iterationCount) {
+		auto* pSweep{ rcast<SweepContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			const uint32_t* values{ pstd::atomicLoad(&pSweep->values) };
+			uint32_t lowest{ values[0] };
+#pragma loop(no_vector)
+			for (size_t j{ 1 }; j < pSweep->count; j++) {
+				lowest = values[j] < lowest ? values[j] : lowest;
+			}
+			res += lowest;
+		}
+		return res;
+	}
+
+	uint64_t benchScalarMax(void* pContext, uint64_t iterationCount) {
+		auto* pSweep{ rcast<SweepContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			const uint32_t* values{ pstd::atomicLoad(&pSweep->values) };
+			uint32_t highest{ values[0] };
+#pragma loop(no_vector)
+			for (size_t j{ 1 }; j < pSweep->count; j++) {
+				highest = values[j] > highest ? values[j] : highest;
+			}
+			res += highest;
+		}
+		return res;
+	}
+
+	uint64_t benchScalarSum(void* pContext, uint64_t iterationCount) {
+		auto* pSweep{ rcast<SweepContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			const uint32_t* values{ pstd::atomicLoad(&pSweep->values) };
+#pragma loop(no_vector)
+			for (size_t j{}; j < pSweep->count; j++) {
+				res += values[j];
+			}
+		}
+		return res;
+	}
+
+	uint64_t benchLowerBound(void* pContext, uint64_t iterationCount) {
+		auto* pSearch{ rcast<SearchContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			uint32_t key{ pSearch->keys[i & (KEY_COUNT - 1)] };
+			res += pstd::lowerBound(pSearch->sorted, key);
+		}
+		return res;
+	}
+
+	uint64_t benchEytzingerLowerBound(
+		void* pContext, uint64_t iterationCount
+	) {
+		auto* pSearch{ rcast<SearchContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			uint32_t key{ pSearch->keys[i & (KEY_COUNT - 1)] };
+			res += pstd::lowerBound(pSearch->eytzinger, key);
+		}
+		return res;
+	}
+
+	uint64_t benchInclusiveScan(void* pContext, uint64_t iterationCount) {
+		auto* pArrays{ rcast<ArrayContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			res += pstd::inclusiveScan(
+				pArrays->scratch.data, pArrays->values.data, ELEMENT_COUNT
+			);
+		}
+		return res;
+	}
+
+	uint64_t benchCompactIf(void* pContext, uint64_t iterationCount) {
+		auto* pArrays{ rcast<ArrayContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			res += pstd::compactIf(
+				pArrays->scratch.data,
+				pArrays->values.data,
+				ELEMENT_COUNT,
+				[](uint32_t value) { return (value & 1) != 0; }
+			);
+		}
+		return res;
+	}
+
+	uint64_t benchViewSum(void* pContext, uint64_t iterationCount) {
+		auto* pArrays{ rcast<ArrayContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			auto odd{ pstd::filter(pArrays->values, [](uint32_t value) {
+				return (value & 1) != 0;
+			}) };
+			for (uint64_t value : pstd::transform(odd, [](uint32_t value) {
+					 return ncast<uint64_t>(value) * 3;
+				 })) {
+				res += value;
+			}
+		}
+		return res;
+	}
+
+	uint64_t benchMaterializedSum(void* pContext, uint64_t iterationCount) {
+		auto* pArrays{ rcast<ArrayContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			size_t count{ pstd::compactIf(
+				pArrays->scratch.data,
+				pArrays->values.data,
+				ELEMENT_COUNT,
+				[](uint32_t value) { return (value & 1) != 0; }
+			) };
+			for (size_t j{}; j < count; j++) {
+				res += ncast<uint64_t>(pArrays->scratch.data[j]) * 3;
+			}
+		}
+		return res;
+	}
+
+	uint64_t benchHeapPushPop(void* pContext, uint64_t iterationCount) {
+		auto* pHeap{ rcast<HeapContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			uint32_t top{};
+			pstd::heapPop(&pHeap->heap, &top);
+			res += top;
+			pstd::heapPush(
+				&pHeap->heap,
+				ncast<uint32_t>(Bench::nextRandom(&pHeap->randomState))
+			);
+		}
+		return res;
+	}
+
+	template<pstd::GridLayout layout>
+	uint64_t benchGridStencil(void* pContext, uint64_t iterationCount) {
+		auto* pGrid{ rcast<GridContext<layout>*>(pContext) };
+
+		float total{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			pstd::forEachCell(
+				pGrid->grid, [&](uint32_t x, uint32_t y, float& cell) {
+					float sum{};
+					pstd::forEachNeighbor(
+						pGrid->grid,
+						x,
+						y,
+						[&](float& neighbor, int32_t, int32_t) {
+							sum += neighbor;
+						}
+					);
+					total += sum - cell;
+				}
+			);
+		}
+		return ncast<uint64_t>(total);
+	}
+
+	uint64_t benchHash64(void* pContext, uint64_t iterationCount) {
+		auto* pHash{ rcast<HashContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			res += pstd::calcHash64(pHash->data, pHash->size, i);
+		}
+		return res;
+	}
+
+	uint64_t benchHash64Key(void* pContext, uint64_t iterationCount) {
+		auto* pHash{ rcast<HashContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			const uint8_t* key{ pHash->data +
+								(i & (pHash->size / HASH_KEY_SIZE - 1)) *
+									HASH_KEY_SIZE };
+			res += pstd::calcHash64(key, HASH_KEY_SIZE);
+		}
+		return res;
+	}
+
+	uint64_t benchCrc32c(void* pContext, uint64_t iterationCount) {
+		auto* pHash{ rcast<HashContext*>(pContext) };
+
+		uint32_t crc{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			crc = pstd::calcCrc32c(pHash->data, pHash->size, crc);
+		}
+		return crc;
+	}
+
+	template<pstd::GridLayout layout>
+	void addGridBenchmark(Suite* pSuite, const char* name) {
+		auto* pGrid{ pstd::alloc<GridContext<layout>>(&pSuite->arena) };
+		pGrid->grid = pstd::createGrid2D<float, layout>(
+			&pSuite->arena, GRID_SIZE, GRID_SIZE
+		);
+		pstd::forEachCell(
+			pGrid->grid, [](uint32_t x, uint32_t y, float& cell) {
+				cell = ncast<float>((x * 7 + y * 3) % 16);
+			}
+		);
+
+		Bench::addBenchmark(pSuite, name, benchGridStencil<layout>, pGrid);
+	}
+
+	void addHashBenchmark(
+		Suite* pSuite,
+		const char* kernel,
+		const HashSize& hashSize,
+		Bench::BenchFunction function,
+		HashContext* pHash
+	) {
+		pstd::StringBuilder nameBuilder{
+			pstd::createStringBuilder(&pSuite->arena)
+		};
+		pstd::appendf(&nameBuilder, "hash/%m/%m", kernel, hashSize.name);
+		Bench::addBenchmark(
+			pSuite,
+			pstd::finishString(&nameBuilder, true).buffer,
+			function,
+			pHash,
+			hashSize.size
+		);
+	}
+}  // namespace
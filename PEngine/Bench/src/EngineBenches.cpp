@@ -0,0 +1,300 @@
+#include "Bench.h"
+
+#include "Logging.h"
+#include "FlightRecorder.h"
+#include "Profiler.h"
+#include "FrameStats.h"
+#include "Metrics.h"
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PMemory.h"
+#include "Core/PString.h"
+#include "Core/PHistogram.h"
+#include "Core/PIntern.h"
+#include "Core/PAssert.h"
+
+using Bench::Suite;
+
+namespace {
+	// values and names are cycled through, powers of two
+	constexpr uint32_t VALUE_COUNT{ 1024 };
+	constexpr uint32_t NAME_COUNT{ 1024 };
+
+	constexpr uint64_t MAX_HISTOGRAM_VALUE{ 1000000 };
+
+	constexpr pstd::String ZONE_NAME{ pstd::createString("bench zone") };
+
+	// the percentile histogram holds VALUE_COUNT values, the other is added
+	// to for as long as the benchmark runs
+	struct HistogramContext {
+		pstd::Histogram* pFilled;
+		pstd::Histogram* pGrowing;
+		uint64_t* values;
+	};
+
+	struct MetricsContext {
+		Metrics::CounterId counter;
+		Metrics::GaugeId gauge;
+		Metrics::HistogramId histogram;
+		uint64_t* values;
+	};
+
+	struct InternContext {
+		pstd::HashedString* names;
+	};
+
+	// the logger blocks on a full ring, so a call that isn't filtered out
+	// costs at least what the writer thread takes to format it
+	uint64_t benchLogFiltered(void* pContext, uint64_t iterationCount);
+	uint64_t benchLogStatic(void* pContext, uint64_t iterationCount);
+	uint64_t benchLogArgs(void* pContext, uint64_t iterationCount);
+	uint64_t benchLogSuppressed(void* pContext, uint64_t iterationCount);
+
+	uint64_t benchRecordFrame(void* pContext, uint64_t iterationCount);
+	uint64_t benchRecordZone(void* pContext, uint64_t iterationCount);
+
+	// with the profiler on each zone also goes to the flight recorder,
+	// like any zone that isn't nested in another
+	uint64_t benchScopeOff(void* pContext, uint64_t iterationCount);
+	uint64_t benchScopeOn(void* pContext, uint64_t iterationCount);
+
+	uint64_t benchHistogramAdd(void* pContext, uint64_t iterationCount);
+	uint64_t benchHistogramPercentile(
+		void* pContext, uint64_t iterationCount
+	);
+
+	uint64_t benchAddToCounter(void* pContext, uint64_t iterationCount);
+	uint64_t benchAddToGauge(void* pContext, uint64_t iterationCount);
+	uint64_t benchRecordValue(void* pContext, uint64_t iterationCount);
+
+	uint64_t benchPhaseScope(void* pContext, uint64_t iterationCount);
+
+	// the names are all interned already
+	uint64_t benchIntern(void* pContext, uint64_t iterationCount);
+	uint64_t benchFindStringId(void* pContext, uint64_t iterationCount);
+
+	uint64_t* createValues(pstd::Arena* pArena, uint64_t* pRandomState);
+}  // namespace
+
+void Bench::addEngineBenchmarks(Suite* pSuite) {
+	ASSERT(pSuite);
+
+	pstd::Arena* pArena{ &pSuite->arena };
+	uint64_t randomState{ 3 };
+
+	addBenchmark(pSuite, "log/filtered", benchLogFiltered);
+	addBenchmark(pSuite, "log/static", benchLogStatic);
+	addBenchmark(pSuite, "log/args", benchLogArgs);
+	addBenchmark(pSuite, "log/limitedSuppressed", benchLogSuppressed);
+
+	addBenchmark(pSuite, "recorder/frame", benchRecordFrame);
+	addBenchmark(pSuite, "recorder/zone", benchRecordZone);
+
+	addBenchmark(pSuite, "profiler/scopeOff", benchScopeOff);
+	addBenchmark(pSuite, "profiler/scopeOn", benchScopeOn);
+
+	auto* pHistograms{ pstd::alloc<HistogramContext>(pArena) };
+	*pHistograms = HistogramContext{
+		.pFilled = pstd::alloc<pstd::Histogram>(pArena),
+		.pGrowing = pstd::alloc<pstd::Histogram>(pArena),
+		.values = createValues(pArena, &randomState),
+	};
+	pstd::memZero(pHistograms->pFilled, sizeof(pstd::Histogram));
+	pstd::memZero(pHistograms->pGrowing, sizeof(pstd::Histogram));
+	for (uint32_t i{}; i < VALUE_COUNT; i++) {
+		pstd::addValue(pHistograms->pFilled, pHistograms->values[i]);
+	}
+	addBenchmark(pSuite, "histogram/addValue", benchHistogramAdd, pHistograms);
+	addBenchmark(
+		pSuite, "histogram/p99", benchHistogramPercentile, pHistograms
+	);
+
+	auto* pMetrics{ pstd::alloc<MetricsContext>(pArena) };
+	*pMetrics = MetricsContext{
+		.counter = Metrics::registerCounter("bench counter"),
+		.gauge = Metrics::registerGauge("bench gauge"),
+		.histogram = Metrics::registerHistogram("bench histogram"),
+		.values = createValues(pArena, &randomState),
+	};
+	addBenchmark(pSuite, "metrics/addToCounter", benchAddToCounter, pMetrics);
+	addBenchmark(pSuite, "metrics/addToGauge", benchAddToGauge, pMetrics);
+	addBenchmark(pSuite, "metrics/recordValue", benchRecordValue, pMetrics);
+
+	addBenchmark(pSuite, "frameStats/phaseScope", benchPhaseScope);
+
+	auto* pIntern{ pstd::alloc<InternContext>(pArena) };
+	pIntern->names = pstd::alloc<pstd::HashedString>(pArena, NAME_COUNT);
+	for (uint32_t i{}; i < NAME_COUNT; i++) {
+		pstd::String name{ pstd::formatString(pArena, "entity %u", i) };
+		pIntern->names[i] = pstd::createHashedString(name);
+		pstd::internString(pIntern->names[i]);
+	}
+	addBenchmark(pSuite, "intern/internExisting", benchIntern, pIntern);
+	addBenchmark(pSuite, "intern/findStringId", benchFindStringId, pIntern);
+}
+
+namespace {
+	uint64_t benchLogFiltered(void* pContext, uint64_t iterationCount) {
+		Console::setLogLevel(Console::LogCategory::renderer, LogLevel::error);
+		for (uint64_t i{}; i < iterationCount; i++) {
+			LOG_INFO(renderer, "filtered out %u\n", i);
+		}
+		Console::setLogLevel(Console::LogCategory::renderer, LogLevel::none);
+		return iterationCount;
+	}
+
+	uint64_t benchLogStatic(void* pContext, uint64_t iterationCount) {
+		for (uint64_t i{}; i < iterationCount; i++) {
+			LOG_INFO(general, "a line of static text\n");
+		}
+		return iterationCount;
+	}
+
+	uint64_t benchLogArgs(void* pContext, uint64_t iterationCount) {
+		for (uint64_t i{}; i < iterationCount; i++) {
+			LOG_INFO(
+				general, "frame %u took %f ms in %m\n", i, 16.25, "update"
+			);
+		}
+		return iterationCount;
+	}
+
+	uint64_t benchLogSuppressed(void* pContext, uint64_t iterationCount) {
+		for (uint64_t i{}; i < iterationCount; i++) {
+			LOG_LIMITED(general, LogLevel::info, 0, "flooding %u\n", i);
+		}
+		return iterationCount;
+	}
+
+	uint64_t benchRecordFrame(void* pContext, uint64_t iterationCount) {
+		for (uint64_t i{}; i < iterationCount; i++) {
+			FlightRecorder::recordFrame(i);
+		}
+		return iterationCount;
+	}
+
+	uint64_t benchRecordZone(void* pContext, uint64_t iterationCount) {
+		for (uint64_t i{}; i < iterationCount; i++) {
+			FlightRecorder::recordZone(ZONE_NAME, i, i + 100);
+		}
+		return iterationCount;
+	}
+
+	uint64_t benchScopeOff(void* pContext, uint64_t iterationCount) {
+		Profiler::setProfilerOn(false);
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			Profiler::Scope scope{ "bench scope" };
+			res += i;
+		}
+		return res;
+	}
+
+	uint64_t benchScopeOn(void* pContext, uint64_t iterationCount) {
+		Profiler::setProfilerOn(true);
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			Profiler::Scope scope{ "bench scope" };
+			res += i;
+		}
+
+		Profiler::setProfilerOn(false);
+		return res;
+	}
+
+	uint64_t benchHistogramAdd(void* pContext, uint64_t iterationCount) {
+		auto* pHistograms{ rcast<HistogramContext*>(pContext) };
+
+		for (uint64_t i{}; i < iterationCount; i++) {
+			pstd::addValue(
+				pHistograms->pGrowing,
+				pHistograms->values[i & (VALUE_COUNT - 1)]
+			);
+		}
+		return pHistograms->pGrowing->totalValue;
+	}
+
+	uint64_t benchHistogramPercentile(
+		void* pContext, uint64_t iterationCount
+	) {
+		auto* pHistograms{ rcast<HistogramContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			res += pstd::calcPercentile(*pHistograms->pFilled, 99.0);
+		}
+		return res;
+	}
+
+	uint64_t benchAddToCounter(void* pContext, uint64_t iterationCount) {
+		auto* pMetrics{ rcast<MetricsContext*>(pContext) };
+
+		for (uint64_t i{}; i < iterationCount; i++) {
+			Metrics::addToCounter(pMetrics->counter);
+		}
+		return Metrics::readCounter(pMetrics->counter);
+	}
+
+	uint64_t benchAddToGauge(void* pContext, uint64_t iterationCount) {
+		auto* pMetrics{ rcast<MetricsContext*>(pContext) };
+
+		for (uint64_t i{}; i < iterationCount; i++) {
+			Metrics::addToGauge(pMetrics->gauge, 1);
+		}
+		return ncast<uint64_t>(Metrics::readGauge(pMetrics->gauge));
+	}
+
+	uint64_t benchRecordValue(void* pContext, uint64_t iterationCount) {
+		auto* pMetrics{ rcast<MetricsContext*>(pContext) };
+
+		for (uint64_t i{}; i < iterationCount; i++) {
+			Metrics::recordValue(
+				pMetrics->histogram, pMetrics->values[i & (VALUE_COUNT - 1)]
+			);
+		}
+		return iterationCount;
+	}
+
+	uint64_t benchPhaseScope(void* pContext, uint64_t iterationCount) {
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			FrameStats::PhaseScope scope{ FrameStats::Phase::gameUpdate };
+			res += i;
+		}
+		return res;
+	}
+
+	uint64_t benchIntern(void* pContext, uint64_t iterationCount) {
+		auto* pIntern{ rcast<InternContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			res += ncast<uint32_t>(
+				pstd::internString(pIntern->names[i & (NAME_COUNT - 1)])
+			);
+		}
+		return res;
+	}
+
+	uint64_t benchFindStringId(void* pContext, uint64_t iterationCount) {
+		auto* pIntern{ rcast<InternContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			res += ncast<uint32_t>(
+				pstd::findStringId(pIntern->names[i & (NAME_COUNT - 1)])
+			);
+		}
+		return res;
+	}
+
+	uint64_t* createValues(pstd::Arena* pArena, uint64_t* pRandomState) {
+		auto* values{ pstd::alloc<uint64_t>(pArena, VALUE_COUNT) };
+		for (uint32_t i{}; i < VALUE_COUNT; i++) {
+			values[i] = Bench::nextRandom(pRandomState) % MAX_HISTOGRAM_VALUE;
+		}
+		return values;
+	}
+}  // namespace
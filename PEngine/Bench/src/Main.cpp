@@ -0,0 +1,268 @@
+#include "Bench.h"
+
+#include "Logging.h"
+#include "LoggingSetup.h"
+#include "FlightRecorder.h"
+#include "Profiler.h"
+#include "FrameStats.h"
+#include "Metrics.h"
+#include "Core/PArena.h"
+#include "Core/PMemory.h"
+#include "Core/PFileIO.h"
+#include "Core/PParse.h"
+#include "Core/PConsole.h"
+#include "Core/PString.h"
+#include "Core/PStringBuilder.h"
+#include "Core/PIntern.h"
+
+// runs the benchmarks and writes their results as JSON, to compare runs
+// across commits.
+//
+// PEngineBench [--out <json file>] [--filter <text>] [--samples <count>]
+//              [--label <text>]
+//
+// --filter only runs the benchmarks whose name has text in it. --label is
+// copied into the JSON, a commit hash say. without --out the JSON goes to
+// the console, with it the console gets a line per benchmark as it runs
+
+namespace {
+	// the container sweep's 100M values take 400MB of it
+	constexpr size_t SUITE_SIZE{ 512 * 1024 * 1024 };
+	constexpr size_t OUTPUT_SIZE{ 256 * 1024 };
+	constexpr uint32_t MAX_LINE_SIZE{ 256 };
+
+	constexpr uint64_t CALIBRATION_NANOSECONDS{ 100 * 1000 * 1000 };
+
+	// the value after flag, empty without the flag
+	pstd::String findArgValue(
+		const pstd::Array<pstd::String>& args, const char* flag
+	);
+
+	// a JSON string, with quotes and backslashes escaped
+	void appendJsonString(
+		pstd::StringBuilder* pBuilder, const pstd::String& text
+	);
+
+	void appendResult(
+		pstd::StringBuilder* pBuilder,
+		const Bench::Benchmark& benchmark,
+		const Bench::Result& result,
+		bool isFirst
+	);
+}  // namespace
+
+int main() {
+	pstd::AllocationRegistry allocationRegistry{ pstd::createAllocationRegistry(
+	) };
+	pstd::Arena scratchArena{
+		pstd::allocateArena(&allocationRegistry, 1024 * 1024)
+	};
+
+	pstd::Array<pstd::String> args{ pstd::getCommandLineArgs(&scratchArena) };
+	pstd::String outPath{ findArgValue(args, "--out") };
+	pstd::String filter{ findArgValue(args, "--filter") };
+	pstd::String label{ findArgValue(args, "--label") };
+
+	Bench::Config config{ Bench::DEFAULT_CONFIG };
+	pstd::String samplesText{ findArgValue(args, "--samples") };
+	uint64_t sampleCount{};
+	if (samplesText.size > 0) {
+		if (!pstd::parseUInt(samplesText, &sampleCount) || sampleCount == 0 ||
+			sampleCount > UINT32_MAX) {
+			pstd::consoleWrite("--samples needs a count above 0\n");
+			return 1;
+		}
+		config.sampleCount = ncast<uint32_t>(sampleCount);
+	}
+
+	pstd::FileHandle outFile{};
+	if (outPath.size > 0) {
+		outFile = pstd::openFile(
+			&scratchArena,
+			outPath,
+			pstd::FileAccess::write,
+			pstd::FileShare::read,
+			pstd::FileCreate::createAlways
+		);
+		if (!outFile) {
+			pstd::consoleWrite("couldn't create the JSON file\n");
+			return 1;
+		}
+	}
+
+	// the engine benchmarks call into these. the log only goes to memory,
+	// the console is for the results
+	FrameStats::startup(&allocationRegistry);
+	Metrics::startup(&allocationRegistry);
+	Profiler::startup(&allocationRegistry);
+
+	pstd::StringBuilder pathBuilder{ pstd::createStringBuilder(&scratchArena
+	) };
+	pstd::appendf(
+		&pathBuilder,
+		"%mBenchRecording.bin",
+		pstd::makeExeDirectoryPath(&scratchArena)
+	);
+	FlightRecorder::Config recorderConfig{ FlightRecorder::DEFAULT_CONFIG };
+	recorderConfig.path = pstd::finishString(&pathBuilder, true).buffer;
+	if (!FlightRecorder::startup(&allocationRegistry, recorderConfig)) {
+		pstd::consoleWrite(
+			"couldn't map the flight recording, the recorder benchmarks "
+			"only time the check\n"
+		);
+	}
+
+	Console::LogConfig logConfig{ Console::DEFAULT_LOG_CONFIG };
+	logConfig.overflow = Console::LogOverflow::block;
+	logConfig.isConsoleOn = false;
+	logConfig.memorySize = 1024 * 1024;
+	Console::startup(&allocationRegistry, logConfig);
+	pstd::startupStringInterner(&allocationRegistry);
+
+	Bench::Suite suite{ Bench::createSuite(&allocationRegistry, SUITE_SIZE) };
+	Bench::addCoreBenchmarks(&suite);
+	Bench::addTextBenchmarks(&suite);
+	Bench::addMathBenchmarks(&suite);
+	Bench::addEngineBenchmarks(&suite);
+
+	double cyclesPerNanosecond{
+		Bench::calibrateCycleCounter(CALIBRATION_NANOSECONDS)
+	};
+
+	pstd::Arena outputArena{
+		pstd::allocateArena(&allocationRegistry, OUTPUT_SIZE)
+	};
+	pstd::StringBuilder builder{ pstd::createStringBuilder(&outputArena) };
+	pstd::append(&builder, "{\n\t\"label\": ");
+	appendJsonString(&builder, label);
+	pstd::appendf(
+		&builder,
+		",\n\t\"cyclesPerNanosecond\": %f,\n\t\"warmupSamples\": %u,\n"
+		"\t\"samples\": %u,\n\t\"minSampleNanoseconds\": %u,\n"
+		"\t\"outlierDeviations\": %f,\n\t\"benchmarks\": [",
+		cyclesPerNanosecond,
+		config.warmupSampleCount,
+		config.sampleCount,
+		config.minSampleNanoseconds,
+		config.outlierDeviations
+	);
+
+	pstd::Arena lineArena{
+		pstd::allocateArena(&allocationRegistry, MAX_LINE_SIZE)
+	};
+	bool isFirst{ true };
+	for (size_t i{}; i < suite.benchmarks.count; i++) {
+		const Bench::Benchmark& benchmark{ suite.benchmarks[i] };
+		pstd::String name{ pstd::createString(benchmark.name) };
+		if (filter.size > 0 && !pstd::findSubstring(name, filter)) {
+			continue;
+		}
+
+		Bench::Result result{ Bench::runBenchmark(
+			benchmark, config, cyclesPerNanosecond, scratchArena
+		) };
+		appendResult(&builder, benchmark, result, isFirst);
+		isFirst = false;
+
+		if (outFile) {
+			pstd::Arena arena{ lineArena };
+			pstd::String line{ pstd::formatString(
+				&arena,
+				"%m: %f ns, %u of %u samples rejected\n",
+				name,
+				result.median,
+				result.rejectedCount,
+				config.sampleCount
+			) };
+			pstd::consoleWrite(line);
+		}
+	}
+	pstd::append(&builder, "\n\t]\n}\n");
+	pstd::String json{ pstd::finishString(&builder) };
+
+	int exitCode{};
+	if (outFile) {
+		if (!pstd::writeFile(outFile, json.buffer, json.size)) {
+			pstd::consoleWrite("couldn't write the JSON file\n");
+			exitCode = 1;
+		}
+		pstd::closeFile(outFile);
+	} else {
+		pstd::consoleWrite(json);
+	}
+
+	Bench::destroySuite(&suite);
+	pstd::freeArena(&allocationRegistry, &lineArena);
+	pstd::freeArena(&allocationRegistry, &outputArena);
+
+	pstd::shutdownStringInterner(&allocationRegistry);
+	Profiler::shutdown(&allocationRegistry);
+	FrameStats::shutdown(&allocationRegistry);
+	Metrics::shutdown(&allocationRegistry);
+	Console::shutdown(&allocationRegistry);
+	FlightRecorder::shutdown(&allocationRegistry);
+	return exitCode;
+}
+
+namespace {
+	pstd::String findArgValue(
+		const pstd::Array<pstd::String>& args, const char* flag
+	) {
+		for (size_t i{ 1 }; i + 1 < args.count; i++) {
+			if (pstd::stringsMatch(args[i], pstd::createString(flag))) {
+				return args[i + 1];
+			}
+		}
+
+		return pstd::String{};
+	}
+
+	void appendJsonString(
+		pstd::StringBuilder* pBuilder, const pstd::String& text
+	) {
+		pstd::append(pBuilder, '"');
+		for (uint32_t i{}; i < text.size; i++) {
+			char letter{ text.buffer[i] };
+			if (letter == '"' || letter == '\\') {
+				pstd::append(pBuilder, '\\');
+			}
+			pstd::append(pBuilder, letter);
+		}
+		pstd::append(pBuilder, '"');
+	}
+
+	void appendResult(
+		pstd::StringBuilder* pBuilder,
+		const Bench::Benchmark& benchmark,
+		const Bench::Result& result,
+		bool isFirst
+	) {
+		pstd::append(pBuilder, isFirst ? "\n\t\t{ " : ",\n\t\t{ ");
+		pstd::append(pBuilder, "\"name\": ");
+		appendJsonString(pBuilder, pstd::createString(benchmark.name));
+		pstd::appendf(
+			pBuilder,
+			", \"iterations\": %u, \"kept\": %u, \"rejected\": %u, "
+			"\"minNs\": %f, \"medianNs\": %f, \"meanNs\": %f, "
+			"\"deviationNs\": %f, \"maxNs\": %f, \"medianCycles\": %f",
+			result.iterationCount,
+			result.keptCount,
+			result.rejectedCount,
+			result.minimum,
+			result.median,
+			result.mean,
+			result.deviation,
+			result.maximum,
+			result.medianCycles
+		);
+		if (benchmark.bytesPerIteration > 0 && result.median > 0.0) {
+			pstd::appendf(
+				pBuilder,
+				", \"bytesPerSecond\": %f",
+				ncast<double>(benchmark.bytesPerIteration) * 1000000000.0 /
+					result.median
+			);
+		}
+		pstd::append(pBuilder, " }");
+	}
+}  // namespace
@@ -0,0 +1,265 @@
+#include "Bench.h"
+
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PMemory.h"
+#include "Core/PMath.h"
+#include "Core/PVector.h"
+#include "Core/PMatrix.h"
+#include "Core/PAssert.h"
+
+using Bench::Suite;
+
+namespace {
+	// inputs are cycled through, a power of two
+	constexpr uint32_t INPUT_COUNT{ 1024 };
+
+	// tanf is kept away from its poles, so the totals stay finite
+	constexpr float MAX_TAN_ANGLE{ 1.4f };
+
+	struct VectorContext {
+		pstd::Vec3* vectors;
+		pstd::Vec4* vectors4;
+		pstd::Mat4* matrices;
+		pstd::Rot3* rotors;
+	};
+
+	// pairs go to the binary functions, atanf2 gets a sine and a cosine
+	struct ScalarContext {
+		const float* inputs;
+		const float* secondInputs;
+	};
+
+	uint64_t benchDot(void* pContext, uint64_t iterationCount);
+	uint64_t benchCross(void* pContext, uint64_t iterationCount);
+	uint64_t benchNormalize(void* pContext, uint64_t iterationCount);
+	uint64_t benchRotate(void* pContext, uint64_t iterationCount);
+	uint64_t benchMatVec(void* pContext, uint64_t iterationCount);
+	uint64_t benchMatMat(void* pContext, uint64_t iterationCount);
+
+	template<float (*function)(float)>
+	uint64_t benchUnary(void* pContext, uint64_t iterationCount);
+
+	uint64_t benchAtan2(void* pContext, uint64_t iterationCount);
+
+	// inputs evenly spread over [low, high), in random order
+	float* createInputs(
+		pstd::Arena* pArena, uint64_t* pRandomState, float low, float high
+	);
+
+	// the bits of a float total, which may have gone to inf or nan
+	uint64_t sinkFloat(float total);
+}  // namespace
+
+void Bench::addMathBenchmarks(Suite* pSuite) {
+	ASSERT(pSuite);
+
+	pstd::Arena* pArena{ &pSuite->arena };
+	uint64_t randomState{ 2 };
+
+	auto* pVectors{ pstd::alloc<VectorContext>(pArena) };
+	*pVectors = VectorContext{
+		.vectors = pstd::alloc<pstd::Vec3>(pArena, INPUT_COUNT),
+		.vectors4 = pstd::alloc<pstd::Vec4>(pArena, INPUT_COUNT),
+		.matrices = pstd::alloc<pstd::Mat4>(pArena, INPUT_COUNT),
+		.rotors = pstd::alloc<pstd::Rot3>(pArena, INPUT_COUNT),
+	};
+	float* components{ createInputs(pArena, &randomState, -1.f, 1.f) };
+	for (uint32_t i{}; i < INPUT_COUNT; i++) {
+		auto component{ [&](uint32_t offset) {
+			return components[(i + offset) & (INPUT_COUNT - 1)];
+		} };
+
+		pVectors->vectors[i] = pstd::Vec3{
+			.x = component(0),
+			.y = component(1),
+			.z = component(2),
+		};
+		pVectors->vectors4[i] = pstd::Vec4{
+			.x = component(0),
+			.y = component(1),
+			.z = component(2),
+			.w = 1.f,
+		};
+		pVectors->matrices[i] = pstd::getIdentityMatrix<4>();
+		for (uint32_t column{}; column < 4; column++) {
+			for (uint32_t row{}; row < 4; row++) {
+				pVectors->matrices[i][column][row] +=
+					component(3 + column * 4 + row) * 0.1f;
+			}
+		}
+	}
+	for (uint32_t i{}; i < INPUT_COUNT; i++) {
+		pVectors->rotors[i] = pstd::calcRotor(
+			pstd::calcNormalized(pVectors->vectors[i]),
+			pstd::calcNormalized(
+				pVectors->vectors[(i + 1) & (INPUT_COUNT - 1)]
+			)
+		);
+	}
+	addBenchmark(pSuite, "vec3/dot", benchDot, pVectors);
+	addBenchmark(pSuite, "vec3/cross", benchCross, pVectors);
+	addBenchmark(pSuite, "vec3/normalize", benchNormalize, pVectors);
+	addBenchmark(pSuite, "vec3/rotate", benchRotate, pVectors);
+	addBenchmark(pSuite, "mat4/mulVec4", benchMatVec, pVectors);
+	addBenchmark(pSuite, "mat4/mulMat4", benchMatMat, pVectors);
+
+	auto addUnary{ [&](const char* name,
+					   uint64_t (*function)(void*, uint64_t),
+					   float low,
+					   float high) {
+		auto* pScalars{ pstd::alloc<ScalarContext>(pArena) };
+		*pScalars = ScalarContext{
+			.inputs = createInputs(pArena, &randomState, low, high),
+		};
+		addBenchmark(pSuite, name, function, pScalars);
+	} };
+	addUnary("soft/sqrtf", benchUnary<pstd::sqrtf>, 0.f, 1000.f);
+	addUnary("soft/sinf", benchUnary<pstd::sinf>, -pstd::TAU, pstd::TAU);
+	addUnary("soft/cosf", benchUnary<pstd::cosf>, -pstd::TAU, pstd::TAU);
+	addUnary(
+		"soft/tanf", benchUnary<pstd::tanf>, -MAX_TAN_ANGLE, MAX_TAN_ANGLE
+	);
+	addUnary("soft/atanf", benchUnary<pstd::atanf>, -100.f, 100.f);
+	addUnary("soft/asinf", benchUnary<pstd::asinf>, -1.f, 1.f);
+	addUnary("soft/acosf", benchUnary<pstd::acosf>, -1.f, 1.f);
+
+	auto* pAngles{ pstd::alloc<ScalarContext>(pArena) };
+	float* angles{ createInputs(pArena, &randomState, -pstd::PI, pstd::PI) };
+	auto* sines{ pstd::alloc<float>(pArena, INPUT_COUNT) };
+	auto* cosines{ pstd::alloc<float>(pArena, INPUT_COUNT) };
+	for (uint32_t i{}; i < INPUT_COUNT; i++) {
+		sines[i] = pstd::sinf(angles[i]);
+		cosines[i] = pstd::cosf(angles[i]);
+	}
+	*pAngles = ScalarContext{
+		.inputs = sines,
+		.secondInputs = cosines,
+	};
+	addBenchmark(pSuite, "soft/atanf2", benchAtan2, pAngles);
+}
+
+namespace {
+	uint64_t benchDot(void* pContext, uint64_t iterationCount) {
+		auto* pVectors{ rcast<VectorContext*>(pContext) };
+
+		float total{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			total += pstd::dot(
+				pVectors->vectors[i & (INPUT_COUNT - 1)],
+				pVectors->vectors[(i + 1) & (INPUT_COUNT - 1)]
+			);
+		}
+		return sinkFloat(total);
+	}
+
+	uint64_t benchCross(void* pContext, uint64_t iterationCount) {
+		auto* pVectors{ rcast<VectorContext*>(pContext) };
+
+		pstd::Vec3 total{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			total += pstd::cross(
+				pVectors->vectors[i & (INPUT_COUNT - 1)],
+				pVectors->vectors[(i + 1) & (INPUT_COUNT - 1)]
+			);
+		}
+		return sinkFloat(total.x + total.y + total.z);
+	}
+
+	uint64_t benchNormalize(void* pContext, uint64_t iterationCount) {
+		auto* pVectors{ rcast<VectorContext*>(pContext) };
+
+		pstd::Vec3 total{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			total +=
+				pstd::calcNormalized(pVectors->vectors[i & (INPUT_COUNT - 1)]);
+		}
+		return sinkFloat(total.x + total.y + total.z);
+	}
+
+	uint64_t benchRotate(void* pContext, uint64_t iterationCount) {
+		auto* pVectors{ rcast<VectorContext*>(pContext) };
+
+		pstd::Vec3 total{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			total += pstd::calcRotated(
+				pVectors->vectors[i & (INPUT_COUNT - 1)],
+				pVectors->rotors[(i + 1) & (INPUT_COUNT - 1)]
+			);
+		}
+		return sinkFloat(total.x + total.y + total.z);
+	}
+
+	uint64_t benchMatVec(void* pContext, uint64_t iterationCount) {
+		auto* pVectors{ rcast<VectorContext*>(pContext) };
+
+		pstd::Vec4 total{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			total += pVectors->matrices[i & (INPUT_COUNT - 1)] *
+				pVectors->vectors4[(i + 1) & (INPUT_COUNT - 1)];
+		}
+		return sinkFloat(total.x + total.y + total.z + total.w);
+	}
+
+	uint64_t benchMatMat(void* pContext, uint64_t iterationCount) {
+		auto* pVectors{ rcast<VectorContext*>(pContext) };
+
+		float total{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			pstd::Mat4 product{
+				pVectors->matrices[i & (INPUT_COUNT - 1)] *
+				pVectors->matrices[(i + 1) & (INPUT_COUNT - 1)]
+			};
+			total += product.col1.x + product.col4.w;
+		}
+		return sinkFloat(total);
+	}
+
+	template<float (*function)(float)>
+	uint64_t benchUnary(void* pContext, uint64_t iterationCount) {
+		auto* pScalars{ rcast<ScalarContext*>(pContext) };
+
+		float total{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			total += function(pScalars->inputs[i & (INPUT_COUNT - 1)]);
+		}
+		return sinkFloat(total);
+	}
+
+	uint64_t benchAtan2(void* pContext, uint64_t iterationCount) {
+		auto* pScalars{ rcast<ScalarContext*>(pContext) };
+
+		float total{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			total += pstd::atanf2(
+				pScalars->inputs[i & (INPUT_COUNT - 1)],
+				pScalars->secondInputs[i & (INPUT_COUNT - 1)]
+			);
+		}
+		return sinkFloat(total);
+	}
+
+	float* createInputs(
+		pstd::Arena* pArena, uint64_t* pRandomState, float low, float high
+	) {
+		auto* inputs{ pstd::alloc<float>(pArena, INPUT_COUNT) };
+		float step{ (high - low) / ncast<float>(INPUT_COUNT) };
+		for (uint32_t i{}; i < INPUT_COUNT; i++) {
+			inputs[i] = low + step * ncast<float>(i);
+		}
+		for (uint32_t i{ INPUT_COUNT - 1 }; i > 0; i--) {
+			uint64_t random{ Bench::nextRandom(pRandomState) };
+			auto j{ ncast<uint32_t>(random % (i + 1)) };
+			float input{ inputs[i] };
+			inputs[i] = inputs[j];
+			inputs[j] = input;
+		}
+		return inputs;
+	}
+
+	uint64_t sinkFloat(float total) {
+		uint32_t bits{};
+		pstd::memCpy(&bits, &total, sizeof(bits));
+		return bits;
+	}
+}  // namespace
@@ -0,0 +1,416 @@
+#include "Bench.h"
+
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PString.h"
+#include "Core/PStringBuilder.h"
+#include "Core/PParse.h"
+#include "Core/PUnicode.h"
+#include "Core/PAssert.h"
+
+using Bench::Suite;
+
+namespace {
+	// numbers are cycled through, a power of two
+	constexpr uint32_t NUMBER_COUNT{ 1024 };
+
+	// about 230K numbers, too many for the branch predictor to learn
+	constexpr uint32_t NUMBER_TEXT_SIZE{ 4 * 1024 * 1024 };
+
+	constexpr uint32_t TEXT_SIZE{ 64 * 1024 };
+	constexpr uint32_t FORMAT_ARENA_SIZE{ 4 * 1024 };
+
+	// the search pattern is only found at the end of the text, whose
+	// letters are all from TEXT_ALPHABET
+	constexpr const char* TEXT_ALPHABET{ "acgt" };
+	constexpr const char* SEARCH_PATTERN{ "acgtacgtacgtacgz" };
+	constexpr const char* SEARCH_SET{ "xyz" };
+
+	// ascii words between two 3 byte code points
+	constexpr const char* MIXED_PIECE{ "frame \xE4\xB8\x96\xE7\x95\x8C " };
+
+	// chinese text, every code point 3 bytes
+	constexpr const char* CJK_PIECE{
+		"\xE6\xB8\xB2\xE6\x9F\x93\xE5\xB8\xA7\xE7\x9A\x84\xE6\x97\xB6"
+		"\xE9\x97\xB4\xEF\xBC\x8C"
+	};
+
+	// every benchmark starts from a copy of the arena, so nothing builds up
+	struct FormatContext {
+		pstd::Arena arena;
+	};
+
+	struct NumberContext {
+		uint64_t* integers;
+		double* doubles;
+		pstd::String* integerTexts;
+		pstd::String* doubleTexts;
+		pstd::String numberText;  // doubles of its own, a space after each
+	};
+
+	struct SearchContext {
+		pstd::String text;
+		pstd::String pattern;
+		pstd::String set;
+	};
+
+	struct UnicodeContext {
+		pstd::String text;
+		char16_t* utf16;
+	};
+
+	uint64_t benchFormatString(void* pContext, uint64_t iterationCount);
+	uint64_t benchAppendf(void* pContext, uint64_t iterationCount);
+
+	uint64_t benchWriteUInt64(void* pContext, uint64_t iterationCount);
+	uint64_t benchWriteDouble(void* pContext, uint64_t iterationCount);
+	uint64_t benchWriteFloat(void* pContext, uint64_t iterationCount);
+	uint64_t benchParseUInt(void* pContext, uint64_t iterationCount);
+	uint64_t benchParseFloat(void* pContext, uint64_t iterationCount);
+
+	// reads every number in the text, an iteration is the whole text
+	uint64_t benchTokenizer(void* pContext, uint64_t iterationCount);
+
+	uint64_t benchFindSubstring(void* pContext, uint64_t iterationCount);
+	uint64_t benchFindAnyOf(void* pContext, uint64_t iterationCount);
+	uint64_t benchCStringLength(void* pContext, uint64_t iterationCount);
+
+	// ascii only takes the fast path, the mixed and chinese texts the
+	// lookup tables
+	uint64_t benchValidateUtf8(void* pContext, uint64_t iterationCount);
+	uint64_t benchUtf8ToUtf16(void* pContext, uint64_t iterationCount);
+
+	// 0 to a million, every bit of the mantissa random
+	double createRandomDouble(uint64_t* pRandomState);
+
+	// text of size letters, pieces repeated until the next one doesn't fit
+	pstd::String createRepeatedText(
+		pstd::Arena* pArena, const pstd::String& piece, uint32_t size
+	);
+}  // namespace
+
+void Bench::addTextBenchmarks(Suite* pSuite) {
+	ASSERT(pSuite);
+
+	pstd::Arena* pArena{ &pSuite->arena };
+	uint64_t randomState{ 1 };
+
+	auto* pFormat{ pstd::alloc<FormatContext>(pArena) };
+	*pFormat = FormatContext{
+		.arena = pstd::Arena{
+			.block = pstd::alloc<char>(pArena, FORMAT_ARENA_SIZE),
+			.size = FORMAT_ARENA_SIZE,
+		},
+	};
+	addBenchmark(pSuite, "format/formatString", benchFormatString, pFormat);
+	addBenchmark(pSuite, "format/appendf", benchAppendf, pFormat);
+
+	auto* pNumbers{ pstd::alloc<NumberContext>(pArena) };
+	*pNumbers = NumberContext{
+		.integers = pstd::alloc<uint64_t>(pArena, NUMBER_COUNT),
+		.doubles = pstd::alloc<double>(pArena, NUMBER_COUNT),
+		.integerTexts = pstd::alloc<pstd::String>(pArena, NUMBER_COUNT),
+		.doubleTexts = pstd::alloc<pstd::String>(pArena, NUMBER_COUNT),
+	};
+	for (uint32_t i{}; i < NUMBER_COUNT; i++) {
+		// every digit count from 1 to 20 comes up
+		uint64_t random{ nextRandom(&randomState) };
+		pNumbers->integers[i] = random >> (random % 64);
+		pNumbers->doubles[i] = createRandomDouble(&randomState);
+		pNumbers->integerTexts[i] =
+			pstd::pushUInt64AsString(pArena, pNumbers->integers[i]);
+		pNumbers->doubleTexts[i] =
+			pstd::pushDoubleAsString(pArena, pNumbers->doubles[i]);
+	}
+	pstd::StringBuilder builder{
+		pstd::createStringBuilder(pArena, NUMBER_TEXT_SIZE)
+	};
+	char number[pstd::MAX_DECIMAL_CHARS];
+	while (builder.size + pstd::MAX_DECIMAL_CHARS + 1 <= NUMBER_TEXT_SIZE) {
+		uint32_t size{
+			pstd::writeDouble(number, createRandomDouble(&randomState))
+		};
+		pstd::append(&builder, pstd::String{ .buffer = number, .size = size });
+		pstd::append(&builder, ' ');
+	}
+	pNumbers->numberText = pstd::finishString(&builder);
+	addBenchmark(pSuite, "format/writeUInt64", benchWriteUInt64, pNumbers);
+	addBenchmark(pSuite, "format/writeDouble", benchWriteDouble, pNumbers);
+	addBenchmark(pSuite, "format/writeFloat", benchWriteFloat, pNumbers);
+	addBenchmark(pSuite, "parse/parseUInt", benchParseUInt, pNumbers);
+	addBenchmark(pSuite, "parse/parseFloat", benchParseFloat, pNumbers);
+	addBenchmark(
+		pSuite,
+		"parse/tokenizer",
+		benchTokenizer,
+		pNumbers,
+		pNumbers->numberText.size
+	);
+
+	// null terminated for calcCStringLength
+	auto* textBuffer{ pstd::alloc<char>(pArena, TEXT_SIZE + 1) };
+	pstd::String pattern{ pstd::createString(SEARCH_PATTERN) };
+	uint32_t randomSize{ TEXT_SIZE - pattern.size };
+	for (uint32_t i{}; i < randomSize; i++) {
+		textBuffer[i] = TEXT_ALPHABET[nextRandom(&randomState) % 4];
+	}
+	pstd::memCpy(textBuffer + randomSize, pattern.buffer, pattern.size);
+	textBuffer[TEXT_SIZE] = '\0';
+
+	auto* pSearch{ pstd::alloc<SearchContext>(pArena) };
+	*pSearch = SearchContext{
+		.text = pstd::String{ .buffer = textBuffer, .size = TEXT_SIZE },
+		.pattern = pattern,
+		.set = pstd::createString(SEARCH_SET),
+	};
+	addBenchmark(
+		pSuite, "search/findSubstring", benchFindSubstring, pSearch, TEXT_SIZE
+	);
+	addBenchmark(
+		pSuite, "search/findAnyOf", benchFindAnyOf, pSearch, TEXT_SIZE
+	);
+	addBenchmark(
+		pSuite, "search/cStringLength", benchCStringLength, pSearch, TEXT_SIZE
+	);
+
+	char16_t* utf16{ pstd::alloc<char16_t>(pArena, TEXT_SIZE) };
+	auto* pAscii{ pstd::alloc<UnicodeContext>(pArena) };
+	*pAscii = UnicodeContext{ .text = pSearch->text, .utf16 = utf16 };
+	addBenchmark(
+		pSuite, "unicode/validateAscii", benchValidateUtf8, pAscii, TEXT_SIZE
+	);
+
+	auto* pMixed{ pstd::alloc<UnicodeContext>(pArena) };
+	*pMixed = UnicodeContext{
+		.text = createRepeatedText(
+			pArena, pstd::createString(MIXED_PIECE), TEXT_SIZE
+		),
+		.utf16 = utf16,
+	};
+	addBenchmark(
+		pSuite,
+		"unicode/validateMixed",
+		benchValidateUtf8,
+		pMixed,
+		pMixed->text.size
+	);
+	addBenchmark(
+		pSuite,
+		"unicode/utf8ToUtf16",
+		benchUtf8ToUtf16,
+		pMixed,
+		pMixed->text.size
+	);
+
+	auto* pCjk{ pstd::alloc<UnicodeContext>(pArena) };
+	*pCjk = UnicodeContext{
+		.text = createRepeatedText(
+			pArena, pstd::createString(CJK_PIECE), TEXT_SIZE
+		),
+		.utf16 = utf16,
+	};
+	addBenchmark(
+		pSuite,
+		"unicode/validateCjk",
+		benchValidateUtf8,
+		pCjk,
+		pCjk->text.size
+	);
+	addBenchmark(
+		pSuite,
+		"unicode/utf8ToUtf16Cjk",
+		benchUtf8ToUtf16,
+		pCjk,
+		pCjk->text.size
+	);
+}
+
+namespace {
+	uint64_t benchFormatString(void* pContext, uint64_t iterationCount) {
+		auto* pFormat{ rcast<FormatContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			pstd::Arena arena{ pFormat->arena };
+			pstd::String text{ pstd::formatString(
+				&arena, "frame %u took %f ms in %m", i, 16.25, "update"
+			) };
+			res += text.size;
+		}
+		return res;
+	}
+
+	uint64_t benchAppendf(void* pContext, uint64_t iterationCount) {
+		auto* pFormat{ rcast<FormatContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			pstd::Arena arena{ pFormat->arena };
+			pstd::StringBuilder builder{ pstd::createStringBuilder(&arena) };
+			pstd::appendf(&builder, "frame %u took ", i);
+			pstd::appendf(&builder, "%f ms in %m", 16.25, "update");
+			res += pstd::finishString(&builder).size;
+		}
+		return res;
+	}
+
+	uint64_t benchWriteUInt64(void* pContext, uint64_t iterationCount) {
+		auto* pNumbers{ rcast<NumberContext*>(pContext) };
+
+		char buffer[pstd::MAX_INT64_CHARS];
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			uint64_t value{ pNumbers->integers[i & (NUMBER_COUNT - 1)] };
+			res += pstd::writeUInt64(buffer, value) + buffer[0];
+		}
+		return res;
+	}
+
+	uint64_t benchWriteDouble(void* pContext, uint64_t iterationCount) {
+		auto* pNumbers{ rcast<NumberContext*>(pContext) };
+
+		char buffer[pstd::MAX_DECIMAL_CHARS];
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			double value{ pNumbers->doubles[i & (NUMBER_COUNT - 1)] };
+			res += pstd::writeDouble(buffer, value) + buffer[0];
+		}
+		return res;
+	}
+
+	uint64_t benchWriteFloat(void* pContext, uint64_t iterationCount) {
+		auto* pNumbers{ rcast<NumberContext*>(pContext) };
+
+		char buffer[pstd::MAX_DECIMAL_CHARS];
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			auto value{
+				ncast<float>(pNumbers->doubles[i & (NUMBER_COUNT - 1)])
+			};
+			res += pstd::writeFloat(buffer, value) + buffer[0];
+		}
+		return res;
+	}
+
+	uint64_t benchParseUInt(void* pContext, uint64_t iterationCount) {
+		auto* pNumbers{ rcast<NumberContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			uint64_t value{};
+			pstd::parseUInt(
+				pNumbers->integerTexts[i & (NUMBER_COUNT - 1)], &value
+			);
+			res += value;
+		}
+		return res;
+	}
+
+	uint64_t benchParseFloat(void* pContext, uint64_t iterationCount) {
+		auto* pNumbers{ rcast<NumberContext*>(pContext) };
+
+		double total{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			double value{};
+			pstd::parseFloat(
+				pNumbers->doubleTexts[i & (NUMBER_COUNT - 1)], &value
+			);
+			total += value;
+		}
+		return ncast<uint64_t>(total);
+	}
+
+	uint64_t benchTokenizer(void* pContext, uint64_t iterationCount) {
+		auto* pNumbers{ rcast<NumberContext*>(pContext) };
+
+		double total{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			pstd::Tokenizer tokenizer{
+				pstd::createTokenizer(pNumbers->numberText)
+			};
+			double value{};
+			while (pstd::getNextNumber(&tokenizer, &value)) {
+				total += value;
+			}
+		}
+		return ncast<uint64_t>(total);
+	}
+
+	uint64_t benchFindSubstring(void* pContext, uint64_t iterationCount) {
+		auto* pSearch{ rcast<SearchContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			uint32_t index{};
+			pstd::findSubstring(pSearch->text, pSearch->pattern, &index);
+			res += index;
+		}
+		return res;
+	}
+
+	uint64_t benchFindAnyOf(void* pContext, uint64_t iterationCount) {
+		auto* pSearch{ rcast<SearchContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			uint32_t index{};
+			pstd::findAnyOf(pSearch->text, pSearch->set, &index);
+			res += index;
+		}
+		return res;
+	}
+
+	uint64_t benchCStringLength(void* pContext, uint64_t iterationCount) {
+		auto* pSearch{ rcast<SearchContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			res += pstd::calcCStringLength(pSearch->text.buffer);
+		}
+		return res;
+	}
+
+	uint64_t benchValidateUtf8(void* pContext, uint64_t iterationCount) {
+		auto* pUnicode{ rcast<UnicodeContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			res += pstd::validateUtf8(pUnicode->text);
+		}
+		return res;
+	}
+
+	uint64_t benchUtf8ToUtf16(void* pContext, uint64_t iterationCount) {
+		auto* pUnicode{ rcast<UnicodeContext*>(pContext) };
+
+		uint64_t res{};
+		for (uint64_t i{}; i < iterationCount; i++) {
+			uint32_t size{};
+			pstd::convertUtf8ToUtf16(
+				pUnicode->utf16, TEXT_SIZE, pUnicode->text, &size
+			);
+			res += size;
+		}
+		return res;
+	}
+
+	double createRandomDouble(uint64_t* pRandomState) {
+		return ncast<double>(Bench::nextRandom(pRandomState) >> 11) /
+			9007199254740992.0 * 1000000.0;
+	}
+
+	pstd::String createRepeatedText(
+		pstd::Arena* pArena, const pstd::String& piece, uint32_t size
+	) {
+		uint32_t pieceCount{ size / piece.size };
+		auto* buffer{ pstd::alloc<char>(pArena, pieceCount * piece.size) };
+		for (uint32_t i{}; i < pieceCount; i++) {
+			pstd::memCpy(buffer + i * piece.size, piece.buffer, piece.size);
+		}
+
+		return pstd::String{
+			.buffer = buffer,
+			.size = pieceCount * piece.size,
+		};
+	}
+}  // namespace
@@ -198,12 +198,17 @@ namespace pstd {
 			// capacitySize should not equal pArray->commitSize here
 			ASSERT(capacitySize > pArray->commitSize);
 
-			growSize =
-				min(capacitySize - pArray->commitSize, pArray->commitSize);
+			// doubles the commit, an empty array commits what it needs
+			growSize = min(
+				capacitySize - pArray->commitSize,
+				max(pArray->commitSize, countSize - pArray->commitSize)
+			);
 		}
 
 		if (growSize > 0) {
-			void* pCommitHead{ pArray->data + pArray->commitSize };
+			// commitSize is in bytes, not elements
+			void* pCommitHead{ rcast<uint8_t*>(pArray->data) +
+							   pArray->commitSize };
 
 			heapCommit(pCommitHead, growSize);
 			pArray->commitSize += growSize;
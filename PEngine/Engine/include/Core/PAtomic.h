@@ -0,0 +1,106 @@
+#pragma once
+#include "PTypes.h"
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+// the few atomic operations the engine needs. loads acquire and stores
+// release, which x64 gives plain moves, so those only have to keep the
+// compiler from reordering around them. the read modify writes are lock
+// prefixed and sequentially consistent
+
+namespace pstd {
+	template<typename T>
+	T atomicLoad(const T* pVal) {
+		static_assert(sizeof(T) <= sizeof(uint64_t));
+#if defined(_MSC_VER)
+		T val{ *rcast<const volatile T*>(pVal) };
+		_ReadWriteBarrier();
+		return val;
+#else
+		return __atomic_load_n(pVal, __ATOMIC_ACQUIRE);
+#endif
+	}
+
+	template<typename T>
+	void atomicStore(T* pVal, T val) {
+		static_assert(sizeof(T) <= sizeof(uint64_t));
+#if defined(_MSC_VER)
+		_ReadWriteBarrier();
+		*rcast<volatile T*>(pVal) = val;
+#else
+		__atomic_store_n(pVal, val, __ATOMIC_RELEASE);
+#endif
+	}
+
+	// the value before the add
+	inline uint64_t atomicAdd(uint64_t* pVal, uint64_t val) {
+#if defined(_MSC_VER)
+		return ncast<uint64_t>(_InterlockedExchangeAdd64(
+			rcast<volatile long long*>(pVal), ncast<long long>(val)
+		));
+#else
+		return __atomic_fetch_add(pVal, val, __ATOMIC_SEQ_CST);
+#endif
+	}
+
+	inline uint32_t atomicAdd(uint32_t* pVal, uint32_t val) {
+#if defined(_MSC_VER)
+		return ncast<uint32_t>(_InterlockedExchangeAdd(
+			rcast<volatile long*>(pVal), ncast<long>(val)
+		));
+#else
+		return __atomic_fetch_add(pVal, val, __ATOMIC_SEQ_CST);
+#endif
+	}
+
+	// true when *pVal was expected and is now desired, otherwise expected
+	// gets what *pVal was
+	inline bool atomicCompareExchange(
+		uint64_t* pVal, uint64_t* pExpected, uint64_t desired
+	) {
+#if defined(_MSC_VER)
+		auto expected{ ncast<long long>(*pExpected) };
+		auto prev{ _InterlockedCompareExchange64(
+			rcast<volatile long long*>(pVal),
+			ncast<long long>(desired),
+			expected
+		) };
+		if (prev == expected) {
+			return true;
+		}
+		*pExpected = ncast<uint64_t>(prev);
+		return false;
+#else
+		return __atomic_compare_exchange_n(
+			pVal, pExpected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST
+		);
+#endif
+	}
+
+	inline uint32_t atomicExchange(uint32_t* pVal, uint32_t val) {
+#if defined(_MSC_VER)
+		return ncast<uint32_t>(
+			_InterlockedExchange(rcast<volatile long*>(pVal), ncast<long>(val))
+		);
+#else
+		return __atomic_exchange_n(pVal, val, __ATOMIC_SEQ_CST);
+#endif
+	}
+
+	// stores before it become visible before any store after it. x64 keeps
+	// stores in order, so only the compiler has to be stopped
+	inline void releaseFence() {
+#if defined(_MSC_VER)
+		_ReadWriteBarrier();
+#else
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+#endif
+	}
+
+	// spin wait hint
+	inline void cpuPause() {
+		_mm_pause();
+	}
+}  // namespace pstd
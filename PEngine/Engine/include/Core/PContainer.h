@@ -1,6 +1,7 @@
 #pragma once
 #include "PAssert.h"
 #include "PArena.h"
+#include "PIntrinsics.h"
 
 namespace pstd {
 
@@ -13,21 +14,70 @@ namespace pstd {
 		arg.data;
 	};
 
+	template<typename F, typename T>
+	concept MatchFunction = requires(F function, const T& element) {
+		static_cast<bool>(function(element));
+	};
+
+	template<ArithmeticType T>
+	constexpr auto getSumIdentity() {
+		if constexpr (DecimalType<T>) {
+			return T{};
+		} else if constexpr (getIsUnsigned<T>()) {
+			return uint64_t{};
+		} else {
+			return int64_t{};
+		}
+	}
+
+	// integers are summed in 64 bits, floats in their own width
+	template<ArithmeticType T>
+	using SumType = decltype(getSumIdentity<T>());
+
+	// sse2 kernels over raw spans, defined in Container.cpp for every
+	// ArithmeticType. floating point sums are reassociated across lanes, so
+	// they may differ from a sequential sum in the last bits
+	template<ArithmeticType T>
+	bool find(
+		const T* data, size_t count, const T val, size_t* outIndex = nullptr
+	);
+
+	template<ArithmeticType T>
+	size_t count(const T* data, size_t count, const T val);
+
+	template<ArithmeticType T>
+	T calcMin(const T* data, size_t count);
+
+	template<ArithmeticType T>
+	T calcMax(const T* data, size_t count);
+
+	template<ArithmeticType T>
+	SumType<T> calcSum(const T* data, size_t count);
+
 	template<ContiguousContainer T>
-	bool find(const T& container, const T& val, size_t* outIndex = nullptr) {
-		for (size_t i{}; i < container.data; i++) {
-			if (container[i] == val) {
-				if (outIndex) {
-					*outIndex = i;
+	bool find(
+		const T& container,
+		const typename T::ElementType& val,
+		size_t* outIndex = nullptr
+	) {
+		if constexpr (ArithmeticType<typename T::ElementType>) {
+			return find(container.data, container.count, val, outIndex);
+		} else {
+			for (size_t i{}; i < container.count; i++) {
+				if (container.data[i] == val) {
+					if (outIndex) {
+						*outIndex = i;
+					}
+					return true;
 				}
-				return true;
 			}
-		}
 
-		return false;
+			return false;
+		}
 	}
 
 	template<ContiguousContainer T, typename Callable>
+		requires MatchFunction<Callable, typename T::ElementType>
 	bool find(
 		const T& container, Callable matchFunction, size_t* outIndex = nullptr
 	) {
@@ -44,4 +94,167 @@ namespace pstd {
 		return false;
 	}
 
+	template<ContiguousContainer T>
+	size_t count(const T& container, const typename T::ElementType& val) {
+		if constexpr (ArithmeticType<typename T::ElementType>) {
+			return count(container.data, container.count, val);
+		} else {
+			size_t res{};
+			for (size_t i{}; i < container.count; i++) {
+				res += container.data[i] == val;
+			}
+			return res;
+		}
+	}
+
+	template<ContiguousContainer T>
+		requires ArithmeticType<typename T::ElementType>
+	typename T::ElementType calcMin(const T& container) {
+		ASSERT(container.count > 0);
+		return calcMin(container.data, container.count);
+	}
+
+	template<ContiguousContainer T>
+		requires ArithmeticType<typename T::ElementType>
+	typename T::ElementType calcMax(const T& container) {
+		ASSERT(container.count > 0);
+		return calcMax(container.data, container.count);
+	}
+
+	template<ContiguousContainer T>
+		requires ArithmeticType<typename T::ElementType>
+	SumType<typename T::ElementType> calcSum(const T& container) {
+		return calcSum(container.data, container.count);
+	}
+
+	// container must be sorted by operator<. returns the index of the first
+	// element that is not less than val, or count if there is none.
+	// branchless, so the loop only stalls on the loads themselves
+	template<ContiguousContainer T>
+	size_t lowerBound(const T& container, const typename T::ElementType& val) {
+		const typename T::ElementType* first{ container.data };
+		const typename T::ElementType* base{ first };
+		size_t length{ container.count };
+		if (length == 0) {
+			return 0;
+		}
+
+		while (length > 1) {
+			size_t half{ length / 2 };
+			base = (base[half] < val) ? base + half : base;
+			length -= half;
+		}
+
+		return ncast<size_t>(base - first) + (*base < val);
+	}
+
+	// container must be sorted by operator<. returns the index of the first
+	// element that is greater than val, or count if there is none
+	template<ContiguousContainer T>
+	size_t upperBound(const T& container, const typename T::ElementType& val) {
+		const typename T::ElementType* first{ container.data };
+		const typename T::ElementType* base{ first };
+		size_t length{ container.count };
+		if (length == 0) {
+			return 0;
+		}
+
+		while (length > 1) {
+			size_t half{ length / 2 };
+			base = (val < base[half]) ? base : base + half;
+			length -= half;
+		}
+
+		return ncast<size_t>(base - first) + !(val < *base);
+	}
+
+	// sorted values stored in breadth first (eytzinger) order, so the first
+	// levels of every search share cache lines and the next levels can be
+	// prefetched. block is 1 indexed, block[0] is unused
+	template<typename T>
+	struct EytzingerArray {
+		T* block;
+		size_t count;
+	};
+
+	template<ContiguousContainer T>
+	EytzingerArray<typename T::ElementType>
+		createEytzingerArray(Arena* pArena, const T& sorted) {
+		ASSERT(pArena);
+
+		using ElementType = typename T::ElementType;
+
+		size_t count{ sorted.count };
+		ElementType* block{ pstd::alloc<ElementType>(pArena, count + 1) };
+
+		if (count == 0) {
+			return EytzingerArray<ElementType>{ .block = block, .count = 0 };
+		}
+
+		// in order walk of the implicit tree, starting at its leftmost node
+		size_t k{ 1 };
+		while (2 * k <= count) {
+			k *= 2;
+		}
+
+		for (size_t i{}; i < count; i++) {
+			block[k] = sorted.data[i];
+
+			if (2 * k + 1 <= count) {
+				k = 2 * k + 1;
+				while (2 * k <= count) {
+					k *= 2;
+				}
+			} else {
+				while (k & 1) {
+					k >>= 1;
+				}
+				k >>= 1;
+			}
+		}
+
+		return EytzingerArray<ElementType>{ .block = block, .count = count };
+	}
+
+	// returns the block index of the first element that is not less than
+	// val, or 0 if there is none
+	template<typename T>
+	size_t lowerBound(const EytzingerArray<T>& array, const T& val) {
+		// one cache line of descendants, 4 levels down
+		constexpr size_t prefetchStride{ 64 / sizeof(T) > 0 ? 64 / sizeof(T)
+															: 1 };
+
+		uintptr_t blockAddress{ rcast<uintptr_t>(array.block) };
+		uint64_t k{ 1 };
+		while (k <= array.count) {
+			pstd::prefetch(
+				rcast<const void*>(blockAddress + k * prefetchStride * sizeof(T))
+			);
+			k = 2 * k + (array.block[k] < val);
+		}
+
+		k >>= countTrailingZeros(~k) + 1;
+		return k;
+	}
+
+	// returns the block index of the first element that is greater than
+	// val, or 0 if there is none
+	template<typename T>
+	size_t upperBound(const EytzingerArray<T>& array, const T& val) {
+		constexpr size_t prefetchStride{ 64 / sizeof(T) > 0 ? 64 / sizeof(T)
+															: 1 };
+
+		uintptr_t blockAddress{ rcast<uintptr_t>(array.block) };
+		uint64_t k{ 1 };
+		while (k <= array.count) {
+			pstd::prefetch(
+				rcast<const void*>(blockAddress + k * prefetchStride * sizeof(T))
+			);
+			k = 2 * k + !(val < array.block[k]);
+		}
+
+		k >>= countTrailingZeros(~k) + 1;
+		return k;
+	}
+
 }  // namespace pstd
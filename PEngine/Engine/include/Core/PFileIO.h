@@ -17,6 +17,7 @@ namespace pstd {
 		COUNT
 	};
 
+	// null when the file can't be opened
 	FileHandle openFile(
 		const char* filepath,
 		const FileAccess& accessFlags,
@@ -43,6 +44,9 @@ namespace pstd {
 
 	// includes the exe name
 	String getEXEPath(Arena* pArena);
+
+	// the exe path first, then every argument as utf-8
+	Array<String> getCommandLineArgs(Arena* pArena);
 	pstd::String makeExeDirectoryPath(pstd::Arena* pPersistArena);
 
 	// returned string is cstring
@@ -51,10 +55,33 @@ namespace pstd {
 	void unloadDll(DllHandle handle);
 	void* findDllFunction(DllHandle handle, const char* functionName);
 
+	// the exe's own module, for looking it up with getModuleSize
+	DllHandle getExeModule();
+
+	// how many bytes of address space a loaded module spans from its handle
+	size_t getModuleSize(DllHandle handle);
+
 	void closeFile(FileHandle handle);
 
 	uint32_t getFileSize(FileHandle handle);
 	size_t getLastFileWriteTime(const char*);
 
 	String readFile(Arena* pArena, FileHandle handle);
+
+	// false when fewer than size bytes were written
+	bool writeFile(FileHandle handle, const void* data, uint32_t size);
+
+	// a file mapped into memory for reading and writing. what is written to
+	// data reaches the file even when the process dies without closing it
+	struct MappedFile {
+		FileHandle file;
+		void* mapping;
+		void* data;
+		size_t size;
+	};
+
+	// creates the file at path, or empties it, size bytes long and maps all
+	// of it. data is null when any of that fails
+	MappedFile createMappedFile(const char* path, size_t size);
+	void closeMappedFile(MappedFile* pMappedFile);
 }  // namespace pstd
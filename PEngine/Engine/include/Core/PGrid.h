@@ -0,0 +1,451 @@
+#pragma once
+#include "PTypes.h"
+#include "PAssert.h"
+#include "PAlgorithm.h"
+#include "PArena.h"
+#include "PMemory.h"
+#include "PIntrinsics.h"
+
+// 2d and 3d grids with a choice of memory layout. every layout here is
+// separable, the offset of a cell is the sum of one offset per axis, so
+// moving along one axis only recomputes that axis' term. tiled and morton
+// grids are padded up to whole tiles or powers of two, padding cells are
+// never touched by the functions in this file.
+//
+// auto grid{ createGrid2D<float, GridLayout::tiled>(&arena, width, height) };
+// grid(x, y) = 1.0f;
+
+namespace pstd {
+	enum class GridLayout : uint32_t {
+		rowMajor,
+		tiled,	// 8x8 tiles in 2d, 4x4x4 bricks in 3d, 64 cells each
+		morton,	 // z-order, axes padded to powers of two
+		COUNT
+	};
+
+	constexpr uint32_t GRID_TILE_SIZE_2D{ 8 };
+	constexpr uint32_t GRID_TILE_SIZE_3D{ 4 };
+	constexpr uint32_t GRID_TILE_CELL_COUNT{ 64 };
+
+	// writes the morton offset of every coordinate in [0, count) along axis.
+	// axisSizes are the padded, power of two, sizes of all axisCount axes.
+	// bits are interleaved round robin while an axis still has bits left, so
+	// mismatched axes don't pad the grid to a square
+	void fillMortonOffsets(
+		uint32_t* offsets,
+		uint32_t count,
+		uint32_t axis,
+		const uint32_t* axisSizes,
+		uint32_t axisCount
+	);
+
+	template<typename T, GridLayout layout = GridLayout::rowMajor>
+	struct Grid2D {
+		using ElementType = T;
+
+		T& operator()(uint32_t x, uint32_t y) {
+			return data[getOffset(x, y)];
+		}
+		const T& operator()(uint32_t x, uint32_t y) const {
+			return data[getOffset(x, y)];
+		}
+
+		size_t getOffsetX(uint32_t x) const {
+			if constexpr (layout == GridLayout::rowMajor) {
+				return x;
+			} else if constexpr (layout == GridLayout::tiled) {
+				return (x / GRID_TILE_SIZE_2D) * GRID_TILE_CELL_COUNT +
+					(x % GRID_TILE_SIZE_2D);
+			} else {
+				return pMortonX[x];
+			}
+		}
+
+		size_t getOffsetY(uint32_t y) const {
+			if constexpr (layout == GridLayout::rowMajor) {
+				return ncast<size_t>(y) * width;
+			} else if constexpr (layout == GridLayout::tiled) {
+				return (y / GRID_TILE_SIZE_2D) * tileRowStride +
+					(y % GRID_TILE_SIZE_2D) * GRID_TILE_SIZE_2D;
+			} else {
+				return pMortonY[y];
+			}
+		}
+
+		size_t getOffset(uint32_t x, uint32_t y) const {
+			ASSERT(x < width);
+			ASSERT(y < height);
+			return getOffsetX(x) + getOffsetY(y);
+		}
+
+		T* data;
+		uint32_t width;
+		uint32_t height;
+		size_t capacity;  // cells allocated, padding included
+		size_t tileRowStride;
+		uint32_t* pMortonX;
+		uint32_t* pMortonY;
+	};
+
+	template<typename T, GridLayout layout = GridLayout::rowMajor>
+	struct Grid3D {
+		using ElementType = T;
+
+		T& operator()(uint32_t x, uint32_t y, uint32_t z) {
+			return data[getOffset(x, y, z)];
+		}
+		const T& operator()(uint32_t x, uint32_t y, uint32_t z) const {
+			return data[getOffset(x, y, z)];
+		}
+
+		size_t getOffsetX(uint32_t x) const {
+			if constexpr (layout == GridLayout::rowMajor) {
+				return x;
+			} else if constexpr (layout == GridLayout::tiled) {
+				return (x / GRID_TILE_SIZE_3D) * GRID_TILE_CELL_COUNT +
+					(x % GRID_TILE_SIZE_3D);
+			} else {
+				return pMortonX[x];
+			}
+		}
+
+		size_t getOffsetY(uint32_t y) const {
+			if constexpr (layout == GridLayout::rowMajor) {
+				return ncast<size_t>(y) * width;
+			} else if constexpr (layout == GridLayout::tiled) {
+				return (y / GRID_TILE_SIZE_3D) * tileRowStride +
+					(y % GRID_TILE_SIZE_3D) * GRID_TILE_SIZE_3D;
+			} else {
+				return pMortonY[y];
+			}
+		}
+
+		size_t getOffsetZ(uint32_t z) const {
+			if constexpr (layout == GridLayout::rowMajor) {
+				return ncast<size_t>(z) * width * height;
+			} else if constexpr (layout == GridLayout::tiled) {
+				return (z / GRID_TILE_SIZE_3D) * tileSliceStride +
+					(z % GRID_TILE_SIZE_3D) * GRID_TILE_SIZE_3D *
+					GRID_TILE_SIZE_3D;
+			} else {
+				return pMortonZ[z];
+			}
+		}
+
+		size_t getOffset(uint32_t x, uint32_t y, uint32_t z) const {
+			ASSERT(x < width);
+			ASSERT(y < height);
+			ASSERT(z < depth);
+			return getOffsetX(x) + getOffsetY(y) + getOffsetZ(z);
+		}
+
+		T* data;
+		uint32_t width;
+		uint32_t height;
+		uint32_t depth;
+		size_t capacity;  // cells allocated, padding included
+		size_t tileRowStride;
+		size_t tileSliceStride;
+		uint32_t* pMortonX;
+		uint32_t* pMortonY;
+		uint32_t* pMortonZ;
+	};
+
+	inline uint32_t roundUpToTile(uint32_t size, uint32_t tileSize) {
+		return (size + tileSize - 1) / tileSize * tileSize;
+	}
+
+	template<typename T, GridLayout layout = GridLayout::rowMajor>
+	Grid2D<T, layout>
+		createGrid2D(Arena* pArena, uint32_t width, uint32_t height) {
+		ASSERT(pArena);
+		ASSERT(width > 0 && height > 0);
+
+		Grid2D<T, layout> res{ .width = width, .height = height };
+		if constexpr (layout == GridLayout::rowMajor) {
+			res.capacity = ncast<size_t>(width) * height;
+		} else if constexpr (layout == GridLayout::tiled) {
+			size_t paddedWidth{ roundUpToTile(width, GRID_TILE_SIZE_2D) };
+			size_t paddedHeight{ roundUpToTile(height, GRID_TILE_SIZE_2D) };
+			res.tileRowStride = paddedWidth * GRID_TILE_SIZE_2D;
+			res.capacity = paddedWidth * paddedHeight;
+		} else {
+			uint32_t axisSizes[2]{
+				ncast<uint32_t>(calcNextPowerOfTwo(width)),
+				ncast<uint32_t>(calcNextPowerOfTwo(height)),
+			};
+			res.capacity = ncast<size_t>(axisSizes[0]) * axisSizes[1];
+			ASSERT(res.capacity <= UINT32_MAX);
+
+			res.pMortonX = alloc<uint32_t>(pArena, width);
+			res.pMortonY = alloc<uint32_t>(pArena, height);
+			fillMortonOffsets(res.pMortonX, width, 0, axisSizes, 2);
+			fillMortonOffsets(res.pMortonY, height, 1, axisSizes, 2);
+		}
+
+		res.data = alloc<T>(pArena, res.capacity);
+		return res;
+	}
+
+	template<typename T, GridLayout layout = GridLayout::rowMajor>
+	Grid3D<T, layout> createGrid3D(
+		Arena* pArena, uint32_t width, uint32_t height, uint32_t depth
+	) {
+		ASSERT(pArena);
+		ASSERT(width > 0 && height > 0 && depth > 0);
+
+		Grid3D<T, layout> res{ .width = width,
+							   .height = height,
+							   .depth = depth };
+		if constexpr (layout == GridLayout::rowMajor) {
+			res.capacity = ncast<size_t>(width) * height * depth;
+		} else if constexpr (layout == GridLayout::tiled) {
+			size_t paddedWidth{ roundUpToTile(width, GRID_TILE_SIZE_3D) };
+			size_t paddedHeight{ roundUpToTile(height, GRID_TILE_SIZE_3D) };
+			size_t paddedDepth{ roundUpToTile(depth, GRID_TILE_SIZE_3D) };
+			res.tileRowStride =
+				paddedWidth * GRID_TILE_SIZE_3D * GRID_TILE_SIZE_3D;
+			res.tileSliceStride =
+				paddedWidth * paddedHeight * GRID_TILE_SIZE_3D;
+			res.capacity = paddedWidth * paddedHeight * paddedDepth;
+		} else {
+			uint32_t axisSizes[3]{
+				ncast<uint32_t>(calcNextPowerOfTwo(width)),
+				ncast<uint32_t>(calcNextPowerOfTwo(height)),
+				ncast<uint32_t>(calcNextPowerOfTwo(depth)),
+			};
+			res.capacity =
+				ncast<size_t>(axisSizes[0]) * axisSizes[1] * axisSizes[2];
+			ASSERT(res.capacity <= UINT32_MAX);
+
+			res.pMortonX = alloc<uint32_t>(pArena, width);
+			res.pMortonY = alloc<uint32_t>(pArena, height);
+			res.pMortonZ = alloc<uint32_t>(pArena, depth);
+			fillMortonOffsets(res.pMortonX, width, 0, axisSizes, 3);
+			fillMortonOffsets(res.pMortonY, height, 1, axisSizes, 3);
+			fillMortonOffsets(res.pMortonZ, depth, 2, axisSizes, 3);
+		}
+
+		res.data = alloc<T>(pArena, res.capacity);
+		return res;
+	}
+
+	// axis offsets of a cell and its neighbors, index 1 is the cell itself.
+	// neighbors past the border are clamped onto the border, so a stencil
+	// reads the edge cell again instead of branching.
+	//
+	// grid.data[n.offsetsX[0] + n.offsetsY[1]] is the cell to the left
+	struct GridNeighborhood2D {
+		size_t offsetsX[3];
+		size_t offsetsY[3];
+	};
+
+	struct GridNeighborhood3D {
+		size_t offsetsX[3];
+		size_t offsetsY[3];
+		size_t offsetsZ[3];
+	};
+
+	template<typename G>
+	void fillNeighborOffsets(
+		size_t* offsets, uint32_t coord, uint32_t size, const G& getAxisOffset
+	) {
+		offsets[0] = getAxisOffset(coord > 0 ? coord - 1 : coord);
+		offsets[1] = getAxisOffset(coord);
+		offsets[2] = getAxisOffset(coord + 1 < size ? coord + 1 : coord);
+	}
+
+	template<typename T, GridLayout layout>
+	GridNeighborhood2D
+		getNeighborhood(const Grid2D<T, layout>& grid, uint32_t x, uint32_t y) {
+		ASSERT(x < grid.width);
+		ASSERT(y < grid.height);
+
+		GridNeighborhood2D res;
+		fillNeighborOffsets(res.offsetsX, x, grid.width, [&](uint32_t c) {
+			return grid.getOffsetX(c);
+		});
+		fillNeighborOffsets(res.offsetsY, y, grid.height, [&](uint32_t c) {
+			return grid.getOffsetY(c);
+		});
+		return res;
+	}
+
+	template<typename T, GridLayout layout>
+	GridNeighborhood3D getNeighborhood(
+		const Grid3D<T, layout>& grid, uint32_t x, uint32_t y, uint32_t z
+	) {
+		ASSERT(x < grid.width);
+		ASSERT(y < grid.height);
+		ASSERT(z < grid.depth);
+
+		GridNeighborhood3D res;
+		fillNeighborOffsets(res.offsetsX, x, grid.width, [&](uint32_t c) {
+			return grid.getOffsetX(c);
+		});
+		fillNeighborOffsets(res.offsetsY, y, grid.height, [&](uint32_t c) {
+			return grid.getOffsetY(c);
+		});
+		fillNeighborOffsets(res.offsetsZ, z, grid.depth, [&](uint32_t c) {
+			return grid.getOffsetZ(c);
+		});
+		return res;
+	}
+
+	// the 8 surrounding cells, cells past the border are skipped.
+	// function(T& cell, int32_t dx, int32_t dy)
+	template<typename T, GridLayout layout, typename F>
+	void forEachNeighbor(
+		Grid2D<T, layout>& grid, uint32_t x, uint32_t y, F function
+	) {
+		GridNeighborhood2D n{ getNeighborhood(grid, x, y) };
+		for (int32_t dy{ -1 }; dy <= 1; dy++) {
+			uint32_t ny{ y + dy };
+			if (ny >= grid.height) {
+				continue;
+			}
+			for (int32_t dx{ -1 }; dx <= 1; dx++) {
+				uint32_t nx{ x + dx };
+				if (nx >= grid.width || (dx == 0 && dy == 0)) {
+					continue;
+				}
+				size_t offset{ n.offsetsX[dx + 1] + n.offsetsY[dy + 1] };
+				function(grid.data[offset], dx, dy);
+			}
+		}
+	}
+
+	// the 26 surrounding cells, cells past the border are skipped.
+	// function(T& cell, int32_t dx, int32_t dy, int32_t dz)
+	template<typename T, GridLayout layout, typename F>
+	void forEachNeighbor(
+		Grid3D<T, layout>& grid, uint32_t x, uint32_t y, uint32_t z, F function
+	) {
+		GridNeighborhood3D n{ getNeighborhood(grid, x, y, z) };
+		for (int32_t dz{ -1 }; dz <= 1; dz++) {
+			uint32_t nz{ z + dz };
+			if (nz >= grid.depth) {
+				continue;
+			}
+			for (int32_t dy{ -1 }; dy <= 1; dy++) {
+				uint32_t ny{ y + dy };
+				if (ny >= grid.height) {
+					continue;
+				}
+				size_t offsetYZ{ n.offsetsY[dy + 1] + n.offsetsZ[dz + 1] };
+				for (int32_t dx{ -1 }; dx <= 1; dx++) {
+					uint32_t nx{ x + dx };
+					if (nx >= grid.width || (dx == 0 && dy == 0 && dz == 0)) {
+						continue;
+					}
+					size_t offset{ n.offsetsX[dx + 1] + offsetYZ };
+					function(grid.data[offset], dx, dy, dz);
+				}
+			}
+		}
+	}
+
+	// visits every cell one 8x8 block at a time, which keeps the working set
+	// small in every layout. function(uint32_t x, uint32_t y, T& cell)
+	template<typename T, GridLayout layout, typename F>
+	void forEachCell(Grid2D<T, layout>& grid, F function) {
+		constexpr uint32_t blockSize{ GRID_TILE_SIZE_2D };
+		for (uint32_t blockY{}; blockY < grid.height; blockY += blockSize) {
+			uint32_t endY{ min(blockY + blockSize, grid.height) };
+			for (uint32_t blockX{}; blockX < grid.width; blockX += blockSize) {
+				uint32_t endX{ min(blockX + blockSize, grid.width) };
+				for (uint32_t y{ blockY }; y < endY; y++) {
+					size_t offsetY{ grid.getOffsetY(y) };
+					for (uint32_t x{ blockX }; x < endX; x++) {
+						function(x, y, grid.data[grid.getOffsetX(x) + offsetY]);
+					}
+				}
+			}
+		}
+	}
+
+	// function(uint32_t x, uint32_t y, uint32_t z, T& cell)
+	template<typename T, GridLayout layout, typename F>
+	void forEachCell(Grid3D<T, layout>& grid, F function) {
+		constexpr uint32_t blockSize{ GRID_TILE_SIZE_3D };
+		for (uint32_t blockZ{}; blockZ < grid.depth; blockZ += blockSize) {
+			uint32_t endZ{ min(blockZ + blockSize, grid.depth) };
+			for (uint32_t blockY{}; blockY < grid.height; blockY += blockSize) {
+				uint32_t endY{ min(blockY + blockSize, grid.height) };
+				for (uint32_t blockX{}; blockX < grid.width; blockX += blockSize) {
+					uint32_t endX{ min(blockX + blockSize, grid.width) };
+					for (uint32_t z{ blockZ }; z < endZ; z++) {
+						size_t offsetZ{ grid.getOffsetZ(z) };
+						for (uint32_t y{ blockY }; y < endY; y++) {
+							size_t offsetYZ{ grid.getOffsetY(y) + offsetZ };
+							for (uint32_t x{ blockX }; x < endX; x++) {
+								function(
+									x, y, z, grid.data[grid.getOffsetX(x) + offsetYZ]
+								);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// both grids must have the same size. a matching layout is one memCpy,
+	// otherwise cells are moved one block at a time
+	template<typename T, GridLayout dstLayout, GridLayout srcLayout>
+	void copyGrid(Grid2D<T, dstLayout>* pDst, const Grid2D<T, srcLayout>& src) {
+		ASSERT(pDst);
+		ASSERT(pDst->width == src.width);
+		ASSERT(pDst->height == src.height);
+
+		if constexpr (dstLayout == srcLayout) {
+			memCpy(pDst->data, src.data, src.capacity * sizeof(T));
+		} else {
+			forEachCell(*pDst, [&](uint32_t x, uint32_t y, T& cell) {
+				cell = src.data[src.getOffsetX(x) + src.getOffsetY(y)];
+			});
+		}
+	}
+
+	template<typename T, GridLayout dstLayout, GridLayout srcLayout>
+	void copyGrid(Grid3D<T, dstLayout>* pDst, const Grid3D<T, srcLayout>& src) {
+		ASSERT(pDst);
+		ASSERT(pDst->width == src.width);
+		ASSERT(pDst->height == src.height);
+		ASSERT(pDst->depth == src.depth);
+
+		if constexpr (dstLayout == srcLayout) {
+			memCpy(pDst->data, src.data, src.capacity * sizeof(T));
+		} else {
+			forEachCell(*pDst, [&](uint32_t x, uint32_t y, uint32_t z, T& cell) {
+				cell = src.data
+					[src.getOffsetX(x) + src.getOffsetY(y) + src.getOffsetZ(z)];
+			});
+		}
+	}
+
+	// row major arrays, e.g. image data, in and out of a grid.
+	// rows are width cells apart
+	template<typename T, GridLayout layout>
+	void copyFromRowMajor(Grid2D<T, layout>* pDst, const T* src) {
+		ASSERT(pDst);
+		ASSERT(src);
+
+		forEachCell(*pDst, [&](uint32_t x, uint32_t y, T& cell) {
+			cell = src[ncast<size_t>(y) * pDst->width + x];
+		});
+	}
+
+	template<typename T, GridLayout layout>
+	void copyToRowMajor(T* dst, const Grid2D<T, layout>& src) {
+		ASSERT(dst);
+
+		for (uint32_t y{}; y < src.height; y++) {
+			size_t offsetY{ src.getOffsetY(y) };
+			T* pRow{ dst + ncast<size_t>(y) * src.width };
+			for (uint32_t x{}; x < src.width; x++) {
+				pRow[x] = src.data[src.getOffsetX(x) + offsetY];
+			}
+		}
+	}
+}  // namespace pstd
@@ -0,0 +1,66 @@
+#pragma once
+#include "PTypes.h"
+#include "PString.h"
+
+// non cryptographic hashing for hash maps and caches, and crc32c for
+// checking data on disk.
+//
+// calcHash64/calcHash128 follow wyhash: 48 byte blocks go through three
+// independent 64x64->128 multiply lanes, inputs up to 16 bytes are two
+// overlapping loads and a single multiply. the high half of the 128 bit
+// hash also keeps two of the block lanes apart instead of folding them
+// into one, its low half is the 64 bit hash of the same input.
+//
+// the streaming HashState gives the same result as the one shot calls for
+// the same bytes, however they were split up
+
+namespace pstd {
+	struct Hash128 {
+		uint64_t low;
+		uint64_t high;
+	};
+
+	constexpr bool operator==(const Hash128& a, const Hash128& b) {
+		return a.low == b.low && a.high == b.high;
+	}
+
+	uint64_t calcHash64(const void* data, size_t size, uint64_t seed = 0);
+
+	Hash128 calcHash128(const void* data, size_t size, uint64_t seed = 0);
+
+	inline uint64_t calcHash64(const String& string, uint64_t seed = 0) {
+		return calcHash64(string.buffer, string.size, seed);
+	}
+
+	inline Hash128 calcHash128(const String& string, uint64_t seed = 0) {
+		return calcHash128(string.buffer, string.size, seed);
+	}
+
+	constexpr size_t HASH_BLOCK_SIZE{ 48 };
+
+	// buffer keeps the last 16 bytes of the consumed blocks in front of the
+	// pending ones, the finish reads back into them like the one shot does
+	struct HashState {
+		uint64_t lanes[3];
+		uint64_t totalSize;
+		uint32_t pendingSize;
+		uint8_t buffer[16 + HASH_BLOCK_SIZE];
+	};
+
+	HashState createHashState(uint64_t seed = 0);
+
+	void updateHash(HashState* pState, const void* data, size_t size);
+
+	inline void updateHash(HashState* pState, const String& string) {
+		updateHash(pState, string.buffer, string.size);
+	}
+
+	uint64_t finishHash64(const HashState& state);
+
+	Hash128 finishHash128(const HashState& state);
+
+	// castagnoli polynomial with the sse4.2 crc32 instruction, a table per
+	// byte position otherwise. pass the previous result as crc to continue
+	// over data that arrives in pieces
+	uint32_t calcCrc32c(const void* data, size_t size, uint32_t crc = 0);
+}  // namespace pstd
@@ -0,0 +1,280 @@
+#pragma once
+#include "PTypes.h"
+#include "PAssert.h"
+#include "PAlgorithm.h"
+#include "PArray.h"
+#include "PContainer.h"
+
+// 4-ary heaps over any contiguous container, Array, DArray or StaticArray.
+// the 4 children of a slot are adjacent, so a sift down level touches one
+// or two cache lines and the tree is half as deep as a binary heap.
+// compare(a, b) is true when a belongs above b, HeapLess makes a min heap.
+//
+// decreaseKey needs the slot of an element. elements with a uint32_t handle
+// member can keep a position index up to date, positions[handle] is always
+// the element's slot, or HEAP_INVALID_POSITION once it has been popped.
+// pass nullptr when the heap doesn't need one.
+
+namespace pstd {
+	constexpr size_t HEAP_ARITY{ 4 };
+	constexpr uint32_t HEAP_INVALID_POSITION{ UINT32_MAX };
+
+	struct HeapLess {
+		template<typename T>
+		constexpr bool operator()(const T& a, const T& b) const {
+			return a < b;
+		}
+	};
+
+	struct HeapGreater {
+		template<typename T>
+		constexpr bool operator()(const T& a, const T& b) const {
+			return b < a;
+		}
+	};
+
+	template<typename T>
+	concept HeapHandle = requires(const T& entry) {
+		ncast<size_t>(entry.handle);
+	};
+
+	// key and handle side by side, comparisons never leave the heap's memory
+	template<typename K>
+	struct HeapEntry {
+		K key;
+		uint32_t handle;
+	};
+
+	template<typename K>
+	constexpr bool operator<(const HeapEntry<K>& a, const HeapEntry<K>& b) {
+		return a.key < b.key;
+	}
+
+	template<typename T>
+	void setHeapPosition(uint32_t* positions, const T& entry, size_t slot) {
+		if constexpr (HeapHandle<T>) {
+			if (positions) {
+				positions[entry.handle] = ncast<uint32_t>(slot);
+			}
+		} else {
+			ASSERT(!positions);
+		}
+	}
+
+	// returns the slot the element came to rest in
+	template<typename T, typename Compare>
+	size_t siftUp(T* data, size_t slot, uint32_t* positions, Compare compare) {
+		ASSERT(data);
+
+		T val{ move(data[slot]) };
+		while (slot > 0) {
+			size_t parent{ (slot - 1) / HEAP_ARITY };
+			if (!compare(val, data[parent])) {
+				break;
+			}
+			data[slot] = move(data[parent]);
+			setHeapPosition(positions, data[slot], slot);
+			slot = parent;
+		}
+		data[slot] = move(val);
+		setHeapPosition(positions, data[slot], slot);
+		return slot;
+	}
+
+	template<typename T, typename Compare>
+	size_t siftDown(
+		T* data, size_t count, size_t slot, uint32_t* positions, Compare compare
+	) {
+		ASSERT(data);
+		ASSERT(slot < count);
+
+		T val{ move(data[slot]) };
+		while (true) {
+			size_t firstChild{ slot * HEAP_ARITY + 1 };
+			if (firstChild >= count) {
+				break;
+			}
+
+			size_t best{ firstChild };
+			if (firstChild + HEAP_ARITY <= count) {
+				// two independent compares, then the winners, a shorter
+				// dependency chain than a linear scan
+				size_t left{ compare(data[firstChild + 1], data[firstChild])
+								 ? firstChild + 1
+								 : firstChild };
+				size_t right{ compare(data[firstChild + 3], data[firstChild + 2])
+								  ? firstChild + 3
+								  : firstChild + 2 };
+				best = compare(data[right], data[left]) ? right : left;
+			} else {
+				for (size_t child{ firstChild + 1 }; child < count; child++) {
+					best = compare(data[child], data[best]) ? child : best;
+				}
+			}
+
+			if (!compare(data[best], val)) {
+				break;
+			}
+			data[slot] = move(data[best]);
+			setHeapPosition(positions, data[slot], slot);
+			slot = best;
+		}
+		data[slot] = move(val);
+		setHeapPosition(positions, data[slot], slot);
+		return slot;
+	}
+
+	// floyd's bottom up construction, O(count)
+	template<typename T, typename Compare = HeapLess>
+	void heapify(
+		T* data,
+		size_t count,
+		uint32_t* positions = nullptr,
+		Compare compare = {}
+	) {
+		ASSERT(data || count == 0);
+
+		if (positions) {
+			for (size_t slot{}; slot < count; slot++) {
+				setHeapPosition(positions, data[slot], slot);
+			}
+		}
+		if (count <= 1) {
+			return;
+		}
+
+		size_t lastParent{ (count - 2) / HEAP_ARITY };
+		for (size_t slot{ lastParent + 1 }; slot > 0; slot--) {
+			siftDown(data, count, slot - 1, positions, compare);
+		}
+	}
+
+	template<ContiguousContainer C, typename Compare = HeapLess>
+	void heapify(
+		C* pHeap, uint32_t* positions = nullptr, Compare compare = {}
+	) {
+		ASSERT(pHeap);
+
+		heapify(pHeap->data, pHeap->count, positions, compare);
+	}
+
+	template<ContiguousContainer C>
+	const typename C::ElementType& getHeapTop(const C& heap) {
+		ASSERT(heap.count > 0);
+
+		return heap.data[0];
+	}
+
+	template<ContiguousContainer C, typename Compare = HeapLess>
+	void heapPush(
+		C* pHeap,
+		const typename C::ElementType& val,
+		uint32_t* positions = nullptr,
+		Compare compare = {}
+	) {
+		ASSERT(pHeap);
+
+		pushBack(pHeap, val);
+		siftUp(pHeap->data, pHeap->count - 1, positions, compare);
+	}
+
+	template<ContiguousContainer C, typename Compare = HeapLess>
+	bool heapPop(
+		C* pHeap,
+		typename C::ElementType* popOut = nullptr,
+		uint32_t* positions = nullptr,
+		Compare compare = {}
+	) {
+		ASSERT(pHeap);
+
+		if (pHeap->count == 0) {
+			return false;
+		}
+
+		if constexpr (HeapHandle<typename C::ElementType>) {
+			if (positions) {
+				positions[pHeap->data[0].handle] = HEAP_INVALID_POSITION;
+			}
+		}
+		if (popOut) {
+			*popOut = move(pHeap->data[0]);
+		}
+
+		pHeap->count--;
+		if (pHeap->count > 0) {
+			pHeap->data[0] = move(pHeap->data[pHeap->count]);
+			siftDown(pHeap->data, pHeap->count, 0, positions, compare);
+		}
+
+		return true;
+	}
+
+	// val must not belong further down than the element it replaces
+	template<ContiguousContainer C, typename Compare = HeapLess>
+	size_t decreaseKey(
+		C* pHeap,
+		size_t slot,
+		const typename C::ElementType& val,
+		uint32_t* positions = nullptr,
+		Compare compare = {}
+	) {
+		ASSERT(pHeap);
+		ASSERT(slot < pHeap->count);
+		ASSERT(!compare(pHeap->data[slot], val));
+
+		pHeap->data[slot] = val;
+		return siftUp(pHeap->data, slot, positions, compare);
+	}
+
+	// replaces the element at slot, sifting whichever way it has to go
+	template<ContiguousContainer C, typename Compare = HeapLess>
+	size_t updateKey(
+		C* pHeap,
+		size_t slot,
+		const typename C::ElementType& val,
+		uint32_t* positions = nullptr,
+		Compare compare = {}
+	) {
+		ASSERT(pHeap);
+		ASSERT(slot < pHeap->count);
+
+		bool isRising{ compare(val, pHeap->data[slot]) };
+		pHeap->data[slot] = val;
+		if (isRising) {
+			return siftUp(pHeap->data, slot, positions, compare);
+		}
+		return siftDown(pHeap->data, pHeap->count, slot, positions, compare);
+	}
+
+	// e.g. a cancelled timer, slot comes from the position index
+	template<ContiguousContainer C, typename Compare = HeapLess>
+	void heapRemove(
+		C* pHeap,
+		size_t slot,
+		uint32_t* positions = nullptr,
+		Compare compare = {}
+	) {
+		ASSERT(pHeap);
+		ASSERT(slot < pHeap->count);
+
+		if constexpr (HeapHandle<typename C::ElementType>) {
+			if (positions) {
+				positions[pHeap->data[slot].handle] = HEAP_INVALID_POSITION;
+			}
+		}
+
+		pHeap->count--;
+		if (slot == pHeap->count) {
+			return;
+		}
+
+		typename C::ElementType last{ move(pHeap->data[pHeap->count]) };
+		bool isRising{ compare(last, pHeap->data[slot]) };
+		pHeap->data[slot] = move(last);
+		if (isRising) {
+			siftUp(pHeap->data, slot, positions, compare);
+		} else {
+			siftDown(pHeap->data, pHeap->count, slot, positions, compare);
+		}
+	}
+}  // namespace pstd
@@ -0,0 +1,50 @@
+#pragma once
+#include "PTypes.h"
+
+// an HDR style histogram of uint64 values. values below
+// HISTOGRAM_SUB_BUCKET_COUNT have a bucket each, above that each power of
+// two is split into HISTOGRAM_SUB_BUCKET_COUNT buckets, so a value is kept
+// to within 1/64 of itself at any size. values past HISTOGRAM_MAX_VALUE
+// are counted as it, with nanoseconds that's about 18 minutes.
+//
+// octaveCounts adds up each power of two's buckets, so a percentile looks
+// at no more than a hundred counts instead of every bucket
+
+namespace pstd {
+	constexpr uint32_t HISTOGRAM_SUB_BUCKET_BITS{ 6 };
+	constexpr uint32_t HISTOGRAM_SUB_BUCKET_COUNT{
+		1u << HISTOGRAM_SUB_BUCKET_BITS
+	};
+	constexpr uint32_t HISTOGRAM_VALUE_BITS{ 40 };
+	constexpr uint64_t HISTOGRAM_MAX_VALUE{ (1ull << HISTOGRAM_VALUE_BITS) -
+											1 };
+	constexpr uint32_t HISTOGRAM_OCTAVE_COUNT{ HISTOGRAM_VALUE_BITS -
+											   HISTOGRAM_SUB_BUCKET_BITS + 1 };
+	constexpr uint32_t HISTOGRAM_BUCKET_COUNT{ HISTOGRAM_OCTAVE_COUNT *
+											   HISTOGRAM_SUB_BUCKET_COUNT };
+
+	// zero initialized is empty. about 18KB, so it goes in an arena rather
+	// than on the stack
+	struct Histogram {
+		uint64_t totalCount;
+		uint64_t totalValue;
+		uint64_t octaveCounts[HISTOGRAM_OCTAVE_COUNT];
+		uint64_t counts[HISTOGRAM_BUCKET_COUNT];
+	};
+
+	void addValue(Histogram* pHistogram, uint64_t value);
+
+	// value must have been added and not removed since
+	void removeValue(Histogram* pHistogram, uint64_t value);
+
+	// adds every value in src to pDst
+	void mergeHistogram(Histogram* pDst, const Histogram& src);
+
+	// percentile is from 0 to 100. the result is the largest value that
+	// shares a bucket with the one at the percentile, which for 100 is the
+	// max. 0 when the histogram is empty
+	uint64_t calcPercentile(const Histogram& histogram, double percentile);
+
+	// exact, the values aren't bucketed for it. 0 when empty
+	uint64_t calcMean(const Histogram& histogram);
+}  // namespace pstd
@@ -0,0 +1,113 @@
+#pragma once
+#include "PTypes.h"
+#include "PAssert.h"
+#include "PArena.h"
+#include "PMemory.h"
+#include "PString.h"
+#include "PThread.h"
+
+// maps strings to stable 32 bit ids, once interned two strings are equal
+// exactly when their ids are. the text is copied into the interner's own
+// arena and null terminated, so getInternedString(id).buffer can go
+// straight to apis that want a c string.
+//
+// hashes of literals are computed at compile time with hashLiteral, the
+// lookup then only probes and compares
+
+namespace pstd {
+	enum class StringId : uint32_t { invalid = 0 };
+
+	// 64 bit fnv-1a, constexpr so it runs the same at compile time
+	constexpr uint64_t calcStringHash(const String& string) {
+		uint64_t hash{ 0xCBF29CE484222325ull };
+		for (uint32_t i{}; i < string.size; i++) {
+			hash ^= ncast<uint8_t>(string.buffer[i]);
+			hash *= 0x100000001B3ull;
+		}
+		return hash;
+	}
+
+	struct HashedString {
+		String string;
+		uint64_t hash;
+	};
+
+	constexpr HashedString createHashedString(const String& string) {
+		return HashedString{ .string = string, .hash = calcStringHash(string) };
+	}
+
+	consteval HashedString hashLiteral(const char* literal) {
+		return createHashedString(createString(literal));
+	}
+
+	// slots hold the high half of the hash next to the id, a probe only
+	// touches the string when the hashes agree. the table never grows,
+	// so ids and the strings they name stay put
+	struct StringInterner {
+		Arena textArena;
+		String* strings;
+		uint64_t* slots;
+		uint32_t slotMask;
+		uint32_t count;
+		uint32_t maxCount;
+		Mutex mutex;
+	};
+
+	StringInterner createStringInterner(
+		AllocationRegistry* pAllocRegistry, size_t textSize, uint32_t maxCount
+	);
+
+	void destroyStringInterner(
+		AllocationRegistry* pAllocRegistry, StringInterner* pInterner
+	);
+
+	// thread safe, lookups of strings already in the table only share a lock.
+	// StringId::invalid when the string is new and the table or its text
+	// is full
+	StringId
+		internString(StringInterner* pInterner, const HashedString& string);
+
+	inline StringId
+		internString(StringInterner* pInterner, const String& string) {
+		return internString(pInterner, createHashedString(string));
+	}
+
+	// like internString but never adds, StringId::invalid when not found
+	StringId
+		findStringId(StringInterner* pInterner, const HashedString& string);
+
+	inline String
+		getInternedString(const StringInterner& interner, StringId id) {
+		ASSERT(id != StringId::invalid);
+		ASSERT(ncast<uint32_t>(id) <= interner.count);
+
+		return interner.strings[ncast<uint32_t>(id) - 1];
+	}
+
+	// the engine wide interner, started once before any thread uses it
+	void startupStringInterner(
+		AllocationRegistry* pAllocRegistry,
+		size_t textSize = 1024 * 1024,
+		uint32_t maxCount = 16 * 1024
+	);
+
+	void shutdownStringInterner(AllocationRegistry* pAllocRegistry);
+
+	StringInterner* getStringInterner();
+
+	inline StringId internString(const HashedString& string) {
+		return internString(getStringInterner(), string);
+	}
+
+	inline StringId internString(const String& string) {
+		return internString(getStringInterner(), createHashedString(string));
+	}
+
+	inline StringId findStringId(const HashedString& string) {
+		return findStringId(getStringInterner(), string);
+	}
+
+	inline String getInternedString(StringId id) {
+		return getInternedString(*getStringInterner(), id);
+	}
+}  // namespace pstd
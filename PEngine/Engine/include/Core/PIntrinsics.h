@@ -0,0 +1,149 @@
+#pragma once
+#include "PTypes.h"
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#else
+	#include <x86intrin.h>
+#endif
+
+namespace pstd {
+
+	// only the features a kernel dispatches on. none of them needs the os
+	// to save extra registers, an avx one would also have to check xgetbv
+	struct CpuFeatures {
+		bool ssse3;
+		bool sse42;
+		bool popcnt;
+	};
+
+	// queried with cpuid once, then cached
+	const CpuFeatures& getCpuFeatures();
+
+	// mask must not be zero
+	inline uint32_t countTrailingZeros(uint64_t mask) {
+		ASSERT(mask != 0);
+#if defined(_MSC_VER)
+		unsigned long index{};
+		_BitScanForward64(&index, mask);
+		return index;
+#else
+		return __builtin_ctzll(mask);
+#endif
+	}
+
+	// mask must not be zero
+	inline uint32_t countLeadingZeros(uint64_t mask) {
+		ASSERT(mask != 0);
+#if defined(_MSC_VER)
+		unsigned long index{};
+		_BitScanReverse64(&index, mask);
+		return 63 - index;
+#else
+		return __builtin_clzll(mask);
+#endif
+	}
+
+	// swar popcount, the popcnt instruction is not part of the x64 baseline
+	constexpr uint32_t popCount(uint64_t mask) {
+		mask = mask - ((mask >> 1) & 0x5555555555555555ull);
+		mask = (mask & 0x3333333333333333ull) +
+			((mask >> 2) & 0x3333333333333333ull);
+		mask = (mask + (mask >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+		return ncast<uint32_t>((mask * 0x0101010101010101ull) >> 56);
+	}
+
+	// the popcnt instruction, only when getCpuFeatures().popcnt is set
+	inline uint32_t popCountInstruction(uint64_t mask) {
+#if defined(_MSC_VER)
+		return ncast<uint32_t>(__popcnt64(mask));
+#else
+		return ncast<uint32_t>(__builtin_popcountll(mask));
+#endif
+	}
+
+	// 0 and 1 both round up to 1
+	inline uint64_t calcNextPowerOfTwo(uint64_t val) {
+		if (val <= 1) {
+			return 1;
+		}
+		return 1ull << (64 - countLeadingZeros(val - 1));
+	}
+
+	inline uint32_t calcLog2(uint64_t powerOfTwo) {
+		return countTrailingZeros(powerOfTwo);
+	}
+
+	// full 128 bit product, returns the low half
+	inline uint64_t multiply128(uint64_t a, uint64_t b, uint64_t* outHigh) {
+		ASSERT(outHigh);
+#if defined(_MSC_VER)
+		return _umul128(a, b, outHigh);
+#else
+		unsigned __int128 product{ ncast<unsigned __int128>(a) * b };
+		*outHigh = ncast<uint64_t>(product >> 64);
+		return ncast<uint64_t>(product);
+#endif
+	}
+
+	// shift must be in (0, 64)
+	constexpr uint64_t
+		shiftRight128(uint64_t low, uint64_t high, uint32_t shift) {
+		return (high << (64 - shift)) | (low >> shift);
+	}
+
+	constexpr uint64_t rotateLeft(uint64_t val, uint32_t shift) {
+		shift &= 63;
+		return (val << shift) | (val >> ((64 - shift) & 63));
+	}
+
+	// unaligned loads that stay inline, memcpy is a real call without the
+	// crt intrinsics
+	inline uint64_t loadUInt64(const void* src) {
+#if defined(_MSC_VER)
+		return *rcast<const __unaligned uint64_t*>(src);
+#else
+		uint64_t val;
+		__builtin_memcpy(&val, src, sizeof(val));
+		return val;
+#endif
+	}
+
+	inline uint32_t loadUInt32(const void* src) {
+#if defined(_MSC_VER)
+		return *rcast<const __unaligned uint32_t*>(src);
+#else
+		uint32_t val;
+		__builtin_memcpy(&val, src, sizeof(val));
+		return val;
+#endif
+	}
+
+	inline void storeUInt64(void* dst, uint64_t val) {
+#if defined(_MSC_VER)
+		*rcast<__unaligned uint64_t*>(dst) = val;
+#else
+		__builtin_memcpy(dst, &val, sizeof(val));
+#endif
+	}
+
+	inline void storeUInt32(void* dst, uint32_t val) {
+#if defined(_MSC_VER)
+		*rcast<__unaligned uint32_t*>(dst) = val;
+#else
+		__builtin_memcpy(dst, &val, sizeof(val));
+#endif
+	}
+
+	// the time stamp counter, constant rate on every x64 cpu we run on but
+	// the rate itself is unknown, PTime's clock gives it a unit
+	inline uint64_t readCycleCounter() {
+		return __rdtsc();
+	}
+
+	// never faults, so it is safe to prefetch past the end of a block
+	inline void prefetch(const void* address) {
+		_mm_prefetch(rcast<const char*>(address), _MM_HINT_T0);
+	}
+
+}  // namespace pstd
@@ -49,6 +49,16 @@ namespace pstd {
 
 	AllocationLimits getSystemAllocationLimits();
 
+	// the whole process's, in bytes. the peaks are since it started
+	struct MemoryUsage {
+		size_t committedSize;
+		size_t peakCommittedSize;
+		size_t residentSize;
+		size_t peakResidentSize;
+	};
+
+	MemoryUsage getProcessMemoryUsage();
+
 	size_t roundUpToPageBoundary(size_t size);
 	size_t roundDownToPageBoundary(size_t size);
 
@@ -0,0 +1,94 @@
+#pragma once
+#include "PTypes.h"
+#include "PString.h"
+
+// locale free number parsing and a zero copy tokenizer for text assets.
+//
+// the parsers read one number from the start of text, whitespace is not
+// skipped. on success the value and the number of chars read are written
+// out, otherwise, no digits or an integer out of range, nothing is written
+// and false is returned
+
+namespace pstd {
+	bool parseUInt(
+		const String& text, uint64_t* pOut, uint32_t* outSize = nullptr
+	);
+
+	bool parseInt(
+		const String& text, int64_t* pOut, uint32_t* outSize = nullptr
+	);
+
+	// decimal or scientific notation, inf, infinity or nan, in any case.
+	// correctly rounded with ties to even, values past the range of the
+	// type become infinity or zero like any other rounding
+	bool parseFloat(
+		const String& text, double* pOut, uint32_t* outSize = nullptr
+	);
+
+	bool parseFloat(
+		const String& text, float* pOut, uint32_t* outSize = nullptr
+	);
+
+	// tokens are slices of text, nothing is copied, so text has to outlive
+	// them. every char at or below ' ' separates tokens
+	struct Tokenizer {
+		String text;
+		uint32_t offset;
+	};
+
+	inline Tokenizer createTokenizer(const String& text) {
+		return Tokenizer{ .text = text, .offset = 0 };
+	}
+
+	inline bool isAtEnd(const Tokenizer& tokenizer) {
+		return tokenizer.offset >= tokenizer.text.size;
+	}
+
+	inline String getRemaining(const Tokenizer& tokenizer) {
+		return String{ .buffer = tokenizer.text.buffer + tokenizer.offset,
+					   .size = tokenizer.text.size - tokenizer.offset };
+	}
+
+	void skipSeparators(Tokenizer* pTokenizer);
+
+	bool getNextToken(Tokenizer* pTokenizer, String* outToken);
+
+	// the line without its \n or \r\n, the tokenizer moves past the ending
+	bool getNextLine(Tokenizer* pTokenizer, String* outLine);
+
+	// skips separators and reads a number, the number doesn't have to fill
+	// the whole token, "1/2/3" reads as 1 and leaves "/2/3". the tokenizer
+	// only moves when a number was read
+	template<typename T>
+	bool getNextNumber(Tokenizer* pTokenizer, T* pOut) {
+		ASSERT(pTokenizer);
+
+		skipSeparators(pTokenizer);
+
+		uint32_t size{};
+		bool isParsed{};
+		String remaining{ getRemaining(*pTokenizer) };
+		if constexpr (isSameType<T, float> || isSameType<T, double>) {
+			isParsed = parseFloat(remaining, pOut, &size);
+		} else if constexpr (getIsUnsigned<T>()) {
+			uint64_t val{};
+			isParsed = parseUInt(remaining, &val, &size) &&
+				!getIsNarrowing<T>(val);
+			if (isParsed) {
+				*pOut = ncast<T>(val);
+			}
+		} else {
+			int64_t val{};
+			isParsed = parseInt(remaining, &val, &size) &&
+				!getIsNarrowing<T>(val);
+			if (isParsed) {
+				*pOut = ncast<T>(val);
+			}
+		}
+
+		if (isParsed) {
+			pTokenizer->offset += size;
+		}
+		return isParsed;
+	}
+}  // namespace pstd
@@ -0,0 +1,192 @@
+#pragma once
+#include "PTypes.h"
+#include "PAssert.h"
+#include "PAlgorithm.h"
+#include "PArena.h"
+#include "PArray.h"
+#include "PMemory.h"
+#include "PThread.h"
+
+namespace pstd {
+	// sse2 kernels over raw spans, defined in Scan.cpp for every
+	// ArithmeticType. dst may be src. carry is added to every output and the
+	// running total is returned, so spans can be scanned piece by piece.
+	// floating point scans are reassociated within a register
+	template<ArithmeticType T>
+	T inclusiveScan(T* dst, const T* src, size_t count, T carry = {});
+
+	template<ArithmeticType T>
+	T exclusiveScan(T* dst, const T* src, size_t count, T carry = {});
+
+	// blocked scans, every task scans its own block, then the block totals
+	// are propagated in a second parallel pass
+	template<ArithmeticType T>
+	void inclusiveScanParallel(
+		T* dst, const T* src, size_t count, uint32_t taskCount
+	);
+
+	template<ArithmeticType T>
+	void exclusiveScanParallel(
+		T* dst, const T* src, size_t count, uint32_t taskCount
+	);
+
+	// packs the elements of src whose bit is set in keepMask into dst, in
+	// order. src holds elementCount (at most 64) elements of elementSize
+	// bytes. whole registers are stored, so dst must have room for
+	// elementCount elements. returns the number of elements written
+	size_t compactByMask(
+		void* dst,
+		const void* src,
+		uint64_t keepMask,
+		uint32_t elementCount,
+		uint32_t elementSize
+	);
+
+	// below this many elements per task a thread costs more than it saves
+	constexpr size_t MIN_PARALLEL_BLOCK_SIZE{ 64 * KIB };
+
+	inline uint32_t calcParallelTaskCount(size_t count, uint32_t taskCount) {
+		size_t maxTasks{ count / MIN_PARALLEL_BLOCK_SIZE };
+		size_t res{ min(ncast<size_t>(taskCount), maxTasks) };
+		res = min(res, ncast<size_t>(MAX_PARALLEL_TASKS));
+		return res > 0 ? ncast<uint32_t>(res) : 1;
+	}
+
+	// elements are copied bitwise, predicate is evaluated once per element.
+	// dst may be src
+	template<typename T, typename Predicate>
+	size_t compactIf(T* dst, const T* src, size_t count, Predicate predicate) {
+		size_t written{};
+		for (size_t i{}; i < count; i += 64) {
+			uint32_t chunkCount{ ncast<uint32_t>(min(count - i, 64ull)) };
+
+			uint64_t keepMask{};
+			for (uint32_t j{}; j < chunkCount; j++) {
+				bool isKept{ static_cast<bool>(predicate(src[i + j])) };
+				keepMask |= ncast<uint64_t>(isKept) << j;
+			}
+
+			if constexpr (sizeof(T) == 4 || sizeof(T) == 8) {
+				written += compactByMask(
+					dst + written, src + i, keepMask, chunkCount, sizeof(T)
+				);
+			} else {
+				// branchless, rejected elements are overwritten by the next
+				for (uint32_t j{}; j < chunkCount; j++) {
+					dst[written] = src[i + j];
+					written += (keepMask >> j) & 1;
+				}
+			}
+		}
+
+		return written;
+	}
+
+	template<ArithmeticType T, typename I>
+	Array<T, I> inclusiveScan(Arena* pArena, const Array<T, I>& src) {
+		if (src.count == 0) {
+			return {};
+		}
+
+		auto res{ createArray<T, I>(pArena, src.count) };
+		inclusiveScan(res.data, src.data, src.count);
+		return res;
+	}
+
+	template<ArithmeticType T, typename I>
+	Array<T, I> exclusiveScan(Arena* pArena, const Array<T, I>& src) {
+		if (src.count == 0) {
+			return {};
+		}
+
+		auto res{ createArray<T, I>(pArena, src.count) };
+		exclusiveScan(res.data, src.data, src.count);
+		return res;
+	}
+
+	template<ArithmeticType T, typename I>
+	Array<T, I> inclusiveScanParallel(
+		Arena* pArena,
+		const Array<T, I>& src,
+		uint32_t taskCount = getLogicalCoreCount()
+	) {
+		if (src.count == 0) {
+			return {};
+		}
+
+		auto res{ createArray<T, I>(pArena, src.count) };
+		inclusiveScanParallel(res.data, src.data, src.count, taskCount);
+		return res;
+	}
+
+	template<ArithmeticType T, typename I>
+	Array<T, I> exclusiveScanParallel(
+		Arena* pArena,
+		const Array<T, I>& src,
+		uint32_t taskCount = getLogicalCoreCount()
+	) {
+		if (src.count == 0) {
+			return {};
+		}
+
+		auto res{ createArray<T, I>(pArena, src.count) };
+		exclusiveScanParallel(res.data, src.data, src.count, taskCount);
+		return res;
+	}
+
+	// the returned array keeps src.count as its capacity
+	template<typename T, typename I, typename Predicate>
+	Array<T, I>
+		compactIf(Arena* pArena, const Array<T, I>& src, Predicate predicate) {
+		if (src.count == 0) {
+			return {};
+		}
+
+		auto res{ createArray<T, I>(pArena, src.count, 0) };
+		res.count = compactIf(res.data, src.data, src.count, predicate);
+		return res;
+	}
+
+	template<typename T, typename I, typename Predicate>
+	Array<T, I> compactIfParallel(
+		Arena* pArena,
+		const Array<T, I>& src,
+		Predicate predicate,
+		uint32_t taskCount = getLogicalCoreCount()
+	) {
+		if (src.count == 0) {
+			return {};
+		}
+
+		auto res{ createArray<T, I>(pArena, src.count, 0) };
+
+		taskCount = calcParallelTaskCount(src.count, taskCount);
+		size_t blockSize{ (src.count + taskCount - 1) / taskCount };
+
+		// every task packs its block in place, at the block's own offset,
+		// so the whole register stores never cross into another block
+		size_t keptCounts[MAX_PARALLEL_TASKS]{};
+		runParallel(taskCount, [&](uint32_t taskIndex) {
+			size_t begin{ min(taskIndex * blockSize, src.count) };
+			size_t end{ min(begin + blockSize, src.count) };
+			keptCounts[taskIndex] = compactIf(
+				res.data + begin, src.data + begin, end - begin, predicate
+			);
+		});
+
+		// blocks only ever move down, and in order, so each move can only
+		// overlap itself
+		size_t written{ keptCounts[0] };
+		for (uint32_t taskIndex{ 1 }; taskIndex < taskCount; taskIndex++) {
+			size_t begin{ taskIndex * blockSize };
+			size_t keptSize{ keptCounts[taskIndex] * sizeof(T) };
+			if (keptSize > 0) {
+				memMov(res.data + written, res.data + begin, keptSize);
+			}
+			written += keptCounts[taskIndex];
+		}
+
+		res.count = written;
+		return res;
+	}
+}  // namespace pstd
@@ -11,22 +11,23 @@ namespace pstd {
 		uint32_t size;
 	};
 
+	// 16 bytes at a time from aligned loads, cString must be terminated
+	uint32_t calcCStringLength(const char* cString);
+
 	constexpr uint32_t getCStringLength(const char* cString) {
 		if (cString == nullptr) {
 			return 0;
 		}
 
-		constexpr uint32_t maxStringSize{
-			1024
-		};	// to avoid an infinite loop for ill-formed cstrings
-
-		uint32_t stringLength{};
-		while (stringLength < 1024 && *cString != '\0') {
-			stringLength++;
-			cString++;
+		if consteval {
+			uint32_t stringLength{};
+			while (cString[stringLength] != '\0') {
+				stringLength++;
+			}
+			return stringLength;
+		} else {
+			return calcCStringLength(cString);
 		}
-
-		return stringLength;
 	}
 
 	constexpr String createString(const char* cString) {
@@ -54,6 +55,27 @@ namespace pstd {
 
 	String makeConcatted(pstd::Arena* pArena, String a, String b);
 
+	// first and last occurrence of pattern in text, outIndex is where the
+	// match starts. short patterns use a simd filter on their first and last
+	// byte, long ones two way, so the search stays linear in the text
+	bool findSubstring(
+		const String& text, const String& pattern, uint32_t* outIndex = nullptr
+	);
+
+	bool findLastSubstring(
+		const String& text, const String& pattern, uint32_t* outIndex = nullptr
+	);
+
+	// first and last letter of text that is any of the letters in set
+	bool findAnyOf(
+		const String& text, const String& set, uint32_t* outIndex = nullptr
+	);
+
+	bool findLastAnyOf(
+		const String& text, const String& set, uint32_t* outIndex = nullptr
+	);
+
+	// outIndex is the last letter of the first match
 	bool substringMatchForward(
 		const String& a, const String& b, uint32_t* outIndex = nullptr
 	);
@@ -65,6 +87,7 @@ namespace pstd {
 		);
 	}
 
+	// outIndex is the first letter of the last match
 	bool substringMatchBackward(
 		const String& a, const String& b, uint32_t* outIndex = nullptr
 	);
@@ -76,43 +99,276 @@ namespace pstd {
 		);
 	}
 
-	String formatString(pstd::Arena* pArena, const String& format);
+	// number to text writers. dst needs room for MAX_INT64_CHARS or
+	// MAX_DECIMAL_CHARS, the number of chars written is returned
+	constexpr uint32_t MAX_INT64_CHARS{ 20 };
+	constexpr uint32_t MAX_DECIMAL_CHARS{ 24 };
 
-	template<typename T>
-	String formatString(pstd::Arena* pArena, const String& format, T val);
+	uint32_t calcDigitCount(uint64_t val);
 
-	template<typename T, typename... Args>
-	String formatString(
-		pstd::Arena* pArena, const String& format, T val, Args... args
-	) {
-		String newFormat{ formatString(pArena, format, val) };
+	uint32_t writeUInt64(char* dst, uint64_t val);
 
-		String res{ formatString(pArena, newFormat, args...) };
+	uint32_t writeInt64(char* dst, int64_t val);
 
-		return res;
-	}
+	// the shortest text that reads back as exactly val, ties rounded to
+	// even. fixed notation from 1e-4 up to 1e16, e.g. 0.1, 2.0, 1e+16 or
+	// 1.5e-05 outside of it, plus inf, -inf and nan
+	uint32_t writeFloat(char* dst, float val);
 
-	String getFileName(const String& string);
+	uint32_t writeDouble(char* dst, double val);
 
-	String getFileName(const char* cString);
+	String pushUInt64AsString(Arena* pArena, uint64_t val);
 
-	inline bool stringsMatch(const char* a, const char* b) {
-		return stringsMatch(createString(a), createString(b));
-	}
+	String pushInt64AsString(Arena* pArena, int64_t val);
+
+	String pushFloatAsString(Arena* pArena, float val);
 
-	inline String formatString(pstd::Arena* pArena, const char* format) {
-		return formatString(pArena, createString(format));
+	String pushDoubleAsString(Arena* pArena, double val);
+
+	// format strings are parsed at compile time, a bad specifier, a
+	// specifier that doesn't fit its argument or a wrong argument count
+	// fails the build. %i and %u take integers, %f takes any number and
+	// writes the shortest text that reads back exactly, %m takes a String
+	// or a c string, %% writes a single %
+	enum class FormatArgKind : uint8_t {
+		none,
+		integer,
+		decimal,
+		string,
+	};
+
+	template<typename T>
+	consteval FormatArgKind getFormatArgKind() {
+		if constexpr (OneOfType<T, String, const char*, char*>) {
+			return FormatArgKind::string;
+		} else if constexpr (ArithmeticType<T> && DecimalType<T>) {
+			return FormatArgKind::decimal;
+		} else if constexpr (ArithmeticType<T>) {
+			return FormatArgKind::integer;
+		}
+		return FormatArgKind::none;
 	}
 
+	constexpr uint32_t MAX_FORMAT_ESCAPES{ 4 };
+	constexpr uint32_t FORMAT_NO_ARG{ UINT32_MAX };
+
+	// a run of literal format text, followed by an argument unless argIndex
+	// is FORMAT_NO_ARG
+	struct FormatPiece {
+		uint32_t literalOffset;
+		uint32_t literalSize;
+		uint32_t argIndex;
+	};
+
+	// declared but never defined, the consteval parser calls these to stop
+	// compilation, so the error names the problem
+	void unknownFormatSpecifier();
+	void formatSpecifierDoesntMatchArgument();
+	void tooFewFormatArguments();
+	void tooManyFormatArguments();
+	void danglingPercentInFormat();
+	void tooManyPercentEscapesInFormat();
+
+	template<typename... Args>
+	struct FormatString {
+		static constexpr uint32_t argCount{ sizeof...(Args) };
+		static constexpr uint32_t maxPieceCount{
+			argCount + MAX_FORMAT_ESCAPES + 1
+		};
+
+		consteval FormatString(const char* cString) : format{ cString } {
+			constexpr FormatArgKind argKinds[argCount + 1]{
+				getFormatArgKind<Args>()..., FormatArgKind::none
+			};
+
+			uint32_t argIndex{};
+			uint32_t literalOffset{};
+			uint32_t i{};
+			while (cString[i] != '\0') {
+				if (cString[i] != '%') {
+					i++;
+					continue;
+				}
+
+				char specifier{ cString[i + 1] };
+				if (specifier == '\0') {
+					danglingPercentInFormat();
+				}
+				if (specifier == '%') {
+					// keep the first %, skip the second
+					addPiece(
+						literalOffset, i + 1 - literalOffset, FORMAT_NO_ARG
+					);
+					i += 2;
+					literalOffset = i;
+					continue;
+				}
+				if (argIndex >= argCount) {
+					tooFewFormatArguments();
+				}
+
+				FormatArgKind argKind{ argKinds[argIndex] };
+				switch (specifier) {
+					case 'i':
+					case 'u': {
+						if (argKind != FormatArgKind::integer) {
+							formatSpecifierDoesntMatchArgument();
+						}
+					} break;
+					case 'f': {
+						if (argKind != FormatArgKind::integer &&
+							argKind != FormatArgKind::decimal) {
+							formatSpecifierDoesntMatchArgument();
+						}
+					} break;
+					case 'm': {
+						if (argKind != FormatArgKind::string) {
+							formatSpecifierDoesntMatchArgument();
+						}
+					} break;
+					default: {
+						unknownFormatSpecifier();
+					} break;
+				}
+
+				specifiers[argIndex] = specifier;
+				addPiece(literalOffset, i - literalOffset, argIndex);
+				argIndex++;
+				i += 2;
+				literalOffset = i;
+			}
+			addPiece(literalOffset, i - literalOffset, FORMAT_NO_ARG);
+
+			if (argIndex != argCount) {
+				tooManyFormatArguments();
+			}
+		}
+
+		consteval void
+			addPiece(uint32_t literalOffset, uint32_t size, uint32_t argIndex) {
+			if (pieceCount == maxPieceCount) {
+				tooManyPercentEscapesInFormat();
+			}
+			pieces[pieceCount] = FormatPiece{ .literalOffset = literalOffset,
+											  .literalSize = size,
+											  .argIndex = argIndex };
+			pieceCount++;
+			literalSize += size;
+		}
+
+		const char* format;
+		uint32_t literalSize{};
+		uint32_t pieceCount{};
+		FormatPiece pieces[maxPieceCount]{};
+		char specifiers[argCount + 1]{};
+	};
+
+	// digits of one argument, or a view of a string argument
+	constexpr uint32_t FORMAT_DIGITS_CAPACITY{ 32 };
+	static_assert(FORMAT_DIGITS_CAPACITY >= MAX_DECIMAL_CHARS);
+
+	struct FormattedArg {
+		const char* buffer;
+		uint32_t size;
+		char digits[FORMAT_DIGITS_CAPACITY];
+	};
+
+	void formatInt64(FormattedArg* pOut, int64_t val);
+	void formatUInt64(FormattedArg* pOut, uint64_t val);
+	void formatFloat(FormattedArg* pOut, float val);
+	void formatDouble(FormattedArg* pOut, double val);
+
+	size_t calcFormattedSize(
+		uint32_t literalSize,
+		const FormatPiece* pieces,
+		uint32_t pieceCount,
+		const FormattedArg* args
+	);
+
+	// copies the pieces and arguments to dst, cut off at capacity, and
+	// returns the number of letters written
+	uint32_t copyFormatted(
+		char* dst,
+		uint32_t capacity,
+		const char* format,
+		const FormatPiece* pieces,
+		uint32_t pieceCount,
+		const FormattedArg* args
+	);
+
+	// measures the exact size, allocates once and copies every piece
+	// straight into place. output that doesn't fit in the arena is cut off
+	String writeFormatted(
+		pstd::Arena* pArena,
+		const char* format,
+		uint32_t literalSize,
+		const FormatPiece* pieces,
+		uint32_t pieceCount,
+		const FormattedArg* args
+	);
+
 	template<typename T>
-	String formatString(pstd::Arena* pArena, const char* format, T val) {
-		return formatString(pArena, createString(format), val);
+	void formatArg(FormattedArg* pOut, char specifier, T val) {
+		constexpr FormatArgKind argKind{ getFormatArgKind<T>() };
+		static_assert(
+			argKind != FormatArgKind::none, "unsupported format argument type"
+		);
+
+		if constexpr (argKind == FormatArgKind::string) {
+			String string{};
+			if constexpr (isSameType<T, String>) {
+				string = val;
+			} else {
+				string = createString(val);
+			}
+			pOut->buffer = string.buffer;
+			pOut->size = string.size;
+		} else if constexpr (isSameType<T, float>) {
+			formatFloat(pOut, val);
+		} else if constexpr (argKind == FormatArgKind::decimal) {
+			formatDouble(pOut, val);
+		} else if (specifier == 'f') {
+			formatDouble(pOut, ncast<double>(val));
+		} else if (specifier == 'u') {
+			formatUInt64(pOut, ncast<uint64_t>(val));
+		} else {
+			formatInt64(pOut, ncast<int64_t>(val));
+		}
 	}
 
-	template<typename T, typename... Args>
+	template<typename... Args>
+	void formatArgs(FormattedArg* pOut, const char* specifiers, Args... args) {
+		uint32_t argIndex{};
+		((formatArg(&pOut[argIndex], specifiers[argIndex], args), argIndex++),
+		 ...);
+	}
+
+	template<typename... Args>
 	String formatString(
-		pstd::Arena* pArena, const char* format, T val, Args... args
+		pstd::Arena* pArena,
+		FormatString<TypeIdentity<Args>...> format,
+		Args... args
 	) {
-		return formatString(pArena, createString(format), val, args...);
+		ASSERT(pArena);
+
+		FormattedArg formattedArgs[sizeof...(Args) + 1];
+		formatArgs(formattedArgs, format.specifiers, args...);
+
+		return writeFormatted(
+			pArena,
+			format.format,
+			format.literalSize,
+			format.pieces,
+			format.pieceCount,
+			formattedArgs
+		);
+	}
+
+	String getFileName(const String& string);
+
+	String getFileName(const char* cString);
+
+	inline bool stringsMatch(const char* a, const char* b) {
+		return stringsMatch(createString(a), createString(b));
 	}
 }  // namespace pstd
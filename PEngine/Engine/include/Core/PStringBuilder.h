@@ -0,0 +1,68 @@
+#pragma once
+#include "PTypes.h"
+#include "PAssert.h"
+#include "PArena.h"
+#include "PString.h"
+
+// builds a string at the tip of an arena. while nothing else is allocated
+// from the arena the buffer is the last allocation and grows in place,
+// otherwise it moves to the tip once with twice the capacity, so building
+// a string is O(length). output that doesn't fit in the arena is cut off,
+// like formatString's
+
+namespace pstd {
+	struct StringBuilder {
+		Arena* pArena;
+		char* buffer;
+		uint32_t size;
+		uint32_t capacity;
+	};
+
+	StringBuilder createStringBuilder(Arena* pArena, uint32_t capacity = 0);
+
+	// room for extraSize more letters, or as many as the arena has left
+	void reserve(StringBuilder* pBuilder, uint32_t extraSize);
+
+	void append(StringBuilder* pBuilder, const String& string);
+
+	void append(StringBuilder* pBuilder, char letter);
+
+	inline void append(StringBuilder* pBuilder, const char* cString) {
+		append(pBuilder, createString(cString));
+	}
+
+	void appendFormatted(
+		StringBuilder* pBuilder,
+		const char* format,
+		uint32_t literalSize,
+		const FormatPiece* pieces,
+		uint32_t pieceCount,
+		const FormattedArg* args
+	);
+
+	// same format strings as formatString
+	template<typename... Args>
+	void appendf(
+		StringBuilder* pBuilder,
+		FormatString<TypeIdentity<Args>...> format,
+		Args... args
+	) {
+		ASSERT(pBuilder);
+
+		FormattedArg formattedArgs[sizeof...(Args) + 1];
+		formatArgs(formattedArgs, format.specifiers, args...);
+
+		appendFormatted(
+			pBuilder,
+			format.format,
+			format.literalSize,
+			format.pieces,
+			format.pieceCount,
+			formattedArgs
+		);
+	}
+
+	// the terminator isn't counted in the size. the unused capacity goes
+	// back to the arena and the builder starts over on an empty string
+	String finishString(StringBuilder* pBuilder, bool nullTerminate = false);
+}  // namespace pstd
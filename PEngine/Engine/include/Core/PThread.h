@@ -0,0 +1,154 @@
+#pragma once
+#include "PTypes.h"
+#include "PAssert.h"
+#include "PFileIO.h"
+
+namespace pstd {
+	using ThreadHandle = void*;
+	using ThreadFunction = uint32_t (*)(void* pArg);
+
+	ThreadHandle createThread(ThreadFunction function, void* pArg);
+
+	// blocks until the thread returns, then releases the handle
+	void joinThread(ThreadHandle handle);
+
+	uint32_t getLogicalCoreCount();
+
+	// a slim reader writer lock, zero initialized is unlocked. it is not
+	// recursive, a thread must not lock it again while holding it
+	struct Mutex {
+		void* state;
+	};
+
+	void lockExclusive(Mutex* pMutex);
+	void unlockExclusive(Mutex* pMutex);
+
+	void lockShared(Mutex* pMutex);
+	void unlockShared(Mutex* pMutex);
+
+	// wakes one waiting thread, a raise with no one waiting is kept until
+	// the next wait
+	using Signal = void*;
+
+	Signal createSignal();
+	void destroySignal(Signal signal);
+
+	void raiseSignal(Signal signal);
+
+	// false when the timeout ran out first
+	bool waitSignal(Signal signal, uint32_t timeoutMs);
+
+	// gives the rest of the time slice to another ready thread
+	void yieldThread();
+
+	// a handle to the calling thread that other threads can use, see
+	// captureThreadStack. closeThreadHandle releases it
+	ThreadHandle openCurrentThread();
+	void closeThreadHandle(ThreadHandle handle);
+
+	// a loaded module's function entries, read out of its image so a stack
+	// walk can find them without the loader, which takes a lock to do it.
+	// good for as long as the module stays loaded
+	struct UnwindTable {
+		uintptr_t base;
+		size_t size;
+		uint32_t functionOffset;  // from base, sorted by address
+		uint32_t functionCount;
+	};
+
+	UnwindTable getUnwindTable(DllHandle handle);
+
+	// every module loaded in the process, up to maxCount, each with a
+	// reference taken so it stays loaded until unloadDll is called on it.
+	// how many went into handles
+	uint32_t acquireLoadedModules(DllHandle* handles, uint32_t maxCount);
+
+	// suspends the thread, puts the addresses on its stack in frames from
+	// the innermost out and resumes it. the first is where the thread was,
+	// the rest are return addresses. the thread can't be the calling one.
+	// functions are only looked up in tables, so nothing it calls while the
+	// thread is suspended takes a lock the thread could be holding. the
+	// walk stops at an address in none of them. 0 when the thread couldn't
+	// be suspended
+	uint32_t captureThreadStack(
+		ThreadHandle handle,
+		const UnwindTable* tables,
+		uint32_t tableCount,
+		uintptr_t* frames,
+		uint32_t maxFrameCount
+	);
+
+	// event counts for profiling. instructions, cache and branch misses come
+	// from the cpu's performance counters, which Windows only lets drivers
+	// program, so it leaves them out. threadCycles are the cycles the
+	// calling thread was scheduled for, pageFaults count the whole process's
+	enum class PerfCounter : uint32_t {
+		threadCycles = 0,
+		instructions,
+		cacheMisses,
+		branchMisses,
+		pageFaults,
+
+		count,
+	};
+
+	struct PerfCounters {
+		uint64_t values[cast<size_t>(PerfCounter::count)];
+	};
+
+	// a bit per PerfCounter, set for those readPerfCounters fills in
+	uint32_t getAvailablePerfCounters();
+
+	// the counts so far, the ones that aren't available are 0. a system
+	// call or two, so it costs a lot more than the cycle counter
+	void readPerfCounters(PerfCounters* pCounters);
+
+	// one pointer per thread, null until the thread sets it
+	using ThreadLocalKey = uint32_t;
+
+	// called with the value of each thread that set one, on that thread as
+	// it exits, or from destroyThreadLocal for the threads still running
+	using ThreadExitFunction = void (*)(void* pVal);
+
+	ThreadLocalKey createThreadLocal(ThreadExitFunction onThreadExit = nullptr);
+	void destroyThreadLocal(ThreadLocalKey key);
+
+	void* getThreadLocal(ThreadLocalKey key);
+	void setThreadLocal(ThreadLocalKey key, void* pVal);
+
+	constexpr uint32_t MAX_PARALLEL_TASKS{ 64 };
+
+	template<typename F>
+	struct ParallelTask {
+		F* pFunction;
+		uint32_t taskIndex;
+	};
+
+	template<typename F>
+	uint32_t runParallelTask(void* pArg) {
+		auto* pTask{ rcast<ParallelTask<F>*>(pArg) };
+		(*pTask->pFunction)(pTask->taskIndex);
+		return 0;
+	}
+
+	// fork join, calls function(taskIndex) once per task. task 0 runs on the
+	// calling thread, the rest get a thread each
+	template<typename F>
+	void runParallel(uint32_t taskCount, F function) {
+		ASSERT(taskCount > 0);
+		ASSERT(taskCount <= MAX_PARALLEL_TASKS);
+
+		ParallelTask<F> tasks[MAX_PARALLEL_TASKS];
+		ThreadHandle threads[MAX_PARALLEL_TASKS]{};
+		for (uint32_t i{ 1 }; i < taskCount; i++) {
+			tasks[i] = ParallelTask<F>{ .pFunction = &function, .taskIndex = i };
+			threads[i] = createThread(runParallelTask<F>, &tasks[i]);
+		}
+
+		function(0);
+
+		for (uint32_t i{ 1 }; i < taskCount; i++) {
+			joinThread(threads[i]);
+		}
+	}
+}  // namespace pstd
@@ -0,0 +1,8 @@
+#pragma once
+#include "PTypes.h"
+
+namespace pstd {
+	// a monotonic clock that ticks getTimeFrequency times a second
+	uint64_t getTime();
+	uint64_t getTimeFrequency();
+}  // namespace pstd
@@ -30,6 +30,30 @@ namespace pstd {
 	template<typename T>
 	concept DecimalType = requires { T{ 1.5 } || T{ 1.5f }; };
 
+	template<typename T, typename U>
+	constexpr bool isSameType{ false };
+
+	template<typename T>
+	constexpr bool isSameType<T, T>{ true };
+
+	template<typename T, typename... Ts>
+	concept OneOfType = (isSameType<T, Ts> || ...);
+
+	template<typename T>
+	concept ArithmeticType = OneOfType<
+		T,
+		char,
+		int8_t,
+		int16_t,
+		int32_t,
+		int64_t,
+		uint8_t,
+		uint16_t,
+		uint32_t,
+		uint64_t,
+		float,
+		double>;
+
 	template<typename R, typename T>
 	bool getIsNarrowing(T num) {
 		if (static_cast<R>(num) != num) {
@@ -69,7 +93,7 @@ namespace pstd {
 		if constexpr (getIsUnsigned<T>()) {
 			return allBitsSet;
 		}
-		return allBitsSet ^ (1 << ((sizeof(T) * 8) - 1));
+		return allBitsSet ^ ((T)1 << ((sizeof(T) * 8) - 1));
 	}
 
 	template<typename R, typename T>
@@ -96,6 +120,19 @@ namespace pstd {
 		return reinterpret_cast<R>(num);
 	}
 
+	template<typename T>
+	struct TypeIdentityOf {
+		using Type = T;
+	};
+
+	// keeps a parameter out of template argument deduction
+	template<typename T>
+	using TypeIdentity = typename TypeIdentityOf<T>::Type;
+
+	// unevaluated contexts only, e.g. decltype(declval<T&>().begin())
+	template<typename T>
+	T&& declval();
+
 	template<typename T>
 	constexpr T&& move(T& num) {
 		return static_cast<T&&>(num);
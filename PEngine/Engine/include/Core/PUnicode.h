@@ -0,0 +1,70 @@
+#pragma once
+#include "PTypes.h"
+#include "PArena.h"
+#include "PString.h"
+
+// utf-8 validation and transcoding between utf-8, utf-16 and utf-32.
+//
+// validateUtf8 checks 16 bytes at a time: runs of ascii only test the high
+// bits, other blocks go through the lookup table check from simdutf, which
+// classifies every byte pair with three nibble lookups and needs ssse3.
+// without ssse3 the non ascii blocks fall back to a scalar decoder.
+//
+// the converters copy ascii runs 16 bytes at a time and decode everything
+// else one code point at a time. they reject overlong forms, surrogates
+// encoded in utf-8, unpaired utf-16 surrogates and code points past
+// 0x10FFFF, nothing is ever replaced with U+FFFD
+
+namespace pstd {
+	struct Utf16String {
+		const char16_t* buffer;
+		uint32_t size;
+	};
+
+	struct Utf32String {
+		const char32_t* buffer;
+		uint32_t size;
+	};
+
+	// outErrorOffset gets the start of the first invalid sequence, or
+	// text.size when the text ends in the middle of one that is valid so
+	// far, so a caller reading a stream knows to wait for more
+	bool validateUtf8(const String& text, uint32_t* outErrorOffset = nullptr);
+
+	// text must be valid utf-8
+	uint32_t countCodePoints(const String& text);
+
+	// a utf-8 sequence is never shorter than the utf-16 units or utf-32 code
+	// points it decodes to, so text.size units of capacity are always enough.
+	// false on invalid text or when dst is too small, outSize is the count
+	// written
+	bool convertUtf8ToUtf16(
+		char16_t* dst, uint32_t capacity, const String& text, uint32_t* outSize
+	);
+
+	bool convertUtf8ToUtf32(
+		char32_t* dst, uint32_t capacity, const String& text, uint32_t* outSize
+	);
+
+	// at most 3 bytes per utf-16 unit and 4 per utf-32 code point
+	bool convertUtf16ToUtf8(
+		char* dst, uint32_t capacity, const Utf16String& text, uint32_t* outSize
+	);
+
+	bool convertUtf32ToUtf8(
+		char* dst, uint32_t capacity, const Utf32String& text, uint32_t* outSize
+	);
+
+	// the arena versions take the worst case size from the tip, give back
+	// what was not used and null terminate the result. the arena is left as
+	// it was when the text is invalid
+	bool
+		createUtf16String(Arena* pArena, const String& text, Utf16String* pOut);
+
+	bool
+		createUtf32String(Arena* pArena, const String& text, Utf32String* pOut);
+
+	bool createUtf8String(Arena* pArena, const Utf16String& text, String* pOut);
+
+	bool createUtf8String(Arena* pArena, const Utf32String& text, String* pOut);
+}  // namespace pstd
@@ -0,0 +1,367 @@
+#pragma once
+#include "PTypes.h"
+#include "PAssert.h"
+#include "PAlgorithm.h"
+#include "PContainer.h"
+
+// lazy views, nothing is allocated and nothing is evaluated until the view
+// is iterated. views hold their source by value, contiguous containers are
+// wrapped in a Span first, so the container has to outlive the view.
+//
+// for (auto [i, val] : pstd::enumerate(pstd::filter(array, isAlive))) {}
+
+namespace pstd {
+	struct ViewEnd {};
+
+	template<typename T>
+	concept View = Container<T> && requires(const T& view) {
+		view.begin();
+		view.end();
+	};
+
+	template<typename T>
+	concept ViewSource = View<T> || ContiguousContainer<T>;
+
+	template<typename T>
+	struct Span {
+		using ElementType = T;
+
+		struct Iterator {
+			constexpr T& operator*() const { return *pElement; }
+			constexpr void operator++() { pElement++; }
+			constexpr bool operator!=(ViewEnd) const {
+				return pElement != pEnd;
+			}
+
+			T* pElement;
+			T* pEnd;
+		};
+
+		constexpr T& operator[](size_t index) const {
+			ASSERT(index < count);
+			return data[index];
+		}
+
+		constexpr Iterator begin() const {
+			return Iterator{ .pElement = data, .pEnd = data + count };
+		}
+		constexpr ViewEnd end() const { return {}; }
+
+		T* data;
+		size_t count;
+	};
+
+	template<typename T>
+	constexpr Span<T> makeSpan(T* data, size_t count) {
+		return Span<T>{ .data = data, .count = count };
+	}
+
+	template<ContiguousContainer T>
+	constexpr auto makeSpan(const T& container) {
+		return makeSpan(container.data, container.count);
+	}
+
+	template<ViewSource T>
+	constexpr auto makeView(const T& source) {
+		if constexpr (View<T>) {
+			return source;
+		} else {
+			return makeSpan(source);
+		}
+	}
+
+	template<ViewSource T>
+	using ViewOf = decltype(makeView(declval<const T&>()));
+
+	template<View V>
+	using ViewIterator = decltype(declval<const V&>().begin());
+
+	template<View V, typename F>
+	struct TransformView {
+		using InnerIterator = ViewIterator<V>;
+		using ElementType =
+			decltype(declval<const F&>()(*declval<const InnerIterator&>()));
+
+		struct Iterator {
+			constexpr ElementType operator*() const {
+				return (*pFunction)(*inner);
+			}
+			constexpr void operator++() { ++inner; }
+			constexpr bool operator!=(ViewEnd viewEnd) const {
+				return inner != viewEnd;
+			}
+
+			InnerIterator inner;
+			const F* pFunction;
+		};
+
+		constexpr Iterator begin() const {
+			return Iterator{ .inner = source.begin(), .pFunction = &function };
+		}
+		constexpr ViewEnd end() const { return {}; }
+
+		V source;
+		F function;
+	};
+
+	template<View V, typename F>
+	struct FilterView {
+		using InnerIterator = ViewIterator<V>;
+		using ElementType = typename V::ElementType;
+
+		struct Iterator {
+			constexpr decltype(auto) operator*() const { return *inner; }
+			constexpr void operator++() {
+				++inner;
+				skipRejected();
+			}
+			constexpr bool operator!=(ViewEnd viewEnd) const {
+				return inner != viewEnd;
+			}
+
+			constexpr void skipRejected() {
+				while (inner != ViewEnd{} && !(*pPredicate)(*inner)) {
+					++inner;
+				}
+			}
+
+			InnerIterator inner;
+			const F* pPredicate;
+		};
+
+		constexpr Iterator begin() const {
+			Iterator iterator{ .inner = source.begin(), .pPredicate = &predicate };
+			iterator.skipRejected();
+			return iterator;
+		}
+		constexpr ViewEnd end() const { return {}; }
+
+		V source;
+		F predicate;
+	};
+
+	template<typename R>
+	struct Enumerated {
+		size_t index;
+		R value;
+	};
+
+	template<View V>
+	struct EnumerateView {
+		using InnerIterator = ViewIterator<V>;
+		using ElementType =
+			Enumerated<decltype(*declval<const InnerIterator&>())>;
+
+		struct Iterator {
+			constexpr ElementType operator*() const {
+				return ElementType{ .index = index, .value = *inner };
+			}
+			constexpr void operator++() {
+				++inner;
+				index++;
+			}
+			constexpr bool operator!=(ViewEnd viewEnd) const {
+				return inner != viewEnd;
+			}
+
+			InnerIterator inner;
+			size_t index;
+		};
+
+		constexpr Iterator begin() const {
+			return Iterator{ .inner = source.begin(), .index = 0 };
+		}
+		constexpr ViewEnd end() const { return {}; }
+
+		V source;
+	};
+
+	template<typename A, typename B>
+	struct Zipped {
+		A first;
+		B second;
+	};
+
+	// stops at the end of the shorter view
+	template<View VA, View VB>
+	struct ZipView {
+		using InnerIteratorA = ViewIterator<VA>;
+		using InnerIteratorB = ViewIterator<VB>;
+		using ElementType = Zipped<
+			decltype(*declval<const InnerIteratorA&>()),
+			decltype(*declval<const InnerIteratorB&>())>;
+
+		struct Iterator {
+			constexpr ElementType operator*() const {
+				return ElementType{ .first = *innerA, .second = *innerB };
+			}
+			constexpr void operator++() {
+				++innerA;
+				++innerB;
+			}
+			constexpr bool operator!=(ViewEnd viewEnd) const {
+				return (innerA != viewEnd) && (innerB != viewEnd);
+			}
+
+			InnerIteratorA innerA;
+			InnerIteratorB innerB;
+		};
+
+		constexpr Iterator begin() const {
+			return Iterator{ .innerA = sourceA.begin(),
+							 .innerB = sourceB.begin() };
+		}
+		constexpr ViewEnd end() const { return {}; }
+
+		VA sourceA;
+		VB sourceB;
+	};
+
+	template<View V>
+	struct TakeView {
+		using InnerIterator = ViewIterator<V>;
+		using ElementType = typename V::ElementType;
+
+		struct Iterator {
+			constexpr decltype(auto) operator*() const { return *inner; }
+			constexpr void operator++() {
+				++inner;
+				remaining--;
+			}
+			constexpr bool operator!=(ViewEnd viewEnd) const {
+				return remaining > 0 && inner != viewEnd;
+			}
+
+			InnerIterator inner;
+			size_t remaining;
+		};
+
+		constexpr Iterator begin() const {
+			return Iterator{ .inner = source.begin(), .remaining = maxCount };
+		}
+		constexpr ViewEnd end() const { return {}; }
+
+		V source;
+		size_t maxCount;
+	};
+
+	// consecutive spans of chunkSize elements, the last one may be shorter
+	template<typename T>
+	struct ChunkView {
+		using ElementType = Span<T>;
+
+		struct Iterator {
+			constexpr Span<T> operator*() const {
+				return makeSpan(pElement, calcChunkCount());
+			}
+			constexpr void operator++() { pElement += calcChunkCount(); }
+			constexpr bool operator!=(ViewEnd) const {
+				return pElement != pEnd;
+			}
+
+			constexpr size_t calcChunkCount() const {
+				return min(chunkSize, ncast<size_t>(pEnd - pElement));
+			}
+
+			T* pElement;
+			T* pEnd;
+			size_t chunkSize;
+		};
+
+		constexpr Iterator begin() const {
+			return Iterator{ .pElement = source.data,
+							 .pEnd = source.data + source.count,
+							 .chunkSize = chunkSize };
+		}
+		constexpr ViewEnd end() const { return {}; }
+
+		Span<T> source;
+		size_t chunkSize;
+	};
+
+	// every step'th element, starting with the first
+	template<typename T>
+	struct StrideView {
+		using ElementType = T;
+
+		struct Iterator {
+			constexpr T& operator*() const { return *pElement; }
+			constexpr void operator++() {
+				remaining--;
+				if (remaining > 0) {
+					pElement += step;
+				}
+			}
+			constexpr bool operator!=(ViewEnd) const { return remaining > 0; }
+
+			T* pElement;
+			size_t remaining;
+			size_t step;
+		};
+
+		constexpr T& operator[](size_t index) const {
+			ASSERT(index < count);
+			return source.data[index * step];
+		}
+
+		constexpr Iterator begin() const {
+			return Iterator{ .pElement = source.data,
+							 .remaining = count,
+							 .step = step };
+		}
+		constexpr ViewEnd end() const { return {}; }
+
+		Span<T> source;
+		size_t step;
+		size_t count;
+	};
+
+	template<ViewSource T, typename F>
+	constexpr TransformView<ViewOf<T>, F> transform(const T& source, F function) {
+		return TransformView<ViewOf<T>, F>{ .source = makeView(source),
+											.function = function };
+	}
+
+	template<ViewSource T, typename F>
+	constexpr FilterView<ViewOf<T>, F> filter(const T& source, F predicate) {
+		return FilterView<ViewOf<T>, F>{ .source = makeView(source),
+										 .predicate = predicate };
+	}
+
+	template<ViewSource T>
+	constexpr EnumerateView<ViewOf<T>> enumerate(const T& source) {
+		return EnumerateView<ViewOf<T>>{ .source = makeView(source) };
+	}
+
+	template<ViewSource A, ViewSource B>
+	constexpr ZipView<ViewOf<A>, ViewOf<B>> zip(const A& a, const B& b) {
+		return ZipView<ViewOf<A>, ViewOf<B>>{ .sourceA = makeView(a),
+											  .sourceB = makeView(b) };
+	}
+
+	template<ViewSource T>
+	constexpr TakeView<ViewOf<T>> take(const T& source, size_t maxCount) {
+		return TakeView<ViewOf<T>>{ .source = makeView(source),
+									.maxCount = maxCount };
+	}
+
+	template<ContiguousContainer T>
+	constexpr auto chunk(const T& source, size_t chunkSize) {
+		ASSERT(chunkSize > 0);
+
+		auto span{ makeSpan(source) };
+		using ElementType = typename decltype(span)::ElementType;
+		return ChunkView<ElementType>{ .source = span, .chunkSize = chunkSize };
+	}
+
+	template<ContiguousContainer T>
+	constexpr auto stride(const T& source, size_t step) {
+		ASSERT(step > 0);
+
+		auto span{ makeSpan(source) };
+		using ElementType = typename decltype(span)::ElementType;
+		return StrideView<ElementType>{ .source = span,
+										.step = step,
+										.count = (span.count + step - 1) / step };
+	}
+}  // namespace pstd
@@ -0,0 +1,133 @@
+#pragma once
+#include "Logging.h"
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PMemory.h"
+#include "Core/PString.h"
+
+// the flight recorder keeps the latest log records, frame markers and
+// profiler zones in a file mapped into memory, so they outlive a crash that
+// comes before the log writer got to them. the file is a header and then
+// blocks. a thread claims a whole block at a time from a shared counter,
+// writes its entries into it and publishes how much of it is used after
+// each one, so a crash loses at most the entry being written. blocks are
+// reused oldest first. a write is a copy into the thread's block, cheap
+// enough to leave on in release builds.
+//
+// LogDecoder dumps a recording, ordered by time
+
+namespace FlightRecorder {
+	constexpr uint32_t RECORDER_FILE_MAGIC{ 0x43524C46 };  // FLRC
+	constexpr uint32_t RECORDER_FILE_VERSION{ 2 };
+
+	struct Config {
+		const char* path;  // read by startup only
+		uint32_t size;	   // rounded down to whole blocks
+		uint32_t blockSize;	 // power of two
+		uint32_t maxThreadCount;  // at once, an exited thread's slot is reused
+	};
+
+	constexpr Config DEFAULT_CONFIG{
+		.size = 8 * 1024 * 1024,
+		.blockSize = 16 * 1024,
+		.maxThreadCount = 32,
+	};
+
+	// false when the file can't be mapped, nothing is recorded then
+	bool startup(
+		pstd::AllocationRegistry* pAllocRegistry, const Config& config
+	);
+
+	// threads that record must be done before this
+	void shutdown(pstd::AllocationRegistry* pAllocRegistry);
+
+	// strings are copied, long string arguments are cut off to fit a block
+	void recordLog(
+		const Console::LogSite& site,
+		const char* format,
+		const Console::LogArgType* argTypes,
+		uint32_t argCount,
+		const Console::LogArg* args,
+		uint64_t cycles
+	);
+
+	void recordFrame(uint64_t frameIndex);
+
+	void recordZone(
+		const pstd::String& name, uint64_t beginCycles, uint64_t endCycles
+	);
+
+	// the file starts with this, the first block starts blockSize in
+	struct FileHeader {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t blockSize;
+		uint32_t blockCount;
+		uint64_t timeFrequency;
+		uint64_t nextSequence;
+		uint64_t droppedCount;	// entries from threads that got no slot
+	};
+
+	// used is how many bytes of entries follow, cycles and time are from
+	// when the block was claimed so a reader can turn cycles into seconds
+	struct BlockHeader {
+		uint64_t sequence;	// 0 for a block that holds nothing, top bit is
+							// set while an entry is being written
+		uint64_t cycles;
+		uint64_t time;
+		uint32_t threadIndex;
+		uint32_t used;
+	};
+
+	enum class EntryKind : uint32_t {
+		log,
+		frame,
+		zone,
+
+		count,
+	};
+
+	// strings point into the recording
+	struct Entry {
+		EntryKind kind;
+		uint32_t threadIndex;
+		uint64_t cycles;
+
+		// log
+		Console::LogLevel level;
+		uint32_t line;
+		pstd::String file;
+		pstd::String format;
+		const Console::LogArgType* argTypes;
+		uint32_t argCount;
+		Console::LogArg args[Console::MAX_LOG_ARGS];
+
+		// frame
+		uint64_t frameIndex;
+
+		// zone, cycles is where it began
+		uint64_t endCycles;
+		pstd::String name;
+	};
+
+	// cyclesPerSecond is 0 when the blocks were all claimed too close
+	// together to tell
+	struct Recording {
+		pstd::String data;
+		FileHeader header;
+		uint32_t* entryOffsets;	 // ordered by cycles
+		uint32_t entryCount;
+		uint64_t firstCycles;
+		double cyclesPerSecond;
+	};
+
+	// false when data isn't a recording of this version. entries that are
+	// cut off or malformed are left out. the entry table comes from pArena
+	bool openRecording(
+		pstd::Arena* pArena, const pstd::String& data, Recording* outRecording
+	);
+
+	void readEntry(
+		const Recording& recording, uint32_t index, Entry* outEntry
+	);
+}  // namespace FlightRecorder
@@ -0,0 +1,96 @@
+#pragma once
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PArray.h"
+
+// frame timing. the main loop brackets each frame with beginFrame and
+// endFrame, and the phases inside it with PhaseScope. a phase's time
+// leaves out the phases nested in it, so the engine update doesn't count
+// the platform pump. each frame's times go in histograms, one for the
+// last windowFrameCount frames, rolling, and one for the whole run.
+//
+// getSummary has the window's percentiles as of the last endFrame, the
+// game gets the same through its setFrameStats export. exportStats writes
+// the window's and the run's at shutdown. everything here is for the main
+// thread only, and does nothing before startup
+
+namespace FrameStats {
+	enum class Phase : uint32_t {
+		hotReloadCheck = 0,
+		platformPump,
+		engineUpdate,
+		gameUpdate,
+
+		count,
+	};
+
+	struct Config {
+		uint32_t windowFrameCount;
+	};
+
+	constexpr Config DEFAULT_CONFIG{
+		.windowFrameCount = 256,
+	};
+
+	// in nanoseconds. the percentiles and max are within 1/64 above the
+	// real value, see PHistogram.h
+	struct PhaseStats {
+		uint64_t mean;
+		uint64_t p50;
+		uint64_t p95;
+		uint64_t p99;
+		uint64_t maximum;
+	};
+
+	// frame is from beginFrame to endFrame, which takes in time outside any
+	// phase too. frameCount is how many frames the window has, until it
+	// fills that's fewer than windowFrameCount
+	struct Summary {
+		uint64_t frameCount;
+		PhaseStats frame;
+		pstd::StaticArray<PhaseStats, cast<size_t>(Phase::count), Phase>
+			phases;
+	};
+
+	void startup(
+		pstd::AllocationRegistry* pAllocRegistry,
+		const Config& config = DEFAULT_CONFIG
+	);
+	void shutdown(pstd::AllocationRegistry* pAllocRegistry);
+
+	void beginFrame();
+
+	// the frame's phases must all have ended
+	void endFrame();
+
+	// phases nest at most MAX_PHASE_DEPTH deep, deeper ones aren't timed
+	constexpr uint32_t MAX_PHASE_DEPTH{ 8 };
+
+	void beginPhase(Phase phase);
+	void endPhase();
+
+	struct PhaseScope {
+		explicit PhaseScope(Phase phase) {
+			beginPhase(phase);
+		}
+
+		~PhaseScope() {
+			endPhase();
+		}
+
+		PhaseScope(const PhaseScope&) = delete;
+		PhaseScope& operator=(const PhaseScope&) = delete;
+	};
+
+	// the name exportStats gives it
+	const char* getPhaseName(Phase phase);
+
+	// stays where it is from startup to shutdown, null outside them
+	const Summary* getSummary();
+
+	// a CSV line for the frame and each phase in the window and in the
+	// whole run. false when the file can't be written
+	bool exportStats(
+		pstd::AllocationRegistry* pAllocRegistry, const char* path
+	);
+}  // namespace FrameStats
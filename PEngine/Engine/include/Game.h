@@ -1,5 +1,6 @@
 #pragma once
 #include "GameAPI.h"
+#include "FrameStats.h"
 
 namespace Game {
 	struct State;
@@ -8,13 +9,22 @@ namespace Game {
 		using Startup = State* (*)();
 		using Update = bool (*)(State* state);
 		using Shutdown = void (*)(State* state);
+		using SetFrameStats = void (*)(const FrameStats::Summary* pSummary);
 
 		Startup startup;
 		Update update;
 		Shutdown shutdown;
+
+		// optional, null when the game doesn't export it
+		SetFrameStats setFrameStats;
 	};
 
 	GAME_API State* startup();
 	GAME_API bool update(State* state);
 	GAME_API void shutdown(State* state);
+
+	// the engine's frame timing, which it updates after each frame until
+	// the game is shut down or unloaded. called after loading, before
+	// startup or the first update since a hot reload
+	GAME_API void setFrameStats(const FrameStats::Summary* pSummary);
 }  // namespace Game
@@ -0,0 +1,131 @@
+#pragma once
+#include "Logging.h"
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PString.h"
+#include "Core/PStringBuilder.h"
+
+// a binary log is a header and then entries, each a LogEntryKind byte and
+// its fields. numbers are little endian and unaligned, sizes, counts, ids
+// and integer arguments are leb128 varints, signed ones zigzag encoded.
+// a site is written once, before the first record that uses it, and
+// records name it by id, so a record is a few bytes plus its arguments.
+// record times are cycle counter deltas from the previous record, clock
+// entries pair the cycle counter with PTime's clock so the decoder can
+// turn cycles into seconds
+
+namespace Console {
+	constexpr uint32_t LOG_FILE_MAGIC{ 0x474F4C50 };  // PLOG
+	constexpr uint32_t LOG_FILE_VERSION{ 1 };
+	constexpr uint32_t LOG_FILE_HEADER_SIZE{ 24 };
+
+	enum class LogEntryKind : uint8_t {
+		site,	  // id, level byte, line, arg count, arg types, file, format
+		record,	  // site id, cycle delta, arguments
+		clock,	  // uint64 cycles, uint64 time
+		dropped,  // record count
+
+		count,
+	};
+
+	struct LogFileHeader {
+		uint32_t magic;
+		uint32_t version;
+		uint64_t timeFrequency;
+		uint32_t maxSiteCount;
+	};
+
+	// each writes one entry to dst and returns its size, or 0 when it
+	// doesn't fit in capacity
+	uint32_t encodeLogFileHeader(
+		uint8_t* dst, uint32_t capacity, const LogFileHeader& header
+	);
+
+	uint32_t encodeLogSite(
+		uint8_t* dst,
+		uint32_t capacity,
+		uint32_t id,
+		const LogSite& site,
+		const char* format,
+		const LogArgType* argTypes,
+		uint32_t argCount
+	);
+
+	uint32_t encodeLogRecord(
+		uint8_t* dst,
+		uint32_t capacity,
+		uint32_t siteId,
+		int64_t cycleDelta,
+		const LogArgType* argTypes,
+		uint32_t argCount,
+		const LogArg* args
+	);
+
+	uint32_t encodeLogClock(
+		uint8_t* dst, uint32_t capacity, uint64_t cycles, uint64_t time
+	);
+
+	uint32_t encodeLogDropped(uint8_t* dst, uint32_t capacity, uint64_t count);
+
+	// strings point into the log data
+	struct LogFileSite {
+		LogLevel level;
+		uint32_t line;
+		pstd::String file;
+		pstd::String format;
+		const LogArgType* argTypes;
+		uint32_t argCount;
+	};
+
+	// cycles is absolute for records, the reader adds up the deltas
+	struct LogEntry {
+		LogEntryKind kind;
+		const LogFileSite* pSite;
+		uint64_t cycles;
+		uint64_t time;
+		uint64_t droppedCount;
+		LogArg args[MAX_LOG_ARGS];
+	};
+
+	struct LogFileReader {
+		pstd::String data;
+		uint32_t offset;
+		LogFileHeader header;
+		LogFileSite* sites;
+		uint32_t siteCount;
+		uint64_t cycles;
+	};
+
+	// false when data doesn't start with a header of this version
+	bool readLogFileHeader(const pstd::String& data, LogFileHeader* outHeader);
+
+	// the site table comes from pArena, header.maxSiteCount entries
+	bool openLogFile(
+		pstd::Arena* pArena, const pstd::String& data, LogFileReader* outReader
+	);
+
+	// false at the end of the data, or at an entry that is cut off or
+	// malformed, which leaves offset short of the data size. site entries
+	// are returned too, after they went into the site table
+	bool readLogEntry(LogFileReader* pReader, LogEntry* outEntry);
+
+	// true when every specifier in format has an argument of a type it can
+	// take, what FormatString checks at compile time
+	bool getLogFormatMatchesArgs(
+		const pstd::String& format,
+		const LogArgType* argTypes,
+		uint32_t argCount
+	);
+
+	// level, file:line and the formatted text, as the console shows them.
+	// format must match argTypes, like one that passed FormatString
+	void appendLogLine(
+		pstd::StringBuilder* pBuilder,
+		LogLevel level,
+		const pstd::String& file,
+		uint32_t line,
+		const pstd::String& format,
+		const LogArgType* argTypes,
+		const LogArg* args
+	);
+}  // namespace Console
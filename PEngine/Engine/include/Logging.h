@@ -1,8 +1,26 @@
 #pragma once
 #include "Core/PArena.h"
+#include "Core/PAtomic.h"
 #include "Core/PTypes.h"
 #include "Core/PString.h"
 
+// a log call copies its raw arguments into a ring owned by the calling
+// thread and returns, nothing is formatted on the calling thread. a writer
+// thread drains the rings and hands the records to the sinks LogConfig
+// turns on: the console, a text file and an in memory ring get the
+// formatted lines, a binary log gets them undecoded for LogDecoder to turn
+// into text later, see LogFile.h. when a ring is full the record is
+// dropped or the caller waits for room, as set in LogConfig, and both are
+// counted.
+//
+// every call has a category and a level, and calls whose pair is filtered
+// out cost a load and a branch, see setLogLevel. LOG_LIMITED calls also
+// have a rate limit, so a source that floods the log is cut down to a
+// summary of how much it repeated.
+//
+// before startup and after shutdown log calls format and write to the
+// console directly
+
 namespace Console {
 	enum class LogLevel : uint32_t {
 		none = 0,
@@ -13,9 +31,240 @@ namespace Console {
 		count,
 	};
 
-	pstd::Arena getLogArena();
+	enum class LogCategory : uint32_t {
+		general = 0,
+		core,
+		renderer,
+		validation,	 // vulkan validation layer messages
+
+		count,
+	};
+
+	enum class LogOverflow : uint32_t {
+		drop,
+		block,
+	};
+
+	// a sink is on when its setting is, any of them can be on together.
+	// paths are read by startup only
+	struct LogConfig {
+		uint32_t threadBufferSize;	// power of two
+		uint32_t maxThreadCount;
+		LogOverflow overflow;
+
+		bool isConsoleOn;
+		const char* filePath;	 // text file
+		const char* binaryPath;	 // binary log
+		uint32_t memorySize;	 // in memory ring, a power of two
+
+		// the console gets a batch each time the writer wakes, the files
+		// when theirs is full and at least every second. all at least
+		// threadBufferSize
+		uint32_t batchSize;
+		uint32_t fileBatchSize;
+
+		uint32_t maxSiteCount;	// binary log only
+
+		// each LOG_LIMITED site and key may log limitBurst calls at once
+		// and limitPerSecond after that
+		uint32_t maxLimitedCount;
+		uint32_t limitBurst;
+		uint32_t limitPerSecond;
+
+		// calls below their category's level are filtered out
+		pstd::StaticArray<
+			LogLevel,
+			cast<size_t>(LogCategory::count),
+			LogCategory>
+			minLevels;
+	};
+
+	constexpr LogConfig DEFAULT_LOG_CONFIG{
+		.threadBufferSize = 64 * 1024,
+		.maxThreadCount = 16,
+		.overflow = LogOverflow::drop,
+		.isConsoleOn = true,
+		.batchSize = 64 * 1024,
+		.fileBatchSize = 1024 * 1024,
+		.maxSiteCount = 4096,
+		.maxLimitedCount = 1024,
+		.limitBurst = 10,
+		.limitPerSecond = 2,
+	};
+
+	// counted as the writer thread and the log calls go, so a snapshot
+	struct LogStats {
+		uint64_t writtenCount;
+		uint64_t droppedCount;
+		uint64_t blockedCount;
+		uint64_t suppressedCount;  // by the rate limit
+	};
+
+	LogStats getLogStats();
+
+	// the latest text the memory sink holds, from the first whole line.
+	// it lags the log calls by as long as the writer thread takes to wake,
+	// empty without a memory sink
+	pstd::String copyLogMemory(pstd::Arena* pArena);
+
+	// a bit per category and level, set when calls with that pair go
+	// through. every pair is on until startup applies LogConfig::minLevels
+	extern uint64_t g_LogFilter;
+
+	static_assert(
+		cast<uint32_t>(LogCategory::count) * cast<uint32_t>(LogLevel::count) <=
+			64,
+		"the log filter has a bit per category and level"
+	);
+
+	constexpr uint64_t getLogFilterBit(LogCategory category, LogLevel level) {
+		return 1ull << (cast<uint32_t>(category) *
+							cast<uint32_t>(LogLevel::count) +
+						cast<uint32_t>(level));
+	}
+
+	// calls in category below minLevel are filtered out from now on, none
+	// lets all of them through
+	void setLogLevel(LogCategory category, LogLevel minLevel);
+
+	// records keep a pointer to their site until the writer thread is done
+	// with them, so sites are static, like the ones the LOG_ macros make
+	struct LogSite {
+		LogCategory category;
+		LogLevel level;
+		const char* file;
+		uint32_t line;
+	};
+
+	inline bool isLogEnabled(const LogSite& site) {
+		return (pstd::atomicLoad(&g_LogFilter) &
+				getLogFilterBit(site.category, site.level)) != 0;
+	}
+
+	// false when site and key are over their rate limit, which counts the
+	// call as suppressed. about once a second the writer thread logs how
+	// many calls each site had suppressed, as the site. key tells apart
+	// messages from one site, like vulkan's message ids, or is 0. past
+	// maxLimitedCount sites and keys calls aren't limited
+	bool checkLogRate(const LogSite& site, uint64_t key);
+
+	// for log calls that don't come from a LOG_ macro, in general
+	constexpr pstd::StaticArray<
+		LogSite,
+		cast<size_t>(LogLevel::count),
+		LogLevel>
+		LEVEL_LOG_SITES{ .data = { { .level = LogLevel::none },
+								   { .level = LogLevel::info },
+								   { .level = LogLevel::warn },
+								   { .level = LogLevel::error } } };
+
+	// how an argument is kept until it is formatted. integers are widened
+	// to 64 bits, the specifier picks how they are written
+	enum class LogArgType : uint8_t {
+		int64,
+		uint64,
+		float32,
+		float64,
+		string,
+
+		count,
+	};
+
+	struct LogArg {
+		union {
+			int64_t intVal;
+			uint64_t uintVal;
+			float floatVal;
+			double doubleVal;
+			pstd::String string;
+		};
+	};
 
-	void log(const LogLevel logLevel, const pstd::String& msg);
+	constexpr uint32_t MAX_LOG_ARGS{ 16 };
+
+	template<typename T>
+	consteval LogArgType getLogArgType() {
+		constexpr pstd::FormatArgKind argKind{ pstd::getFormatArgKind<T>() };
+		static_assert(
+			argKind != pstd::FormatArgKind::none,
+			"unsupported log argument type"
+		);
+
+		if constexpr (argKind == pstd::FormatArgKind::string) {
+			return LogArgType::string;
+		} else if constexpr (pstd::isSameType<T, float>) {
+			return LogArgType::float32;
+		} else if constexpr (argKind == pstd::FormatArgKind::decimal) {
+			return LogArgType::float64;
+		} else if constexpr (pstd::getIsUnsigned<T>()) {
+			return LogArgType::uint64;
+		}
+		return LogArgType::int64;
+	}
+
+	template<typename T>
+	void packLogArg(LogArg* pOut, T val) {
+		constexpr LogArgType argType{ getLogArgType<T>() };
+
+		if constexpr (argType == LogArgType::string) {
+			if constexpr (pstd::isSameType<T, pstd::String>) {
+				pOut->string = val;
+			} else {
+				pOut->string = pstd::createString(val);
+			}
+		} else if constexpr (argType == LogArgType::float32) {
+			pOut->floatVal = val;
+		} else if constexpr (argType == LogArgType::float64) {
+			pOut->doubleVal = val;
+		} else if constexpr (argType == LogArgType::uint64) {
+			pOut->uintVal = val;
+		} else {
+			pOut->intVal = val;
+		}
+	}
+
+	// format is the literal from the call, argTypes has one entry per
+	// argument. both are static, the record keeps the pointers. the filter
+	// is checked by the caller
+	void logRecord(
+		const LogSite& site,
+		const char* format,
+		const LogArgType* argTypes,
+		uint32_t argCount,
+		const LogArg* args
+	);
+
+	// the filter is checked by the caller, like the LOG_ macros do before
+	// they evaluate the arguments
+	template<typename... Args>
+	void log(
+		const LogSite& site,
+		pstd::FormatString<pstd::TypeIdentity<Args>...> format,
+		Args... args
+	) {
+		static_assert(
+			sizeof...(Args) <= MAX_LOG_ARGS, "too many log arguments"
+		);
+		static constexpr LogArgType ARG_TYPES[sizeof...(Args) + 1]{
+			getLogArgType<Args>()..., LogArgType::count
+		};
+
+		LogArg logArgs[sizeof...(Args) + 1];
+		uint32_t argIndex{};
+		((packLogArg(&logArgs[argIndex], args), argIndex++), ...);
+
+		logRecord(site, format.format, ARG_TYPES, sizeof...(Args), logArgs);
+	}
+
+	inline void log(const LogSite& site, const pstd::String& msg) {
+		log(site, "%m", msg);
+	}
+
+	inline void log(const LogLevel logLevel, const pstd::String& msg) {
+		if (isLogEnabled(LEVEL_LOG_SITES[logLevel])) {
+			log(LEVEL_LOG_SITES[logLevel], msg);
+		}
+	}
 
 	inline void log(const pstd::String& msg) {
 		log(LogLevel::none, msg);
@@ -31,74 +280,61 @@ namespace Console {
 	}
 
 	template<typename... Args>
-	void
-		log(const LogLevel logLevel, const pstd::String& format, Args... args) {
-		pstd::Arena logArena{ getLogArena() };
-		pstd::String formattedString{
-			pstd::formatString({ &logArena }, format, args...)
-		};
-		log(logLevel, formattedString);
+	void log(
+		const LogLevel logLevel,
+		pstd::FormatString<pstd::TypeIdentity<Args>...> format,
+		Args... args
+	) {
+		if (isLogEnabled(LEVEL_LOG_SITES[logLevel])) {
+			log(LEVEL_LOG_SITES[logLevel], format, args...);
+		}
 	}
 
 	template<typename... Args>
-	void log(const LogLevel logLevel, const char* format, Args... args) {
-		log(logLevel, pstd::createString(format), args...);
+	void log(
+		pstd::FormatString<pstd::TypeIdentity<Args>...> format, Args... args
+	) {
+		log(LogLevel::none, format, args...);
 	}
+}  // namespace Console
 
-	template<typename... Args>
-	void log(const pstd::String& format, Args... args) {
-		log(LogLevel::none, format, args...);
+using Console::LogLevel;
+
+// one static site per call, logCategory is a LogCategory name. arguments
+// are only evaluated when the call isn't filtered out
+#define LOG_AT_LEVEL(logCategory, logLevel, format, ...)                  \
+	{                                                                     \
+		static constexpr Console::LogSite logSite{                        \
+			.category = Console::LogCategory::logCategory,                \
+			.level = logLevel,                                            \
+			.file = __FILE__,                                             \
+			.line = __LINE__,                                             \
+		};                                                                \
+		if (Console::isLogEnabled(logSite)) {                             \
+			Console::log(logSite, format, ##__VA_ARGS__);                 \
+		}                                                                 \
 	}
 
-	template<typename... Args>
-	void log(const char* format, Args... args) {
-		log(LogLevel::none, format, args...);
+// like LOG_AT_LEVEL, for sources that can flood the log, see checkLogRate
+#define LOG_LIMITED(logCategory, logLevel, key, format, ...)              \
+	{                                                                     \
+		static constexpr Console::LogSite logSite{                        \
+			.category = Console::LogCategory::logCategory,                \
+			.level = logLevel,                                            \
+			.file = __FILE__,                                             \
+			.line = __LINE__,                                             \
+		};                                                                \
+		if (Console::isLogEnabled(logSite) &&                             \
+			Console::checkLogRate(logSite, key)) {                        \
+			Console::log(logSite, format, ##__VA_ARGS__);                 \
+		}                                                                 \
 	}
-}  // namespace Console
 
-using Console::LogLevel;
+#define LOG_INFO(category, format, ...) \
+	LOG_AT_LEVEL(category, Console::LogLevel::info, format, ##__VA_ARGS__)
 
-#ifdef LOG_LEVEL_INFO
-	#define LOG_INFO(format, ...)                \
-		{                                        \
-			Console::log(                        \
-				Console::LogLevel::info,         \
-				"[%m:%i] ",                      \
-				pstd::getFileName(__FILE__),     \
-				__LINE__                         \
-			);                                   \
-			Console::log(format, ##__VA_ARGS__); \
-		}
-#else
-	#define LOG_INFO(format, ...)
-#endif
-
-#ifdef LOG_LEVEL_WARN
-	#define LOG_WARN(format, ...)                \
-		{                                        \
-			Console::log(                        \
-				Console::LogLevel::warn,         \
-				"[%m:%i] ",                      \
-				pstd::getFileName(__FILE__),     \
-				__LINE__                         \
-			);                                   \
-			Console::log(format, ##__VA_ARGS__); \
-		}
-#else
-	#define LOG_WARN(format, ...)
-#endif
-
-#ifdef LOG_LEVEL_ERROR
-	#define LOG_ERROR(format, ...)               \
-		{                                        \
-			Console::log(                        \
-				Console::LogLevel::error,        \
-				"[%m:%i] ",                      \
-				pstd::getFileName(__FILE__),     \
-				__LINE__                         \
-			);                                   \
-			Console::log(format, ##__VA_ARGS__); \
-		}
-#else
-	#define LOG_ERROR(format, ...)
-#endif
+#define LOG_WARN(category, format, ...) \
+	LOG_AT_LEVEL(category, Console::LogLevel::warn, format, ##__VA_ARGS__)
+
+#define LOG_ERROR(category, format, ...) \
+	LOG_AT_LEVEL(category, Console::LogLevel::error, format, ##__VA_ARGS__)
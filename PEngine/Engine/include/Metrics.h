@@ -0,0 +1,131 @@
+#pragma once
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PString.h"
+
+// counters, gauges and histograms that any thread can bump. a counter or
+// histogram lives in a shard per thread, only the thread writes its shard
+// and shards don't share cache lines, so bumping one is a thread local
+// lookup and a store. a gauge is one value on a cache line of its own,
+// set or added to from anywhere, for things like how much an arena holds.
+//
+// with a path in the config a publisher thread adds the shards up every
+// publishIntervalMs and writes the totals into a file mapped in memory,
+// which another process can read while this one runs, see openSnapshot.
+// LogDecoder prints it.
+//
+// names are registered once and the ids bumped after. registering a name
+// again gets the same id. ids are invalid before startup and once the
+// metric table is full, and bumping an invalid id does nothing
+
+namespace Metrics {
+	enum class CounterId : uint32_t { invalid = 0 };
+	enum class GaugeId : uint32_t { invalid = 0 };
+	enum class HistogramId : uint32_t { invalid = 0 };
+
+	struct Config {
+		const char* path;  // null to not publish
+		uint32_t publishIntervalMs;
+		uint32_t maxCounterCount;
+		uint32_t maxGaugeCount;
+		uint32_t maxHistogramCount;	 // each takes 18KB per thread
+		uint32_t maxThreadCount;
+	};
+
+	constexpr Config DEFAULT_CONFIG{
+		.path = nullptr,
+		.publishIntervalMs = 100,
+		.maxCounterCount = 256,
+		.maxGaugeCount = 64,
+		.maxHistogramCount = 8,
+		.maxThreadCount = 16,
+	};
+
+	// false when the path was set and the file couldn't be mapped, the
+	// metrics still count then
+	bool startup(
+		pstd::AllocationRegistry* pAllocRegistry,
+		const Config& config = DEFAULT_CONFIG
+	);
+
+	// publishes one last time. threads must be done bumping
+	void shutdown(pstd::AllocationRegistry* pAllocRegistry);
+
+	// name is copied, only its first MAX_METRIC_NAME_SIZE letters are kept
+	CounterId registerCounter(const char* name);
+	GaugeId registerGauge(const char* name);
+	HistogramId registerHistogram(const char* name);
+
+	// a thread's shard goes to the next thread that bumps a metric once it
+	// exits. bumps from threads past maxThreadCount at once are left out
+	// and counted in the snapshot's droppedCount
+	void addToCounter(CounterId id, uint64_t delta = 1);
+
+	void setGauge(GaugeId id, int64_t value);
+	void addToGauge(GaugeId id, int64_t delta);
+
+	// a snapshot can miss the last few values a thread recorded
+	void recordValue(HistogramId id, uint64_t value);
+
+	// the total across threads right now
+	uint64_t readCounter(CounterId id);
+	int64_t readGauge(GaugeId id);
+
+	// the published file is a SnapshotHeader, maxMetricCount
+	// SnapshotMetrics of which the first metricCount are in use, and a
+	// copy of the sequence. the sequence and then the copy go up by one
+	// before a snapshot's metrics are written, and the copy and then the
+	// sequence again after, so a copy of the file made front to back whose
+	// sequence is even and matches the one at its end wasn't written while
+	// it was made
+	constexpr uint32_t METRICS_FILE_MAGIC{ 0x5254454D };  // METR
+	constexpr uint32_t METRICS_FILE_VERSION{ 2 };
+
+	constexpr uint32_t MAX_METRIC_NAME_SIZE{ 47 };
+
+	enum class MetricKind : uint32_t {
+		counter = 0,
+		gauge,
+		histogram,
+
+		count,
+	};
+
+	struct SnapshotHeader {
+		uint32_t magic;
+		uint32_t version;
+		uint64_t sequence;
+		uint64_t time;	// PTime ticks
+		uint64_t timeFrequency;
+		uint32_t metricCount;
+		uint32_t maxMetricCount;
+		uint64_t droppedCount;	// bumps from threads that got no shard
+	};
+
+	// value is a counter's total, a gauge's value as an int64_t or how many
+	// values a histogram has. the rest are a histogram's, see PHistogram.h
+	struct SnapshotMetric {
+		char name[MAX_METRIC_NAME_SIZE + 1];
+		MetricKind kind;
+		uint32_t reserved;
+		uint64_t value;
+		uint64_t mean;
+		uint64_t p50;
+		uint64_t p95;
+		uint64_t p99;
+		uint64_t maximum;
+	};
+
+	struct Snapshot {
+		pstd::String data;
+		SnapshotHeader header;
+	};
+
+	// data is a copy of the file. false when it isn't a snapshot of this
+	// version or was copied while a snapshot was being written
+	bool openSnapshot(const pstd::String& data, Snapshot* outSnapshot);
+
+	void readSnapshotMetric(
+		const Snapshot& snapshot, uint32_t index, SnapshotMetric* outMetric
+	);
+}  // namespace Metrics
@@ -0,0 +1,126 @@
+#pragma once
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PAtomic.h"
+#include "Core/PIntrinsics.h"
+
+// instrumented profiling. PROFILE_SCOPE("name") times the rest of the
+// enclosing block and PROFILE_FUNCTION() the enclosing function. a zone is
+// a cycle counter read at each end, kept in the calling thread's ring where
+// the newest zones replace the oldest. exportChromeTrace writes what the
+// rings hold as Chrome trace JSON, which chrome://tracing and the Perfetto
+// UI both open. zones that aren't inside another one on their thread also
+// go to the flight recorder.
+//
+// with hasPerfCounters set, each zone also counts the events in
+// pstd::PerfCounter that the platform has, read as it begins and ends, and
+// exportScopeCounters adds them up per scope name per frame. page faults
+// are only counted for the whole process, so the processPageFaults column
+// has the faults of every thread while the zone ran. the counters are
+// system calls on Windows, a zone costs a few hundred nanoseconds more
+// with them and what they count takes in half of those calls.
+//
+// the macros compile to nothing unless PROFILE_BUILD is defined. while the
+// profiler is off they cost a load and a branch, see setProfilerOn
+
+namespace Profiler {
+	struct Config {
+		uint32_t zonesPerThread;  // power of two
+		uint32_t maxThreadCount;
+		bool hasPerfCounters;
+	};
+
+	constexpr Config DEFAULT_CONFIG{
+		.zonesPerThread = 16 * 1024,
+		.maxThreadCount = 32,
+		.hasPerfCounters = false,
+	};
+
+	// zones nested deeper than this on their thread count no events
+	constexpr uint32_t MAX_COUNTED_DEPTH{ 32 };
+
+	// the profiler starts off
+	void startup(
+		pstd::AllocationRegistry* pAllocRegistry,
+		const Config& config = DEFAULT_CONFIG
+	);
+
+	// threads that profile must be done before this
+	void shutdown(pstd::AllocationRegistry* pAllocRegistry);
+
+	extern uint32_t g_IsProfilerOn;
+
+	inline bool isProfilerOn() {
+		return pstd::atomicLoad(&g_IsProfilerOn) != 0;
+	}
+
+	// scopes that began while the profiler was on still end in their zone.
+	// does nothing before startup
+	void setProfilerOn(bool isOn);
+
+	// false when the file can't be written. zones that threads replace
+	// while they are read are left out, so exporting while the profiler
+	// is on only loses the oldest ones
+	bool exportChromeTrace(
+		pstd::AllocationRegistry* pAllocRegistry, const char* path
+	);
+
+	// zones that end from now on are in frameIndex. does nothing before
+	// startup
+	void markFrame(uint64_t frameIndex);
+
+	// a line per frame, thread and scope name with how many zones of that
+	// name ended in the frame and their cycles added up, as CSV. the event
+	// counts are added up next to them with hasPerfCounters. false when the
+	// file can't be written
+	bool exportScopeCounters(
+		pstd::AllocationRegistry* pAllocRegistry, const char* path
+	);
+
+	struct ThreadZones;
+
+	// null when the thread table is full. a thread's ring goes to the next
+	// thread that profiles once it exits, the trace shows both as one
+	// thread
+	ThreadZones* beginZone();
+
+	void endZone(
+		ThreadZones* pThread, const char* name, uint64_t beginCycles
+	);
+
+	// name has to outlive the profiler
+	struct Scope {
+		ThreadZones* pThread;
+		const char* name;
+		uint64_t beginCycles;
+
+		explicit Scope(const char* zoneName)
+			: pThread{}, name{ zoneName }, beginCycles{} {
+			if (isProfilerOn()) {
+				pThread = beginZone();
+				beginCycles = pstd::readCycleCounter();
+			}
+		}
+
+		~Scope() {
+			if (pThread) {
+				endZone(pThread, name, beginCycles);
+			}
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	};
+}  // namespace Profiler
+
+#if defined(PROFILE_BUILD)
+	#define PROFILE_CONCAT_INNER(a, b) a##b
+	#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+	#define PROFILE_SCOPE(name) \
+		Profiler::Scope PROFILE_CONCAT(profileScope, __LINE__) { name }
+	#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#else
+	#define PROFILE_SCOPE(name)
+	#define PROFILE_FUNCTION()
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PFileIO.h"
+
+// a sampling profiler, for the code no PROFILE_SCOPE covers. a thread of
+// its own wakes every intervalMs, suspends each registered thread in turn,
+// walks its stack and resumes it. the walk goes through the modules loaded
+// at startup and the ones added, it stops at the first frame in any other.
+// addresses are turned into module and offset right away, so a module that
+// is unloaded and loaded again, like the game dll on a hot reload, keeps
+// the samples of each load apart as its own generation. stacks are counted
+// as they come in, the memory they take grows with the distinct stacks and
+// not with the time sampled.
+//
+// exportFoldedStacks writes them in the folded format flamegraph tools
+// read, a frame being module#generation+0xoffset. offsets are from the
+// module's base, so they can be symbolized offline against its pdb. the
+// interval can't be finer than the OS wait, which on Windows is 15.6 ms
+// unless the process raised the timer resolution
+
+namespace Sampler {
+	constexpr uint32_t MAX_FRAME_COUNT{ 64 };
+
+	struct Config {
+		uint32_t intervalMs;
+		uint32_t maxFrameCount;	 // at most MAX_FRAME_COUNT
+		uint32_t maxThreadCount;
+		uint32_t maxModuleCount;
+		uint32_t maxStackCount;	 // distinct stacks, later ones are dropped
+		uint32_t maxFrameTotal;	 // frames across the distinct stacks
+	};
+
+	constexpr Config DEFAULT_CONFIG{
+		.intervalMs = 1,
+		.maxFrameCount = MAX_FRAME_COUNT,
+		.maxThreadCount = 16,
+		.maxModuleCount = 32,
+		.maxStackCount = 16 * 1024,
+		.maxFrameTotal = 512 * 1024,
+	};
+
+	void startup(
+		pstd::AllocationRegistry* pAllocRegistry,
+		const Config& config = DEFAULT_CONFIG
+	);
+
+	// stops sampling. registered threads must have unregistered
+	void shutdown(pstd::AllocationRegistry* pAllocRegistry);
+
+	// the calling thread is sampled until it unregisters, which it has to do
+	// before it exits. both do nothing before startup
+	void registerThread();
+	void unregisterThread();
+
+	// name is copied, only its first 63 letters are kept. do nothing before
+	// startup, and removeModule has to come before the module is unloaded
+	void addModule(const char* name, pstd::DllHandle handle);
+	void removeModule(pstd::DllHandle handle);
+
+	// false when the file can't be written. sampling pauses while it runs
+	bool exportFoldedStacks(
+		pstd::AllocationRegistry* pAllocRegistry, const char* path
+	);
+}  // namespace Sampler
@@ -13,8 +13,8 @@ Arena pstd::allocateArena(AllocationRegistry* pAllocRegistry, size_t size) {
 }
 
 void pstd::freeArena(AllocationRegistry* pAllocRegistry, Arena* pArena) {
-	heapFree(pAllocRegistry, &pArena->block);
-	pArena = {};
+	heapFree(pAllocRegistry, pArena->block);
+	*pArena = {};
 }
 
 void* pstd::alloc(Arena* pArena, size_t size, uint32_t alignment) {
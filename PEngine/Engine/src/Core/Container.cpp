@@ -0,0 +1,273 @@
+#include "Core/PContainer.h"
+#include "Core/PIntrinsics.h"
+#include "Core/PTypes.h"
+#include "Core/PAssert.h"
+
+#include "Core/Lanes.h"
+
+using namespace pstd;
+
+namespace {
+	template<typename T, bool isMin>
+	T reduceExtreme(const T* data, size_t count);
+
+	template<typename T>
+	SumType<T> sumScalar(const T* data, size_t count) {
+		SumType<T> res{};
+		for (size_t i{}; i < count; i++) {
+			res += data[i];
+		}
+		return res;
+	}
+}  // namespace
+
+template<ArithmeticType T>
+bool pstd::find(const T* data, size_t count, const T val, size_t* outIndex) {
+	ASSERT(data || count == 0);
+
+	using L = Lanes<T>;
+	constexpr size_t stride{ L::width * 4 };
+
+	typename L::Register needle{ L::splat(val) };
+
+	size_t i{};
+	for (; i + stride <= count; i += stride) {
+		// one branch per 64 bytes, the exact lane is only resolved on a hit
+		typename L::Register eq0{ L::equal(L::load(data + i), needle) };
+		typename L::Register eq1{
+			L::equal(L::load(data + i + L::width), needle)
+		};
+		typename L::Register eq2{
+			L::equal(L::load(data + i + L::width * 2), needle)
+		};
+		typename L::Register eq3{
+			L::equal(L::load(data + i + L::width * 3), needle)
+		};
+		typename L::Register anyEq{
+			L::bitOr(L::bitOr(eq0, eq1), L::bitOr(eq2, eq3))
+		};
+		if (L::byteMask(anyEq) == 0) {
+			continue;
+		}
+
+		uint64_t mask{ ncast<uint64_t>(L::byteMask(eq0)) |
+					   (ncast<uint64_t>(L::byteMask(eq1)) << 16) |
+					   (ncast<uint64_t>(L::byteMask(eq2)) << 32) |
+					   (ncast<uint64_t>(L::byteMask(eq3)) << 48) };
+		if (outIndex) {
+			*outIndex = i + countTrailingZeros(mask) / sizeof(T);
+		}
+		return true;
+	}
+
+	for (; i + L::width <= count; i += L::width) {
+		uint32_t mask{ L::byteMask(L::equal(L::load(data + i), needle)) };
+		if (mask != 0) {
+			if (outIndex) {
+				*outIndex = i + countTrailingZeros(mask) / sizeof(T);
+			}
+			return true;
+		}
+	}
+
+	for (; i < count; i++) {
+		if (data[i] == val) {
+			if (outIndex) {
+				*outIndex = i;
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+
+template<ArithmeticType T>
+size_t pstd::count(const T* data, size_t count, const T val) {
+	ASSERT(data || count == 0);
+
+	using L = Lanes<T>;
+
+	typename L::Register needle{ L::splat(val) };
+	bool hasPopcnt{ getCpuFeatures().popcnt };
+
+	// every match sets sizeof(T) bits of the byte mask
+	size_t matchedBits{};
+	size_t i{};
+	for (; i + L::width * 2 <= count; i += L::width * 2) {
+		uint64_t mask{
+			ncast<uint64_t>(L::byteMask(L::equal(L::load(data + i), needle))) |
+			(ncast<uint64_t>(
+				 L::byteMask(L::equal(L::load(data + i + L::width), needle))
+			 )
+			 << 16)
+		};
+		matchedBits +=
+			hasPopcnt ? popCountInstruction(mask) : popCount(mask);
+	}
+
+	size_t res{ matchedBits / sizeof(T) };
+	for (; i < count; i++) {
+		res += data[i] == val;
+	}
+
+	return res;
+}
+
+template<ArithmeticType T>
+T pstd::calcMin(const T* data, size_t count) {
+	return reduceExtreme<T, true>(data, count);
+}
+
+template<ArithmeticType T>
+T pstd::calcMax(const T* data, size_t count) {
+	return reduceExtreme<T, false>(data, count);
+}
+
+template<ArithmeticType T>
+SumType<T> pstd::calcSum(const T* data, size_t count) {
+	ASSERT(data || count == 0);
+
+	size_t i{};
+	SumType<T> res{};
+	if constexpr (isSameType<T, float>) {
+		__m128 acc0{ _mm_setzero_ps() };
+		__m128 acc1{ _mm_setzero_ps() };
+		for (; i + 8 <= count; i += 8) {
+			acc0 = _mm_add_ps(acc0, _mm_loadu_ps(data + i));
+			acc1 = _mm_add_ps(acc1, _mm_loadu_ps(data + i + 4));
+		}
+		float lanes[4];
+		_mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+		res = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+	} else if constexpr (isSameType<T, double>) {
+		__m128d acc0{ _mm_setzero_pd() };
+		__m128d acc1{ _mm_setzero_pd() };
+		for (; i + 4 <= count; i += 4) {
+			acc0 = _mm_add_pd(acc0, _mm_loadu_pd(data + i));
+			acc1 = _mm_add_pd(acc1, _mm_loadu_pd(data + i + 2));
+		}
+		double lanes[2];
+		_mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+		res = lanes[0] + lanes[1];
+	} else {
+		// integers are widened to 64 bit lanes before they are accumulated,
+		// so the vector sum wraps exactly like the scalar 64 bit sum
+		__m128i acc{ _mm_setzero_si128() };
+		__m128i zero{ _mm_setzero_si128() };
+		constexpr size_t width{ 16 / sizeof(T) };
+		for (; i + width <= count; i += width) {
+			__m128i v{ _mm_loadu_si128(rcast<const __m128i*>(data + i)) };
+			if constexpr (sizeof(T) == 1) {
+				if constexpr (!getIsUnsigned<T>()) {
+					// bias into unsigned range, sad sums 8 bytes per half
+					v = _mm_xor_si128(v, _mm_set1_epi8(ncast<char>(0x80)));
+					acc = _mm_sub_epi64(acc, _mm_set1_epi64x(128 * 8));
+				}
+				acc = _mm_add_epi64(acc, _mm_sad_epu8(v, zero));
+			} else if constexpr (sizeof(T) == 2) {
+				__m128i sums32{};
+				if constexpr (getIsUnsigned<T>()) {
+					sums32 = _mm_add_epi32(
+						_mm_unpacklo_epi16(v, zero), _mm_unpackhi_epi16(v, zero)
+					);
+					acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(sums32, zero));
+					acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(sums32, zero));
+				} else {
+					sums32 = _mm_madd_epi16(v, _mm_set1_epi16(1));
+					__m128i sign{ _mm_srai_epi32(sums32, 31) };
+					acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(sums32, sign));
+					acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(sums32, sign));
+				}
+			} else if constexpr (sizeof(T) == 4) {
+				__m128i high{};
+				if constexpr (getIsUnsigned<T>()) {
+					high = zero;
+				} else {
+					high = _mm_srai_epi32(v, 31);
+				}
+				acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, high));
+				acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(v, high));
+			} else {
+				acc = _mm_add_epi64(acc, v);
+			}
+		}
+		SumType<T> lanes[2];
+		_mm_storeu_si128(rcast<__m128i*>(lanes), acc);
+		res = lanes[0] + lanes[1];
+	}
+
+	return res + sumScalar(data + i, count - i);
+}
+
+namespace {
+	template<typename T, bool isMin>
+	T reduceExtreme(const T* data, size_t count) {
+		ASSERT(data);
+		ASSERT(count > 0);
+
+		using L = Lanes<T>;
+
+		size_t i{};
+		T res{ data[0] };
+		if constexpr (L::hasLessThan) {
+			if (count >= L::width * 2) {
+				typename L::Register acc0{ L::load(data) };
+				typename L::Register acc1{ L::load(data + L::width) };
+				for (i = L::width * 2; i + L::width * 2 <= count;
+					 i += L::width * 2) {
+					typename L::Register v0{ L::load(data + i) };
+					typename L::Register v1{ L::load(data + i + L::width) };
+					if constexpr (isMin) {
+						acc0 = L::select(L::lessThan(v0, acc0), v0, acc0);
+						acc1 = L::select(L::lessThan(v1, acc1), v1, acc1);
+					} else {
+						acc0 = L::select(L::lessThan(acc0, v0), v0, acc0);
+						acc1 = L::select(L::lessThan(acc1, v1), v1, acc1);
+					}
+				}
+				if constexpr (isMin) {
+					acc0 = L::select(L::lessThan(acc1, acc0), acc1, acc0);
+				} else {
+					acc0 = L::select(L::lessThan(acc0, acc1), acc1, acc0);
+				}
+
+				T lanes[L::width];
+				L::store(lanes, acc0);
+				res = lanes[0];
+				for (size_t lane{ 1 }; lane < L::width; lane++) {
+					bool isBetter{ isMin ? lanes[lane] < res : res < lanes[lane] };
+					res = isBetter ? lanes[lane] : res;
+				}
+			}
+		}
+
+		for (; i < count; i++) {
+			bool isBetter{ isMin ? data[i] < res : res < data[i] };
+			res = isBetter ? data[i] : res;
+		}
+
+		return res;
+	}
+}  // namespace
+
+#define INSTANTIATE_CONTAINER_KERNELS(T)                                     \
+	template bool pstd::find(                                                \
+		const T* data, size_t count, const T val, size_t* outIndex           \
+	);                                                                       \
+	template size_t pstd::count(const T* data, size_t count, const T val);   \
+	template T pstd::calcMin(const T* data, size_t count);                   \
+	template T pstd::calcMax(const T* data, size_t count);                   \
+	template SumType<T> pstd::calcSum(const T* data, size_t count);
+
+INSTANTIATE_CONTAINER_KERNELS(char)
+INSTANTIATE_CONTAINER_KERNELS(int8_t)
+INSTANTIATE_CONTAINER_KERNELS(int16_t)
+INSTANTIATE_CONTAINER_KERNELS(int32_t)
+INSTANTIATE_CONTAINER_KERNELS(int64_t)
+INSTANTIATE_CONTAINER_KERNELS(uint8_t)
+INSTANTIATE_CONTAINER_KERNELS(uint16_t)
+INSTANTIATE_CONTAINER_KERNELS(uint32_t)
+INSTANTIATE_CONTAINER_KERNELS(uint64_t)
+INSTANTIATE_CONTAINER_KERNELS(float)
+INSTANTIATE_CONTAINER_KERNELS(double)
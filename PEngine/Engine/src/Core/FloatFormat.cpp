@@ -0,0 +1,354 @@
+#include "Core/PString.h"
+#include "Core/PIntrinsics.h"
+#include "Core/PMemory.h"
+#include "Core/PAssert.h"
+#include "Core/PTypes.h"
+
+#include "Core/FloatTables.h"
+
+using namespace pstd;
+
+// shortest round trip conversion after ryu (Ulf Adams, PLDI 2018). floats
+// and doubles share the 64 bit path, only the width of the rounding
+// interval depends on the type, so floats still get their own shortest
+// digits.
+
+namespace {
+	// the value is digits * 10^exponent
+	struct DecimalFloat {
+		uint64_t digits;
+		int32_t exponent;
+	};
+
+	DecimalFloat convertToDecimal(uint64_t m2, int32_t e2, bool hasNarrowLow);
+
+	uint32_t writeDecimal(char* dst, bool isNegative, DecimalFloat decimal);
+
+	uint32_t writeSpecial(char* dst, bool isNegative, bool isNan);
+
+	// ceil(log2(5^e)), exact for e in [0, 3528]
+	int32_t calcPow5Bits(int32_t e) {
+		return ncast<int32_t>((ncast<uint32_t>(e) * 1217359) >> 19) + 1;
+	}
+
+	// floor(log10(2^e)), exact for e in [0, 1650]
+	uint32_t calcLog10Pow2(int32_t e) {
+		return (ncast<uint32_t>(e) * 78913) >> 18;
+	}
+
+	// floor(log10(5^e)), exact for e in [0, 2620]
+	uint32_t calcLog10Pow5(int32_t e) {
+		return (ncast<uint32_t>(e) * 732923) >> 20;
+	}
+
+	uint32_t calcPow5Factor(uint64_t val) {
+		uint32_t count{};
+		while (val % 5 == 0) {
+			val /= 5;
+			count++;
+		}
+		return count;
+	}
+
+	bool isMultipleOfPow5(uint64_t val, uint32_t p) {
+		return calcPow5Factor(val) >= p;
+	}
+
+	bool isMultipleOfPow2(uint64_t val, uint32_t p) {
+		return (val & ((1ull << p) - 1)) == 0;
+	}
+
+	// (m * multiplier) >> shift, multiplier is 128 bits and shift > 64
+	uint64_t mulShift(uint64_t m, const uint64_t* multiplier, int32_t shift) {
+		uint64_t high0{};
+		multiply128(m, multiplier[0], &high0);
+		uint64_t high1{};
+		uint64_t low1{ multiply128(m, multiplier[1], &high1) };
+
+		uint64_t sum{ high0 + low1 };
+		high1 += sum < high0;
+		return shiftRight128(sum, high1, ncast<uint32_t>(shift - 64));
+	}
+}  // namespace
+
+uint32_t pstd::writeFloat(char* dst, float val) {
+	ASSERT(dst);
+
+	constexpr uint32_t mantissaBits{ 23 };
+	constexpr uint32_t exponentBits{ 8 };
+	constexpr int32_t bias{ 127 };
+
+	uint32_t bits{};
+	memCpy(&bits, &val, sizeof(bits));
+
+	bool isNegative{ (bits >> 31) != 0 };
+	uint32_t mantissa{ bits & ((1u << mantissaBits) - 1) };
+	uint32_t exponent{ (bits >> mantissaBits) & ((1u << exponentBits) - 1) };
+
+	if (exponent == (1u << exponentBits) - 1) {
+		return writeSpecial(dst, isNegative, mantissa != 0);
+	}
+	if (exponent == 0 && mantissa == 0) {
+		return writeDecimal(dst, isNegative, {});
+	}
+
+	// the 2 extra bits leave room for the interval bounds at 4m - 1 and
+	// 4m + 2
+	int32_t e2{};
+	uint64_t m2{};
+	if (exponent == 0) {
+		e2 = 1 - bias - mantissaBits - 2;
+		m2 = mantissa;
+	} else {
+		e2 = ncast<int32_t>(exponent) - bias - mantissaBits - 2;
+		m2 = (1ull << mantissaBits) | mantissa;
+	}
+	bool hasNarrowLow{ mantissa == 0 && exponent > 1 };
+
+	return writeDecimal(
+		dst, isNegative, convertToDecimal(m2, e2, hasNarrowLow)
+	);
+}
+
+uint32_t pstd::writeDouble(char* dst, double val) {
+	ASSERT(dst);
+
+	constexpr uint32_t mantissaBits{ 52 };
+	constexpr uint32_t exponentBits{ 11 };
+	constexpr int32_t bias{ 1023 };
+
+	uint64_t bits{};
+	memCpy(&bits, &val, sizeof(bits));
+
+	bool isNegative{ (bits >> 63) != 0 };
+	uint64_t mantissa{ bits & ((1ull << mantissaBits) - 1) };
+	auto exponent{
+		ncast<uint32_t>((bits >> mantissaBits) & ((1u << exponentBits) - 1))
+	};
+
+	if (exponent == (1u << exponentBits) - 1) {
+		return writeSpecial(dst, isNegative, mantissa != 0);
+	}
+	if (exponent == 0 && mantissa == 0) {
+		return writeDecimal(dst, isNegative, {});
+	}
+
+	int32_t e2{};
+	uint64_t m2{};
+	if (exponent == 0) {
+		e2 = 1 - bias - mantissaBits - 2;
+		m2 = mantissa;
+	} else {
+		e2 = ncast<int32_t>(exponent) - bias - mantissaBits - 2;
+		m2 = (1ull << mantissaBits) | mantissa;
+	}
+	bool hasNarrowLow{ mantissa == 0 && exponent > 1 };
+
+	return writeDecimal(
+		dst, isNegative, convertToDecimal(m2, e2, hasNarrowLow)
+	);
+}
+
+namespace {
+	// m2 * 2^e2 is 4x the value. hasNarrowLow is set for powers of two,
+	// where the gap to the next lower value is half the gap above
+	DecimalFloat convertToDecimal(uint64_t m2, int32_t e2, bool hasNarrowLow) {
+		bool isEven{ (m2 & 1) == 0 };
+		bool acceptBounds{ isEven };
+		uint64_t lowShift{ hasNarrowLow ? 0ull : 1ull };
+
+		uint64_t mv{ 4 * m2 };
+
+		// step 1: scale the interval [mm, mp] around mv by a power of 10
+		uint64_t vr{};
+		uint64_t vp{};
+		uint64_t vm{};
+		int32_t e10{};
+		bool vmIsTrailingZeros{};
+		bool vrIsTrailingZeros{};
+		if (e2 >= 0) {
+			uint32_t q{ calcLog10Pow2(e2) - (e2 > 3) };
+			e10 = ncast<int32_t>(q);
+			int32_t k{
+				POW5_INV_BIT_COUNT + calcPow5Bits(ncast<int32_t>(q)) - 1
+			};
+			int32_t i{ -e2 + ncast<int32_t>(q) + k };
+			vr = mulShift(4 * m2, POW5_INV_SPLIT[q], i);
+			vp = mulShift(4 * m2 + 2, POW5_INV_SPLIT[q], i);
+			vm = mulShift(4 * m2 - 1 - lowShift, POW5_INV_SPLIT[q], i);
+
+			if (q <= 21) {
+				// at most one of mp, mv and mm is a multiple of 5
+				if (mv % 5 == 0) {
+					vrIsTrailingZeros = isMultipleOfPow5(mv, q);
+				} else if (acceptBounds) {
+					vmIsTrailingZeros = isMultipleOfPow5(mv - 1 - lowShift, q);
+				} else {
+					vp -= isMultipleOfPow5(mv + 2, q);
+				}
+			}
+		} else {
+			uint32_t q{ calcLog10Pow5(-e2) - (-e2 > 1) };
+			e10 = ncast<int32_t>(q) + e2;
+			int32_t i{ -e2 - ncast<int32_t>(q) };
+			int32_t k{ calcPow5Bits(i) - POW5_BIT_COUNT };
+			int32_t j{ ncast<int32_t>(q) - k };
+			vr = mulShift(4 * m2, POW5_SPLIT[i], j);
+			vp = mulShift(4 * m2 + 2, POW5_SPLIT[i], j);
+			vm = mulShift(4 * m2 - 1 - lowShift, POW5_SPLIT[i], j);
+
+			if (q <= 1) {
+				// mv has at least q trailing zero bits, so vr is exact
+				vrIsTrailingZeros = true;
+				if (acceptBounds) {
+					vmIsTrailingZeros = lowShift == 1;
+				} else {
+					vp--;
+				}
+			} else if (q < 63) {
+				vrIsTrailingZeros = isMultipleOfPow2(mv, q);
+			}
+		}
+
+		// step 2: drop digits while the interval still holds a shorter
+		// number
+		int32_t removed{};
+		uint64_t lastRemovedDigit{};
+		uint64_t output{};
+		if (vmIsTrailingZeros || vrIsTrailingZeros) {
+			// rare, exact values and bounds need their zeros tracked
+			while (vp / 10 > vm / 10) {
+				vmIsTrailingZeros &= vm % 10 == 0;
+				vrIsTrailingZeros &= lastRemovedDigit == 0;
+				lastRemovedDigit = vr % 10;
+				vr /= 10;
+				vp /= 10;
+				vm /= 10;
+				removed++;
+			}
+			if (vmIsTrailingZeros) {
+				while (vm % 10 == 0) {
+					vrIsTrailingZeros &= lastRemovedDigit == 0;
+					lastRemovedDigit = vr % 10;
+					vr /= 10;
+					vp /= 10;
+					vm /= 10;
+					removed++;
+				}
+			}
+			if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0) {
+				// exactly halfway, round to even
+				lastRemovedDigit = 4;
+			}
+			bool isRoundingUp{ (vr == vm &&
+								(!acceptBounds || !vmIsTrailingZeros)) ||
+							   lastRemovedDigit >= 5 };
+			output = vr + isRoundingUp;
+		} else {
+			bool isRoundingUp{};
+			if (vp / 100 > vm / 100) {
+				isRoundingUp = vr % 100 >= 50;
+				vr /= 100;
+				vp /= 100;
+				vm /= 100;
+				removed += 2;
+			}
+			while (vp / 10 > vm / 10) {
+				isRoundingUp = vr % 10 >= 5;
+				vr /= 10;
+				vp /= 10;
+				vm /= 10;
+				removed++;
+			}
+			output = vr + (vr == vm || isRoundingUp);
+		}
+
+		return DecimalFloat{ .digits = output, .exponent = e10 + removed };
+	}
+
+	uint32_t writeDecimal(char* dst, bool isNegative, DecimalFloat decimal) {
+		char* pLetter{ dst };
+		if (isNegative) {
+			*pLetter = '-';
+			pLetter++;
+		}
+
+		char digits[MAX_INT64_CHARS];
+		auto digitCount{ ncast<int32_t>(writeUInt64(digits, decimal.digits)) };
+
+		// digits before the decimal point
+		int32_t pointPosition{ digitCount + decimal.exponent };
+		if (pointPosition > -4 && pointPosition <= 16) {
+			if (pointPosition <= 0) {
+				*pLetter = '0';
+				pLetter++;
+				*pLetter = '.';
+				pLetter++;
+				for (int32_t i{ pointPosition }; i < 0; i++) {
+					*pLetter = '0';
+					pLetter++;
+				}
+				memCpy(pLetter, digits, digitCount);
+				pLetter += digitCount;
+			} else if (pointPosition < digitCount) {
+				memCpy(pLetter, digits, pointPosition);
+				pLetter += pointPosition;
+				*pLetter = '.';
+				pLetter++;
+				int32_t fractionCount{ digitCount - pointPosition };
+				memCpy(pLetter, digits + pointPosition, fractionCount);
+				pLetter += fractionCount;
+			} else {
+				memCpy(pLetter, digits, digitCount);
+				pLetter += digitCount;
+				for (int32_t i{ digitCount }; i < pointPosition; i++) {
+					*pLetter = '0';
+					pLetter++;
+				}
+				*pLetter = '.';
+				pLetter++;
+				*pLetter = '0';
+				pLetter++;
+			}
+		} else {
+			*pLetter = digits[0];
+			pLetter++;
+			if (digitCount > 1) {
+				*pLetter = '.';
+				pLetter++;
+				memCpy(pLetter, digits + 1, digitCount - 1);
+				pLetter += digitCount - 1;
+			}
+
+			int32_t exponent{ pointPosition - 1 };
+			*pLetter = 'e';
+			pLetter++;
+			*pLetter = exponent < 0 ? '-' : '+';
+			pLetter++;
+			uint64_t exponentMagnitude{ ncast<uint64_t>(
+				exponent < 0 ? -exponent : exponent
+			) };
+			if (exponentMagnitude < 10) {
+				*pLetter = '0';
+				pLetter++;
+			}
+			pLetter += writeUInt64(pLetter, exponentMagnitude);
+		}
+
+		return ncast<uint32_t>(pLetter - dst);
+	}
+
+	uint32_t writeSpecial(char* dst, bool isNegative, bool isNan) {
+		char* pLetter{ dst };
+		if (isNan) {
+			memCpy(pLetter, "nan", 3);
+			return 3;
+		}
+		if (isNegative) {
+			*pLetter = '-';
+			pLetter++;
+		}
+		memCpy(pLetter, "inf", 3);
+		return ncast<uint32_t>(pLetter - dst) + 3;
+	}
+}  // namespace
@@ -0,0 +1,40 @@
+#include "Core/PGrid.h"
+#include "Core/PIntrinsics.h"
+#include "Core/PAssert.h"
+#include "Core/PTypes.h"
+
+void pstd::fillMortonOffsets(
+	uint32_t* offsets,
+	uint32_t count,
+	uint32_t axis,
+	const uint32_t* axisSizes,
+	uint32_t axisCount
+) {
+	ASSERT(offsets);
+	ASSERT(axis < axisCount);
+	ASSERT(count <= axisSizes[axis]);
+
+	// output bit of every input bit of this axis
+	uint32_t depositBits[32]{};
+	uint32_t axisBitCount{ calcLog2(axisSizes[axis]) };
+	uint32_t outBit{};
+	for (uint32_t bit{}; bit < axisBitCount; bit++) {
+		for (uint32_t i{}; i < axisCount; i++) {
+			if (bit >= calcLog2(axisSizes[i])) {
+				continue;
+			}
+			if (i == axis) {
+				depositBits[bit] = outBit;
+			}
+			outBit++;
+		}
+	}
+
+	for (uint32_t coord{}; coord < count; coord++) {
+		uint32_t offset{};
+		for (uint32_t bit{}; bit < axisBitCount; bit++) {
+			offset |= ((coord >> bit) & 1) << depositBits[bit];
+		}
+		offsets[coord] = offset;
+	}
+}
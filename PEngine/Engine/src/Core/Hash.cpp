@@ -0,0 +1,281 @@
+#include "Core/PHash.h"
+#include "Core/PIntrinsics.h"
+#include "Core/PAlgorithm.h"
+#include "Core/PMemory.h"
+#include "Core/PAssert.h"
+
+#include <nmmintrin.h>
+
+using namespace pstd;
+
+namespace {
+	constexpr uint64_t SECRETS[4]{
+		0x2D358DCCAA6C78A5ull,
+		0x8BB84B93962EACC9ull,
+		0x4B33A62ED433D4A3ull,
+		0x4D5A2DA51DE1AA47ull,
+	};
+
+	// both halves of the product, a gets the low one
+	void multiplyInPlace(uint64_t* a, uint64_t* b) {
+		*a = multiply128(*a, *b, b);
+	}
+
+	uint64_t mix(uint64_t a, uint64_t b) {
+		uint64_t high{};
+		uint64_t low{ multiply128(a, b, &high) };
+		return low ^ high;
+	}
+
+	uint64_t loadShort(const uint8_t* data, size_t size) {
+		return (ncast<uint64_t>(data[0]) << 16) |
+			(ncast<uint64_t>(data[size >> 1]) << 8) | data[size - 1];
+	}
+
+	uint64_t mixSeed(uint64_t seed) {
+		return seed ^ mix(seed ^ SECRETS[0], SECRETS[1]);
+	}
+
+	void consumeBlock(uint64_t* lanes, const uint8_t* data) {
+		lanes[0] = mix(
+			loadUInt64(data) ^ SECRETS[1], loadUInt64(data + 8) ^ lanes[0]
+		);
+		lanes[1] = mix(
+			loadUInt64(data + 16) ^ SECRETS[2], loadUInt64(data + 24) ^ lanes[1]
+		);
+		lanes[2] = mix(
+			loadUInt64(data + 32) ^ SECRETS[3], loadUInt64(data + 40) ^ lanes[2]
+		);
+	}
+
+	// tail is the last 1 to 48 bytes, or every byte when there were no
+	// blocks. past the first 16 bytes the 16 in front of tail are readable
+	Hash128 finish(
+		const uint64_t* lanes,
+		const uint8_t* tail,
+		size_t tailSize,
+		uint64_t totalSize,
+		bool isWide
+	);
+
+	struct CrcTables {
+		uint32_t entries[8][256];
+	};
+
+	// entries[k][i] is the crc of byte i followed by k zero bytes, so 8
+	// lookups fold 8 bytes at once
+	constexpr CrcTables makeCrcTables() {
+		constexpr uint32_t polynomial{ 0x82F63B78 };
+
+		CrcTables tables{};
+		for (uint32_t i{}; i < 256; i++) {
+			uint32_t crc{ i };
+			for (uint32_t bit{}; bit < 8; bit++) {
+				crc = (crc >> 1) ^ (polynomial & (0 - (crc & 1)));
+			}
+			tables.entries[0][i] = crc;
+		}
+		for (uint32_t k{ 1 }; k < 8; k++) {
+			for (uint32_t i{}; i < 256; i++) {
+				uint32_t previous{ tables.entries[k - 1][i] };
+				tables.entries[k][i] =
+					(previous >> 8) ^ tables.entries[0][previous & 0xFF];
+			}
+		}
+		return tables;
+	}
+
+	constexpr CrcTables g_CrcTables{ makeCrcTables() };
+
+	Hash128 hashBytes(
+		const uint8_t* data, size_t size, uint64_t seed, bool isWide
+	);
+
+	uint32_t
+		calcCrc32cHardware(const uint8_t* data, size_t size, uint32_t crc);
+	uint32_t calcCrc32cTable(const uint8_t* data, size_t size, uint32_t crc);
+}  // namespace
+
+uint64_t pstd::calcHash64(const void* data, size_t size, uint64_t seed) {
+	ASSERT(data || size == 0);
+
+	return hashBytes(rcast<const uint8_t*>(data), size, seed, false).low;
+}
+
+Hash128 pstd::calcHash128(const void* data, size_t size, uint64_t seed) {
+	ASSERT(data || size == 0);
+
+	return hashBytes(rcast<const uint8_t*>(data), size, seed, true);
+}
+
+HashState pstd::createHashState(uint64_t seed) {
+	uint64_t mixedSeed{ mixSeed(seed) };
+	return HashState{ .lanes = { mixedSeed, mixedSeed, mixedSeed } };
+}
+
+void pstd::updateHash(HashState* pState, const void* data, size_t size) {
+	ASSERT(pState);
+	ASSERT(data || size == 0);
+
+	auto* bytes{ rcast<const uint8_t*>(data) };
+	uint8_t* pending{ pState->buffer + 16 };
+	pState->totalSize += size;
+
+	// a full block is only consumed once more bytes follow it, the one
+	// shot hash keeps the last block for its finish too
+	while (size > 0) {
+		if (pState->pendingSize == HASH_BLOCK_SIZE) {
+			consumeBlock(pState->lanes, pending);
+			memCpy(pState->buffer, pending + HASH_BLOCK_SIZE - 16, 16);
+			pState->pendingSize = 0;
+		}
+
+		if (pState->pendingSize == 0 && size > HASH_BLOCK_SIZE) {
+			while (size > HASH_BLOCK_SIZE) {
+				consumeBlock(pState->lanes, bytes);
+				bytes += HASH_BLOCK_SIZE;
+				size -= HASH_BLOCK_SIZE;
+			}
+			memCpy(pState->buffer, bytes - 16, 16);
+		}
+
+		size_t copySize{ min(HASH_BLOCK_SIZE - pState->pendingSize, size) };
+		memCpy(pending + pState->pendingSize, bytes, copySize);
+		pState->pendingSize += ncast<uint32_t>(copySize);
+		bytes += copySize;
+		size -= copySize;
+	}
+}
+
+uint64_t pstd::finishHash64(const HashState& state) {
+	Hash128 res{ finish(
+		state.lanes,
+		state.buffer + 16,
+		state.pendingSize,
+		state.totalSize,
+		false
+	) };
+	return res.low;
+}
+
+Hash128 pstd::finishHash128(const HashState& state) {
+	return finish(
+		state.lanes, state.buffer + 16, state.pendingSize, state.totalSize, true
+	);
+}
+
+uint32_t pstd::calcCrc32c(const void* data, size_t size, uint32_t crc) {
+	ASSERT(data || size == 0);
+
+	auto* bytes{ rcast<const uint8_t*>(data) };
+	crc = ~crc;
+	if (getCpuFeatures().sse42) {
+		crc = calcCrc32cHardware(bytes, size, crc);
+	} else {
+		crc = calcCrc32cTable(bytes, size, crc);
+	}
+	return ~crc;
+}
+
+namespace {
+	Hash128 hashBytes(
+		const uint8_t* data, size_t size, uint64_t seed, bool isWide
+	) {
+		uint64_t mixedSeed{ mixSeed(seed) };
+		uint64_t lanes[3]{ mixedSeed, mixedSeed, mixedSeed };
+
+		size_t remaining{ size };
+		while (remaining > HASH_BLOCK_SIZE) {
+			consumeBlock(lanes, data);
+			data += HASH_BLOCK_SIZE;
+			remaining -= HASH_BLOCK_SIZE;
+		}
+
+		return finish(lanes, data, remaining, size, isWide);
+	}
+
+	Hash128 finish(
+		const uint64_t* lanes,
+		const uint8_t* tail,
+		size_t tailSize,
+		uint64_t totalSize,
+		bool isWide
+	) {
+		uint64_t seed{ lanes[0] };
+		uint64_t highLane{};
+		if (totalSize > HASH_BLOCK_SIZE) {
+			seed ^= lanes[1] ^ lanes[2];
+			if (isWide) {
+				highLane = mix(lanes[1] ^ SECRETS[2], lanes[2] ^ SECRETS[3]);
+			}
+		}
+
+		uint64_t a{};
+		uint64_t b{};
+		if (totalSize <= 16) {
+			if (totalSize >= 4) {
+				size_t offset{ (totalSize >> 3) << 2 };
+				a = (ncast<uint64_t>(loadUInt32(tail)) << 32) |
+					loadUInt32(tail + offset);
+				b = (ncast<uint64_t>(loadUInt32(tail + totalSize - 4)) << 32) |
+					loadUInt32(tail + totalSize - 4 - offset);
+			} else if (totalSize > 0) {
+				a = loadShort(tail, totalSize);
+			}
+		} else {
+			while (tailSize > 16) {
+				seed = mix(
+					loadUInt64(tail) ^ SECRETS[1], loadUInt64(tail + 8) ^ seed
+				);
+				tail += 16;
+				tailSize -= 16;
+			}
+			a = loadUInt64(tail + tailSize - 16);
+			b = loadUInt64(tail + tailSize - 8);
+		}
+
+		a ^= SECRETS[1];
+		b ^= seed;
+		multiplyInPlace(&a, &b);
+
+		Hash128 res{ .low = mix(a ^ SECRETS[0] ^ totalSize, b ^ SECRETS[1]) };
+		if (isWide) {
+			res.high =
+				mix(a ^ SECRETS[2] ^ totalSize, b ^ SECRETS[3] ^ highLane);
+		}
+		return res;
+	}
+
+	uint32_t
+		calcCrc32cHardware(const uint8_t* data, size_t size, uint32_t crc) {
+		uint64_t wideCrc{ crc };
+		size_t i{};
+		for (; i + 8 <= size; i += 8) {
+			wideCrc = _mm_crc32_u64(wideCrc, loadUInt64(data + i));
+		}
+		crc = ncast<uint32_t>(wideCrc);
+		for (; i < size; i++) {
+			crc = _mm_crc32_u8(crc, data[i]);
+		}
+		return crc;
+	}
+
+	uint32_t calcCrc32cTable(const uint8_t* data, size_t size, uint32_t crc) {
+		const auto& entries{ g_CrcTables.entries };
+
+		size_t i{};
+		for (; i + 8 <= size; i += 8) {
+			uint64_t val{ loadUInt64(data + i) ^ crc };
+			crc = entries[7][val & 0xFF] ^ entries[6][(val >> 8) & 0xFF] ^
+				entries[5][(val >> 16) & 0xFF] ^
+				entries[4][(val >> 24) & 0xFF] ^
+				entries[3][(val >> 32) & 0xFF] ^
+				entries[2][(val >> 40) & 0xFF] ^
+				entries[1][(val >> 48) & 0xFF] ^ entries[0][val >> 56];
+		}
+		for (; i < size; i++) {
+			crc = (crc >> 8) ^ entries[0][(crc ^ data[i]) & 0xFF];
+		}
+		return crc;
+	}
+}  // namespace
@@ -0,0 +1,135 @@
+#include "Core/PHistogram.h"
+#include "Core/PIntrinsics.h"
+#include "Core/PAlgorithm.h"
+#include "Core/PAssert.h"
+
+using namespace pstd;
+
+namespace {
+	uint32_t calcBucketIndex(uint64_t value);
+
+	// the largest value that lands in the bucket
+	uint64_t calcBucketMax(uint32_t bucketIndex);
+}  // namespace
+
+void pstd::addValue(Histogram* pHistogram, uint64_t value) {
+	ASSERT(pHistogram);
+
+	value = min(value, HISTOGRAM_MAX_VALUE);
+	uint32_t bucketIndex{ calcBucketIndex(value) };
+	pHistogram->counts[bucketIndex]++;
+	pHistogram->octaveCounts[bucketIndex >> HISTOGRAM_SUB_BUCKET_BITS]++;
+	pHistogram->totalCount++;
+	pHistogram->totalValue += value;
+}
+
+void pstd::removeValue(Histogram* pHistogram, uint64_t value) {
+	ASSERT(pHistogram);
+
+	value = min(value, HISTOGRAM_MAX_VALUE);
+	uint32_t bucketIndex{ calcBucketIndex(value) };
+	ASSERT(pHistogram->counts[bucketIndex] > 0);
+	pHistogram->counts[bucketIndex]--;
+	pHistogram->octaveCounts[bucketIndex >> HISTOGRAM_SUB_BUCKET_BITS]--;
+	pHistogram->totalCount--;
+	pHistogram->totalValue -= value;
+}
+
+void pstd::mergeHistogram(Histogram* pDst, const Histogram& src) {
+	ASSERT(pDst);
+
+	for (uint32_t i{}; i < HISTOGRAM_OCTAVE_COUNT; i++) {
+		if (src.octaveCounts[i] == 0) {
+			continue;
+		}
+
+		pDst->octaveCounts[i] += src.octaveCounts[i];
+		uint32_t firstBucket{ i << HISTOGRAM_SUB_BUCKET_BITS };
+		for (uint32_t j{}; j < HISTOGRAM_SUB_BUCKET_COUNT; j++) {
+			pDst->counts[firstBucket + j] += src.counts[firstBucket + j];
+		}
+	}
+	pDst->totalCount += src.totalCount;
+	pDst->totalValue += src.totalValue;
+}
+
+uint64_t pstd::calcPercentile(const Histogram& histogram, double percentile) {
+	// the rank comes from the buckets' own counts rather than totalCount,
+	// so a histogram whose totalCount has run ahead of its buckets, copied
+	// while it was being added to say, can't send the walk past the end
+	uint64_t bucketedCount{};
+	for (uint64_t octaveCount : histogram.octaveCounts) {
+		bucketedCount += octaveCount;
+	}
+	if (bucketedCount == 0) {
+		return 0;
+	}
+
+	// the rank of the value at the percentile counting from 1, rounded up
+	double clamped{ max(min(percentile, 100.0), 0.0) };
+	double exactRank{ clamped / 100.0 * ncast<double>(bucketedCount) };
+	auto rank{ ncast<uint64_t>(exactRank) };
+	if (ncast<double>(rank) < exactRank) {
+		rank++;
+	}
+	rank = max(min(rank, bucketedCount), 1ull);
+
+	uint64_t count{};
+	uint32_t octave{};
+	while (octave + 1 < HISTOGRAM_OCTAVE_COUNT &&
+		   count + histogram.octaveCounts[octave] < rank) {
+		count += histogram.octaveCounts[octave];
+		octave++;
+	}
+
+	// the buckets can disagree with their octave's count the same way
+	uint32_t bucketIndex{ octave << HISTOGRAM_SUB_BUCKET_BITS };
+	uint32_t lastBucketIndex{ bucketIndex + HISTOGRAM_SUB_BUCKET_COUNT - 1 };
+	while (bucketIndex < lastBucketIndex &&
+		   count + histogram.counts[bucketIndex] < rank) {
+		count += histogram.counts[bucketIndex];
+		bucketIndex++;
+	}
+
+	return calcBucketMax(bucketIndex);
+}
+
+uint64_t pstd::calcMean(const Histogram& histogram) {
+	if (histogram.totalCount == 0) {
+		return 0;
+	}
+
+	return histogram.totalValue / histogram.totalCount;
+}
+
+namespace {
+	// octave 0 holds the values below HISTOGRAM_SUB_BUCKET_COUNT one per
+	// bucket. above them octave n holds the power of two from
+	// 2^(n - 1 + HISTOGRAM_SUB_BUCKET_BITS), whose buckets are 2^(n - 1)
+	// values wide
+	uint32_t calcBucketIndex(uint64_t value) {
+		if (value < HISTOGRAM_SUB_BUCKET_COUNT) {
+			return ncast<uint32_t>(value);
+		}
+
+		uint32_t shift{ 63 - countLeadingZeros(value) -
+						HISTOGRAM_SUB_BUCKET_BITS };
+		auto subBucket{ ncast<uint32_t>(value >> shift) -
+						HISTOGRAM_SUB_BUCKET_COUNT };
+		return ((shift + 1) << HISTOGRAM_SUB_BUCKET_BITS) + subBucket;
+	}
+
+	uint64_t calcBucketMax(uint32_t bucketIndex) {
+		uint32_t octave{ bucketIndex >> HISTOGRAM_SUB_BUCKET_BITS };
+		uint32_t subBucket{ bucketIndex & (HISTOGRAM_SUB_BUCKET_COUNT - 1) };
+		if (octave == 0) {
+			return subBucket;
+		}
+
+		uint32_t shift{ octave - 1 };
+		uint64_t bucketMin{
+			ncast<uint64_t>(subBucket + HISTOGRAM_SUB_BUCKET_COUNT) << shift
+		};
+		return bucketMin + (1ull << shift) - 1;
+	}
+}  // namespace
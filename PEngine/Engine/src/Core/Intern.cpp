@@ -0,0 +1,153 @@
+#include "Core/PIntern.h"
+#include "Core/PIntrinsics.h"
+#include "Core/PArena.h"
+#include "Core/PMemory.h"
+#include "Core/PAssert.h"
+
+using namespace pstd;
+
+namespace {
+	StringInterner g_StringInterner{};
+
+	constexpr uint64_t SLOT_ID_MASK{ 0xFFFFFFFFull };
+
+	uint64_t makeSlot(uint64_t hash, StringId id) {
+		return (hash & ~SLOT_ID_MASK) | ncast<uint32_t>(id);
+	}
+
+	StringId findInSlots(
+		const StringInterner& interner,
+		const HashedString& string,
+		uint32_t* outSlotIndex
+	);
+}  // namespace
+
+StringInterner pstd::createStringInterner(
+	AllocationRegistry* pAllocRegistry, size_t textSize, uint32_t maxCount
+) {
+	ASSERT(pAllocRegistry);
+	ASSERT(maxCount > 0);
+
+	// at most half full, so probe sequences stay short
+	auto slotCount{ ncast<uint32_t>(calcNextPowerOfTwo(maxCount * 2ull)) };
+	size_t tableSize{ maxCount * sizeof(String) + slotCount * sizeof(uint64_t) +
+					  alignof(uint64_t) };
+
+	StringInterner res{
+		.textArena = allocateArena(pAllocRegistry, textSize + tableSize),
+		.slotMask = slotCount - 1,
+		.maxCount = maxCount,
+	};
+	res.strings = alloc<String>(&res.textArena, maxCount);
+	res.slots = alloc<uint64_t>(&res.textArena, slotCount);
+	memZero(res.slots, slotCount * sizeof(uint64_t));
+
+	return res;
+}
+
+void pstd::destroyStringInterner(
+	AllocationRegistry* pAllocRegistry, StringInterner* pInterner
+) {
+	ASSERT(pAllocRegistry);
+	ASSERT(pInterner);
+
+	freeArena(pAllocRegistry, &pInterner->textArena);
+	*pInterner = {};
+}
+
+StringId
+	pstd::internString(StringInterner* pInterner, const HashedString& string) {
+	ASSERT(pInterner);
+	ASSERT(pInterner->slots);
+
+	lockShared(&pInterner->mutex);
+	uint32_t slotIndex{};
+	StringId id{ findInSlots(*pInterner, string, &slotIndex) };
+	unlockShared(&pInterner->mutex);
+	if (id != StringId::invalid) {
+		return id;
+	}
+
+	lockExclusive(&pInterner->mutex);
+
+	// another thread may have added it between the two locks
+	id = findInSlots(*pInterner, string, &slotIndex);
+	uint32_t size{ string.string.size };
+	bool isFull{ pInterner->count == pInterner->maxCount ||
+				 getAvailableCount<char>(pInterner->textArena) <= size };
+	if (id == StringId::invalid && !isFull) {
+		char* text{ alloc<char>(&pInterner->textArena, size + 1) };
+		memCpy(text, string.string.buffer, size);
+		text[size] = '\0';
+
+		pInterner->strings[pInterner->count] =
+			String{ .buffer = text, .size = size };
+		pInterner->count++;
+
+		id = StringId{ pInterner->count };
+		pInterner->slots[slotIndex] = makeSlot(string.hash, id);
+	}
+
+	unlockExclusive(&pInterner->mutex);
+	return id;
+}
+
+StringId
+	pstd::findStringId(StringInterner* pInterner, const HashedString& string) {
+	ASSERT(pInterner);
+	ASSERT(pInterner->slots);
+
+	lockShared(&pInterner->mutex);
+	uint32_t slotIndex{};
+	StringId id{ findInSlots(*pInterner, string, &slotIndex) };
+	unlockShared(&pInterner->mutex);
+
+	return id;
+}
+
+void pstd::startupStringInterner(
+	AllocationRegistry* pAllocRegistry, size_t textSize, uint32_t maxCount
+) {
+	ASSERT(!g_StringInterner.slots);
+
+	g_StringInterner = createStringInterner(pAllocRegistry, textSize, maxCount);
+}
+
+void pstd::shutdownStringInterner(AllocationRegistry* pAllocRegistry) {
+	destroyStringInterner(pAllocRegistry, &g_StringInterner);
+}
+
+StringInterner* pstd::getStringInterner() {
+	ASSERT(g_StringInterner.slots);
+
+	return &g_StringInterner;
+}
+
+namespace {
+	// the id at the string's slot, or StringId::invalid and the empty slot
+	// it would go in
+	StringId findInSlots(
+		const StringInterner& interner,
+		const HashedString& string,
+		uint32_t* outSlotIndex
+	) {
+		uint64_t hashHigh{ string.hash & ~SLOT_ID_MASK };
+		uint32_t slotIndex{ ncast<uint32_t>(string.hash) & interner.slotMask };
+		while (true) {
+			uint64_t slot{ interner.slots[slotIndex] };
+			if (slot == 0) {
+				*outSlotIndex = slotIndex;
+				return StringId::invalid;
+			}
+
+			auto id{ StringId{ ncast<uint32_t>(slot & SLOT_ID_MASK) } };
+			if ((slot & ~SLOT_ID_MASK) == hashHigh &&
+				stringsMatch(getInternedString(interner, id), string.string)) {
+				*outSlotIndex = slotIndex;
+				return id;
+			}
+
+			slotIndex = (slotIndex + 1) & interner.slotMask;
+		}
+	}
+}  // namespace
@@ -0,0 +1,49 @@
+#include "Core/PIntrinsics.h"
+
+namespace {
+	// no function local static, thread safe statics need the crt
+	pstd::CpuFeatures g_CpuFeatures{};
+	bool g_CpuFeaturesQueried{};
+
+	void queryCpuid(uint32_t leaf, uint32_t subleaf, uint32_t* outRegisters) {
+#if defined(_MSC_VER)
+		int registers[4]{};
+		__cpuidex(registers, ncast<int>(leaf), ncast<int>(subleaf));
+		for (uint32_t i{}; i < 4; i++) {
+			outRegisters[i] = ncast<uint32_t>(registers[i]);
+		}
+#else
+		__asm__ __volatile__("cpuid"
+							 : "=a"(outRegisters[0]),
+							   "=b"(outRegisters[1]),
+							   "=c"(outRegisters[2]),
+							   "=d"(outRegisters[3])
+							 : "a"(leaf), "c"(subleaf));
+#endif
+	}
+}  // namespace
+
+const pstd::CpuFeatures& pstd::getCpuFeatures() {
+	if (g_CpuFeaturesQueried) {
+		return g_CpuFeatures;
+	}
+
+	// eax, ebx, ecx, edx
+	uint32_t registers[4]{};
+	queryCpuid(0, 0, registers);
+	uint32_t maxLeaf{ registers[0] };
+
+	CpuFeatures features{};
+	if (maxLeaf >= 1) {
+		queryCpuid(1, 0, registers);
+		features.ssse3 = (registers[2] >> 9) & 1;
+		features.sse42 = (registers[2] >> 20) & 1;
+		features.popcnt = (registers[2] >> 23) & 1;
+	}
+
+	// racing threads compute the same value, so the write is benign
+	g_CpuFeatures = features;
+	g_CpuFeaturesQueried = true;
+
+	return g_CpuFeatures;
+}
@@ -0,0 +1,202 @@
+#pragma once
+#include "Core/PTypes.h"
+
+#include <emmintrin.h>
+
+namespace pstd {
+	// every kernel works on 128 bit registers, sse2 is the x64 baseline so
+	// no runtime dispatch is needed. Lanes<T> hides the per type intrinsics
+	template<typename T>
+	struct Lanes;
+
+	template<typename T>
+	struct IntegerLanes {
+		using Register = __m128i;
+		static constexpr size_t width{ 16 / sizeof(T) };
+		static constexpr bool hasLessThan{ sizeof(T) < 8 };
+
+		static Register load(const T* data) {
+			return _mm_loadu_si128(rcast<const __m128i*>(data));
+		}
+
+		static void store(T* dst, Register a) {
+			_mm_storeu_si128(rcast<__m128i*>(dst), a);
+		}
+
+		static Register splat(T val) {
+			if constexpr (sizeof(T) == 1) {
+				return _mm_set1_epi8(ncast<char>(val));
+			} else if constexpr (sizeof(T) == 2) {
+				return _mm_set1_epi16(ncast<short>(val));
+			} else if constexpr (sizeof(T) == 4) {
+				return _mm_set1_epi32(ncast<int>(val));
+			} else {
+				return _mm_set1_epi64x(ncast<long long>(val));
+			}
+		}
+
+		static Register add(Register a, Register b) {
+			if constexpr (sizeof(T) == 1) {
+				return _mm_add_epi8(a, b);
+			} else if constexpr (sizeof(T) == 2) {
+				return _mm_add_epi16(a, b);
+			} else if constexpr (sizeof(T) == 4) {
+				return _mm_add_epi32(a, b);
+			} else {
+				return _mm_add_epi64(a, b);
+			}
+		}
+
+		// moves every lane up by laneCount, filling the bottom with zeros
+		template<uint32_t laneCount>
+		static Register shiftLanesUp(Register a) {
+			return _mm_slli_si128(a, laneCount * sizeof(T));
+		}
+
+		static T getLastLane(Register a) {
+			T lanes[width];
+			store(lanes, a);
+			return lanes[width - 1];
+		}
+
+		static Register equal(Register a, Register b) {
+			if constexpr (sizeof(T) == 1) {
+				return _mm_cmpeq_epi8(a, b);
+			} else if constexpr (sizeof(T) == 2) {
+				return _mm_cmpeq_epi16(a, b);
+			} else if constexpr (sizeof(T) == 4) {
+				return _mm_cmpeq_epi32(a, b);
+			} else {
+				// sse2 has no 64 bit compare, both 32 bit halves must match
+				__m128i halves{ _mm_cmpeq_epi32(a, b) };
+				__m128i swapped{
+					_mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1))
+				};
+				return _mm_and_si128(halves, swapped);
+			}
+		}
+
+		static Register lessThan(Register a, Register b) {
+			static_assert(hasLessThan);
+			if constexpr (getIsUnsigned<T>()) {
+				// flipping the sign bit maps unsigned order onto signed order
+				Register bias{ splat(ncast<T>(T{ 1 } << (sizeof(T) * 8 - 1))) };
+				a = _mm_xor_si128(a, bias);
+				b = _mm_xor_si128(b, bias);
+			}
+			if constexpr (sizeof(T) == 1) {
+				return _mm_cmplt_epi8(a, b);
+			} else if constexpr (sizeof(T) == 2) {
+				return _mm_cmplt_epi16(a, b);
+			} else {
+				return _mm_cmplt_epi32(a, b);
+			}
+		}
+
+		static Register select(Register mask, Register a, Register b) {
+			return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+		}
+
+		static Register bitOr(Register a, Register b) {
+			return _mm_or_si128(a, b);
+		}
+
+		// one bit per byte
+		static uint32_t byteMask(Register mask) {
+			return ncast<uint32_t>(_mm_movemask_epi8(mask));
+		}
+	};
+
+	template<>
+	struct Lanes<char> : IntegerLanes<char> {};
+	template<>
+	struct Lanes<int8_t> : IntegerLanes<int8_t> {};
+	template<>
+	struct Lanes<int16_t> : IntegerLanes<int16_t> {};
+	template<>
+	struct Lanes<int32_t> : IntegerLanes<int32_t> {};
+	template<>
+	struct Lanes<int64_t> : IntegerLanes<int64_t> {};
+	template<>
+	struct Lanes<uint8_t> : IntegerLanes<uint8_t> {};
+	template<>
+	struct Lanes<uint16_t> : IntegerLanes<uint16_t> {};
+	template<>
+	struct Lanes<uint32_t> : IntegerLanes<uint32_t> {};
+	template<>
+	struct Lanes<uint64_t> : IntegerLanes<uint64_t> {};
+
+	template<>
+	struct Lanes<float> {
+		using Register = __m128;
+		static constexpr size_t width{ 4 };
+		static constexpr bool hasLessThan{ true };
+
+		static Register load(const float* data) { return _mm_loadu_ps(data); }
+		static void store(float* dst, Register a) { _mm_storeu_ps(dst, a); }
+		static Register splat(float val) { return _mm_set1_ps(val); }
+		static Register add(Register a, Register b) { return _mm_add_ps(a, b); }
+
+		template<uint32_t laneCount>
+		static Register shiftLanesUp(Register a) {
+			return _mm_castsi128_ps(
+				_mm_slli_si128(_mm_castps_si128(a), laneCount * sizeof(float))
+			);
+		}
+
+		static float getLastLane(Register a) {
+			return _mm_cvtss_f32(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)));
+		}
+
+		static Register equal(Register a, Register b) {
+			return _mm_cmpeq_ps(a, b);
+		}
+		static Register lessThan(Register a, Register b) {
+			return _mm_cmplt_ps(a, b);
+		}
+		static Register select(Register mask, Register a, Register b) {
+			return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+		}
+		static Register bitOr(Register a, Register b) { return _mm_or_ps(a, b); }
+		static uint32_t byteMask(Register mask) {
+			return ncast<uint32_t>(_mm_movemask_epi8(_mm_castps_si128(mask)));
+		}
+	};
+
+	template<>
+	struct Lanes<double> {
+		using Register = __m128d;
+		static constexpr size_t width{ 2 };
+		static constexpr bool hasLessThan{ true };
+
+		static Register load(const double* data) { return _mm_loadu_pd(data); }
+		static void store(double* dst, Register a) { _mm_storeu_pd(dst, a); }
+		static Register splat(double val) { return _mm_set1_pd(val); }
+		static Register add(Register a, Register b) { return _mm_add_pd(a, b); }
+
+		template<uint32_t laneCount>
+		static Register shiftLanesUp(Register a) {
+			return _mm_castsi128_pd(
+				_mm_slli_si128(_mm_castpd_si128(a), laneCount * sizeof(double))
+			);
+		}
+
+		static double getLastLane(Register a) {
+			return _mm_cvtsd_f64(_mm_unpackhi_pd(a, a));
+		}
+
+		static Register equal(Register a, Register b) {
+			return _mm_cmpeq_pd(a, b);
+		}
+		static Register lessThan(Register a, Register b) {
+			return _mm_cmplt_pd(a, b);
+		}
+		static Register select(Register mask, Register a, Register b) {
+			return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+		}
+		static Register bitOr(Register a, Register b) { return _mm_or_pd(a, b); }
+		static uint32_t byteMask(Register mask) {
+			return ncast<uint32_t>(_mm_movemask_epi8(_mm_castpd_si128(mask)));
+		}
+	};
+}  // namespace pstd
@@ -0,0 +1,971 @@
+#include "Core/PParse.h"
+#include "Core/PString.h"
+#include "Core/PIntrinsics.h"
+#include "Core/PAlgorithm.h"
+#include "Core/PMemory.h"
+#include "Core/PAssert.h"
+#include "Core/PTypes.h"
+
+#include "Core/FloatTables.h"
+
+#include <emmintrin.h>
+
+using namespace pstd;
+
+namespace {
+	struct FloatInfo {
+		uint32_t mantissaBits;
+		uint32_t exponentBits;
+		int32_t bias;
+	};
+
+	constexpr FloatInfo FLOAT_INFO{ .mantissaBits = 23,
+									.exponentBits = 8,
+									.bias = -127 };
+	constexpr FloatInfo DOUBLE_INFO{ .mantissaBits = 52,
+									 .exponentBits = 11,
+									 .bias = -1023 };
+
+	// the digits of a number as they appear in the text, the decimal point
+	// sits between the integer and fraction runs
+	struct DecimalText {
+		const char* integerDigits;
+		uint32_t integerCount;
+		const char* fractionDigits;
+		uint32_t fractionCount;
+		int64_t exponent;
+		bool isNegative;
+	};
+
+	// at most 19 significant digits, so it always fits in a uint64_t
+	struct DecimalMantissa {
+		uint64_t digits;
+		int64_t exponent;
+		bool isTruncated;
+	};
+
+	constexpr uint32_t MAX_MANTISSA_DIGITS{ 19 };
+
+	// arbitrary precision fallback, only used when the fast paths can't
+	// decide the rounding. the value is 0.digits * 10^pointPosition
+	constexpr int32_t MAX_DECIMAL_DIGITS{ 800 };
+	constexpr uint32_t MAX_DECIMAL_SHIFT{ 60 };
+
+	struct Decimal {
+		uint8_t digits[MAX_DECIMAL_DIGITS];
+		int32_t digitCount;
+		int32_t pointPosition;
+		bool isTruncated;
+	};
+
+	constexpr double EXACT_DOUBLE_POWERS[]{
+		1e0,  1e1,	1e2,  1e3,	1e4,  1e5,	1e6,  1e7,
+		1e8,  1e9,	1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+		1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+	};
+
+	constexpr uint64_t POWERS_OF_TEN[]{
+		1ull,
+		10ull,
+		100ull,
+		1000ull,
+		10000ull,
+		100000ull,
+		1000000ull,
+		10000000ull,
+		100000000ull,
+		1000000000ull,
+		10000000000ull,
+		100000000000ull,
+		1000000000000ull,
+		10000000000000ull,
+		100000000000000ull,
+		1000000000000000ull,
+		10000000000000000ull,
+		100000000000000000ull,
+		1000000000000000000ull,
+		10000000000000000000ull,
+	};
+
+	constexpr float EXACT_FLOAT_POWERS[]{
+		1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f,
+	};
+
+	bool isDigit(char letter) {
+		return ncast<uint8_t>(letter - '0') < 10;
+	}
+
+	char toLower(char letter) {
+		return (letter >= 'A' && letter <= 'Z') ? ncast<char>(letter + 32)
+												: letter;
+	}
+
+	// swar, every byte is in '0' to '9'
+	bool isEightDigits(uint64_t val) {
+		return ((val & 0xF0F0F0F0F0F0F0F0ull) |
+				(((val + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >>
+				 4)) == 0x3333333333333333ull;
+	}
+
+	// swar, three multiplies combine 8 digits, the first digit is in the
+	// lowest byte
+	uint32_t parseEightDigits(uint64_t val) {
+		constexpr uint64_t mask{ 0x000000FF000000FFull };
+		constexpr uint64_t mul1{ 100 + (1000000ull << 32) };
+		constexpr uint64_t mul2{ 1 + (10000ull << 32) };
+
+		val -= 0x3030303030303030ull;
+		val = (val * 10) + (val >> 8);
+		val = (((val & mask) * mul1) + (((val >> 16) & mask) * mul2)) >> 32;
+		return ncast<uint32_t>(val);
+	}
+
+	uint32_t countDigits(const char* text, uint32_t size) {
+		uint32_t count{};
+		while (count + 8 <= size && isEightDigits(loadUInt64(text + count))) {
+			count += 8;
+		}
+		while (count < size && isDigit(text[count])) {
+			count++;
+		}
+		return count;
+	}
+
+	// count must be at most 19
+	uint64_t parseDigits(const char* text, uint32_t count) {
+		uint64_t val{};
+		uint32_t i{};
+		for (; i + 8 <= count; i += 8) {
+			val = val * 100000000 + parseEightDigits(loadUInt64(text + i));
+		}
+		for (; i < count; i++) {
+			val = val * 10 + ncast<uint64_t>(text[i] - '0');
+		}
+		return val;
+	}
+
+	uint32_t skipZeros(const char* text, uint32_t count) {
+		uint32_t i{};
+		while (i < count && text[i] == '0') {
+			i++;
+		}
+		return i;
+	}
+
+	bool parseUnsignedDigits(
+		const char* text, uint32_t size, uint64_t* pOut, uint32_t* outSize
+	);
+
+	bool scanDecimalText(
+		const String& text, DecimalText* pOut, uint32_t* outSize
+	);
+
+	bool scanSpecial(
+		const String& text, bool* outIsNan, bool* outIsNegative, uint32_t* outSize
+	);
+
+	DecimalMantissa getMantissa(const DecimalText& decimal);
+
+	bool computeEiselLemire(
+		uint64_t mantissa,
+		int64_t exponent10,
+		const FloatInfo& info,
+		uint64_t* outBits
+	);
+
+	uint64_t convertWithDecimal(const DecimalText& text, const FloatInfo& info);
+
+	template<typename T>
+	T makeFloat(uint64_t bits, bool isNegative);
+
+	template<typename T>
+	bool parseFloatText(const String& text, T* pOut, uint32_t* outSize);
+}  // namespace
+
+bool pstd::parseUInt(const String& text, uint64_t* pOut, uint32_t* outSize) {
+	ASSERT(pOut);
+	ASSERT(text.buffer || text.size == 0);
+
+	uint32_t i{};
+	if (i < text.size && text.buffer[i] == '+') {
+		i++;
+	}
+
+	uint64_t val{};
+	uint32_t digitsSize{};
+	if (!parseUnsignedDigits(
+			text.buffer + i, text.size - i, &val, &digitsSize
+		)) {
+		return false;
+	}
+
+	*pOut = val;
+	if (outSize) {
+		*outSize = i + digitsSize;
+	}
+	return true;
+}
+
+bool pstd::parseInt(const String& text, int64_t* pOut, uint32_t* outSize) {
+	ASSERT(pOut);
+	ASSERT(text.buffer || text.size == 0);
+
+	uint32_t i{};
+	bool isNegative{};
+	if (i < text.size && (text.buffer[i] == '+' || text.buffer[i] == '-')) {
+		isNegative = text.buffer[i] == '-';
+		i++;
+	}
+
+	uint64_t magnitude{};
+	uint32_t digitsSize{};
+	if (!parseUnsignedDigits(
+			text.buffer + i, text.size - i, &magnitude, &digitsSize
+		)) {
+		return false;
+	}
+
+	// the negative range is one larger
+	uint64_t limit{ ncast<uint64_t>(getMax<int64_t>()) + isNegative };
+	if (magnitude > limit) {
+		return false;
+	}
+
+	*pOut = isNegative ? ncast<int64_t>(0 - magnitude)
+					   : ncast<int64_t>(magnitude);
+	if (outSize) {
+		*outSize = i + digitsSize;
+	}
+	return true;
+}
+
+bool pstd::parseFloat(const String& text, double* pOut, uint32_t* outSize) {
+	return parseFloatText(text, pOut, outSize);
+}
+
+bool pstd::parseFloat(const String& text, float* pOut, uint32_t* outSize) {
+	return parseFloatText(text, pOut, outSize);
+}
+
+void pstd::skipSeparators(Tokenizer* pTokenizer) {
+	ASSERT(pTokenizer);
+
+	const char* buffer{ pTokenizer->text.buffer };
+	uint32_t size{ pTokenizer->text.size };
+	uint32_t i{ pTokenizer->offset };
+
+	// a byte is a separator when max(byte, ' ') == ' '
+	__m128i space{ _mm_set1_epi8(' ') };
+	for (; i + 16 <= size; i += 16) {
+		__m128i letters{ _mm_loadu_si128(rcast<const __m128i*>(buffer + i)) };
+		__m128i isSeparator{
+			_mm_cmpeq_epi8(_mm_max_epu8(letters, space), space)
+		};
+		uint32_t tokenMask{
+			~ncast<uint32_t>(_mm_movemask_epi8(isSeparator)) & 0xFFFF
+		};
+		if (tokenMask != 0) {
+			pTokenizer->offset = i + countTrailingZeros(tokenMask);
+			return;
+		}
+	}
+	while (i < size && ncast<uint8_t>(buffer[i]) <= ' ') {
+		i++;
+	}
+	pTokenizer->offset = i;
+}
+
+bool pstd::getNextToken(Tokenizer* pTokenizer, String* outToken) {
+	ASSERT(pTokenizer);
+	ASSERT(outToken);
+
+	skipSeparators(pTokenizer);
+	if (isAtEnd(*pTokenizer)) {
+		return false;
+	}
+
+	const char* buffer{ pTokenizer->text.buffer };
+	uint32_t size{ pTokenizer->text.size };
+	uint32_t begin{ pTokenizer->offset };
+	uint32_t i{ begin };
+
+	__m128i space{ _mm_set1_epi8(' ') };
+	bool isEndFound{};
+	for (; i + 16 <= size; i += 16) {
+		__m128i letters{ _mm_loadu_si128(rcast<const __m128i*>(buffer + i)) };
+		__m128i isSeparator{
+			_mm_cmpeq_epi8(_mm_max_epu8(letters, space), space)
+		};
+		uint32_t separatorMask{
+			ncast<uint32_t>(_mm_movemask_epi8(isSeparator))
+		};
+		if (separatorMask != 0) {
+			i += countTrailingZeros(separatorMask);
+			isEndFound = true;
+			break;
+		}
+	}
+	if (!isEndFound) {
+		while (i < size && ncast<uint8_t>(buffer[i]) > ' ') {
+			i++;
+		}
+	}
+
+	*outToken = String{ .buffer = buffer + begin, .size = i - begin };
+	pTokenizer->offset = i;
+	return true;
+}
+
+bool pstd::getNextLine(Tokenizer* pTokenizer, String* outLine) {
+	ASSERT(pTokenizer);
+	ASSERT(outLine);
+
+	if (isAtEnd(*pTokenizer)) {
+		return false;
+	}
+
+	const char* buffer{ pTokenizer->text.buffer };
+	uint32_t size{ pTokenizer->text.size };
+	uint32_t begin{ pTokenizer->offset };
+	uint32_t i{ begin };
+
+	__m128i newLine{ _mm_set1_epi8('\n') };
+	bool isEndFound{};
+	for (; i + 16 <= size; i += 16) {
+		__m128i letters{ _mm_loadu_si128(rcast<const __m128i*>(buffer + i)) };
+		uint32_t newLineMask{ ncast<uint32_t>(
+			_mm_movemask_epi8(_mm_cmpeq_epi8(letters, newLine))
+		) };
+		if (newLineMask != 0) {
+			i += countTrailingZeros(newLineMask);
+			isEndFound = true;
+			break;
+		}
+	}
+	if (!isEndFound) {
+		while (i < size && buffer[i] != '\n') {
+			i++;
+		}
+	}
+
+	uint32_t end{ i };
+	if (end > begin && buffer[end - 1] == '\r') {
+		end--;
+	}
+
+	*outLine = String{ .buffer = buffer + begin, .size = end - begin };
+	pTokenizer->offset = i < size ? i + 1 : size;
+	return true;
+}
+
+namespace {
+	bool parseUnsignedDigits(
+		const char* text, uint32_t size, uint64_t* pOut, uint32_t* outSize
+	) {
+		uint32_t digitCount{ countDigits(text, size) };
+		if (digitCount == 0) {
+			return false;
+		}
+
+		uint32_t zeroCount{ skipZeros(text, digitCount) };
+		uint32_t significantCount{ digitCount - zeroCount };
+		const char* significant{ text + zeroCount };
+		if (significantCount > 20) {
+			return false;
+		}
+
+		uint64_t val{};
+		if (significantCount <= MAX_MANTISSA_DIGITS) {
+			val = parseDigits(significant, significantCount);
+		} else {
+			// the 20th digit can overflow
+			val = parseDigits(significant, MAX_MANTISSA_DIGITS);
+			auto lastDigit{ ncast<uint64_t>(significant[19] - '0') };
+			if (val > (getMax<uint64_t>() - lastDigit) / 10) {
+				return false;
+			}
+			val = val * 10 + lastDigit;
+		}
+
+		*pOut = val;
+		*outSize = digitCount;
+		return true;
+	}
+
+	bool scanSpecial(
+		const String& text, bool* outIsNan, bool* outIsNegative, uint32_t* outSize
+	) {
+		uint32_t i{};
+		bool isNegative{};
+		if (i < text.size && (text.buffer[i] == '+' || text.buffer[i] == '-')) {
+			isNegative = text.buffer[i] == '-';
+			i++;
+		}
+
+		auto matches{ [&](const char* word, uint32_t wordSize) {
+			if (text.size - i < wordSize) {
+				return false;
+			}
+			for (uint32_t j{}; j < wordSize; j++) {
+				if (toLower(text.buffer[i + j]) != word[j]) {
+					return false;
+				}
+			}
+			return true;
+		} };
+
+		if (matches("nan", 3)) {
+			*outIsNan = true;
+			*outSize = i + 3;
+		} else if (matches("infinity", 8)) {
+			*outIsNan = false;
+			*outSize = i + 8;
+		} else if (matches("inf", 3)) {
+			*outIsNan = false;
+			*outSize = i + 3;
+		} else {
+			return false;
+		}
+
+		*outIsNegative = isNegative;
+		return true;
+	}
+
+	bool scanDecimalText(
+		const String& text, DecimalText* pOut, uint32_t* outSize
+	) {
+		const char* buffer{ text.buffer };
+		uint32_t size{ text.size };
+
+		DecimalText res{};
+		uint32_t i{};
+		if (i < size && (buffer[i] == '+' || buffer[i] == '-')) {
+			res.isNegative = buffer[i] == '-';
+			i++;
+		}
+
+		res.integerDigits = buffer + i;
+		res.integerCount = countDigits(buffer + i, size - i);
+		i += res.integerCount;
+
+		res.fractionDigits = buffer + i;
+		if (i < size && buffer[i] == '.') {
+			i++;
+			res.fractionDigits = buffer + i;
+			res.fractionCount = countDigits(buffer + i, size - i);
+			i += res.fractionCount;
+		}
+
+		if (res.integerCount + res.fractionCount == 0) {
+			return false;
+		}
+
+		// an exponent without digits is not part of the number
+		if (i < size && (buffer[i] == 'e' || buffer[i] == 'E')) {
+			uint32_t j{ i + 1 };
+			bool isExponentNegative{};
+			if (j < size && (buffer[j] == '+' || buffer[j] == '-')) {
+				isExponentNegative = buffer[j] == '-';
+				j++;
+			}
+			if (j < size && isDigit(buffer[j])) {
+				int64_t exponent{};
+				while (j < size && isDigit(buffer[j])) {
+					// anything this large is already zero or infinity
+					if (exponent < 100000) {
+						exponent = exponent * 10 + (buffer[j] - '0');
+					}
+					j++;
+				}
+				res.exponent = isExponentNegative ? -exponent : exponent;
+				i = j;
+			}
+		}
+
+		*pOut = res;
+		*outSize = i;
+		return true;
+	}
+
+	DecimalMantissa getMantissa(const DecimalText& decimal) {
+		// leading zeros, possibly running into the fraction, carry nothing
+		const char* digits{ decimal.integerDigits };
+		uint32_t count{ decimal.integerCount };
+		uint32_t zeroCount{ skipZeros(digits, count) };
+		int64_t exponent{ decimal.exponent + (count - zeroCount) };
+		digits += zeroCount;
+		count -= zeroCount;
+		if (count == 0) {
+			digits = decimal.fractionDigits;
+			count = decimal.fractionCount;
+			zeroCount = skipZeros(digits, count);
+			exponent = decimal.exponent - zeroCount;
+			digits += zeroCount;
+			count -= zeroCount;
+
+			if (count == 0) {
+				return {};
+			}
+
+			uint32_t takenCount{ min(count, MAX_MANTISSA_DIGITS) };
+			DecimalMantissa res{ .digits = parseDigits(digits, takenCount),
+								 .exponent = exponent - takenCount };
+			for (uint32_t i{ takenCount }; i < count; i++) {
+				res.isTruncated |= digits[i] != '0';
+			}
+			return res;
+		}
+
+		// the value is 0.digits * 10^exponent from here on, digits may
+		// continue into the fraction
+		uint32_t takenCount{ min(count, MAX_MANTISSA_DIGITS) };
+		DecimalMantissa res{ .digits = parseDigits(digits, takenCount) };
+		for (uint32_t i{ takenCount }; i < count; i++) {
+			res.isTruncated |= digits[i] != '0';
+		}
+
+		uint32_t fractionTaken{
+			min(decimal.fractionCount, MAX_MANTISSA_DIGITS - takenCount)
+		};
+		if (fractionTaken > 0) {
+			res.digits = res.digits * POWERS_OF_TEN[fractionTaken] +
+				parseDigits(decimal.fractionDigits, fractionTaken);
+		}
+		for (uint32_t i{ fractionTaken }; i < decimal.fractionCount; i++) {
+			res.isTruncated |= decimal.fractionDigits[i] != '0';
+		}
+
+		res.exponent = exponent - takenCount - fractionTaken;
+		return res;
+	}
+}  // namespace
+
+namespace {
+	bool computeEiselLemire(
+		uint64_t mantissa,
+		int64_t exponent10,
+		const FloatInfo& info,
+		uint64_t* outBits
+	) {
+		ASSERT(mantissa != 0);
+		ASSERT(exponent10 >= POW10_MIN_EXPONENT);
+		ASSERT(exponent10 <= POW10_MAX_EXPONENT);
+
+		const uint64_t* pow10{ POW10_128[exponent10 - POW10_MIN_EXPONENT] };
+
+		uint32_t leadingZeros{ countLeadingZeros(mantissa) };
+		mantissa <<= leadingZeros;
+
+		// floor(log2(10^exponent10)) is (217706 * exponent10) >> 16
+		uint64_t exponent2{ ncast<uint64_t>(
+			((217706 * exponent10) >> 16) + 64 - info.bias
+		) - leadingZeros };
+
+		// the low bits left over after the mantissa and a rounding bit
+		uint32_t extraShift{ 64 - info.mantissaBits - 3 };
+		uint64_t extraMask{ (1ull << extraShift) - 1 };
+
+		uint64_t productHigh{};
+		uint64_t productLow{ multiply128(mantissa, pow10[1], &productHigh) };
+
+		// the truncated power of ten could carry into the kept bits, a second
+		// multiply with its low half settles it or gives up
+		if ((productHigh & extraMask) == extraMask &&
+			productLow + mantissa < mantissa) {
+			uint64_t lowHigh{};
+			uint64_t lowLow{ multiply128(mantissa, pow10[0], &lowHigh) };
+			uint64_t mergedHigh{ productHigh };
+			uint64_t mergedLow{ productLow + lowHigh };
+			if (mergedLow < productLow) {
+				mergedHigh++;
+			}
+			if ((mergedHigh & extraMask) == extraMask && mergedLow + 1 == 0 &&
+				lowLow + mantissa < mantissa) {
+				return false;
+			}
+			productHigh = mergedHigh;
+			productLow = mergedLow;
+		}
+
+		uint64_t topBit{ productHigh >> 63 };
+		uint64_t bits{ productHigh >> (topBit + extraShift) };
+		exponent2 -= 1 ^ topBit;
+
+		// exactly halfway between two floats, the tail decides the tie
+		if (productLow == 0 && (productHigh & extraMask) == 0 &&
+			(bits & 3) == 1) {
+			return false;
+		}
+
+		bits += bits & 1;
+		bits >>= 1;
+		if ((bits >> (info.mantissaBits + 1)) > 0) {
+			bits >>= 1;
+			exponent2++;
+		}
+
+		// subnormals, infinity and the edges around them go the slow way
+		uint64_t maxExponent{ (1ull << info.exponentBits) - 1 };
+		if (exponent2 - 1 >= maxExponent - 1) {
+			return false;
+		}
+
+		*outBits = (exponent2 << info.mantissaBits) |
+			(bits & ((1ull << info.mantissaBits) - 1));
+		return true;
+	}
+
+	void trimDecimal(Decimal* pDecimal) {
+		while (pDecimal->digitCount > 0 &&
+			   pDecimal->digits[pDecimal->digitCount - 1] == 0) {
+			pDecimal->digitCount--;
+		}
+		if (pDecimal->digitCount == 0) {
+			pDecimal->pointPosition = 0;
+		}
+	}
+
+	void shiftDecimalRight(Decimal* pDecimal, uint32_t shift) {
+		int32_t readIndex{};
+		int32_t writeIndex{};
+
+		// enough leading digits to cover the first shift
+		uint64_t val{};
+		for (; (val >> shift) == 0; readIndex++) {
+			if (readIndex >= pDecimal->digitCount) {
+				if (val == 0) {
+					pDecimal->digitCount = 0;
+					return;
+				}
+				while ((val >> shift) == 0) {
+					val *= 10;
+					readIndex++;
+				}
+				break;
+			}
+			val = val * 10 + pDecimal->digits[readIndex];
+		}
+		pDecimal->pointPosition -= readIndex - 1;
+
+		uint64_t mask{ (1ull << shift) - 1 };
+		for (; readIndex < pDecimal->digitCount; readIndex++) {
+			uint64_t digit{ val >> shift };
+			val &= mask;
+			pDecimal->digits[writeIndex++] = ncast<uint8_t>(digit);
+			val = val * 10 + pDecimal->digits[readIndex];
+		}
+
+		while (val > 0) {
+			uint64_t digit{ val >> shift };
+			val &= mask;
+			if (writeIndex < MAX_DECIMAL_DIGITS) {
+				pDecimal->digits[writeIndex++] = ncast<uint8_t>(digit);
+			} else if (digit > 0) {
+				pDecimal->isTruncated = true;
+			}
+			val *= 10;
+		}
+
+		pDecimal->digitCount = writeIndex;
+		trimDecimal(pDecimal);
+	}
+
+	void shiftDecimalLeft(Decimal* pDecimal, uint32_t shift) {
+		// a shift of at most 60 adds at most 19 digits, they are written
+		// back to front and copied over once the count is known
+		constexpr int32_t maxNewDigits{ 19 };
+		uint8_t scratch[MAX_DECIMAL_DIGITS + maxNewDigits];
+
+		int32_t writeIndex{ pDecimal->digitCount + maxNewDigits };
+		uint64_t val{};
+		for (int32_t readIndex{ pDecimal->digitCount - 1 }; readIndex >= 0;
+			 readIndex--) {
+			val += ncast<uint64_t>(pDecimal->digits[readIndex]) << shift;
+			uint64_t quotient{ val / 10 };
+			scratch[--writeIndex] = ncast<uint8_t>(val - quotient * 10);
+			val = quotient;
+		}
+		while (val > 0) {
+			uint64_t quotient{ val / 10 };
+			scratch[--writeIndex] = ncast<uint8_t>(val - quotient * 10);
+			val = quotient;
+		}
+
+		int32_t newCount{ pDecimal->digitCount + maxNewDigits - writeIndex };
+		pDecimal->pointPosition += newCount - pDecimal->digitCount;
+
+		int32_t keptCount{ min(newCount, MAX_DECIMAL_DIGITS) };
+		for (int32_t i{ keptCount }; i < newCount; i++) {
+			pDecimal->isTruncated |= scratch[writeIndex + i] != 0;
+		}
+		memCpy(pDecimal->digits, scratch + writeIndex, keptCount);
+		pDecimal->digitCount = keptCount;
+		trimDecimal(pDecimal);
+	}
+
+	// positive shifts multiply by 2^shift, negative ones divide
+	void shiftDecimal(Decimal* pDecimal, int32_t shift) {
+		if (pDecimal->digitCount == 0) {
+			return;
+		}
+
+		constexpr int32_t maxShift{ ncast<int32_t>(MAX_DECIMAL_SHIFT) };
+		if (shift > 0) {
+			for (; shift > maxShift; shift -= maxShift) {
+				shiftDecimalLeft(pDecimal, MAX_DECIMAL_SHIFT);
+			}
+			shiftDecimalLeft(pDecimal, ncast<uint32_t>(shift));
+		} else if (shift < 0) {
+			for (; shift < -maxShift; shift += maxShift) {
+				shiftDecimalRight(pDecimal, MAX_DECIMAL_SHIFT);
+			}
+			shiftDecimalRight(pDecimal, ncast<uint32_t>(-shift));
+		}
+	}
+
+	bool shouldRoundUp(const Decimal& decimal, int32_t index) {
+		if (index < 0 || index >= decimal.digitCount) {
+			return false;
+		}
+		// exactly halfway rounds to even, unless digits were dropped
+		if (decimal.digits[index] == 5 && index + 1 == decimal.digitCount) {
+			if (decimal.isTruncated) {
+				return true;
+			}
+			return index > 0 && (decimal.digits[index - 1] & 1) != 0;
+		}
+		return decimal.digits[index] >= 5;
+	}
+
+	uint64_t getRoundedInteger(const Decimal& decimal) {
+		if (decimal.pointPosition > 20) {
+			return getMax<uint64_t>();
+		}
+
+		uint64_t val{};
+		int32_t i{};
+		for (; i < decimal.pointPosition && i < decimal.digitCount; i++) {
+			val = val * 10 + decimal.digits[i];
+		}
+		for (; i < decimal.pointPosition; i++) {
+			val *= 10;
+		}
+		if (shouldRoundUp(decimal, decimal.pointPosition)) {
+			val++;
+		}
+		return val;
+	}
+
+	// the largest power of two below 10^index, so a shift can't overshoot
+	constexpr int32_t DECIMAL_SHIFT_COUNT{ 9 };
+	constexpr int32_t DECIMAL_SHIFTS[DECIMAL_SHIFT_COUNT]{
+		1, 3, 6, 9, 13, 16, 19, 23, 26,
+	};
+	constexpr int32_t MAX_DECIMAL_STEP{ 27 };
+
+	int32_t getDecimalShift(int32_t pointPosition) {
+		return pointPosition < DECIMAL_SHIFT_COUNT
+			? DECIMAL_SHIFTS[pointPosition]
+			: MAX_DECIMAL_STEP;
+	}
+
+	uint64_t convertWithDecimal(const DecimalText& text, const FloatInfo& info) {
+		Decimal decimal;
+		decimal.digitCount = 0;
+		decimal.isTruncated = false;
+
+		int64_t pointPosition{ text.integerCount };
+		auto pushDigits{ [&](const char* digits, uint32_t count) {
+			for (uint32_t i{}; i < count; i++) {
+				auto digit{ ncast<uint8_t>(digits[i] - '0') };
+				if (digit == 0 && decimal.digitCount == 0) {
+					pointPosition--;
+				} else if (decimal.digitCount < MAX_DECIMAL_DIGITS) {
+					decimal.digits[decimal.digitCount++] = digit;
+				} else if (digit != 0) {
+					decimal.isTruncated = true;
+				}
+			}
+		} };
+		pushDigits(text.integerDigits, text.integerCount);
+		pushDigits(text.fractionDigits, text.fractionCount);
+
+		// the scan clamps the exponent, so this can't overflow
+		pointPosition += text.exponent;
+		constexpr int64_t pointLimit{ 100000 };
+		decimal.pointPosition = ncast<int32_t>(
+			clamp(-pointLimit, pointLimit, pointPosition)
+		);
+		trimDecimal(&decimal);
+
+		uint64_t maxExponent{ (1ull << info.exponentBits) - 1 };
+		uint64_t infinityBits{ maxExponent << info.mantissaBits };
+
+		if (decimal.digitCount == 0 || decimal.pointPosition < -330) {
+			return 0;
+		}
+		if (decimal.pointPosition > 310) {
+			return infinityBits;
+		}
+
+		// scale by powers of two into [0.5, 1)
+		int32_t exponent2{};
+		while (decimal.pointPosition > 0) {
+			int32_t shift{ getDecimalShift(decimal.pointPosition) };
+			shiftDecimal(&decimal, -shift);
+			exponent2 += shift;
+		}
+		while (decimal.pointPosition < 0 ||
+			   (decimal.pointPosition == 0 && decimal.digits[0] < 5)) {
+			int32_t shift{ getDecimalShift(-decimal.pointPosition) };
+			shiftDecimal(&decimal, shift);
+			exponent2 -= shift;
+		}
+
+		// [0.5, 1) to [1, 2)
+		exponent2--;
+
+		// below the smallest normal exponent the value becomes subnormal
+		if (exponent2 < info.bias + 1) {
+			int32_t shift{ info.bias + 1 - exponent2 };
+			shiftDecimal(&decimal, -shift);
+			exponent2 += shift;
+		}
+		if (exponent2 - info.bias >= ncast<int32_t>(maxExponent)) {
+			return infinityBits;
+		}
+
+		shiftDecimal(&decimal, ncast<int32_t>(info.mantissaBits + 1));
+		uint64_t mantissa{ getRoundedInteger(decimal) };
+
+		// rounding can carry into a new bit
+		if (mantissa == (2ull << info.mantissaBits)) {
+			mantissa >>= 1;
+			exponent2++;
+			if (exponent2 - info.bias >= ncast<int32_t>(maxExponent)) {
+				return infinityBits;
+			}
+		}
+		if ((mantissa & (1ull << info.mantissaBits)) == 0) {
+			exponent2 = info.bias;
+		}
+
+		auto biasedExponent{ ncast<uint64_t>(exponent2 - info.bias) };
+		return (biasedExponent << info.mantissaBits) |
+			(mantissa & ((1ull << info.mantissaBits) - 1));
+	}
+
+	template<typename T>
+	T makeFloat(uint64_t bits, bool isNegative) {
+		if constexpr (isSameType<T, float>) {
+			auto floatBits{ ncast<uint32_t>(bits) | (ncast<uint32_t>(isNegative)
+													 << 31) };
+			float res{};
+			memCpy(&res, &floatBits, sizeof(res));
+			return res;
+		} else {
+			bits |= ncast<uint64_t>(isNegative) << 63;
+			double res{};
+			memCpy(&res, &bits, sizeof(res));
+			return res;
+		}
+	}
+
+	template<typename T>
+	bool parseFloatText(const String& text, T* pOut, uint32_t* outSize) {
+		ASSERT(pOut);
+		ASSERT(text.buffer || text.size == 0);
+
+		constexpr bool isFloat{ isSameType<T, float> };
+		constexpr const FloatInfo& info{ isFloat ? FLOAT_INFO : DOUBLE_INFO };
+		uint64_t maxExponent{ (1ull << info.exponentBits) - 1 };
+
+		DecimalText decimalText{};
+		uint32_t size{};
+		if (!scanDecimalText(text, &decimalText, &size)) {
+			bool isNan{};
+			bool isNegative{};
+			if (!scanSpecial(text, &isNan, &isNegative, &size)) {
+				return false;
+			}
+
+			// nan is quiet, the top mantissa bit set
+			uint64_t bits{ maxExponent << info.mantissaBits };
+			if (isNan) {
+				bits |= 1ull << (info.mantissaBits - 1);
+			}
+			*pOut = makeFloat<T>(bits, isNegative);
+			if (outSize) {
+				*outSize = size;
+			}
+			return true;
+		}
+
+		if (outSize) {
+			*outSize = size;
+		}
+
+		DecimalMantissa mantissa{ getMantissa(decimalText) };
+		bool isNegative{ decimalText.isNegative };
+		if (mantissa.digits == 0) {
+			*pOut = makeFloat<T>(0, isNegative);
+			return true;
+		}
+
+		// both operands exact, so one correctly rounded operation
+		if (!mantissa.isTruncated) {
+			if constexpr (isFloat) {
+				if (mantissa.digits <= (1ull << 24) && mantissa.exponent >= -10 &&
+					mantissa.exponent <= 10) {
+					auto val{ ncast<float>(mantissa.digits) };
+					val = mantissa.exponent < 0
+						? val / EXACT_FLOAT_POWERS[-mantissa.exponent]
+						: val * EXACT_FLOAT_POWERS[mantissa.exponent];
+					*pOut = isNegative ? -val : val;
+					return true;
+				}
+			} else {
+				if (mantissa.digits <= (1ull << 53) && mantissa.exponent >= -22 &&
+					mantissa.exponent <= 22) {
+					auto val{ ncast<double>(mantissa.digits) };
+					val = mantissa.exponent < 0
+						? val / EXACT_DOUBLE_POWERS[-mantissa.exponent]
+						: val * EXACT_DOUBLE_POWERS[mantissa.exponent];
+					*pOut = isNegative ? -val : val;
+					return true;
+				}
+			}
+		}
+
+		// even 10^19 times the smallest power rounds to zero, and anything
+		// past the largest power is infinite
+		if (mantissa.exponent < POW10_MIN_EXPONENT) {
+			*pOut = makeFloat<T>(0, isNegative);
+			return true;
+		}
+		if (mantissa.exponent > POW10_MAX_EXPONENT) {
+			*pOut = makeFloat<T>(maxExponent << info.mantissaBits, isNegative);
+			return true;
+		}
+
+		// with dropped digits the value is between digits and digits + 1,
+		// both have to round the same way
+		uint64_t bits{};
+		if (computeEiselLemire(
+				mantissa.digits, mantissa.exponent, info, &bits
+			)) {
+			uint64_t upperBits{};
+			if (!mantissa.isTruncated ||
+				(computeEiselLemire(
+					 mantissa.digits + 1, mantissa.exponent, info, &upperBits
+				 ) &&
+				 upperBits == bits)) {
+				*pOut = makeFloat<T>(bits, isNegative);
+				return true;
+			}
+		}
+
+		*pOut = makeFloat<T>(convertWithDecimal(decimalText, info), isNegative);
+		return true;
+	}
+}  // namespace
@@ -12,6 +12,9 @@ namespace {
 
 void pstd::startupConsole() {
 	g_Stdout = GetStdHandle(STD_OUTPUT_HANDLE);
+
+	// log text is utf-8, WriteConsoleA reads it in the output code page
+	SetConsoleOutputCP(CP_UTF8);
 }
 
 bool pstd::consoleWrite(const pstd::String string) {
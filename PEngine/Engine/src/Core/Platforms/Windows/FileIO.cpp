@@ -1,6 +1,7 @@
 #include "Core/PArena.h"
 #include "Core/PString.h"
 #include "Core/PFileIO.h"
+#include "Core/PUnicode.h"
 #include "Core/PAssert.h"
 
 #include <Windows.h>
@@ -22,6 +23,25 @@ namespace {
 
 	using FileHandleImpl = HANDLE;
 	using DllHandleImpl = HINSTANCE;
+
+	// paths are utf-8 on our side and go to the W apis as utf-16, MAX_PATH
+	// counts utf-16 units like it does for the A apis
+	using WidePath = wchar_t[MAX_PATH];
+
+	bool convertPath(const char* path, WidePath outPath) {
+		uint32_t size{};
+		if (!pstd::convertUtf8ToUtf16(
+				rcast<char16_t*>(outPath),
+				MAX_PATH - 1,
+				pstd::createString(path),
+				&size
+			)) {
+			return false;
+		}
+
+		outPath[size] = L'\0';
+		return true;
+	}
 }  // namespace
 
 pstd::FileHandle pstd::openFile(
@@ -38,8 +58,13 @@ pstd::FileHandle pstd::openFile(
 	uint64_t fileShareFlags{ fileShareWin32Flags[(size_t)shareFlags] };
 	uint64_t fileCreateFlags{ fileCreateWin32Flags[(size_t)createFlags] };
 
-	HANDLE hFile{ CreateFile(
-		filepath,
+	WidePath widePath{};
+	if (!convertPath(filepath, widePath)) {
+		return nullptr;
+	}
+
+	HANDLE hFile{ CreateFileW(
+		widePath,
 		fileAccessFlags,
 		fileShareFlags,
 		0,
@@ -48,23 +73,71 @@ pstd::FileHandle pstd::openFile(
 		0
 	) };
 
-	// ASSERT(hFile != INVALID_HANDLE_VALUE);
-	DWORD errorCode{ GetLastError() };
+	if (hFile == INVALID_HANDLE_VALUE) {
+		return nullptr;
+	}
 
 	return hFile;
 }
 
 bool pstd::copyFile(const char* dstName, const char* srcName, bool replace) {
-	auto res{ (bool)CopyFileA(srcName, dstName, !replace) };
+	WidePath wideDstName{};
+	WidePath wideSrcName{};
+	if (!convertPath(dstName, wideDstName) ||
+		!convertPath(srcName, wideSrcName)) {
+		return false;
+	}
+
+	auto res{ (bool)CopyFileW(wideSrcName, wideDstName, !replace) };
 	return res;
 }
 
 // TODO: change the name of this function
 pstd::String pstd::getEXEPath(Arena* pArena) {
-	char exePath[MAX_PATH];
-	GetModuleFileNameA(0, exePath, MAX_PATH);
-	pstd::String res{ pstd::createString(pArena, exePath) };
+	WidePath exePath{};
+	DWORD size{ GetModuleFileNameW(0, exePath, MAX_PATH) };
+
+	pstd::String res{};
+	bool converted{ pstd::createUtf8String(
+		pArena,
+		pstd::Utf16String{ .buffer = rcast<const char16_t*>(exePath),
+						   .size = size },
+		&res
+	) };
+	ASSERT(converted);
+
+	return res;
+}
+
+pstd::Array<pstd::String> pstd::getCommandLineArgs(Arena* pArena) {
+	ASSERT(pArena);
 
+	int argCount{};
+	LPWSTR* wideArgs{ CommandLineToArgvW(GetCommandLineW(), &argCount) };
+	if (!wideArgs) {
+		return {};
+	}
+
+	pstd::Array<pstd::String> res{
+		.data = pstd::alloc<pstd::String>(pArena, argCount),
+		.capacity = ncast<size_t>(argCount),
+	};
+	for (int i{}; i < argCount; i++) {
+		uint32_t size{};
+		while (wideArgs[i][size] != L'\0') {
+			size++;
+		}
+
+		bool converted{ pstd::createUtf8String(
+			pArena,
+			pstd::Utf16String{ .buffer = rcast<const char16_t*>(wideArgs[i]),
+							   .size = size },
+			&res[i]
+		) };
+		ASSERT(converted);
+	}
+
+	LocalFree(wideArgs);
 	return res;
 }
 
@@ -73,7 +146,12 @@ pstd::String pstd::getDllExtensionName() {
 }
 
 pstd::DllHandle pstd::loadDll(const char* filepath) {
-	HINSTANCE handle{ LoadLibraryA(filepath) };
+	WidePath widePath{};
+	if (!convertPath(filepath, widePath)) {
+		return nullptr;
+	}
+
+	HINSTANCE handle{ LoadLibraryW(widePath) };
 
 	return handle;
 }
@@ -90,6 +168,23 @@ void* pstd::findDllFunction(DllHandle pHandle, const char* functionName) {
 	return functionPtr;
 }
 
+pstd::DllHandle pstd::getExeModule() {
+	return GetModuleHandleW(nullptr);
+}
+
+size_t pstd::getModuleSize(DllHandle pHandle) {
+	ASSERT(pHandle);
+
+	// a loaded module starts with its headers, the nt ones say how large the
+	// image is
+	auto* pBase{ rcast<const uint8_t*>(pHandle) };
+	auto* pDosHeader{ rcast<const IMAGE_DOS_HEADER*>(pBase) };
+	auto* pNtHeaders{
+		rcast<const IMAGE_NT_HEADERS*>(pBase + pDosHeader->e_lfanew)
+	};
+	return pNtHeaders->OptionalHeader.SizeOfImage;
+}
+
 void pstd::closeFile(pstd::FileHandle pHandle) {
 	ASSERT(pHandle);
 	auto hFile{ (FileHandleImpl)pHandle };
@@ -112,7 +207,10 @@ uint32_t pstd::getFileSize(FileHandle pHandle) {
 
 size_t pstd::getLastFileWriteTime(const char* filename) {
 	WIN32_FILE_ATTRIBUTE_DATA attribData{};
-	GetFileAttributesExA(filename, GetFileExInfoStandard, &attribData);
+	WidePath widePath{};
+	if (convertPath(filename, widePath)) {
+		GetFileAttributesExW(widePath, GetFileExInfoStandard, &attribData);
+	}
 	size_t time{ attribData.ftLastWriteTime.dwHighDateTime };
 	time = time << 32;
 	time |= attribData.ftLastWriteTime.dwLowDateTime;
@@ -139,3 +237,66 @@ pstd::String pstd::readFile(pstd::Arena* pArena, pstd::FileHandle pHandle) {
 
 	return fileString;
 }
+
+bool pstd::writeFile(
+	pstd::FileHandle pHandle, const void* data, uint32_t size
+) {
+	ASSERT(data || size == 0);
+	auto hFile{ rcast<FileHandleImpl>(pHandle) };
+
+	DWORD bytesWritten{};
+	if (WriteFile(hFile, data, size, &bytesWritten, nullptr) == false) {
+		return false;
+	}
+
+	return bytesWritten == size;
+}
+
+pstd::MappedFile pstd::createMappedFile(const char* path, size_t size) {
+	ASSERT(size > 0);
+
+	MappedFile res{};
+	res.file = pstd::openFile(
+		path,
+		pstd::FileAccess::readwrite,
+		pstd::FileShare::read,
+		pstd::FileCreate::createAlways
+	);
+	if (!res.file) {
+		return MappedFile{};
+	}
+
+	res.mapping = CreateFileMappingW(
+		rcast<FileHandleImpl>(res.file),
+		nullptr,
+		PAGE_READWRITE,
+		ncast<DWORD>(size >> 32),
+		ncast<DWORD>(size),
+		nullptr
+	);
+	if (res.mapping) {
+		res.data = MapViewOfFile(res.mapping, FILE_MAP_WRITE, 0, 0, size);
+	}
+	if (!res.data) {
+		closeMappedFile(&res);
+		return MappedFile{};
+	}
+
+	res.size = size;
+	return res;
+}
+
+void pstd::closeMappedFile(MappedFile* pMappedFile) {
+	ASSERT(pMappedFile);
+
+	if (pMappedFile->data) {
+		UnmapViewOfFile(pMappedFile->data);
+	}
+	if (pMappedFile->mapping) {
+		CloseHandle(rcast<HANDLE>(pMappedFile->mapping));
+	}
+	if (pMappedFile->file) {
+		pstd::closeFile(pMappedFile->file);
+	}
+	*pMappedFile = MappedFile{};
+}
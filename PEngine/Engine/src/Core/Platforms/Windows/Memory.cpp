@@ -5,6 +5,7 @@
 #include "Core/PAssert.h"
 
 #include <Windows.h>
+#include <Psapi.h>
 
 using namespace pstd;
 
@@ -42,6 +43,22 @@ pstd::AllocationLimits pstd::getSystemAllocationLimits() {
 	};
 }
 
+pstd::MemoryUsage pstd::getProcessMemoryUsage() {
+	// PagefileUsage is the commit charge, whether or not any of it went to
+	// the page file, and the working set is what is resident
+	PROCESS_MEMORY_COUNTERS memoryCounters{ .cb = sizeof(memoryCounters) };
+	K32GetProcessMemoryInfo(
+		GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters)
+	);
+
+	return MemoryUsage{
+		.committedSize = memoryCounters.PagefileUsage,
+		.peakCommittedSize = memoryCounters.PeakPagefileUsage,
+		.residentSize = memoryCounters.WorkingSetSize,
+		.peakResidentSize = memoryCounters.PeakWorkingSetSize,
+	};
+}
+
 void* pstd::allocPages(
 	const size_t size, AllocationTypeBits allocType, void* baseAddress
 ) {
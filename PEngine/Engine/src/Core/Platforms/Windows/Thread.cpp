@@ -0,0 +1,313 @@
+#include "Core/PThread.h"
+#include "Core/PAssert.h"
+
+#include <Windows.h>
+#include <Psapi.h>
+
+namespace {
+	// the table of the module address is in, null when it is in none
+	const pstd::UnwindTable* findUnwindTable(
+		const pstd::UnwindTable* tables, uint32_t tableCount, uintptr_t address
+	) {
+		for (uint32_t i{}; i < tableCount; i++) {
+			if (address - tables[i].base < tables[i].size) {
+				return &tables[i];
+			}
+		}
+
+		return nullptr;
+	}
+
+	// the search RtlLookupFunctionEntry does, without the lock it takes.
+	// null for a leaf, which has no entry
+	RUNTIME_FUNCTION*
+		findFunction(const pstd::UnwindTable& table, uintptr_t address) {
+		auto* functions{
+			rcast<RUNTIME_FUNCTION*>(table.base + table.functionOffset)
+		};
+		auto offset{ ncast<DWORD>(address - table.base) };
+
+		uint32_t low{};
+		uint32_t high{ table.functionCount };
+		while (low < high) {
+			uint32_t middle{ low + (high - low) / 2 };
+			RUNTIME_FUNCTION* pFunction{ &functions[middle] };
+			if (offset < pFunction->BeginAddress) {
+				high = middle;
+			} else if (offset >= pFunction->EndAddress) {
+				low = middle + 1;
+			} else if (pFunction->UnwindData & 1) {
+				// the entry points at another that has the unwind data
+				return rcast<RUNTIME_FUNCTION*>(
+					table.base + (pFunction->UnwindData & ~1u)
+				);
+			} else {
+				return pFunction;
+			}
+		}
+
+		return nullptr;
+	}
+}  // namespace
+
+pstd::ThreadHandle
+	pstd::createThread(ThreadFunction function, void* pArg) {
+	// x64 has a single calling convention, so the signatures are compatible
+	HANDLE handle{ CreateThread(
+		nullptr, 0, rcast<LPTHREAD_START_ROUTINE>(function), pArg, 0, nullptr
+	) };
+	ASSERT(handle);
+
+	return handle;
+}
+
+void pstd::joinThread(ThreadHandle pHandle) {
+	ASSERT(pHandle);
+	auto handle{ (HANDLE)pHandle };
+
+	WaitForSingleObject(handle, INFINITE);
+	CloseHandle(handle);
+}
+
+uint32_t pstd::getLogicalCoreCount() {
+	SYSTEM_INFO sysInfo{};
+	GetSystemInfo(&sysInfo);
+
+	return sysInfo.dwNumberOfProcessors;
+}
+
+// SRWLOCK is a single pointer and zero is SRWLOCK_INIT
+static_assert(sizeof(SRWLOCK) == sizeof(pstd::Mutex));
+
+void pstd::lockExclusive(Mutex* pMutex) {
+	ASSERT(pMutex);
+
+	AcquireSRWLockExclusive(rcast<SRWLOCK*>(&pMutex->state));
+}
+
+void pstd::unlockExclusive(Mutex* pMutex) {
+	ASSERT(pMutex);
+
+	ReleaseSRWLockExclusive(rcast<SRWLOCK*>(&pMutex->state));
+}
+
+void pstd::lockShared(Mutex* pMutex) {
+	ASSERT(pMutex);
+
+	AcquireSRWLockShared(rcast<SRWLOCK*>(&pMutex->state));
+}
+
+void pstd::unlockShared(Mutex* pMutex) {
+	ASSERT(pMutex);
+
+	ReleaseSRWLockShared(rcast<SRWLOCK*>(&pMutex->state));
+}
+
+pstd::Signal pstd::createSignal() {
+	// auto reset, a wait lets a single raise through
+	HANDLE handle{ CreateEventA(nullptr, false, false, nullptr) };
+	ASSERT(handle);
+
+	return handle;
+}
+
+void pstd::destroySignal(Signal signal) {
+	ASSERT(signal);
+
+	CloseHandle((HANDLE)signal);
+}
+
+void pstd::raiseSignal(Signal signal) {
+	ASSERT(signal);
+
+	SetEvent((HANDLE)signal);
+}
+
+bool pstd::waitSignal(Signal signal, uint32_t timeoutMs) {
+	ASSERT(signal);
+
+	return WaitForSingleObject((HANDLE)signal, timeoutMs) == WAIT_OBJECT_0;
+}
+
+void pstd::yieldThread() {
+	SwitchToThread();
+}
+
+pstd::ThreadHandle pstd::openCurrentThread() {
+	HANDLE handle{ OpenThread(
+		THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_QUERY_INFORMATION,
+		false,
+		GetCurrentThreadId()
+	) };
+	ASSERT(handle);
+
+	return handle;
+}
+
+void pstd::closeThreadHandle(ThreadHandle handle) {
+	ASSERT(handle);
+
+	CloseHandle((HANDLE)handle);
+}
+
+pstd::UnwindTable pstd::getUnwindTable(DllHandle pHandle) {
+	ASSERT(pHandle);
+
+	// the exception directory is the module's array of function entries
+	auto* pBase{ rcast<const uint8_t*>(pHandle) };
+	auto* pDosHeader{ rcast<const IMAGE_DOS_HEADER*>(pBase) };
+	auto* pNtHeaders{
+		rcast<const IMAGE_NT_HEADERS*>(pBase + pDosHeader->e_lfanew)
+	};
+	const IMAGE_DATA_DIRECTORY& directory{
+		pNtHeaders->OptionalHeader
+			.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXCEPTION]
+	};
+
+	return UnwindTable{
+		.base = rcast<uintptr_t>(pHandle),
+		.size = pNtHeaders->OptionalHeader.SizeOfImage,
+		.functionOffset = cast<uint32_t>(directory.VirtualAddress),
+		.functionCount =
+			ncast<uint32_t>(directory.Size / sizeof(RUNTIME_FUNCTION)),
+	};
+}
+
+uint32_t pstd::acquireLoadedModules(DllHandle* handles, uint32_t maxCount) {
+	ASSERT(handles);
+
+	DWORD listSize{};
+	if (!K32EnumProcessModules(
+			GetCurrentProcess(),
+			rcast<HMODULE*>(handles),
+			ncast<DWORD>(maxCount * sizeof(HMODULE)),
+			&listSize
+		)) {
+		return 0;
+	}
+
+	// listSize is the whole list's, which can be more than fit. a module
+	// unloaded since the list was taken is left out
+	auto listCount{ ncast<uint32_t>(listSize / sizeof(HMODULE)) };
+	if (listCount > maxCount) {
+		listCount = maxCount;
+	}
+	uint32_t count{};
+	for (uint32_t i{}; i < listCount; i++) {
+		HMODULE module{};
+		if (GetModuleHandleExW(
+				GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS,
+				rcast<LPCWSTR>(handles[i]),
+				&module
+			)) {
+			handles[count++] = module;
+		}
+	}
+
+	return count;
+}
+
+uint32_t pstd::captureThreadStack(
+	ThreadHandle pHandle,
+	const UnwindTable* tables,
+	uint32_t tableCount,
+	uintptr_t* frames,
+	uint32_t maxFrameCount
+) {
+	ASSERT(pHandle);
+	ASSERT(tables || tableCount == 0);
+	ASSERT(frames);
+	auto handle{ (HANDLE)pHandle };
+
+	if (SuspendThread(handle) == ncast<DWORD>(-1)) {
+		return 0;
+	}
+
+	// GetThreadContext waits for the suspension to take effect. x64 code
+	// keeps unwind data for every function that isn't a leaf, so the walk
+	// needs no frame pointers. RtlVirtualUnwind only reads the unwind data
+	// and the stack, it takes no lock
+	CONTEXT context{};
+	context.ContextFlags = CONTEXT_CONTROL | CONTEXT_INTEGER;
+	uint32_t frameCount{};
+	if (GetThreadContext(handle, &context)) {
+		while (frameCount < maxFrameCount && context.Rip != 0 &&
+			   context.Rsp % sizeof(DWORD64) == 0) {
+			frames[frameCount++] = context.Rip;
+
+			const UnwindTable* pTable{
+				findUnwindTable(tables, tableCount, context.Rip)
+			};
+			if (!pTable) {
+				break;
+			}
+
+			RUNTIME_FUNCTION* pFunction{ findFunction(*pTable, context.Rip) };
+			if (pFunction) {
+				void* handlerData{};
+				DWORD64 establisherFrame{};
+				RtlVirtualUnwind(
+					UNW_FLAG_NHANDLER,
+					pTable->base,
+					context.Rip,
+					pFunction,
+					&context,
+					&handlerData,
+					&establisherFrame,
+					nullptr
+				);
+			} else {
+				// a leaf has nothing on the stack but its return address
+				context.Rip = *rcast<DWORD64*>(context.Rsp);
+				context.Rsp += sizeof(DWORD64);
+			}
+		}
+	}
+
+	ResumeThread(handle);
+	return frameCount;
+}
+
+uint32_t pstd::getAvailablePerfCounters() {
+	return (1u << cast<uint32_t>(PerfCounter::threadCycles)) |
+		   (1u << cast<uint32_t>(PerfCounter::pageFaults));
+}
+
+void pstd::readPerfCounters(PerfCounters* pCounters) {
+	ASSERT(pCounters);
+
+	*pCounters = PerfCounters{};
+
+	ULONG64 threadCycles{};
+	QueryThreadCycleTime(GetCurrentThread(), &threadCycles);
+	pCounters->values[cast<size_t>(PerfCounter::threadCycles)] = threadCycles;
+
+	// the K32 name is in kernel32 itself, no psapi.lib needed
+	PROCESS_MEMORY_COUNTERS memoryCounters{ .cb = sizeof(memoryCounters) };
+	K32GetProcessMemoryInfo(
+		GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters)
+	);
+	pCounters->values[cast<size_t>(PerfCounter::pageFaults)] =
+		memoryCounters.PageFaultCount;
+}
+
+// fiber local storage is the only kind that calls back on thread exit. on
+// a thread that isn't a fiber it's the same as thread local storage
+pstd::ThreadLocalKey pstd::createThreadLocal(ThreadExitFunction onThreadExit) {
+	DWORD key{ FlsAlloc(onThreadExit) };
+	ASSERT(key != FLS_OUT_OF_INDEXES);
+
+	return key;
+}
+
+void pstd::destroyThreadLocal(ThreadLocalKey key) {
+	FlsFree(key);
+}
+
+void* pstd::getThreadLocal(ThreadLocalKey key) {
+	return FlsGetValue(key);
+}
+
+void pstd::setThreadLocal(ThreadLocalKey key, void* pVal) {
+	FlsSetValue(key, pVal);
+}
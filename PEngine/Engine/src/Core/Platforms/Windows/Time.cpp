@@ -0,0 +1,18 @@
+#include "Core/PTime.h"
+
+#include <Windows.h>
+
+uint64_t pstd::getTime() {
+	LARGE_INTEGER counter{};
+	QueryPerformanceCounter(&counter);
+
+	return counter.QuadPart;
+}
+
+uint64_t pstd::getTimeFrequency() {
+	// fixed at boot, the query can't fail on xp and later
+	LARGE_INTEGER frequency{};
+	QueryPerformanceFrequency(&frequency);
+
+	return frequency.QuadPart;
+}
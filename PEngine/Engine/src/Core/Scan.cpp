@@ -0,0 +1,297 @@
+#include "Core/PScan.h"
+#include "Core/PIntrinsics.h"
+#include "Core/PThread.h"
+#include "Core/PAlgorithm.h"
+#include "Core/PAssert.h"
+#include "Core/PTypes.h"
+
+#include "Core/Lanes.h"
+
+#include <tmmintrin.h>
+
+using namespace pstd;
+
+namespace {
+	template<typename T>
+	typename Lanes<T>::Register prefixSumLanes(typename Lanes<T>::Register x);
+
+	template<typename T>
+	void addToAll(T* data, size_t count, T val);
+
+	template<typename T, bool isInclusive>
+	T scan(T* dst, const T* src, size_t count, T carry);
+
+	template<typename T, bool isInclusive>
+	void scanParallel(T* dst, const T* src, size_t count, uint32_t taskCount);
+
+	struct ShuffleTable {
+		alignas(16) uint8_t controls[16][16];
+		uint8_t counts[16];
+	};
+
+	// pshufb controls that pack the 32 bit lanes selected by a 4 bit mask
+	// into the bottom of the register, the rest of the bytes are zeroed
+	constexpr ShuffleTable makeCompactShuffleTable() {
+		ShuffleTable table{};
+		for (uint32_t mask{}; mask < 16; mask++) {
+			uint32_t written{};
+			for (uint32_t lane{}; lane < 4; lane++) {
+				if ((mask >> lane) & 1) {
+					for (uint32_t byte{}; byte < 4; byte++) {
+						table.controls[mask][written * 4 + byte] =
+							ncast<uint8_t>(lane * 4 + byte);
+					}
+					written++;
+				}
+			}
+			for (uint32_t byte{ written * 4 }; byte < 16; byte++) {
+				table.controls[mask][byte] = 0x80;
+			}
+			table.counts[mask] = ncast<uint8_t>(written);
+		}
+		return table;
+	}
+
+	constexpr ShuffleTable g_CompactShuffles{ makeCompactShuffleTable() };
+
+	size_t compactByMask32(
+		uint32_t* dst, const uint32_t* src, uint64_t keepMask, uint32_t count
+	);
+	size_t compactByMask64(
+		uint64_t* dst, const uint64_t* src, uint64_t keepMask, uint32_t count
+	);
+}  // namespace
+
+template<ArithmeticType T>
+T pstd::inclusiveScan(T* dst, const T* src, size_t count, T carry) {
+	return scan<T, true>(dst, src, count, carry);
+}
+
+template<ArithmeticType T>
+T pstd::exclusiveScan(T* dst, const T* src, size_t count, T carry) {
+	return scan<T, false>(dst, src, count, carry);
+}
+
+template<ArithmeticType T>
+void pstd::inclusiveScanParallel(
+	T* dst, const T* src, size_t count, uint32_t taskCount
+) {
+	scanParallel<T, true>(dst, src, count, taskCount);
+}
+
+template<ArithmeticType T>
+void pstd::exclusiveScanParallel(
+	T* dst, const T* src, size_t count, uint32_t taskCount
+) {
+	scanParallel<T, false>(dst, src, count, taskCount);
+}
+
+size_t pstd::compactByMask(
+	void* dst,
+	const void* src,
+	uint64_t keepMask,
+	uint32_t elementCount,
+	uint32_t elementSize
+) {
+	ASSERT(dst);
+	ASSERT(src);
+	ASSERT(elementCount <= 64);
+	ASSERT(elementSize == 4 || elementSize == 8);
+
+	if (elementSize == 4) {
+		return compactByMask32(
+			rcast<uint32_t*>(dst),
+			rcast<const uint32_t*>(src),
+			keepMask,
+			elementCount
+		);
+	}
+	return compactByMask64(
+		rcast<uint64_t*>(dst),
+		rcast<const uint64_t*>(src),
+		keepMask,
+		elementCount
+	);
+}
+
+namespace {
+	// log2(width) shift and add steps, the classic in register scan
+	template<typename T>
+	typename Lanes<T>::Register prefixSumLanes(typename Lanes<T>::Register x) {
+		using L = Lanes<T>;
+
+		x = L::add(x, L::template shiftLanesUp<1>(x));
+		if constexpr (L::width > 2) {
+			x = L::add(x, L::template shiftLanesUp<2>(x));
+		}
+		if constexpr (L::width > 4) {
+			x = L::add(x, L::template shiftLanesUp<4>(x));
+		}
+		if constexpr (L::width > 8) {
+			x = L::add(x, L::template shiftLanesUp<8>(x));
+		}
+		return x;
+	}
+
+	template<typename T>
+	void addToAll(T* data, size_t count, T val) {
+		using L = Lanes<T>;
+
+		typename L::Register offset{ L::splat(val) };
+
+		size_t i{};
+		for (; i + L::width <= count; i += L::width) {
+			L::store(data + i, L::add(L::load(data + i), offset));
+		}
+		for (; i < count; i++) {
+			data[i] += val;
+		}
+	}
+
+	template<typename T, bool isInclusive>
+	T scan(T* dst, const T* src, size_t count, T carry) {
+		ASSERT((dst && src) || count == 0);
+
+		using L = Lanes<T>;
+
+		size_t i{};
+		for (; i + L::width <= count; i += L::width) {
+			typename L::Register prefix{ prefixSumLanes<T>(L::load(src + i)) };
+			typename L::Register carryLanes{ L::splat(carry) };
+			typename L::Register inclusive{ L::add(prefix, carryLanes) };
+			if constexpr (isInclusive) {
+				L::store(dst + i, inclusive);
+			} else {
+				L::store(
+					dst + i,
+					L::add(L::template shiftLanesUp<1>(prefix), carryLanes)
+				);
+			}
+			carry = L::getLastLane(inclusive);
+		}
+
+		for (; i < count; i++) {
+			T val{ src[i] };
+			if constexpr (isInclusive) {
+				carry += val;
+				dst[i] = carry;
+			} else {
+				dst[i] = carry;
+				carry += val;
+			}
+		}
+
+		return carry;
+	}
+
+	template<typename T, bool isInclusive>
+	void scanParallel(T* dst, const T* src, size_t count, uint32_t taskCount) {
+		taskCount = calcParallelTaskCount(count, taskCount);
+		if (taskCount == 1) {
+			scan<T, isInclusive>(dst, src, count, T{});
+			return;
+		}
+
+		size_t blockSize{ (count + taskCount - 1) / taskCount };
+
+		T blockTotals[MAX_PARALLEL_TASKS]{};
+		runParallel(taskCount, [&](uint32_t taskIndex) {
+			size_t begin{ min(taskIndex * blockSize, count) };
+			size_t end{ min(begin + blockSize, count) };
+			blockTotals[taskIndex] = scan<T, isInclusive>(
+				dst + begin, src + begin, end - begin, T{}
+			);
+		});
+
+		T blockCarries[MAX_PARALLEL_TASKS]{};
+		for (uint32_t taskIndex{ 1 }; taskIndex < taskCount; taskIndex++) {
+			blockCarries[taskIndex] =
+				blockCarries[taskIndex - 1] + blockTotals[taskIndex - 1];
+		}
+
+		runParallel(taskCount, [&](uint32_t taskIndex) {
+			size_t begin{ min(taskIndex * blockSize, count) };
+			size_t end{ min(begin + blockSize, count) };
+			if (taskIndex > 0) {
+				addToAll(dst + begin, end - begin, blockCarries[taskIndex]);
+			}
+		});
+	}
+
+	size_t compactByMask32(
+		uint32_t* dst, const uint32_t* src, uint64_t keepMask, uint32_t count
+	) {
+		size_t written{};
+		uint32_t i{};
+		if (getCpuFeatures().ssse3) {
+			for (; i + 4 <= count; i += 4) {
+				uint32_t laneMask{ ncast<uint32_t>((keepMask >> i) & 0xF) };
+				__m128i lanes{ _mm_loadu_si128(rcast<const __m128i*>(src + i)) };
+				__m128i control{ _mm_load_si128(
+					rcast<const __m128i*>(g_CompactShuffles.controls[laneMask])
+				) };
+				_mm_storeu_si128(
+					rcast<__m128i*>(dst + written), _mm_shuffle_epi8(lanes, control)
+				);
+				written += g_CompactShuffles.counts[laneMask];
+			}
+		}
+
+		for (; i < count; i++) {
+			dst[written] = src[i];
+			written += (keepMask >> i) & 1;
+		}
+
+		return written;
+	}
+
+	size_t compactByMask64(
+		uint64_t* dst, const uint64_t* src, uint64_t keepMask, uint32_t count
+	) {
+		size_t written{};
+		uint32_t i{};
+		for (; i + 2 <= count; i += 2) {
+			uint32_t laneMask{ ncast<uint32_t>((keepMask >> i) & 0x3) };
+			__m128i lanes{ _mm_loadu_si128(rcast<const __m128i*>(src + i)) };
+			// only a lone upper lane has to move, sse2 can do that directly
+			if (laneMask == 0b10) {
+				lanes = _mm_unpackhi_epi64(lanes, lanes);
+			}
+			_mm_storeu_si128(rcast<__m128i*>(dst + written), lanes);
+			written += popCount(laneMask);
+		}
+
+		for (; i < count; i++) {
+			dst[written] = src[i];
+			written += (keepMask >> i) & 1;
+		}
+
+		return written;
+	}
+}  // namespace
+
+#define INSTANTIATE_SCAN_KERNELS(T)                                          \
+	template T pstd::inclusiveScan(                                          \
+		T* dst, const T* src, size_t count, T carry                          \
+	);                                                                       \
+	template T pstd::exclusiveScan(                                          \
+		T* dst, const T* src, size_t count, T carry                          \
+	);                                                                       \
+	template void pstd::inclusiveScanParallel(                               \
+		T* dst, const T* src, size_t count, uint32_t taskCount               \
+	);                                                                       \
+	template void pstd::exclusiveScanParallel(                               \
+		T* dst, const T* src, size_t count, uint32_t taskCount               \
+	);
+
+INSTANTIATE_SCAN_KERNELS(char)
+INSTANTIATE_SCAN_KERNELS(int8_t)
+INSTANTIATE_SCAN_KERNELS(int16_t)
+INSTANTIATE_SCAN_KERNELS(int32_t)
+INSTANTIATE_SCAN_KERNELS(int64_t)
+INSTANTIATE_SCAN_KERNELS(uint8_t)
+INSTANTIATE_SCAN_KERNELS(uint16_t)
+INSTANTIATE_SCAN_KERNELS(uint32_t)
+INSTANTIATE_SCAN_KERNELS(uint64_t)
+INSTANTIATE_SCAN_KERNELS(float)
+INSTANTIATE_SCAN_KERNELS(double)
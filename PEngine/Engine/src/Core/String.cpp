@@ -9,31 +9,27 @@
 using namespace pstd;
 
 namespace {
-	pstd::String pushUInt64AsString(
-		pstd::Arena* pArena, uint64_t number
-	);	// returns size of string pushed
-	pstd::String pushInt64AsString(
-		pstd::Arena* pArena, int64_t number
-	);	// returns size of string pushed
-	pstd::String pushDoubleAsString(
-		pstd::Arena* pArena,
-		double number,
-		uint32_t precision = 5
-	);	// returns size of string pushed
-
 	pstd::String pushString(
 		pstd::Arena* pArena, const String& string
 	);	// returns size of string pushed
 
-	pstd::String pushStringUntilControlCharacter(
-		pstd::Arena* pArena,
-		const String& format,
-		uint32_t* outFormatCharactersProccessed,
-		char* outControlCharacter
-	);
-	// returns size of string pushed
-
 	pstd::String pushLetter(pstd::Arena* pArena, char letter);
+
+	struct DigitPairs {
+		char letters[200];
+	};
+
+	// "00" to "99", two digits per division
+	constexpr DigitPairs makeDigitPairs() {
+		DigitPairs pairs{};
+		for (uint32_t i{}; i < 100; i++) {
+			pairs.letters[i * 2] = ncast<char>('0' + i / 10);
+			pairs.letters[i * 2 + 1] = ncast<char>('0' + i % 10);
+		}
+		return pairs;
+	}
+
+	constexpr DigitPairs g_DigitPairs{ makeDigitPairs() };
 }  // namespace
 
 String pstd::createString(pstd::Arena* pArena, const String& string) {
@@ -104,6 +100,14 @@ bool pstd::concat(String* a, String&& b) {
 String pstd::makeConcatted(pstd::Arena* pArena, String a, String b) {
 	ASSERT(pArena);
 
+	// a that ends at the tip of the arena is extended in place, only b is
+	// copied after it
+	const char* tip{ rcast<const char*>(pArena->block) + pArena->offset };
+	if (a.buffer && a.buffer + a.size == tip) {
+		String newB{ pushString(pArena, b) };
+		return String{ .buffer = a.buffer, .size = a.size + newB.size };
+	}
+
 	String newA{ pushString(pArena, a) };
 	String newB{ pushString(pArena, b) };
 	String res{
@@ -114,218 +118,203 @@ String pstd::makeConcatted(pstd::Arena* pArena, String a, String b) {
 	return res;
 }
 
-String pstd::formatString(pstd::Arena* pArena, const String& format) {
-	String res{ pushString(pArena, format) };
-	return res;
+uint32_t pstd::calcDigitCount(uint64_t val) {
+	uint32_t count{ 1 };
+	while (true) {
+		if (val < 10) {
+			return count;
+		}
+		if (val < 100) {
+			return count + 1;
+		}
+		if (val < 1000) {
+			return count + 2;
+		}
+		if (val < 10000) {
+			return count + 3;
+		}
+		val /= 10000;
+		count += 4;
+	}
 }
 
-template<typename T>
-String pstd::formatString(pstd::Arena* pArena, const String& format, T val) {
-	char controlCharacter{};
-	uint32_t formatCharactersProccessed{};
-	String string{ pushStringUntilControlCharacter(
-		pArena, format, &formatCharactersProccessed, &controlCharacter
-	) };
-
-	switch (controlCharacter) {
-		case 'i': {
-			concat(&string, pushInt64AsString(pArena, ncast<int64_t>(val)));
-		} break;
-		case 'u': {
-			concat(&string, pushInt64AsString(pArena, ncast<uint64_t>(val)));
-		} break;
-		case 'f': {
-			concat(&string, pushDoubleAsString(pArena, ncast<double>(val)));
-		} break;
-		default:
-			break;
+uint32_t pstd::writeUInt64(char* dst, uint64_t val) {
+	ASSERT(dst);
+
+	uint32_t count{ calcDigitCount(val) };
+	char* pLetter{ dst + count };
+	while (val >= 100) {
+		uint64_t pairIndex{ (val % 100) * 2 };
+		val /= 100;
+		pLetter -= 2;
+		pLetter[0] = g_DigitPairs.letters[pairIndex];
+		pLetter[1] = g_DigitPairs.letters[pairIndex + 1];
 	}
-	auto stringFormatSizeDifference{
-		pstd::abs(ncast<int>(format.size) - ncast<int>(string.size))
-	};
-
-	if (formatCharactersProccessed < format.size) {
-		String restOfFormat{ .buffer =
-								 format.buffer + formatCharactersProccessed,
-							 .size = format.size - formatCharactersProccessed };
-
-		concat(&string, pushString(pArena, restOfFormat));
+	if (val >= 10) {
+		pLetter -= 2;
+		pLetter[0] = g_DigitPairs.letters[val * 2];
+		pLetter[1] = g_DigitPairs.letters[val * 2 + 1];
+	} else {
+		pLetter--;
+		*pLetter = ncast<char>('0' + val);
 	}
-
-	return string;
+	return count;
 }
 
-template<>
-String pstd::formatString(
-	pstd::Arena* pArena, const String& format, pstd::String val
-) {
-	char controlCharacter{};
-	uint32_t formatCharactersProccessed{};
-	String string{ pushStringUntilControlCharacter(
-		pArena, format, &formatCharactersProccessed, &controlCharacter
-	) };
+uint32_t pstd::writeInt64(char* dst, int64_t val) {
+	ASSERT(dst);
 
-	if (controlCharacter == 'm') {
-		concat(&string, pushString(pArena, val));
+	if (val >= 0) {
+		return writeUInt64(dst, ncast<uint64_t>(val));
 	}
 
-	if (formatCharactersProccessed < format.size) {
-		String restOfFormat{ .buffer =
-								 format.buffer + formatCharactersProccessed,
-							 .size = format.size - formatCharactersProccessed };
-
-		concat(&string, pushString(pArena, restOfFormat));
-	}
-
-	return string;
+	// negated as unsigned, so the most negative value survives
+	*dst = '-';
+	return writeUInt64(dst + 1, 0 - ncast<uint64_t>(val)) + 1;
 }
 
-template<>
-String pstd::formatString(
-	pstd::Arena* pArena, const String& format, const char* val
-) {
-	return formatString(pArena, format, createString(val));
+String pstd::pushUInt64AsString(Arena* pArena, uint64_t val) {
+	char letters[MAX_INT64_CHARS];
+	uint32_t size{ writeUInt64(letters, val) };
+	return pushString(pArena, String{ .buffer = letters, .size = size });
 }
 
-String pstd::getFileName(const String& string) {
-	uint32_t fileNameSize{};
-	for (uint32_t i{}; i < string.size; i++) {
-		uint32_t reverseI{ string.size - 1 - i };
+String pstd::pushInt64AsString(Arena* pArena, int64_t val) {
+	char letters[MAX_INT64_CHARS];
+	uint32_t size{ writeInt64(letters, val) };
+	return pushString(pArena, String{ .buffer = letters, .size = size });
+}
 
-		char letter{ string.buffer[reverseI] };
-		if (letter == '\\' || letter == '/') {
-			break;
-		}
-		fileNameSize++;
-	}
-	size_t pathSize{ string.size - fileNameSize };
-	const char* address{ string.buffer + pathSize };
-	String res{ .buffer = address, .size = fileNameSize };
-	return res;
+String pstd::pushFloatAsString(Arena* pArena, float val) {
+	char letters[MAX_DECIMAL_CHARS];
+	uint32_t size{ writeFloat(letters, val) };
+	return pushString(pArena, String{ .buffer = letters, .size = size });
 }
 
-String pstd::getFileName(const char* cString) {
-	return getFileName(pstd::createString(cString));
+String pstd::pushDoubleAsString(Arena* pArena, double val) {
+	char letters[MAX_DECIMAL_CHARS];
+	uint32_t size{ writeDouble(letters, val) };
+	return pushString(pArena, String{ .buffer = letters, .size = size });
 }
 
-bool pstd::substringMatchForward(
-	const String& a, const String& b, uint32_t* outIndex
-) {
-	ASSERT(b.size != 0);
-	ASSERT(b.buffer);
-	ASSERT(a.size != 0);
-	ASSERT(a.buffer);
+void pstd::formatUInt64(FormattedArg* pOut, uint64_t val) {
+	ASSERT(pOut);
 
-	size_t charactersMatched{};
-	for (size_t i{}; i < a.size; i++) {
-		if (a.buffer[i] == b.buffer[charactersMatched]) {
-			charactersMatched++;
-		} else {
-			charactersMatched = 0;
-		}
+	pOut->buffer = pOut->digits;
+	pOut->size = writeUInt64(pOut->digits, val);
+}
 
-		if (charactersMatched == b.size) {
-			if (outIndex) {
-				*outIndex = i;
-			}
-			return true;
-		}
-	}
-	return false;
+void pstd::formatInt64(FormattedArg* pOut, int64_t val) {
+	ASSERT(pOut);
+
+	pOut->buffer = pOut->digits;
+	pOut->size = writeInt64(pOut->digits, val);
 }
 
-bool pstd::substringMatchBackward(
-	const String& a, const String& b, uint32_t* outIndex
-) {
-	ASSERT(b.size != 0);
-	ASSERT(b.buffer);
-	ASSERT(a.size != 0);
-	ASSERT(a.buffer);
+void pstd::formatFloat(FormattedArg* pOut, float val) {
+	ASSERT(pOut);
 
-	size_t charactersMatched{};
-	for (size_t i{}; i < a.size; i++) {
-		size_t reverseIndexA{ a.size - i - 1 };
+	pOut->buffer = pOut->digits;
+	pOut->size = writeFloat(pOut->digits, val);
+}
 
-		size_t reverseIndexB{ b.size - charactersMatched - 1 };
+void pstd::formatDouble(FormattedArg* pOut, double val) {
+	ASSERT(pOut);
 
-		if (a.buffer[reverseIndexA] == b.buffer[reverseIndexB]) {
-			charactersMatched++;
-		} else {
-			charactersMatched = 0;
-		}
+	pOut->buffer = pOut->digits;
+	pOut->size = writeDouble(pOut->digits, val);
+}
 
-		if (charactersMatched == b.size) {
-			if (outIndex) {
-				*outIndex = reverseIndexA;
-			}
-			return true;
+size_t pstd::calcFormattedSize(
+	uint32_t literalSize,
+	const FormatPiece* pieces,
+	uint32_t pieceCount,
+	const FormattedArg* args
+) {
+	ASSERT(pieces);
+
+	size_t size{ literalSize };
+	for (uint32_t i{}; i < pieceCount; i++) {
+		if (pieces[i].argIndex != FORMAT_NO_ARG) {
+			size += args[pieces[i].argIndex].size;
 		}
 	}
-	return false;
+
+	return size;
 }
 
-namespace {
-	String pushDoubleAsString(
-		pstd::Arena* pArena, double number, uint32_t precision
-	) {
-		ASSERT(precision < 128);  // to avoid a loop that blows out the buffer
-
-		String string{};
-		if (number < 0) {
-			concat(&string, pushLetter(pArena, '-'));
-			number *= -1.f;
+uint32_t pstd::copyFormatted(
+	char* dst,
+	uint32_t capacity,
+	const char* format,
+	const FormatPiece* pieces,
+	uint32_t pieceCount,
+	const FormattedArg* args
+) {
+	ASSERT(dst || capacity == 0);
+	ASSERT(format);
+	ASSERT(pieces);
+
+	uint32_t written{};
+	auto append{ [&](const char* src, uint32_t srcSize) {
+		uint32_t copySize{ min(srcSize, capacity - written) };
+		memCpy(dst + written, src, copySize);
+		written += copySize;
+	} };
+
+	for (uint32_t i{}; i < pieceCount; i++) {
+		const FormatPiece& piece{ pieces[i] };
+		append(format + piece.literalOffset, piece.literalSize);
+		if (piece.argIndex != FORMAT_NO_ARG) {
+			const FormattedArg& arg{ args[piece.argIndex] };
+			append(arg.buffer, arg.size);
 		}
+	}
 
-		auto wholePart{ ncast<uint32_t>(number) };
-		concat(&string, pushUInt64AsString(pArena, wholePart));
+	return written;
+}
 
-		concat(&string, pushLetter(pArena, '.'));
+String pstd::writeFormatted(
+	pstd::Arena* pArena,
+	const char* format,
+	uint32_t literalSize,
+	const FormatPiece* pieces,
+	uint32_t pieceCount,
+	const FormattedArg* args
+) {
+	ASSERT(pArena);
 
-		size_t factor{ pstd::pow<size_t>(10, precision) };
-		auto decimalPart{
-			ncast<uint32_t>((pstd::abs(number - wholePart) * factor) + 0.5f)
-		};
-		concat(&string, pushUInt64AsString(pArena, decimalPart));
-		return string;
+	size_t size{ calcFormattedSize(literalSize, pieces, pieceCount, args) };
+	size = min(size, ncast<size_t>(getAvailableCount<char>(*pArena)));
+	if (size == 0) {
+		return {};
 	}
 
-	String pushInt64AsString(pstd::Arena* pArena, int64_t number) {
-		size_t stringSize{};
-		if (number >= 0) {
-			return pushUInt64AsString(pArena, (uint32_t)number);
-		}
+	char* buffer{ pstd::alloc<char>(pArena, size) };
+	uint32_t written{ copyFormatted(
+		buffer, ncast<uint32_t>(size), format, pieces, pieceCount, args
+	) };
 
-		String string{ pushLetter(pArena, '-') };
+	return String{ .buffer = buffer, .size = written };
+}
 
-		concat(&string, pushUInt64AsString(pArena, -number));
+String pstd::getFileName(const String& string) {
+	uint32_t separatorIndex{};
+	if (!findLastAnyOf(string, createString("\\/"), &separatorIndex)) {
 		return string;
 	}
 
-	String pushUInt64AsString(pstd::Arena* pArena, uint64_t number) {
-		uint32_t count{ 1 };
-		{
-			size_t bufferCountAvaliable{ getAvailableCount<char>(*pArena) };
-			uint64_t numberCopy{ number };
-			while (numberCopy > 9 && count < bufferCountAvaliable) {
-				numberCopy /= 10;
-				count++;
-			}
-		}
-
-		auto letterArray{ pstd::createArray<char>(pArena, count) };
+	uint32_t pathSize{ separatorIndex + 1 };
+	String res{ .buffer = string.buffer + pathSize,
+				.size = string.size - pathSize };
+	return res;
+}
 
-		for (uint32_t i{}; i < count; i++) {
-			uint32_t reverseIndex{ (count - 1) - i };
-			uint64_t digit{ number % 10 };
-			char digitLetter{ (char)((uint32_t)'0' + digit) };
-			letterArray[reverseIndex] = digitLetter;
-			number /= 10;
-		}
-		String string{ .buffer = rcast<const char*>(letterArray.data),
-					   .size = ncast<uint32_t>(letterArray.count) };
-		return string;
-	}
+String pstd::getFileName(const char* cString) {
+	return getFileName(pstd::createString(cString));
+}
 
+namespace {
 	String pushLetter(pstd::Arena* pArena, char letter) {
 		if (pstd::getAvailableCount<char>(*pArena) == 0) {
 			return {};
@@ -348,55 +337,4 @@ namespace {
 		memcpy(newStringBuffer, string.buffer, string.size);
 		return String{ .buffer = newStringBuffer, .size = string.size };
 	}
-
-	String pushStringUntilControlCharacter(
-		pstd::Arena* pArena,
-		const String& format,
-		uint32_t* outFormatCharactersProccessed,
-		char* outControlCharacter
-	) {
-		size_t searchSize{
-			min(pstd::getAvailableCount<char>(*pArena), format.size)
-		};
-
-		char previousLetter{};
-		char controlCharacter{ '\0' };
-		uint32_t normalStringSize{};
-		uint32_t controlCharactersProccessedSize{};
-		for (size_t i{}; i < searchSize; i++) {
-			char currentLetter{ format.buffer[i] };
-
-			if (previousLetter == '%') {
-				controlCharacter = currentLetter;
-				normalStringSize--;
-				controlCharactersProccessedSize = 2;
-				break;
-			}
-
-			previousLetter = currentLetter;
-			normalStringSize++;
-		}
-		pstd::String normalString{ .buffer = format.buffer,
-								   .size = normalStringSize };
-		*outControlCharacter = controlCharacter;
-		*outFormatCharactersProccessed =
-			normalStringSize + controlCharactersProccessedSize;
-
-		String res{ pushString(pArena, normalString) };
-		return res;
-	}
 }  // namespace
-
-template String
-	pstd::formatString(pstd::Arena* pArena, const String& format, uint64_t val);
-template String
-	pstd::formatString(pstd::Arena* pArena, const String& format, int64_t val);
-template String
-	pstd::formatString(pstd::Arena* pArena, const String& format, double val);
-
-template String
-	pstd::formatString(pstd::Arena* pArena, const String& format, uint32_t val);
-template String
-	pstd::formatString(pstd::Arena* pArena, const String& format, int32_t val);
-template String
-	pstd::formatString(pstd::Arena* pArena, const String& format, float val);
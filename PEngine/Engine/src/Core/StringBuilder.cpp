@@ -0,0 +1,133 @@
+#include "Core/PStringBuilder.h"
+#include "Core/PArena.h"
+#include "Core/PAlgorithm.h"
+#include "Core/PMemory.h"
+#include "Core/PAssert.h"
+
+using namespace pstd;
+
+namespace {
+	constexpr uint32_t MIN_BUILDER_GROWTH{ 64 };
+
+	char* getArenaTip(const Arena& arena) {
+		return rcast<char*>(arena.block) + arena.offset;
+	}
+}  // namespace
+
+StringBuilder pstd::createStringBuilder(Arena* pArena, uint32_t capacity) {
+	ASSERT(pArena);
+
+	StringBuilder res{ .pArena = pArena, .buffer = getArenaTip(*pArena) };
+	reserve(&res, capacity);
+
+	return res;
+}
+
+void pstd::reserve(StringBuilder* pBuilder, uint32_t extraSize) {
+	ASSERT(pBuilder);
+	ASSERT(pBuilder->pArena);
+
+	uint32_t neededSize{ pBuilder->size + extraSize };
+	if (neededSize <= pBuilder->capacity) {
+		return;
+	}
+
+	Arena* pArena{ pBuilder->pArena };
+	uint32_t availableSize{ getAvailableCount<char>(*pArena) };
+
+	if (pBuilder->buffer + pBuilder->capacity == getArenaTip(*pArena)) {
+		uint32_t growth{ neededSize - pBuilder->capacity };
+		growth = max(growth, max(pBuilder->capacity, MIN_BUILDER_GROWTH));
+		growth = min(growth, availableSize);
+
+		pArena->offset += growth;
+		pBuilder->capacity += growth;
+		return;
+	}
+
+	// something else was allocated after the buffer, it has to move
+	uint32_t newCapacity{ max(neededSize, pBuilder->capacity * 2) };
+	newCapacity = min(newCapacity, availableSize);
+	if (newCapacity <= pBuilder->capacity) {
+		return;
+	}
+
+	char* newBuffer{ alloc<char>(pArena, newCapacity) };
+	memCpy(newBuffer, pBuilder->buffer, pBuilder->size);
+
+	pBuilder->buffer = newBuffer;
+	pBuilder->capacity = newCapacity;
+}
+
+void pstd::append(StringBuilder* pBuilder, const String& string) {
+	ASSERT(pBuilder);
+
+	reserve(pBuilder, string.size);
+
+	uint32_t copySize{ min(string.size, pBuilder->capacity - pBuilder->size) };
+	memCpy(pBuilder->buffer + pBuilder->size, string.buffer, copySize);
+	pBuilder->size += copySize;
+}
+
+void pstd::append(StringBuilder* pBuilder, char letter) {
+	ASSERT(pBuilder);
+
+	reserve(pBuilder, 1);
+
+	if (pBuilder->size < pBuilder->capacity) {
+		pBuilder->buffer[pBuilder->size] = letter;
+		pBuilder->size++;
+	}
+}
+
+void pstd::appendFormatted(
+	StringBuilder* pBuilder,
+	const char* format,
+	uint32_t literalSize,
+	const FormatPiece* pieces,
+	uint32_t pieceCount,
+	const FormattedArg* args
+) {
+	ASSERT(pBuilder);
+
+	size_t size{ calcFormattedSize(literalSize, pieces, pieceCount, args) };
+	reserve(pBuilder, ncast<uint32_t>(min(size, ncast<size_t>(UINT32_MAX))));
+
+	pBuilder->size += copyFormatted(
+		pBuilder->buffer + pBuilder->size,
+		pBuilder->capacity - pBuilder->size,
+		format,
+		pieces,
+		pieceCount,
+		args
+	);
+}
+
+String pstd::finishString(StringBuilder* pBuilder, bool nullTerminate) {
+	ASSERT(pBuilder);
+	ASSERT(pBuilder->pArena);
+
+	uint32_t usedSize{ pBuilder->size };
+	if (nullTerminate) {
+		reserve(pBuilder, 1);
+		ASSERT(pBuilder->capacity > 0);
+
+		// in a full arena the terminator takes the place of the last letter
+		if (pBuilder->size == pBuilder->capacity) {
+			pBuilder->size--;
+		}
+		pBuilder->buffer[pBuilder->size] = '\0';
+		usedSize = pBuilder->size + 1;
+	}
+
+	Arena* pArena{ pBuilder->pArena };
+	if (pBuilder->buffer + pBuilder->capacity == getArenaTip(*pArena)) {
+		pArena->offset -= pBuilder->capacity - usedSize;
+	}
+
+	String res{ .buffer = pBuilder->buffer, .size = pBuilder->size };
+	*pBuilder = StringBuilder{ .pArena = pArena,
+							   .buffer = getArenaTip(*pArena) };
+
+	return res;
+}
@@ -0,0 +1,570 @@
+#include "Core/PString.h"
+#include "Core/PIntrinsics.h"
+#include "Core/PAlgorithm.h"
+#include "Core/PAssert.h"
+#include "Core/PTypes.h"
+
+#include <emmintrin.h>
+
+using namespace pstd;
+
+namespace {
+	// the first and last byte filter verifies every candidate, so on
+	// repetitive text its cost grows with the pattern. longer patterns use
+	// two way, which is linear in the text no matter the input
+	constexpr uint32_t MAX_FILTER_PATTERN_SIZE{ 32 };
+
+	constexpr uint32_t SMALL_CHAR_SET_SIZE{ 8 };
+
+	uint32_t getMatchMask(__m128i letters, __m128i splat) {
+		return ncast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(letters, splat))
+		);
+	}
+
+	__m128i loadLetters(const char* text) {
+		return _mm_loadu_si128(rcast<const __m128i*>(text));
+	}
+
+	uint32_t getHighestBit(uint32_t mask) {
+		return 63 - countLeadingZeros(mask);
+	}
+
+	bool lettersMatch(const char* a, const char* b, uint32_t size) {
+		for (uint32_t i{}; i < size; i++) {
+			if (a[i] != b[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool findLetter(
+		const char* text, uint32_t size, char letter, uint32_t* outIndex
+	);
+
+	bool findLastLetter(
+		const char* text, uint32_t size, char letter, uint32_t* outIndex
+	);
+
+	bool findWithFilter(
+		const String& text, const String& pattern, uint32_t* outIndex
+	);
+
+	bool findLastWithFilter(
+		const String& text, const String& pattern, uint32_t* outIndex
+	);
+
+	template<bool isReversed>
+	bool findWithTwoWay(
+		const String& text, const String& pattern, uint32_t* outIndex
+	);
+
+	struct CharSet {
+		uint64_t bits[4];
+	};
+
+	CharSet createCharSet(const String& set);
+
+	bool isInCharSet(const CharSet& charSet, char letter) {
+		auto index{ ncast<uint8_t>(letter) };
+		return (charSet.bits[index >> 6] >> (index & 63)) & 1;
+	}
+
+	// one bit per text letter that is any of the set's letters
+	uint32_t getCharSetMask(
+		__m128i letters, const __m128i* setSplats, uint32_t setSize
+	) {
+		__m128i isMatch{ _mm_setzero_si128() };
+		for (uint32_t i{}; i < setSize; i++) {
+			__m128i isLetter{ _mm_cmpeq_epi8(letters, setSplats[i]) };
+			isMatch = _mm_or_si128(isMatch, isLetter);
+		}
+		return ncast<uint32_t>(_mm_movemask_epi8(isMatch));
+	}
+}  // namespace
+
+uint32_t pstd::calcCStringLength(const char* cString) {
+	ASSERT(cString);
+
+	// aligned loads never cross a page boundary, so reading past the
+	// terminator stays inside memory that is already mapped
+	auto address{ rcast<uintptr_t>(cString) };
+	uint32_t misalignment{ ncast<uint32_t>(address & 15) };
+	const char* block{ cString - misalignment };
+
+	__m128i zero{ _mm_setzero_si128() };
+	uint32_t mask{
+		getMatchMask(_mm_load_si128(rcast<const __m128i*>(block)), zero) >>
+		misalignment
+	};
+	if (mask != 0) {
+		return countTrailingZeros(mask);
+	}
+
+	while (true) {
+		block += 16;
+		mask = getMatchMask(_mm_load_si128(rcast<const __m128i*>(block)), zero);
+		if (mask != 0) {
+			return ncast<uint32_t>(block - cString) + countTrailingZeros(mask);
+		}
+	}
+}
+
+bool pstd::findSubstring(
+	const String& text, const String& pattern, uint32_t* outIndex
+) {
+	ASSERT(text.buffer || text.size == 0);
+	ASSERT(pattern.buffer);
+	ASSERT(pattern.size != 0);
+
+	if (pattern.size > text.size) {
+		return false;
+	}
+	if (pattern.size == 1) {
+		return findLetter(text.buffer, text.size, pattern.buffer[0], outIndex);
+	}
+	if (pattern.size <= MAX_FILTER_PATTERN_SIZE) {
+		return findWithFilter(text, pattern, outIndex);
+	}
+	return findWithTwoWay<false>(text, pattern, outIndex);
+}
+
+bool pstd::findLastSubstring(
+	const String& text, const String& pattern, uint32_t* outIndex
+) {
+	ASSERT(text.buffer || text.size == 0);
+	ASSERT(pattern.buffer);
+	ASSERT(pattern.size != 0);
+
+	if (pattern.size > text.size) {
+		return false;
+	}
+	if (pattern.size == 1) {
+		return findLastLetter(
+			text.buffer, text.size, pattern.buffer[0], outIndex
+		);
+	}
+	if (pattern.size <= MAX_FILTER_PATTERN_SIZE) {
+		return findLastWithFilter(text, pattern, outIndex);
+	}
+	return findWithTwoWay<true>(text, pattern, outIndex);
+}
+
+bool pstd::findAnyOf(
+	const String& text, const String& set, uint32_t* outIndex
+) {
+	ASSERT(text.buffer || text.size == 0);
+	ASSERT(set.buffer || set.size == 0);
+
+	uint32_t i{};
+	if (set.size <= SMALL_CHAR_SET_SIZE) {
+		__m128i setSplats[SMALL_CHAR_SET_SIZE];
+		for (uint32_t j{}; j < set.size; j++) {
+			setSplats[j] = _mm_set1_epi8(set.buffer[j]);
+		}
+		for (; i + 16 <= text.size; i += 16) {
+			uint32_t mask{ getCharSetMask(
+				loadLetters(text.buffer + i), setSplats, set.size
+			) };
+			if (mask != 0) {
+				if (outIndex) {
+					*outIndex = i + countTrailingZeros(mask);
+				}
+				return true;
+			}
+		}
+	}
+
+	CharSet charSet{ createCharSet(set) };
+	for (; i < text.size; i++) {
+		if (isInCharSet(charSet, text.buffer[i])) {
+			if (outIndex) {
+				*outIndex = i;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+bool pstd::findLastAnyOf(
+	const String& text, const String& set, uint32_t* outIndex
+) {
+	ASSERT(text.buffer || text.size == 0);
+	ASSERT(set.buffer || set.size == 0);
+
+	uint32_t end{ text.size };
+	if (set.size <= SMALL_CHAR_SET_SIZE) {
+		__m128i setSplats[SMALL_CHAR_SET_SIZE];
+		for (uint32_t j{}; j < set.size; j++) {
+			setSplats[j] = _mm_set1_epi8(set.buffer[j]);
+		}
+		for (; end >= 16; end -= 16) {
+			uint32_t mask{ getCharSetMask(
+				loadLetters(text.buffer + end - 16), setSplats, set.size
+			) };
+			if (mask != 0) {
+				if (outIndex) {
+					*outIndex = end - 16 + getHighestBit(mask);
+				}
+				return true;
+			}
+		}
+	}
+
+	CharSet charSet{ createCharSet(set) };
+	for (; end > 0; end--) {
+		if (isInCharSet(charSet, text.buffer[end - 1])) {
+			if (outIndex) {
+				*outIndex = end - 1;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+bool pstd::substringMatchForward(
+	const String& a, const String& b, uint32_t* outIndex
+) {
+	ASSERT(b.size != 0);
+	ASSERT(b.buffer);
+	ASSERT(a.size != 0);
+	ASSERT(a.buffer);
+
+	uint32_t index{};
+	if (!findSubstring(a, b, &index)) {
+		return false;
+	}
+	if (outIndex) {
+		*outIndex = index + b.size - 1;
+	}
+	return true;
+}
+
+bool pstd::substringMatchBackward(
+	const String& a, const String& b, uint32_t* outIndex
+) {
+	ASSERT(b.size != 0);
+	ASSERT(b.buffer);
+	ASSERT(a.size != 0);
+	ASSERT(a.buffer);
+
+	return findLastSubstring(a, b, outIndex);
+}
+
+namespace {
+	bool findLetter(
+		const char* text, uint32_t size, char letter, uint32_t* outIndex
+	) {
+		__m128i splat{ _mm_set1_epi8(letter) };
+		uint32_t i{};
+		for (; i + 16 <= size; i += 16) {
+			uint32_t mask{ getMatchMask(loadLetters(text + i), splat) };
+			if (mask != 0) {
+				if (outIndex) {
+					*outIndex = i + countTrailingZeros(mask);
+				}
+				return true;
+			}
+		}
+		for (; i < size; i++) {
+			if (text[i] == letter) {
+				if (outIndex) {
+					*outIndex = i;
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool findLastLetter(
+		const char* text, uint32_t size, char letter, uint32_t* outIndex
+	) {
+		__m128i splat{ _mm_set1_epi8(letter) };
+		uint32_t end{ size };
+		for (; end >= 16; end -= 16) {
+			uint32_t mask{ getMatchMask(loadLetters(text + end - 16), splat) };
+			if (mask != 0) {
+				if (outIndex) {
+					*outIndex = end - 16 + getHighestBit(mask);
+				}
+				return true;
+			}
+		}
+		for (; end > 0; end--) {
+			if (text[end - 1] == letter) {
+				if (outIndex) {
+					*outIndex = end - 1;
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// candidates are the positions where both the first and the last byte
+	// of the pattern line up, only those compare the middle
+	bool findWithFilter(
+		const String& text, const String& pattern, uint32_t* outIndex
+	) {
+		const char* buffer{ text.buffer };
+		uint32_t lastOffset{ pattern.size - 1 };
+		uint32_t candidateCount{ text.size - lastOffset };
+		const char* middle{ pattern.buffer + 1 };
+		uint32_t middleSize{ pattern.size - 2 };
+
+		__m128i first{ _mm_set1_epi8(pattern.buffer[0]) };
+		__m128i last{ _mm_set1_epi8(pattern.buffer[lastOffset]) };
+
+		uint32_t i{};
+		for (; i + 16 <= candidateCount; i += 16) {
+			__m128i firstLetters{ loadLetters(buffer + i) };
+			__m128i lastLetters{ loadLetters(buffer + i + lastOffset) };
+			uint32_t mask{ getMatchMask(firstLetters, first) &
+						   getMatchMask(lastLetters, last) };
+			while (mask != 0) {
+				uint32_t candidate{ i + countTrailingZeros(mask) };
+				if (lettersMatch(buffer + candidate + 1, middle, middleSize)) {
+					if (outIndex) {
+						*outIndex = candidate;
+					}
+					return true;
+				}
+				mask &= mask - 1;
+			}
+		}
+
+		for (; i < candidateCount; i++) {
+			if (buffer[i] == pattern.buffer[0] &&
+				buffer[i + lastOffset] == pattern.buffer[lastOffset] &&
+				lettersMatch(buffer + i + 1, middle, middleSize)) {
+				if (outIndex) {
+					*outIndex = i;
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool findLastWithFilter(
+		const String& text, const String& pattern, uint32_t* outIndex
+	) {
+		const char* buffer{ text.buffer };
+		uint32_t lastOffset{ pattern.size - 1 };
+		const char* middle{ pattern.buffer + 1 };
+		uint32_t middleSize{ pattern.size - 2 };
+
+		__m128i first{ _mm_set1_epi8(pattern.buffer[0]) };
+		__m128i last{ _mm_set1_epi8(pattern.buffer[lastOffset]) };
+
+		// candidates below end are left, walked from the top down
+		uint32_t end{ text.size - lastOffset };
+		for (; end >= 16; end -= 16) {
+			uint32_t begin{ end - 16 };
+			__m128i firstLetters{ loadLetters(buffer + begin) };
+			__m128i lastLetters{ loadLetters(buffer + begin + lastOffset) };
+			uint32_t mask{ getMatchMask(firstLetters, first) &
+						   getMatchMask(lastLetters, last) };
+			while (mask != 0) {
+				uint32_t bit{ getHighestBit(mask) };
+				uint32_t candidate{ begin + bit };
+				if (lettersMatch(buffer + candidate + 1, middle, middleSize)) {
+					if (outIndex) {
+						*outIndex = candidate;
+					}
+					return true;
+				}
+				mask &= ~(1u << bit);
+			}
+		}
+
+		for (; end > 0; end--) {
+			uint32_t candidate{ end - 1 };
+			if (buffer[candidate] == pattern.buffer[0] &&
+				buffer[candidate + lastOffset] == pattern.buffer[lastOffset] &&
+				lettersMatch(buffer + candidate + 1, middle, middleSize)) {
+				if (outIndex) {
+					*outIndex = candidate;
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// reads a string front to back, or back to front so the same two way
+	// search finds the last match
+	template<bool isReversed>
+	struct LetterView {
+		const uint8_t* letters;
+		int64_t size;
+
+		uint8_t operator[](int64_t index) const {
+			if constexpr (isReversed) {
+				return letters[size - 1 - index];
+			} else {
+				return letters[index];
+			}
+		}
+	};
+
+	// the start of the right half of a critical factorization, from the
+	// maximal suffixes under both orderings. outPeriod is the period of
+	// the right half
+	template<bool isReversed>
+	int64_t calcCriticalPosition(
+		const LetterView<isReversed>& pattern, int64_t* outPeriod
+	) {
+		auto findMaximalSuffix{ [&](bool isOrderFlipped,
+									int64_t* outSuffixPeriod) {
+			int64_t suffix{ -1 };
+			int64_t j{};
+			int64_t k{ 1 };
+			int64_t period{ 1 };
+			while (j + k < pattern.size) {
+				uint8_t a{ pattern[j + k] };
+				uint8_t b{ pattern[suffix + k] };
+				bool isBelow{ isOrderFlipped ? b < a : a < b };
+				if (isBelow) {
+					j += k;
+					k = 1;
+					period = j - suffix;
+				} else if (a == b) {
+					if (k != period) {
+						k++;
+					} else {
+						j += period;
+						k = 1;
+					}
+				} else {
+					suffix = j++;
+					k = 1;
+					period = 1;
+				}
+			}
+			*outSuffixPeriod = period;
+			return suffix;
+		} };
+
+		int64_t period{};
+		int64_t flippedPeriod{};
+		int64_t suffix{ findMaximalSuffix(false, &period) };
+		int64_t flippedSuffix{ findMaximalSuffix(true, &flippedPeriod) };
+
+		// the longer of the two suffixes
+		if (flippedSuffix < suffix) {
+			*outPeriod = period;
+			return suffix + 1;
+		}
+		*outPeriod = flippedPeriod;
+		return flippedSuffix + 1;
+	}
+
+	// crochemore perrin, O(text + pattern) time and O(1) space
+	template<bool isReversed>
+	bool findWithTwoWay(
+		const String& text, const String& pattern, uint32_t* outIndex
+	) {
+		LetterView<isReversed> haystack{
+			.letters = rcast<const uint8_t*>(text.buffer), .size = text.size
+		};
+		LetterView<isReversed> needle{
+			.letters = rcast<const uint8_t*>(pattern.buffer),
+			.size = pattern.size
+		};
+
+		int64_t patternSize{ needle.size };
+		int64_t lastStart{ haystack.size - patternSize };
+
+		int64_t period{};
+		int64_t critical{ calcCriticalPosition(needle, &period) };
+
+		bool isPeriodic{ true };
+		for (int64_t i{}; i < critical; i++) {
+			if (needle[i] != needle[i + period]) {
+				isPeriodic = false;
+				break;
+			}
+		}
+
+		int64_t matchStart{ -1 };
+		if (isPeriodic) {
+			// the prefix already known to match after a shift by the period
+			int64_t memory{};
+			int64_t j{};
+			while (j <= lastStart) {
+				int64_t i{ critical > memory ? critical : memory };
+				while (i < patternSize && needle[i] == haystack[i + j]) {
+					i++;
+				}
+				if (i < patternSize) {
+					j += i - critical + 1;
+					memory = 0;
+					continue;
+				}
+
+				i = critical - 1;
+				while (i >= memory && needle[i] == haystack[i + j]) {
+					i--;
+				}
+				if (i < memory) {
+					matchStart = j;
+					break;
+				}
+				j += period;
+				memory = patternSize - period;
+			}
+		} else {
+			int64_t shift{
+				(critical > patternSize - critical ? critical
+												   : patternSize - critical) +
+				1
+			};
+			int64_t j{};
+			while (j <= lastStart) {
+				int64_t i{ critical };
+				while (i < patternSize && needle[i] == haystack[i + j]) {
+					i++;
+				}
+				if (i < patternSize) {
+					j += i - critical + 1;
+					continue;
+				}
+
+				i = critical - 1;
+				while (i >= 0 && needle[i] == haystack[i + j]) {
+					i--;
+				}
+				if (i < 0) {
+					matchStart = j;
+					break;
+				}
+				j += shift;
+			}
+		}
+
+		if (matchStart < 0) {
+			return false;
+		}
+		if (outIndex) {
+			int64_t index{ matchStart };
+			if constexpr (isReversed) {
+				index = haystack.size - patternSize - matchStart;
+			}
+			*outIndex = ncast<uint32_t>(index);
+		}
+		return true;
+	}
+
+	CharSet createCharSet(const String& set) {
+		CharSet charSet{};
+		for (uint32_t i{}; i < set.size; i++) {
+			auto index{ ncast<uint8_t>(set.buffer[i]) };
+			charSet.bits[index >> 6] |= 1ull << (index & 63);
+		}
+		return charSet;
+	}
+}  // namespace
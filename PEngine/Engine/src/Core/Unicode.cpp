@@ -0,0 +1,746 @@
+#include "Core/PUnicode.h"
+#include "Core/PIntrinsics.h"
+#include "Core/PArena.h"
+#include "Core/PMemory.h"
+#include "Core/PAssert.h"
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+
+using namespace pstd;
+
+namespace {
+	// error bits of the lookup table check, each one is set in all three
+	// tables only for the byte pairs that make that error
+	constexpr uint8_t TOO_SHORT{ 1 << 0 };	// 11______ 0_______
+											// 11______ 11______
+	constexpr uint8_t TOO_LONG{ 1 << 1 };	// 0_______ 10______
+	constexpr uint8_t OVERLONG_3{ 1 << 2 };	 // 11100000 100_____
+	constexpr uint8_t TOO_LARGE{ 1 << 3 };	 // 11110100 1001____
+											 // 11110100 101_____
+											 // 11110101 1001____
+											 // 11110101 101_____
+											 // 1111011_ 1001____
+											 // 1111011_ 101_____
+											 // 11111___ 1001____
+											 // 11111___ 101_____
+	constexpr uint8_t SURROGATE{ 1 << 4 };	 // 11101101 101_____
+	constexpr uint8_t OVERLONG_2{ 1 << 5 };	 // 1100000_ 10______
+	constexpr uint8_t TOO_LARGE_1000{ 1 << 6 };	 // 11110101 1000____
+												 // 1111011_ 1000____
+												 // 11111___ 1000____
+	constexpr uint8_t OVERLONG_4{ 1 << 6 };	 // 11110000 1000____
+	constexpr uint8_t TWO_CONTS{ 1 << 7 };	 // 10______ 10______
+
+	// the errors that only depend on the high nibble of the first byte
+	constexpr uint8_t CARRY{ TOO_SHORT | TOO_LONG | TWO_CONTS };
+
+	struct Utf8Checker {
+		__m128i error;
+		__m128i prevInput;
+		__m128i prevIncomplete;
+	};
+
+	void checkUtf8Block(Utf8Checker* pChecker, __m128i input);
+
+	bool validateUtf8Blocks(const uint8_t* data, uint32_t size);
+
+	// the length of the sequence lead starts, 0 when it can't start one,
+	// and the range its second byte has to be in
+	uint32_t getSequenceLength(
+		uint8_t lead, uint8_t* outSecondMin, uint8_t* outSecondMax
+	);
+
+	// decodes the sequence at the start of data, 0 when it is invalid or
+	// runs past the end
+	uint32_t decodeSequence(
+		const uint8_t* data, uint32_t remaining, char32_t* outCodePoint
+	);
+
+	// true when the sequence at the start of data only fails because the
+	// text ends before it does
+	bool isCutShort(const uint8_t* data, uint32_t remaining);
+
+	// codePoint must not be a surrogate or past 0x10FFFF
+	uint32_t encodeSequence(uint8_t* dst, char32_t codePoint);
+
+	uint32_t calcSequenceSize(char32_t codePoint) {
+		if (codePoint < 0x80) {
+			return 1;
+		} else if (codePoint < 0x800) {
+			return 2;
+		} else if (codePoint < 0x10000) {
+			return 3;
+		}
+		return 4;
+	}
+
+	bool isSurrogate(char32_t codePoint) {
+		return codePoint >= 0xD800 && codePoint <= 0xDFFF;
+	}
+
+	// hands back the part of the last allocation after end
+	void shrinkLastAlloc(Arena* pArena, const void* end) {
+		pArena->offset = ncast<uint32_t>(
+			rcast<uintptr_t>(end) - rcast<uintptr_t>(pArena->block)
+		);
+	}
+}  // namespace
+
+bool pstd::validateUtf8(const String& text, uint32_t* outErrorOffset) {
+	auto* data{ rcast<const uint8_t*>(text.buffer) };
+	uint32_t size{ text.size };
+
+	if (getCpuFeatures().ssse3 && validateUtf8Blocks(data, size)) {
+		return true;
+	}
+
+	// the scalar walk also finds where the error is when the blocks failed
+	uint32_t i{};
+	while (i < size) {
+		if (i + 16 <= size) {
+			__m128i block{ _mm_loadu_si128(rcast<const __m128i*>(data + i)) };
+			if (_mm_movemask_epi8(block) == 0) {
+				i += 16;
+				continue;
+			}
+		}
+
+		char32_t codePoint{};
+		uint32_t length{ decodeSequence(data + i, size - i, &codePoint) };
+		if (length == 0) {
+			if (outErrorOffset) {
+				*outErrorOffset = isCutShort(data + i, size - i) ? size : i;
+			}
+			return false;
+		}
+		i += length;
+	}
+
+	return true;
+}
+
+uint32_t pstd::countCodePoints(const String& text) {
+	auto* data{ rcast<const uint8_t*>(text.buffer) };
+	uint32_t size{ text.size };
+
+	// every byte but a continuation byte starts a code point. the byte
+	// counters are summed before 255 blocks can overflow them
+	uint32_t count{};
+	uint32_t i{};
+	while (i + 16 <= size) {
+		uint32_t blockEnd{ size & ~15u };
+		if (blockEnd - i > 255 * 16) {
+			blockEnd = i + 255 * 16;
+		}
+
+		__m128i counters{ _mm_setzero_si128() };
+		for (; i < blockEnd; i += 16) {
+			__m128i block{ _mm_loadu_si128(rcast<const __m128i*>(data + i)) };
+
+			// continuation bytes are -128 to -65 as signed bytes
+			__m128i isLead{ _mm_cmpgt_epi8(block, _mm_set1_epi8(-65)) };
+			counters = _mm_sub_epi8(counters, isLead);
+		}
+
+		__m128i sums{ _mm_sad_epu8(counters, _mm_setzero_si128()) };
+		count += ncast<uint32_t>(_mm_cvtsi128_si32(sums)) +
+			ncast<uint32_t>(_mm_extract_epi16(sums, 4));
+	}
+
+	for (; i < size; i++) {
+		count += (data[i] & 0xC0) != 0x80;
+	}
+
+	return count;
+}
+
+bool pstd::convertUtf8ToUtf16(
+	char16_t* dst, uint32_t capacity, const String& text, uint32_t* outSize
+) {
+	ASSERT(dst || capacity == 0);
+	ASSERT(outSize);
+
+	auto* data{ rcast<const uint8_t*>(text.buffer) };
+	uint32_t size{ text.size };
+
+	uint32_t i{};
+	uint32_t written{};
+	while (i < size) {
+		// all 16 get widened, only the ascii ones in front are kept
+		if (i + 16 <= size && written + 16 <= capacity) {
+			__m128i block{ _mm_loadu_si128(rcast<const __m128i*>(data + i)) };
+			__m128i zero{ _mm_setzero_si128() };
+			auto* out{ rcast<__m128i*>(dst + written) };
+			_mm_storeu_si128(out, _mm_unpacklo_epi8(block, zero));
+			_mm_storeu_si128(out + 1, _mm_unpackhi_epi8(block, zero));
+
+			uint32_t nonAsciiMask{ ncast<uint32_t>(_mm_movemask_epi8(block)) };
+			if (nonAsciiMask == 0) {
+				i += 16;
+				written += 16;
+				continue;
+			}
+
+			uint32_t asciiCount{ countTrailingZeros(nonAsciiMask) };
+			i += asciiCount;
+			written += asciiCount;
+		}
+
+		// stays here while the text is not ascii, cjk text never goes back
+		// through the block load
+		do {
+			char32_t codePoint{};
+			uint32_t length{ decodeSequence(data + i, size - i, &codePoint) };
+			if (length == 0) {
+				return false;
+			}
+
+			if (codePoint < 0x10000) {
+				if (written + 1 > capacity) {
+					return false;
+				}
+				dst[written] = ncast<char16_t>(codePoint);
+				written++;
+			} else {
+				if (written + 2 > capacity) {
+					return false;
+				}
+				codePoint -= 0x10000;
+				dst[written] = ncast<char16_t>(0xD800 + (codePoint >> 10));
+				dst[written + 1] =
+					ncast<char16_t>(0xDC00 + (codePoint & 0x3FF));
+				written += 2;
+			}
+			i += length;
+		} while (i < size && data[i] >= 0x80);
+	}
+
+	*outSize = written;
+	return true;
+}
+
+bool pstd::convertUtf8ToUtf32(
+	char32_t* dst, uint32_t capacity, const String& text, uint32_t* outSize
+) {
+	ASSERT(dst || capacity == 0);
+	ASSERT(outSize);
+
+	auto* data{ rcast<const uint8_t*>(text.buffer) };
+	uint32_t size{ text.size };
+
+	uint32_t i{};
+	uint32_t written{};
+	while (i < size) {
+		if (i + 16 <= size && written + 16 <= capacity) {
+			__m128i block{ _mm_loadu_si128(rcast<const __m128i*>(data + i)) };
+			__m128i zero{ _mm_setzero_si128() };
+			__m128i low{ _mm_unpacklo_epi8(block, zero) };
+			__m128i high{ _mm_unpackhi_epi8(block, zero) };
+			auto* out{ rcast<__m128i*>(dst + written) };
+			_mm_storeu_si128(out, _mm_unpacklo_epi16(low, zero));
+			_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(low, zero));
+			_mm_storeu_si128(out + 2, _mm_unpacklo_epi16(high, zero));
+			_mm_storeu_si128(out + 3, _mm_unpackhi_epi16(high, zero));
+
+			uint32_t nonAsciiMask{ ncast<uint32_t>(_mm_movemask_epi8(block)) };
+			if (nonAsciiMask == 0) {
+				i += 16;
+				written += 16;
+				continue;
+			}
+
+			uint32_t asciiCount{ countTrailingZeros(nonAsciiMask) };
+			i += asciiCount;
+			written += asciiCount;
+		}
+
+		do {
+			char32_t codePoint{};
+			uint32_t length{ decodeSequence(data + i, size - i, &codePoint) };
+			if (length == 0 || written + 1 > capacity) {
+				return false;
+			}
+
+			dst[written] = codePoint;
+			written++;
+			i += length;
+		} while (i < size && data[i] >= 0x80);
+	}
+
+	*outSize = written;
+	return true;
+}
+
+bool pstd::convertUtf16ToUtf8(
+	char* dst, uint32_t capacity, const Utf16String& text, uint32_t* outSize
+) {
+	ASSERT(dst || capacity == 0);
+	ASSERT(outSize);
+
+	const char16_t* data{ text.buffer };
+	uint32_t size{ text.size };
+	auto* out{ rcast<uint8_t*>(dst) };
+
+	uint32_t i{};
+	uint32_t written{};
+	while (i < size) {
+		if (i + 8 <= size && written + 8 <= capacity) {
+			__m128i block{ _mm_loadu_si128(rcast<const __m128i*>(data + i)) };
+			__m128i high{ _mm_and_si128(block, _mm_set1_epi16(-0x80)) };
+			auto asciiMask{ ncast<uint32_t>(
+				_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128()))
+			) };
+			_mm_storel_epi64(
+				rcast<__m128i*>(out + written), _mm_packus_epi16(block, block)
+			);
+
+			if (asciiMask == 0xFFFF) {
+				i += 8;
+				written += 8;
+				continue;
+			}
+
+			// two mask bits per unit
+			uint32_t asciiCount{ countTrailingZeros(~asciiMask) / 2 };
+			i += asciiCount;
+			written += asciiCount;
+		}
+
+		do {
+			char32_t codePoint{ data[i] };
+			uint32_t length{ 1 };
+			if (isSurrogate(codePoint)) {
+				char16_t low{ i + 1 < size ? data[i + 1] : u'\0' };
+				if (codePoint > 0xDBFF || low < 0xDC00 || low > 0xDFFF) {
+					return false;
+				}
+				codePoint = 0x10000 + ((codePoint - 0xD800) << 10) +
+					(low - 0xDC00);
+				length = 2;
+			}
+
+			if (written + calcSequenceSize(codePoint) > capacity) {
+				return false;
+			}
+			written += encodeSequence(out + written, codePoint);
+			i += length;
+		} while (i < size && data[i] >= 0x80);
+	}
+
+	*outSize = written;
+	return true;
+}
+
+bool pstd::convertUtf32ToUtf8(
+	char* dst, uint32_t capacity, const Utf32String& text, uint32_t* outSize
+) {
+	ASSERT(dst || capacity == 0);
+	ASSERT(outSize);
+
+	const char32_t* data{ text.buffer };
+	uint32_t size{ text.size };
+	auto* out{ rcast<uint8_t*>(dst) };
+
+	uint32_t i{};
+	uint32_t written{};
+	while (i < size) {
+		if (i + 4 <= size && written + 4 <= capacity) {
+			__m128i block{ _mm_loadu_si128(rcast<const __m128i*>(data + i)) };
+			__m128i high{ _mm_and_si128(block, _mm_set1_epi32(-0x80)) };
+			auto asciiMask{ ncast<uint32_t>(
+				_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128()))
+			) };
+
+			if (asciiMask == 0xFFFF) {
+				__m128i units{ _mm_packs_epi32(block, block) };
+				auto bytes{ ncast<uint32_t>(
+					_mm_cvtsi128_si32(_mm_packus_epi16(units, units))
+				) };
+				memCpy(out + written, &bytes, sizeof(bytes));
+				i += 4;
+				written += 4;
+				continue;
+			}
+		}
+
+		do {
+			char32_t codePoint{ data[i] };
+			if (codePoint > 0x10FFFF || isSurrogate(codePoint) ||
+				written + calcSequenceSize(codePoint) > capacity) {
+				return false;
+			}
+
+			written += encodeSequence(out + written, codePoint);
+			i++;
+		} while (i < size && data[i] >= 0x80);
+	}
+
+	*outSize = written;
+	return true;
+}
+
+bool pstd::createUtf16String(
+	Arena* pArena, const String& text, Utf16String* pOut
+) {
+	ASSERT(pArena);
+	ASSERT(pOut);
+
+	uint32_t startOffset{ pArena->offset };
+	auto* buffer{ alloc<char16_t>(pArena, text.size + 1) };
+
+	uint32_t size{};
+	if (!convertUtf8ToUtf16(buffer, text.size, text, &size)) {
+		pArena->offset = startOffset;
+		return false;
+	}
+
+	buffer[size] = u'\0';
+	shrinkLastAlloc(pArena, buffer + size + 1);
+
+	*pOut = Utf16String{ .buffer = buffer, .size = size };
+	return true;
+}
+
+bool pstd::createUtf32String(
+	Arena* pArena, const String& text, Utf32String* pOut
+) {
+	ASSERT(pArena);
+	ASSERT(pOut);
+
+	uint32_t startOffset{ pArena->offset };
+	auto* buffer{ alloc<char32_t>(pArena, text.size + 1) };
+
+	uint32_t size{};
+	if (!convertUtf8ToUtf32(buffer, text.size, text, &size)) {
+		pArena->offset = startOffset;
+		return false;
+	}
+
+	buffer[size] = U'\0';
+	shrinkLastAlloc(pArena, buffer + size + 1);
+
+	*pOut = Utf32String{ .buffer = buffer, .size = size };
+	return true;
+}
+
+bool pstd::createUtf8String(
+	Arena* pArena, const Utf16String& text, String* pOut
+) {
+	ASSERT(pArena);
+	ASSERT(pOut);
+	ASSERT(text.size < getMax<uint32_t>() / 3);
+
+	uint32_t startOffset{ pArena->offset };
+	uint32_t capacity{ text.size * 3 };
+	auto* buffer{ alloc<char>(pArena, capacity + 1) };
+
+	uint32_t size{};
+	if (!convertUtf16ToUtf8(buffer, capacity, text, &size)) {
+		pArena->offset = startOffset;
+		return false;
+	}
+
+	buffer[size] = '\0';
+	shrinkLastAlloc(pArena, buffer + size + 1);
+
+	*pOut = String{ .buffer = buffer, .size = size };
+	return true;
+}
+
+bool pstd::createUtf8String(
+	Arena* pArena, const Utf32String& text, String* pOut
+) {
+	ASSERT(pArena);
+	ASSERT(pOut);
+	ASSERT(text.size < getMax<uint32_t>() / 4);
+
+	uint32_t startOffset{ pArena->offset };
+	uint32_t capacity{ text.size * 4 };
+	auto* buffer{ alloc<char>(pArena, capacity + 1) };
+
+	uint32_t size{};
+	if (!convertUtf32ToUtf8(buffer, capacity, text, &size)) {
+		pArena->offset = startOffset;
+		return false;
+	}
+
+	buffer[size] = '\0';
+	shrinkLastAlloc(pArena, buffer + size + 1);
+
+	*pOut = String{ .buffer = buffer, .size = size };
+	return true;
+}
+
+namespace {
+	void checkUtf8Block(Utf8Checker* pChecker, __m128i input) {
+		if (_mm_movemask_epi8(input) == 0) {
+			// an ascii block can only be wrong if the one before it ended
+			// in the middle of a sequence
+			pChecker->error =
+				_mm_or_si128(pChecker->error, pChecker->prevIncomplete);
+			pChecker->prevInput = input;
+			pChecker->prevIncomplete = _mm_setzero_si128();
+			return;
+		}
+
+		__m128i lowNibbleMask{ _mm_set1_epi8(0x0F) };
+		__m128i prev1{ _mm_alignr_epi8(input, pChecker->prevInput, 15) };
+
+		__m128i byte1HighTable{ _mm_setr_epi8(
+			// 0_______ ________, ascii first
+			TOO_LONG,
+			TOO_LONG,
+			TOO_LONG,
+			TOO_LONG,
+			TOO_LONG,
+			TOO_LONG,
+			TOO_LONG,
+			TOO_LONG,
+			// 10______ ________, continuation first
+			TWO_CONTS,
+			TWO_CONTS,
+			TWO_CONTS,
+			TWO_CONTS,
+			// 1100____ ________
+			TOO_SHORT | OVERLONG_2,
+			// 1101____ ________
+			TOO_SHORT,
+			// 1110____ ________
+			TOO_SHORT | OVERLONG_3 | SURROGATE,
+			// 1111____ ________
+			ncast<char>(TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4)
+		) };
+
+		__m128i byte1LowTable{ _mm_setr_epi8(
+			// ____0000 ________
+			ncast<char>(CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4),
+			// ____0001 ________
+			ncast<char>(CARRY | OVERLONG_2),
+			// ____001_ ________
+			ncast<char>(CARRY),
+			ncast<char>(CARRY),
+			// ____0100 ________
+			ncast<char>(CARRY | TOO_LARGE),
+			// ____0101 ________
+			ncast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			// ____011_ ________
+			ncast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			ncast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			// ____1___ ________
+			ncast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			ncast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			ncast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			ncast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			ncast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			// ____1101 ________
+			ncast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE),
+			ncast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			ncast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000)
+		) };
+
+		__m128i byte2HighTable{ _mm_setr_epi8(
+			// ________ 0_______, ascii second
+			TOO_SHORT,
+			TOO_SHORT,
+			TOO_SHORT,
+			TOO_SHORT,
+			TOO_SHORT,
+			TOO_SHORT,
+			TOO_SHORT,
+			TOO_SHORT,
+			// ________ 1000____
+			ncast<char>(
+				TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 |
+				TOO_LARGE_1000 | OVERLONG_4
+			),
+			// ________ 1001____
+			ncast<char>(
+				TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE
+			),
+			// ________ 101_____
+			ncast<char>(
+				TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE
+			),
+			ncast<char>(
+				TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE
+			),
+			// ________ 11______, lead second
+			TOO_SHORT,
+			TOO_SHORT,
+			TOO_SHORT,
+			TOO_SHORT
+		) };
+
+		// there is no byte shift, the nibbles are masked after the word one
+		__m128i byte1High{ _mm_shuffle_epi8(
+			byte1HighTable,
+			_mm_and_si128(_mm_srli_epi16(prev1, 4), lowNibbleMask)
+		) };
+		__m128i byte1Low{ _mm_shuffle_epi8(
+			byte1LowTable, _mm_and_si128(prev1, lowNibbleMask)
+		) };
+		__m128i byte2High{ _mm_shuffle_epi8(
+			byte2HighTable,
+			_mm_and_si128(_mm_srli_epi16(input, 4), lowNibbleMask)
+		) };
+		__m128i specialCases{
+			_mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High)
+		};
+
+		// two continuations in a row are only right as the 3rd or 4th byte
+		// of a sequence, which the lead two or three bytes back says
+		__m128i prev2{ _mm_alignr_epi8(input, pChecker->prevInput, 14) };
+		__m128i prev3{ _mm_alignr_epi8(input, pChecker->prevInput, 13) };
+		__m128i isThirdByte{
+			_mm_subs_epu8(prev2, _mm_set1_epi8(ncast<char>(0xE0 - 0x80)))
+		};
+		__m128i isFourthByte{
+			_mm_subs_epu8(prev3, _mm_set1_epi8(ncast<char>(0xF0 - 0x80)))
+		};
+		__m128i mustBeContinuation{ _mm_and_si128(
+			_mm_or_si128(isThirdByte, isFourthByte),
+			_mm_set1_epi8(ncast<char>(0x80))
+		) };
+
+		pChecker->error = _mm_or_si128(
+			pChecker->error, _mm_xor_si128(mustBeContinuation, specialCases)
+		);
+
+		// a lead in the last three bytes that needs more than what is left
+		__m128i maxValue{ _mm_setr_epi8(
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			ncast<char>(0xF0 - 1),
+			ncast<char>(0xE0 - 1),
+			ncast<char>(0xC0 - 1)
+		) };
+		pChecker->prevIncomplete = _mm_subs_epu8(input, maxValue);
+		pChecker->prevInput = input;
+	}
+
+	bool validateUtf8Blocks(const uint8_t* data, uint32_t size) {
+		Utf8Checker checker{
+			.error = _mm_setzero_si128(),
+			.prevInput = _mm_setzero_si128(),
+			.prevIncomplete = _mm_setzero_si128(),
+		};
+
+		uint32_t i{};
+		for (; i + 16 <= size; i += 16) {
+			checkUtf8Block(
+				&checker, _mm_loadu_si128(rcast<const __m128i*>(data + i))
+			);
+		}
+
+		// zeros are ascii, a sequence cut off by the end is too short
+		if (i < size) {
+			alignas(16) uint8_t tail[16]{};
+			memCpy(tail, data + i, size - i);
+			checkUtf8Block(&checker, _mm_load_si128(rcast<__m128i*>(tail)));
+		}
+
+		__m128i error{ _mm_or_si128(checker.error, checker.prevIncomplete) };
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) ==
+			0xFFFF;
+	}
+
+	uint32_t getSequenceLength(
+		uint8_t lead, uint8_t* outSecondMin, uint8_t* outSecondMax
+	) {
+		// the second byte range is narrower after some leads, that is what
+		// rules out overlong forms, surrogates and code points past 0x10FFFF
+		*outSecondMin = 0x80;
+		*outSecondMax = 0xBF;
+		if (lead < 0xC2) {
+			return 0;
+		} else if (lead < 0xE0) {
+			return 2;
+		} else if (lead < 0xF0) {
+			if (lead == 0xE0) {
+				*outSecondMin = 0xA0;
+			} else if (lead == 0xED) {
+				*outSecondMax = 0x9F;
+			}
+			return 3;
+		} else if (lead < 0xF5) {
+			if (lead == 0xF0) {
+				*outSecondMin = 0x90;
+			} else if (lead == 0xF4) {
+				*outSecondMax = 0x8F;
+			}
+			return 4;
+		}
+		return 0;
+	}
+
+	uint32_t decodeSequence(
+		const uint8_t* data, uint32_t remaining, char32_t* outCodePoint
+	) {
+		uint8_t lead{ data[0] };
+		if (lead < 0x80) {
+			*outCodePoint = lead;
+			return 1;
+		}
+
+		uint8_t secondMin{};
+		uint8_t secondMax{};
+		uint32_t length{ getSequenceLength(lead, &secondMin, &secondMax) };
+		if (length == 0 || remaining < length || data[1] < secondMin ||
+			data[1] > secondMax) {
+			return 0;
+		}
+
+		// the lead keeps 7 - length bits of the code point
+		char32_t codePoint{ lead & (0x7Fu >> length) };
+		for (uint32_t i{ 1 }; i < length; i++) {
+			if ((data[i] & 0xC0) != 0x80) {
+				return 0;
+			}
+			codePoint = (codePoint << 6) | (data[i] & 0x3F);
+		}
+
+		*outCodePoint = codePoint;
+		return length;
+	}
+
+	bool isCutShort(const uint8_t* data, uint32_t remaining) {
+		uint8_t secondMin{};
+		uint8_t secondMax{};
+		uint32_t length{ getSequenceLength(data[0], &secondMin, &secondMax) };
+		if (length == 0 || remaining >= length) {
+			return false;
+		}
+		if (remaining > 1 && (data[1] < secondMin || data[1] > secondMax)) {
+			return false;
+		}
+
+		for (uint32_t i{ 2 }; i < remaining; i++) {
+			if ((data[i] & 0xC0) != 0x80) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	uint32_t encodeSequence(uint8_t* dst, char32_t codePoint) {
+		if (codePoint < 0x80) {
+			dst[0] = ncast<uint8_t>(codePoint);
+			return 1;
+		} else if (codePoint < 0x800) {
+			dst[0] = ncast<uint8_t>(0xC0 | (codePoint >> 6));
+			dst[1] = ncast<uint8_t>(0x80 | (codePoint & 0x3F));
+			return 2;
+		} else if (codePoint < 0x10000) {
+			dst[0] = ncast<uint8_t>(0xE0 | (codePoint >> 12));
+			dst[1] = ncast<uint8_t>(0x80 | ((codePoint >> 6) & 0x3F));
+			dst[2] = ncast<uint8_t>(0x80 | (codePoint & 0x3F));
+			return 3;
+		}
+
+		dst[0] = ncast<uint8_t>(0xF0 | (codePoint >> 18));
+		dst[1] = ncast<uint8_t>(0x80 | ((codePoint >> 12) & 0x3F));
+		dst[2] = ncast<uint8_t>(0x80 | ((codePoint >> 6) & 0x3F));
+		dst[3] = ncast<uint8_t>(0x80 | (codePoint & 0x3F));
+		return 4;
+	}
+}  // namespace
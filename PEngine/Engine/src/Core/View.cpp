@@ -0,0 +1,72 @@
+#include "Core/PView.h"
+#include "Core/PArray.h"
+#include "Core/PTypes.h"
+
+// compile time checks that the views stay as thin as a hand written loop:
+// no hidden state beyond the source span and the callable, and every
+// composition folds to a constant when its input is constant
+
+namespace {
+	constexpr pstd::StaticArray<int32_t, 10> c_Values{
+		.data = { 3, 8, 1, 6, 7, 2, 9, 4, 5, 10 }
+	};
+
+	constexpr auto isEven{ [](int32_t val) { return val % 2 == 0; } };
+	constexpr auto square{ [](int32_t val) { return val * val; } };
+
+	using ValueSpan = pstd::Span<const int32_t>;
+
+	static_assert(sizeof(ValueSpan) == sizeof(void*) + sizeof(size_t));
+	static_assert(
+		sizeof(pstd::FilterView<ValueSpan, decltype(isEven)>) ==
+		sizeof(ValueSpan) + sizeof(size_t)
+	);
+	static_assert(
+		sizeof(ValueSpan::Iterator) == sizeof(void*) * 2,
+		"a span iterator is a pointer pair"
+	);
+	static_assert(pstd::ContiguousContainer<ValueSpan>);
+	static_assert(pstd::View<pstd::ChunkView<const int32_t>>);
+
+	constexpr int32_t sumEvenSquares() {
+		int32_t res{};
+		for (int32_t val :
+			 pstd::take(pstd::transform(pstd::filter(c_Values, isEven), square), 3)
+		) {
+			res += val;
+		}
+		return res;
+	}
+	static_assert(sumEvenSquares() == 8 * 8 + 6 * 6 + 2 * 2);
+
+	constexpr size_t sumEnumeratedIndices() {
+		size_t res{};
+		for (auto [index, val] : pstd::enumerate(pstd::filter(c_Values, isEven))
+		) {
+			res += index;
+		}
+		return res;
+	}
+	static_assert(sumEnumeratedIndices() == 0 + 1 + 2 + 3 + 4);
+
+	constexpr int32_t dotWithStride() {
+		int32_t res{};
+		for (auto [a, b] :
+			 pstd::zip(pstd::stride(c_Values, 2), pstd::stride(c_Values, 3))) {
+			res += a * b;
+		}
+		return res;
+	}
+	static_assert(dotWithStride() == 3 * 3 + 1 * 6 + 7 * 9 + 9 * 10);
+
+	constexpr size_t countChunks() {
+		size_t res{};
+		size_t lastChunkCount{};
+		for (ValueSpan span : pstd::chunk(c_Values, 4)) {
+			res++;
+			lastChunkCount = span.count;
+		}
+		return res * 10 + lastChunkCount;
+	}
+	static_assert(countChunks() == 32);
+}  // namespace
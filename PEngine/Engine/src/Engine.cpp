@@ -1,6 +1,9 @@
 #include "Engine.h"
 
 #include "Logging.h"
+#include "Profiler.h"
+#include "FrameStats.h"
+#include "Metrics.h"
 
 #include "Platforms/Window.h"
 #include "Renderer/Renderer.h"
@@ -29,6 +32,8 @@ namespace PE {
 		Platform::State* platformState;
 		Renderer::State* rendererState;
 
+		Metrics::CounterId eventCounter;
+
 		bool isRunning;
 	};
 };	// namespace PE
@@ -53,6 +58,8 @@ size_t PE::getSizeofState() {
 }
 
 PE::State* PE::startup(pstd::Arena* pPersistArena, pstd::Arena scratchArena) {
+	PROFILE_FUNCTION();
+
 	Platform::State* platformState{
 		Platform::startup(pPersistArena, "window", 1920 / 2, 1080 / 2)
 	};
@@ -65,15 +72,22 @@ PE::State* PE::startup(pstd::Arena* pPersistArena, pstd::Arena scratchArena) {
 	new (pState) State{ .engineArena = pPersistArena,
 						.platformState = platformState,
 						.rendererState = rendererState,
+						.eventCounter =
+							Metrics::registerCounter("platform events"),
 						.isRunning = true };
 	return pState;
 }
 bool PE::update(State* state) {
+	PROFILE_FUNCTION();
+
 	if (state->isRunning && Platform::isRunning(state->platformState)) {
+		PROFILE_SCOPE("platform pump");
+		FrameStats::PhaseScope phaseScope{ FrameStats::Phase::platformPump };
 		Platform::update(state->platformState);
 
 		Platform::Event event{};
 		while (Platform::popEvent(state->platformState, &event)) {
+			Metrics::addToCounter(state->eventCounter);
 			switch (event.type) {
 				case Platform::EventType::key: {
 					if (event.keyEvent.action == InputAction::PRESSED) {
@@ -0,0 +1,812 @@
+#include "FlightRecorder.h"
+#include "Logging.h"
+#include "LogFile.h"
+
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PAtomic.h"
+#include "Core/PThread.h"
+#include "Core/PTime.h"
+#include "Core/PFileIO.h"
+#include "Core/PIntrinsics.h"
+#include "Core/PMemory.h"
+#include "Core/PString.h"
+#include "Core/PAlgorithm.h"
+#include "Core/PAssert.h"
+
+using Console::LogArg;
+using Console::LogArgType;
+using Console::LogLevel;
+using FlightRecorder::BlockHeader;
+using FlightRecorder::EntryKind;
+using FlightRecorder::FileHeader;
+
+namespace {
+	// every entry starts with this and is padded to ENTRY_ALIGNMENT, size
+	// counts both
+	struct EntryHeader {
+		uint32_t size;
+		EntryKind kind;
+		uint64_t cycles;
+	};
+
+	constexpr uint32_t ENTRY_ALIGNMENT{ 8 };
+
+	// a log entry goes on with its argument types, file name, format and
+	// packed arguments. integers and doubles take 8 bytes, floats 4 and
+	// strings a 4 byte size and their letters
+	struct LogEntryHeader {
+		uint32_t line;
+		uint16_t fileSize;
+		uint16_t formatSize;
+		uint8_t level;
+		uint8_t argCount;
+	};
+
+	struct FrameEntryHeader {
+		uint64_t frameIndex;
+	};
+
+	// the name follows
+	struct ZoneEntryHeader {
+		uint64_t endCycles;
+		uint32_t nameSize;
+	};
+
+	constexpr uint64_t BLOCK_WRITING_BIT{ 1ull << 63 };
+
+	// a block's size keeps every size in an entry within 16 bits
+	constexpr uint32_t MAX_BLOCK_SIZE{ 64 * 1024 };
+
+	// the block a thread writes into. sequence is what the block had when
+	// the thread claimed it, a different one means another thread went all
+	// the way around the ring and took it back. the owner sets
+	// BLOCK_WRITING_BIT in the block's sequence for as long as it writes an
+	// entry and claiming skips blocks that have it, so a thread that stalls
+	// in the middle of an entry never has its block taken from under it.
+	// once the thread exits the next one to record takes over the slot,
+	// with a new index and block
+	struct alignas(64) RecorderThread {
+		BlockHeader* pBlock;
+		uint64_t sequence;
+		uint32_t used;
+		uint32_t index;
+		uint32_t isReleased;
+	};
+
+	struct Recorder {
+		pstd::Arena arena;
+		pstd::MappedFile file;
+		FileHeader* pHeader;
+		uint8_t* blocks;
+		uint32_t blockSize;
+		uint32_t blockCount;
+		RecorderThread* threads;
+		uint32_t threadCount;
+		uint32_t maxThreadCount;
+		uint32_t nextThreadIndex;
+		pstd::ThreadLocalKey threadKey;
+		pstd::Mutex registerMutex;
+		uint32_t isStarted;
+	};
+
+	Recorder g_Recorder{};
+
+	// threads past maxThreadCount keep this one, so they don't look for a
+	// slot again on every entry
+	RecorderThread g_NoThread{};
+
+	// bounded reads out of an entry, the first one that doesn't fit fails
+	// every one after it
+	struct EntryReader {
+		const uint8_t* src;
+		uint32_t size;
+		uint32_t offset;
+		bool hasFailed;
+	};
+
+	struct SortKey {
+		uint64_t cycles;
+		uint32_t offset;
+	};
+
+	// null for a thread that got no slot, which counts the entry as
+	// dropped
+	RecorderThread* getRecorderThread();
+
+	// the thread local's exit function
+	void releaseRecorderThread(void* pVal);
+
+	// null when size can't fit in a block
+	uint8_t* reserveEntry(
+		RecorderThread* pThread, EntryKind kind, uint64_t cycles, uint32_t size
+	);
+
+	void commitEntry(RecorderThread* pThread, uint32_t size);
+
+	void claimBlock(RecorderThread* pThread);
+
+	uint32_t calcPackedArgsSize(
+		const LogArgType* argTypes,
+		uint32_t argCount,
+		const LogArg* args,
+		uint32_t maxStringSize
+	);
+
+	uint8_t* packArgs(
+		uint8_t* dst,
+		const LogArgType* argTypes,
+		uint32_t argCount,
+		const LogArg* args,
+		uint32_t maxStringSize
+	);
+
+	// parses the entry at offset, which has to end by endOffset. false when
+	// it is cut off or malformed
+	bool parseEntry(
+		const pstd::String& data,
+		uint32_t offset,
+		uint32_t endOffset,
+		FlightRecorder::Entry* outEntry,
+		uint32_t* outSize
+	);
+
+	const uint8_t* getBytes(EntryReader* pReader, uint32_t size);
+
+	template<typename T>
+	T getStruct(EntryReader* pReader);
+
+	// stable, so entries with the same cycles stay in block order
+	void sortKeys(SortKey* keys, SortKey* scratch, uint32_t count);
+
+	uint32_t alignEntrySize(size_t size) {
+		return ncast<uint32_t>(
+			(size + ENTRY_ALIGNMENT - 1) & ~(ENTRY_ALIGNMENT - 1)
+		);
+	}
+}  // namespace
+
+bool FlightRecorder::startup(
+	pstd::AllocationRegistry* pAllocRegistry, const Config& config
+) {
+	ASSERT(pAllocRegistry);
+	ASSERT(config.path);
+	ASSERT(!pstd::atomicLoad(&g_Recorder.isStarted));
+	ASSERT(pstd::calcNextPowerOfTwo(config.blockSize) == config.blockSize);
+	ASSERT(config.blockSize >= 1024 && config.blockSize <= MAX_BLOCK_SIZE);
+	ASSERT(config.maxThreadCount > 0);
+
+	// the header gets a block of its own, so the blocks stay page aligned.
+	// there has to be a block no thread is writing for claiming to find
+	uint32_t blockCount{ config.size / config.blockSize - 1 };
+	ASSERT(blockCount > config.maxThreadCount);
+	pstd::MappedFile file{ pstd::createMappedFile(
+		config.path, (blockCount + 1ull) * config.blockSize
+	) };
+	if (!file.data) {
+		return false;
+	}
+
+	g_Recorder = Recorder{
+		.arena = pstd::allocateArena(
+			pAllocRegistry,
+			config.maxThreadCount * sizeof(RecorderThread) +
+				alignof(RecorderThread)
+		),
+		.file = file,
+		.pHeader = rcast<FileHeader*>(file.data),
+		.blocks = rcast<uint8_t*>(file.data) + config.blockSize,
+		.blockSize = config.blockSize,
+		.blockCount = blockCount,
+		.maxThreadCount = config.maxThreadCount,
+		.threadKey = pstd::createThreadLocal(releaseRecorderThread),
+	};
+	g_Recorder.threads = pstd::alloc<RecorderThread>(
+		&g_Recorder.arena, config.maxThreadCount
+	);
+
+	// the file is new, so every block starts out zeroed and empty
+	*g_Recorder.pHeader = FileHeader{
+		.magic = RECORDER_FILE_MAGIC,
+		.version = RECORDER_FILE_VERSION,
+		.blockSize = config.blockSize,
+		.blockCount = blockCount,
+		.timeFrequency = pstd::getTimeFrequency(),
+	};
+
+	pstd::atomicStore(&g_Recorder.isStarted, 1u);
+	return true;
+}
+
+void FlightRecorder::shutdown(pstd::AllocationRegistry* pAllocRegistry) {
+	ASSERT(pAllocRegistry);
+	if (!pstd::atomicLoad(&g_Recorder.isStarted)) {
+		return;
+	}
+
+	pstd::atomicStore(&g_Recorder.isStarted, 0u);
+	pstd::closeMappedFile(&g_Recorder.file);
+	pstd::destroyThreadLocal(g_Recorder.threadKey);
+	pstd::freeArena(pAllocRegistry, &g_Recorder.arena);
+	g_Recorder = Recorder{};
+}
+
+void FlightRecorder::recordLog(
+	const Console::LogSite& site,
+	const char* format,
+	const LogArgType* argTypes,
+	uint32_t argCount,
+	const LogArg* args,
+	uint64_t cycles
+) {
+	if (!pstd::atomicLoad(&g_Recorder.isStarted)) {
+		return;
+	}
+
+	RecorderThread* pThread{ getRecorderThread() };
+	if (!pThread) {
+		return;
+	}
+
+	pstd::String file{ pstd::getFileName(site.file) };
+	pstd::String formatString{ pstd::createString(format) };
+
+	// long string arguments share what the headers and the other arguments
+	// leave of the block
+	size_t capacity{ g_Recorder.blockSize - sizeof(BlockHeader) };
+	size_t headerSize{ sizeof(EntryHeader) + sizeof(LogEntryHeader) +
+					   argCount + file.size + formatString.size };
+	size_t fixedSize{ headerSize +
+					  calcPackedArgsSize(argTypes, argCount, args, 0) };
+	if (fixedSize > capacity) {
+		return;
+	}
+
+	uint32_t stringCount{};
+	for (uint32_t i{}; i < argCount; i++) {
+		stringCount += argTypes[i] == LogArgType::string;
+	}
+	uint32_t maxStringSize{};
+	if (stringCount > 0) {
+		maxStringSize = ncast<uint32_t>((capacity - fixedSize) / stringCount);
+	}
+	uint32_t entrySize{ alignEntrySize(
+		headerSize + calcPackedArgsSize(argTypes, argCount, args, maxStringSize)
+	) };
+
+	uint8_t* dst{ reserveEntry(pThread, EntryKind::log, cycles, entrySize) };
+	*rcast<LogEntryHeader*>(dst) = LogEntryHeader{
+		.line = site.line,
+		.fileSize = ncast<uint16_t>(file.size),
+		.formatSize = ncast<uint16_t>(formatString.size),
+		.level = ncast<uint8_t>(site.level),
+		.argCount = ncast<uint8_t>(argCount),
+	};
+	dst += sizeof(LogEntryHeader);
+
+	pstd::memCpy(dst, argTypes, argCount);
+	dst += argCount;
+	pstd::memCpy(dst, file.buffer, file.size);
+	dst += file.size;
+	pstd::memCpy(dst, formatString.buffer, formatString.size);
+	dst += formatString.size;
+	packArgs(dst, argTypes, argCount, args, maxStringSize);
+
+	commitEntry(pThread, entrySize);
+}
+
+void FlightRecorder::recordFrame(uint64_t frameIndex) {
+	if (!pstd::atomicLoad(&g_Recorder.isStarted)) {
+		return;
+	}
+
+	RecorderThread* pThread{ getRecorderThread() };
+	if (!pThread) {
+		return;
+	}
+
+	uint32_t entrySize{
+		alignEntrySize(sizeof(EntryHeader) + sizeof(FrameEntryHeader))
+	};
+	uint8_t* dst{ reserveEntry(
+		pThread, EntryKind::frame, pstd::readCycleCounter(), entrySize
+	) };
+	*rcast<FrameEntryHeader*>(dst) =
+		FrameEntryHeader{ .frameIndex = frameIndex };
+
+	commitEntry(pThread, entrySize);
+}
+
+void FlightRecorder::recordZone(
+	const pstd::String& name, uint64_t beginCycles, uint64_t endCycles
+) {
+	if (!pstd::atomicLoad(&g_Recorder.isStarted)) {
+		return;
+	}
+
+	RecorderThread* pThread{ getRecorderThread() };
+	if (!pThread) {
+		return;
+	}
+
+	size_t fixedSize{ sizeof(EntryHeader) + sizeof(ZoneEntryHeader) };
+	size_t capacity{ g_Recorder.blockSize - sizeof(BlockHeader) };
+	auto nameSize{ ncast<uint32_t>(min(name.size, capacity - fixedSize)) };
+	uint32_t entrySize{ alignEntrySize(fixedSize + nameSize) };
+
+	uint8_t* dst{
+		reserveEntry(pThread, EntryKind::zone, beginCycles, entrySize)
+	};
+	*rcast<ZoneEntryHeader*>(dst) = ZoneEntryHeader{
+		.endCycles = endCycles,
+		.nameSize = nameSize,
+	};
+	pstd::memCpy(dst + sizeof(ZoneEntryHeader), name.buffer, nameSize);
+
+	commitEntry(pThread, entrySize);
+}
+
+bool FlightRecorder::openRecording(
+	pstd::Arena* pArena, const pstd::String& data, Recording* outRecording
+) {
+	ASSERT(pArena);
+	ASSERT(outRecording);
+
+	FileHeader header{};
+	if (data.size < sizeof(FileHeader)) {
+		return false;
+	}
+	pstd::memCpy(&header, data.buffer, sizeof(FileHeader));
+
+	if (header.magic != RECORDER_FILE_MAGIC ||
+		header.version != RECORDER_FILE_VERSION ||
+		pstd::calcNextPowerOfTwo(header.blockSize) != header.blockSize ||
+		header.blockSize < sizeof(BlockHeader) + sizeof(EntryHeader) ||
+		header.blockSize > MAX_BLOCK_SIZE ||
+		(header.blockCount + 1ull) * header.blockSize != data.size) {
+		return false;
+	}
+
+	// entries are counted first, so the tables are only as large as they
+	// need to be
+	uint32_t capacity{ header.blockSize -
+					   ncast<uint32_t>(sizeof(BlockHeader)) };
+	for (uint32_t pass{}; pass < 2; pass++) {
+		uint32_t entryCount{};
+		SortKey* keys{};
+		if (pass == 1) {
+			keys = pstd::alloc<SortKey>(pArena, outRecording->entryCount);
+		}
+
+		uint64_t firstSequence{ ~0ull };
+		uint64_t lastSequence{};
+		BlockHeader firstBlock{};
+		BlockHeader lastBlock{};
+		for (uint32_t i{}; i < header.blockCount; i++) {
+			uint32_t blockOffset{ (i + 1) * header.blockSize };
+			BlockHeader block{};
+			pstd::memCpy(
+				&block, data.buffer + blockOffset, sizeof(BlockHeader)
+			);
+
+			// what was written before a crash in the middle of an entry is
+			// still good
+			block.sequence &= ~BLOCK_WRITING_BIT;
+			if (block.sequence == 0) {
+				continue;
+			}
+
+			if (block.sequence < firstSequence) {
+				firstSequence = block.sequence;
+				firstBlock = block;
+			}
+			if (block.sequence > lastSequence) {
+				lastSequence = block.sequence;
+				lastBlock = block;
+			}
+
+			uint32_t offset{ blockOffset +
+							 ncast<uint32_t>(sizeof(BlockHeader)) };
+			uint32_t endOffset{ offset + min(block.used, capacity) };
+			Entry entry{};
+			uint32_t entrySize{};
+			while (offset < endOffset &&
+				   parseEntry(data, offset, endOffset, &entry, &entrySize)) {
+				if (keys) {
+					keys[entryCount] = SortKey{
+						.cycles = entry.cycles,
+						.offset = offset,
+					};
+				}
+				entryCount++;
+				offset += entrySize;
+			}
+		}
+
+		if (pass == 0) {
+			*outRecording = Recording{
+				.data = data,
+				.header = header,
+				.entryCount = entryCount,
+			};
+			if (entryCount == 0) {
+				return true;
+			}
+			continue;
+		}
+
+		SortKey* scratch{ pstd::alloc<SortKey>(pArena, entryCount) };
+		sortKeys(keys, scratch, entryCount);
+
+		uint32_t* entryOffsets{ pstd::alloc<uint32_t>(pArena, entryCount) };
+		for (uint32_t i{}; i < entryCount; i++) {
+			entryOffsets[i] = keys[i].offset;
+		}
+
+		*outRecording = Recording{
+			.data = data,
+			.header = header,
+			.entryOffsets = entryOffsets,
+			.entryCount = entryCount,
+			.firstCycles = entryCount > 0 ? keys[0].cycles : 0,
+		};
+
+		// the first and last claimed blocks pair cycles with PTime's clock
+		if (lastBlock.time > firstBlock.time &&
+			lastBlock.cycles > firstBlock.cycles && header.timeFrequency > 0) {
+			double seconds{ ncast<double>(lastBlock.time - firstBlock.time) /
+							ncast<double>(header.timeFrequency) };
+			outRecording->cyclesPerSecond =
+				ncast<double>(lastBlock.cycles - firstBlock.cycles) / seconds;
+		}
+	}
+
+	return true;
+}
+
+void FlightRecorder::readEntry(
+	const Recording& recording, uint32_t index, Entry* outEntry
+) {
+	ASSERT(index < recording.entryCount);
+	ASSERT(outEntry);
+
+	uint32_t offset{ recording.entryOffsets[index] };
+	uint32_t blockOffset{ offset & ~(recording.header.blockSize - 1) };
+	BlockHeader block{};
+	pstd::memCpy(
+		&block, recording.data.buffer + blockOffset, sizeof(BlockHeader)
+	);
+
+	uint32_t entrySize{};
+	bool isParsed{ parseEntry(
+		recording.data,
+		offset,
+		blockOffset + recording.header.blockSize,
+		outEntry,
+		&entrySize
+	) };
+	ASSERT(isParsed);
+	outEntry->threadIndex = block.threadIndex;
+}
+
+namespace {
+	RecorderThread* getRecorderThread() {
+		auto* pThread{ rcast<RecorderThread*>(
+			pstd::getThreadLocal(g_Recorder.threadKey)
+		) };
+		if (pThread == &g_NoThread) {
+			pstd::atomicAdd(&g_Recorder.pHeader->droppedCount, 1ull);
+			return nullptr;
+		}
+		if (pThread) {
+			return pThread;
+		}
+
+		// the exited thread's last block is left as it is, the slot claims
+		// a new one
+		pstd::lockExclusive(&g_Recorder.registerMutex);
+		for (uint32_t i{}; i < g_Recorder.threadCount && !pThread; i++) {
+			if (pstd::atomicLoad(&g_Recorder.threads[i].isReleased)) {
+				pThread = &g_Recorder.threads[i];
+			}
+		}
+		if (!pThread && g_Recorder.threadCount < g_Recorder.maxThreadCount) {
+			pThread = &g_Recorder.threads[g_Recorder.threadCount++];
+		}
+		if (pThread) {
+			*pThread = RecorderThread{ .index = g_Recorder.nextThreadIndex++ };
+		}
+		pstd::unlockExclusive(&g_Recorder.registerMutex);
+
+		if (!pThread) {
+			pstd::setThreadLocal(g_Recorder.threadKey, &g_NoThread);
+			pstd::atomicAdd(&g_Recorder.pHeader->droppedCount, 1ull);
+			return nullptr;
+		}
+
+		pstd::setThreadLocal(g_Recorder.threadKey, pThread);
+		return pThread;
+	}
+
+	void releaseRecorderThread(void* pVal) {
+		auto* pThread{ rcast<RecorderThread*>(pVal) };
+		if (pThread != &g_NoThread) {
+			pstd::atomicStore(&pThread->isReleased, 1u);
+		}
+	}
+
+	uint8_t* reserveEntry(
+		RecorderThread* pThread, EntryKind kind, uint64_t cycles, uint32_t size
+	) {
+		uint32_t capacity{ g_Recorder.blockSize -
+						   ncast<uint32_t>(sizeof(BlockHeader)) };
+		ASSERT(size <= capacity);
+
+		uint64_t sequence{ pThread->sequence };
+		if (!pThread->pBlock || pThread->used + size > capacity ||
+			!pstd::atomicCompareExchange(
+				&pThread->pBlock->sequence,
+				&sequence,
+				pThread->sequence | BLOCK_WRITING_BIT
+			)) {
+			claimBlock(pThread);
+		}
+
+		uint8_t* dst{ rcast<uint8_t*>(pThread->pBlock + 1) + pThread->used };
+		*rcast<EntryHeader*>(dst) = EntryHeader{
+			.size = size,
+			.kind = kind,
+			.cycles = cycles,
+		};
+		return dst + sizeof(EntryHeader);
+	}
+
+	void commitEntry(RecorderThread* pThread, uint32_t size) {
+		pThread->used += size;
+		pstd::atomicStore(&pThread->pBlock->used, pThread->used);
+		pstd::atomicStore(&pThread->pBlock->sequence, pThread->sequence);
+	}
+
+	void claimBlock(RecorderThread* pThread) {
+		BlockHeader* pBlock{};
+		uint64_t sequence{};
+		while (!pBlock) {
+			sequence =
+				pstd::atomicAdd(&g_Recorder.pHeader->nextSequence, 1ull) + 1;
+			uint64_t blockIndex{ sequence % g_Recorder.blockCount };
+			auto* pCandidate{ rcast<BlockHeader*>(
+				g_Recorder.blocks + blockIndex * g_Recorder.blockSize
+			) };
+
+			// a block being written or claimed is passed over, readers skip
+			// it until its new sequence is in
+			uint64_t previous{ pstd::atomicLoad(&pCandidate->sequence) };
+			if (!(previous & BLOCK_WRITING_BIT) &&
+				pstd::atomicCompareExchange(
+					&pCandidate->sequence, &previous, BLOCK_WRITING_BIT
+				)) {
+				pBlock = pCandidate;
+			}
+		}
+
+		pstd::atomicStore(&pBlock->used, 0u);
+		pBlock->cycles = pstd::readCycleCounter();
+		pBlock->time = pstd::getTime();
+		pBlock->threadIndex = pThread->index;
+		pstd::atomicStore(&pBlock->sequence, sequence | BLOCK_WRITING_BIT);
+
+		pThread->pBlock = pBlock;
+		pThread->sequence = sequence;
+		pThread->used = 0;
+	}
+
+	uint32_t calcPackedArgsSize(
+		const LogArgType* argTypes,
+		uint32_t argCount,
+		const LogArg* args,
+		uint32_t maxStringSize
+	) {
+		uint32_t size{};
+		for (uint32_t i{}; i < argCount; i++) {
+			if (argTypes[i] == LogArgType::float32) {
+				size += sizeof(float);
+			} else if (argTypes[i] == LogArgType::string) {
+				size += sizeof(uint32_t) +
+					min(args[i].string.size, maxStringSize);
+			} else {
+				size += sizeof(uint64_t);
+			}
+		}
+
+		return size;
+	}
+
+	uint8_t* packArgs(
+		uint8_t* dst,
+		const LogArgType* argTypes,
+		uint32_t argCount,
+		const LogArg* args,
+		uint32_t maxStringSize
+	) {
+		for (uint32_t i{}; i < argCount; i++) {
+			if (argTypes[i] == LogArgType::float32) {
+				pstd::storeUInt32(dst, pstd::loadUInt32(&args[i]));
+				dst += sizeof(float);
+			} else if (argTypes[i] == LogArgType::string) {
+				const pstd::String& string{ args[i].string };
+				uint32_t size{ min(string.size, maxStringSize) };
+				pstd::storeUInt32(dst, size);
+				pstd::memCpy(dst + sizeof(uint32_t), string.buffer, size);
+				dst += sizeof(uint32_t) + size;
+			} else {
+				pstd::storeUInt64(dst, pstd::loadUInt64(&args[i]));
+				dst += sizeof(uint64_t);
+			}
+		}
+
+		return dst;
+	}
+
+	bool parseEntry(
+		const pstd::String& data,
+		uint32_t offset,
+		uint32_t endOffset,
+		FlightRecorder::Entry* outEntry,
+		uint32_t* outSize
+	) {
+		if (endOffset - offset < sizeof(EntryHeader)) {
+			return false;
+		}
+
+		EntryHeader header{};
+		pstd::memCpy(&header, data.buffer + offset, sizeof(EntryHeader));
+		if (header.size < sizeof(EntryHeader) ||
+			header.size % ENTRY_ALIGNMENT != 0 ||
+			header.size > endOffset - offset) {
+			return false;
+		}
+
+		EntryReader reader{
+			.src = rcast<const uint8_t*>(data.buffer + offset),
+			.size = header.size,
+			.offset = sizeof(EntryHeader),
+		};
+		outEntry->kind = header.kind;
+		outEntry->cycles = header.cycles;
+		*outSize = header.size;
+
+		switch (header.kind) {
+			case EntryKind::log: {
+				auto logHeader{ getStruct<LogEntryHeader>(&reader) };
+				if (logHeader.level >= ncast<uint8_t>(LogLevel::count) ||
+					logHeader.argCount > Console::MAX_LOG_ARGS) {
+					return false;
+				}
+
+				auto* argTypes{ rcast<const LogArgType*>(
+					getBytes(&reader, logHeader.argCount)
+				) };
+				const uint8_t* file{ getBytes(&reader, logHeader.fileSize) };
+				const uint8_t* format{
+					getBytes(&reader, logHeader.formatSize)
+				};
+				if (reader.hasFailed) {
+					return false;
+				}
+				for (uint32_t i{}; i < logHeader.argCount; i++) {
+					if (argTypes[i] >= LogArgType::count) {
+						return false;
+					}
+				}
+
+				outEntry->level = ncast<LogLevel>(logHeader.level);
+				outEntry->line = logHeader.line;
+				outEntry->file = pstd::String{
+					.buffer = rcast<const char*>(file),
+					.size = logHeader.fileSize,
+				};
+				outEntry->format = pstd::String{
+					.buffer = rcast<const char*>(format),
+					.size = logHeader.formatSize,
+				};
+				outEntry->argTypes = argTypes;
+				outEntry->argCount = logHeader.argCount;
+				if (!Console::getLogFormatMatchesArgs(
+						outEntry->format, argTypes, logHeader.argCount
+					)) {
+					return false;
+				}
+
+				for (uint32_t i{}; i < logHeader.argCount; i++) {
+					LogArg& arg{ outEntry->args[i] };
+					if (argTypes[i] == LogArgType::float32) {
+						const uint8_t* src{ getBytes(&reader, sizeof(float)) };
+						if (src) {
+							pstd::storeUInt32(&arg, pstd::loadUInt32(src));
+						}
+					} else if (argTypes[i] == LogArgType::string) {
+						auto size{ getStruct<uint32_t>(&reader) };
+						arg.string = pstd::String{
+							.buffer =
+								rcast<const char*>(getBytes(&reader, size)),
+							.size = size,
+						};
+					} else {
+						arg.uintVal = getStruct<uint64_t>(&reader);
+					}
+				}
+			} break;
+			case EntryKind::frame: {
+				outEntry->frameIndex =
+					getStruct<FrameEntryHeader>(&reader).frameIndex;
+			} break;
+			case EntryKind::zone: {
+				auto zoneHeader{ getStruct<ZoneEntryHeader>(&reader) };
+				const uint8_t* name{ getBytes(&reader, zoneHeader.nameSize) };
+				outEntry->endCycles = zoneHeader.endCycles;
+				outEntry->name = pstd::String{
+					.buffer = rcast<const char*>(name),
+					.size = zoneHeader.nameSize,
+				};
+			} break;
+			default: {
+				return false;
+			} break;
+		}
+
+		return !reader.hasFailed;
+	}
+
+	const uint8_t* getBytes(EntryReader* pReader, uint32_t size) {
+		if (pReader->hasFailed || pReader->size - pReader->offset < size) {
+			pReader->hasFailed = true;
+			return nullptr;
+		}
+
+		const uint8_t* src{ pReader->src + pReader->offset };
+		pReader->offset += size;
+		return src;
+	}
+
+	template<typename T>
+	T getStruct(EntryReader* pReader) {
+		T val{};
+		const uint8_t* src{ getBytes(pReader, sizeof(T)) };
+		if (src) {
+			pstd::memCpy(&val, src, sizeof(T));
+		}
+		return val;
+	}
+
+	void sortKeys(SortKey* keys, SortKey* scratch, uint32_t count) {
+		// bottom up merge sort, the runs swap between keys and scratch
+		SortKey* src{ keys };
+		SortKey* dst{ scratch };
+		for (uint32_t width{ 1 }; width < count; width *= 2) {
+			for (uint32_t begin{}; begin < count; begin += 2 * width) {
+				uint32_t middle{ min(begin + width, count) };
+				uint32_t end{ min(begin + 2 * width, count) };
+
+				uint32_t left{ begin };
+				uint32_t right{ middle };
+				for (uint32_t i{ begin }; i < end; i++) {
+					if (left < middle &&
+						(right == end ||
+						 src[left].cycles <= src[right].cycles)) {
+						dst[i] = src[left++];
+					} else {
+						dst[i] = src[right++];
+					}
+				}
+			}
+
+			SortKey* swap{ src };
+			src = dst;
+			dst = swap;
+		}
+
+		if (src != keys) {
+			pstd::memCpy(keys, src, count * sizeof(SortKey));
+		}
+	}
+}  // namespace
@@ -0,0 +1,309 @@
+#include "FrameStats.h"
+
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PTime.h"
+#include "Core/PMemory.h"
+#include "Core/PFileIO.h"
+#include "Core/PHistogram.h"
+#include "Core/PString.h"
+#include "Core/PStringBuilder.h"
+#include "Core/PAlgorithm.h"
+#include "Core/PAssert.h"
+
+using FrameStats::MAX_PHASE_DEPTH;
+using FrameStats::Phase;
+using FrameStats::PhaseStats;
+using FrameStats::Summary;
+
+namespace {
+	constexpr uint32_t PHASE_COUNT{ cast<uint32_t>(Phase::count) };
+
+	// a frame has a timing per phase and one for the whole frame after them
+	constexpr uint32_t TIMING_COUNT{ PHASE_COUNT + 1 };
+	constexpr uint32_t FRAME_TIMING{ PHASE_COUNT };
+
+	constexpr const char* TIMING_NAMES[TIMING_COUNT]{
+		"hotReloadCheck", "platformPump", "engineUpdate", "gameUpdate",
+		"frame",
+	};
+
+	// a CSV line is two names and six numbers
+	constexpr uint32_t MAX_LINE_SIZE{ 256 };
+
+	// childTime is what the phases nested in it took
+	struct OpenPhase {
+		Phase phase;
+		uint64_t beginTime;
+		uint64_t childTime;
+	};
+
+	// windowTimes is a ring of the last windowFrameCount frames' timings in
+	// nanoseconds, which come out of the window histograms when they leave
+	// it. frameTimes adds up the current frame's in PTime ticks. phaseDepth
+	// goes past MAX_PHASE_DEPTH for phases that aren't timed
+	struct FrameStatsState {
+		pstd::Arena arena;
+		pstd::Histogram* windowHistograms;
+		pstd::Histogram* runHistograms;
+		uint64_t* windowTimes;
+		uint32_t windowFrameCount;
+		uint64_t frameCount;
+		uint64_t frameBeginTime;
+		uint64_t frameTimes[TIMING_COUNT];
+		OpenPhase openPhases[MAX_PHASE_DEPTH];
+		uint32_t phaseDepth;
+		double nanosecondsPerTick;
+		Summary summary;
+		bool isStarted;
+		bool isInFrame;
+	};
+
+	FrameStatsState g_FrameStats{};
+
+	PhaseStats calcPhaseStats(const pstd::Histogram& histogram);
+
+	void appendStatsLine(
+		pstd::StringBuilder* pBuilder,
+		const char* windowName,
+		const char* timingName,
+		const pstd::Histogram& histogram
+	);
+}  // namespace
+
+void FrameStats::startup(
+	pstd::AllocationRegistry* pAllocRegistry, const Config& config
+) {
+	ASSERT(pAllocRegistry);
+	ASSERT(!g_FrameStats.isStarted);
+	ASSERT(config.windowFrameCount > 0);
+
+	size_t histogramsSize{ 2 * TIMING_COUNT * sizeof(pstd::Histogram) +
+						   alignof(pstd::Histogram) };
+	size_t windowSize{ ncast<size_t>(config.windowFrameCount) *
+						   TIMING_COUNT * sizeof(uint64_t) +
+					   alignof(uint64_t) };
+	g_FrameStats = FrameStatsState{
+		.arena = pstd::allocateArena(
+			pAllocRegistry, histogramsSize + windowSize
+		),
+		.windowFrameCount = config.windowFrameCount,
+		.nanosecondsPerTick = 1000000000.0 /
+			ncast<double>(pstd::getTimeFrequency()),
+		.isStarted = true,
+	};
+
+	// zeroed is an empty histogram
+	g_FrameStats.windowHistograms =
+		pstd::alloc<pstd::Histogram>(&g_FrameStats.arena, TIMING_COUNT);
+	g_FrameStats.runHistograms =
+		pstd::alloc<pstd::Histogram>(&g_FrameStats.arena, TIMING_COUNT);
+	pstd::memZero(
+		g_FrameStats.windowHistograms, TIMING_COUNT * sizeof(pstd::Histogram)
+	);
+	pstd::memZero(
+		g_FrameStats.runHistograms, TIMING_COUNT * sizeof(pstd::Histogram)
+	);
+	g_FrameStats.windowTimes = pstd::alloc<uint64_t>(
+		&g_FrameStats.arena,
+		ncast<size_t>(config.windowFrameCount) * TIMING_COUNT
+	);
+}
+
+void FrameStats::shutdown(pstd::AllocationRegistry* pAllocRegistry) {
+	ASSERT(pAllocRegistry);
+	if (!g_FrameStats.isStarted) {
+		return;
+	}
+
+	pstd::freeArena(pAllocRegistry, &g_FrameStats.arena);
+	g_FrameStats = FrameStatsState{};
+}
+
+void FrameStats::beginFrame() {
+	if (!g_FrameStats.isStarted) {
+		return;
+	}
+	ASSERT(!g_FrameStats.isInFrame);
+
+	for (uint64_t& time : g_FrameStats.frameTimes) {
+		time = 0;
+	}
+	g_FrameStats.isInFrame = true;
+	g_FrameStats.frameBeginTime = pstd::getTime();
+}
+
+void FrameStats::endFrame() {
+	if (!g_FrameStats.isStarted) {
+		return;
+	}
+	ASSERT(g_FrameStats.isInFrame);
+	ASSERT(g_FrameStats.phaseDepth == 0);
+
+	g_FrameStats.frameTimes[FRAME_TIMING] =
+		pstd::getTime() - g_FrameStats.frameBeginTime;
+	g_FrameStats.isInFrame = false;
+
+	uint64_t windowIndex{ g_FrameStats.frameCount %
+						  g_FrameStats.windowFrameCount };
+	uint64_t* windowTimes{ g_FrameStats.windowTimes +
+						   windowIndex * TIMING_COUNT };
+	bool isWindowFull{ g_FrameStats.frameCount >=
+					   g_FrameStats.windowFrameCount };
+	for (uint32_t i{}; i < TIMING_COUNT; i++) {
+		auto nanoseconds{ ncast<uint64_t>(
+			ncast<double>(g_FrameStats.frameTimes[i]) *
+			g_FrameStats.nanosecondsPerTick
+		) };
+
+		if (isWindowFull) {
+			pstd::removeValue(
+				&g_FrameStats.windowHistograms[i], windowTimes[i]
+			);
+		}
+		windowTimes[i] = nanoseconds;
+		pstd::addValue(&g_FrameStats.windowHistograms[i], nanoseconds);
+		pstd::addValue(&g_FrameStats.runHistograms[i], nanoseconds);
+	}
+	g_FrameStats.frameCount++;
+
+	Summary& summary{ g_FrameStats.summary };
+	summary.frameCount =
+		g_FrameStats.windowHistograms[FRAME_TIMING].totalCount;
+	summary.frame =
+		calcPhaseStats(g_FrameStats.windowHistograms[FRAME_TIMING]);
+	for (uint32_t i{}; i < PHASE_COUNT; i++) {
+		summary.phases[ncast<Phase>(i)] =
+			calcPhaseStats(g_FrameStats.windowHistograms[i]);
+	}
+}
+
+void FrameStats::beginPhase(Phase phase) {
+	if (!g_FrameStats.isStarted) {
+		return;
+	}
+
+	if (g_FrameStats.phaseDepth < MAX_PHASE_DEPTH) {
+		g_FrameStats.openPhases[g_FrameStats.phaseDepth] = OpenPhase{
+			.phase = phase,
+			.beginTime = pstd::getTime(),
+		};
+	}
+	g_FrameStats.phaseDepth++;
+}
+
+void FrameStats::endPhase() {
+	if (!g_FrameStats.isStarted) {
+		return;
+	}
+	ASSERT(g_FrameStats.phaseDepth > 0);
+
+	g_FrameStats.phaseDepth--;
+	uint32_t depth{ g_FrameStats.phaseDepth };
+	if (depth >= MAX_PHASE_DEPTH) {
+		return;
+	}
+
+	const OpenPhase& openPhase{ g_FrameStats.openPhases[depth] };
+	uint64_t elapsed{ pstd::getTime() - openPhase.beginTime };
+	g_FrameStats.frameTimes[cast<uint32_t>(openPhase.phase)] +=
+		elapsed - min(openPhase.childTime, elapsed);
+
+	if (depth > 0) {
+		g_FrameStats.openPhases[depth - 1].childTime += elapsed;
+	}
+}
+
+const char* FrameStats::getPhaseName(Phase phase) {
+	ASSERT(phase < Phase::count);
+
+	return TIMING_NAMES[cast<uint32_t>(phase)];
+}
+
+const Summary* FrameStats::getSummary() {
+	if (!g_FrameStats.isStarted) {
+		return nullptr;
+	}
+
+	return &g_FrameStats.summary;
+}
+
+bool FrameStats::exportStats(
+	pstd::AllocationRegistry* pAllocRegistry, const char* path
+) {
+	ASSERT(pAllocRegistry);
+	ASSERT(path);
+	if (!g_FrameStats.isStarted) {
+		return false;
+	}
+
+	pstd::FileHandle file{ pstd::openFile(
+		path,
+		pstd::FileAccess::write,
+		pstd::FileShare::read,
+		pstd::FileCreate::createAlways
+	) };
+	if (!file) {
+		return false;
+	}
+
+	pstd::Arena arena{ pstd::allocateArena(
+		pAllocRegistry, (2 * TIMING_COUNT + 1) * MAX_LINE_SIZE
+	) };
+	pstd::StringBuilder builder{ pstd::createStringBuilder(&arena) };
+
+	pstd::append(&builder, "window,timing,frames,mean,p50,p95,p99,max\n");
+	for (uint32_t i{}; i < TIMING_COUNT; i++) {
+		appendStatsLine(
+			&builder,
+			"last",
+			TIMING_NAMES[i],
+			g_FrameStats.windowHistograms[i]
+		);
+	}
+	for (uint32_t i{}; i < TIMING_COUNT; i++) {
+		appendStatsLine(
+			&builder, "run", TIMING_NAMES[i], g_FrameStats.runHistograms[i]
+		);
+	}
+
+	pstd::String text{ pstd::finishString(&builder) };
+	bool hasWritten{ pstd::writeFile(file, text.buffer, text.size) };
+
+	pstd::closeFile(file);
+	pstd::freeArena(pAllocRegistry, &arena);
+	return hasWritten;
+}
+
+namespace {
+	PhaseStats calcPhaseStats(const pstd::Histogram& histogram) {
+		return PhaseStats{
+			.mean = pstd::calcMean(histogram),
+			.p50 = pstd::calcPercentile(histogram, 50.0),
+			.p95 = pstd::calcPercentile(histogram, 95.0),
+			.p99 = pstd::calcPercentile(histogram, 99.0),
+			.maximum = pstd::calcPercentile(histogram, 100.0),
+		};
+	}
+
+	void appendStatsLine(
+		pstd::StringBuilder* pBuilder,
+		const char* windowName,
+		const char* timingName,
+		const pstd::Histogram& histogram
+	) {
+		PhaseStats stats{ calcPhaseStats(histogram) };
+		pstd::appendf(
+			pBuilder,
+			"%m,%m,%u,%u,%u,%u,%u,%u\n",
+			windowName,
+			timingName,
+			histogram.totalCount,
+			stats.mean,
+			stats.p50,
+			stats.p95,
+			stats.p99,
+			stats.maximum
+		);
+	}
+}  // namespace
@@ -0,0 +1,634 @@
+#include "LogFile.h"
+#include "Logging.h"
+
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PString.h"
+#include "Core/PStringBuilder.h"
+#include "Core/PIntrinsics.h"
+#include "Core/PMemory.h"
+#include "Core/PAssert.h"
+
+using namespace Console;
+
+namespace {
+	constexpr pstd::StaticArray<
+		const char*,
+		cast<size_t>(LogLevel::count),
+		LogLevel>
+		g_LogLevelStrings{ .data = {
+							   "", "[INFO]: ", "[WARNING] ", "[ERROR] " } };
+
+	constexpr uint32_t MAX_VARINT_SIZE{ 10 };
+
+	// writes stop at capacity and mark the entry as not fitting
+	struct EntryWriter {
+		uint8_t* dst;
+		uint32_t capacity;
+		uint32_t size;
+		bool isFull;
+	};
+
+	void putBytes(EntryWriter* pWriter, const void* src, uint32_t size);
+	void putByte(EntryWriter* pWriter, uint8_t val);
+	void putUInt32(EntryWriter* pWriter, uint32_t val);
+	void putUInt64(EntryWriter* pWriter, uint64_t val);
+	void putVarint(EntryWriter* pWriter, uint64_t val);
+	void putZigzag(EntryWriter* pWriter, int64_t val);
+	void putString(EntryWriter* pWriter, const pstd::String& string);
+	uint32_t finishEntry(const EntryWriter& writer);
+
+	// reads fail once past the end and leave the reader failed
+	struct EntryReader {
+		const uint8_t* src;
+		uint32_t size;
+		uint32_t offset;
+		bool hasFailed;
+	};
+
+	uint8_t getByte(EntryReader* pReader);
+	uint32_t getUInt32(EntryReader* pReader);
+	uint64_t getUInt64(EntryReader* pReader);
+	uint64_t getVarint(EntryReader* pReader);
+	int64_t getZigzag(EntryReader* pReader);
+	pstd::String getString(EntryReader* pReader);
+
+	bool readSite(
+		LogFileReader* pReader, EntryReader* pEntryReader, LogEntry* outEntry
+	);
+	bool readRecord(
+		LogFileReader* pReader, EntryReader* pEntryReader, LogEntry* outEntry
+	);
+
+	// every specifier is known and fits its argument, like FormatString
+	// checks at compile time
+	void appendLogArg(
+		pstd::StringBuilder* pBuilder,
+		char specifier,
+		LogArgType argType,
+		const LogArg& arg
+	);
+}  // namespace
+
+uint32_t Console::encodeLogFileHeader(
+	uint8_t* dst, uint32_t capacity, const LogFileHeader& header
+) {
+	EntryWriter writer{ .dst = dst, .capacity = capacity };
+	putUInt32(&writer, header.magic);
+	putUInt32(&writer, header.version);
+	putUInt64(&writer, header.timeFrequency);
+	putUInt32(&writer, header.maxSiteCount);
+	putUInt32(&writer, 0);
+
+	ASSERT(writer.isFull || writer.size == LOG_FILE_HEADER_SIZE);
+	return finishEntry(writer);
+}
+
+uint32_t Console::encodeLogSite(
+	uint8_t* dst,
+	uint32_t capacity,
+	uint32_t id,
+	const LogSite& site,
+	const char* format,
+	const LogArgType* argTypes,
+	uint32_t argCount
+) {
+	ASSERT(format);
+	ASSERT(argTypes || argCount == 0);
+
+	EntryWriter writer{ .dst = dst, .capacity = capacity };
+	putByte(&writer, cast<uint8_t>(LogEntryKind::site));
+	putVarint(&writer, id);
+	putByte(&writer, ncast<uint8_t>(site.level));
+	putVarint(&writer, site.line);
+	putVarint(&writer, argCount);
+	putBytes(&writer, argTypes, argCount);
+	putString(&writer, pstd::createString(site.file));
+	putString(&writer, pstd::createString(format));
+
+	return finishEntry(writer);
+}
+
+uint32_t Console::encodeLogRecord(
+	uint8_t* dst,
+	uint32_t capacity,
+	uint32_t siteId,
+	int64_t cycleDelta,
+	const LogArgType* argTypes,
+	uint32_t argCount,
+	const LogArg* args
+) {
+	ASSERT(argTypes || argCount == 0);
+
+	EntryWriter writer{ .dst = dst, .capacity = capacity };
+	putByte(&writer, cast<uint8_t>(LogEntryKind::record));
+	putVarint(&writer, siteId);
+	putZigzag(&writer, cycleDelta);
+
+	for (uint32_t i{}; i < argCount; i++) {
+		switch (argTypes[i]) {
+			case LogArgType::int64: {
+				putZigzag(&writer, args[i].intVal);
+			} break;
+			case LogArgType::uint64: {
+				putVarint(&writer, args[i].uintVal);
+			} break;
+			case LogArgType::float32: {
+				putBytes(&writer, &args[i].floatVal, sizeof(float));
+			} break;
+			case LogArgType::float64: {
+				putBytes(&writer, &args[i].doubleVal, sizeof(double));
+			} break;
+			case LogArgType::string: {
+				putString(&writer, args[i].string);
+			} break;
+			default: {
+				ASSERT(false);
+			} break;
+		}
+	}
+
+	return finishEntry(writer);
+}
+
+uint32_t Console::encodeLogClock(
+	uint8_t* dst, uint32_t capacity, uint64_t cycles, uint64_t time
+) {
+	EntryWriter writer{ .dst = dst, .capacity = capacity };
+	putByte(&writer, cast<uint8_t>(LogEntryKind::clock));
+	putUInt64(&writer, cycles);
+	putUInt64(&writer, time);
+
+	return finishEntry(writer);
+}
+
+uint32_t
+	Console::encodeLogDropped(uint8_t* dst, uint32_t capacity, uint64_t count) {
+	EntryWriter writer{ .dst = dst, .capacity = capacity };
+	putByte(&writer, cast<uint8_t>(LogEntryKind::dropped));
+	putVarint(&writer, count);
+
+	return finishEntry(writer);
+}
+
+bool Console::readLogFileHeader(
+	const pstd::String& data, LogFileHeader* outHeader
+) {
+	ASSERT(outHeader);
+
+	EntryReader reader{ .src = rcast<const uint8_t*>(data.buffer),
+						.size = data.size };
+	LogFileHeader header{
+		.magic = getUInt32(&reader),
+		.version = getUInt32(&reader),
+		.timeFrequency = getUInt64(&reader),
+		.maxSiteCount = getUInt32(&reader),
+	};
+	getUInt32(&reader);
+
+	if (reader.hasFailed || header.magic != LOG_FILE_MAGIC ||
+		header.version != LOG_FILE_VERSION) {
+		return false;
+	}
+
+	*outHeader = header;
+	return true;
+}
+
+bool Console::openLogFile(
+	pstd::Arena* pArena, const pstd::String& data, LogFileReader* outReader
+) {
+	ASSERT(pArena);
+	ASSERT(outReader);
+
+	LogFileHeader header{};
+	if (!readLogFileHeader(data, &header)) {
+		return false;
+	}
+	if (header.maxSiteCount > pstd::getAvailableCount<LogFileSite>(*pArena)) {
+		return false;
+	}
+
+	*outReader = LogFileReader{
+		.data = data,
+		.offset = LOG_FILE_HEADER_SIZE,
+		.header = header,
+		.sites = pstd::alloc<LogFileSite>(pArena, header.maxSiteCount),
+	};
+	return true;
+}
+
+bool Console::readLogEntry(LogFileReader* pReader, LogEntry* outEntry) {
+	ASSERT(pReader);
+	ASSERT(outEntry);
+
+	EntryReader reader{
+		.src = rcast<const uint8_t*>(pReader->data.buffer),
+		.size = pReader->data.size,
+		.offset = pReader->offset,
+	};
+	if (reader.offset >= reader.size) {
+		return false;
+	}
+
+	auto kind{ ncast<LogEntryKind>(getByte(&reader)) };
+	*outEntry = LogEntry{ .kind = kind };
+
+	bool isValid{};
+	switch (kind) {
+		case LogEntryKind::site: {
+			isValid = readSite(pReader, &reader, outEntry);
+		} break;
+		case LogEntryKind::record: {
+			isValid = readRecord(pReader, &reader, outEntry);
+		} break;
+		case LogEntryKind::clock: {
+			outEntry->cycles = getUInt64(&reader);
+			outEntry->time = getUInt64(&reader);
+			isValid = true;
+		} break;
+		case LogEntryKind::dropped: {
+			outEntry->droppedCount = getVarint(&reader);
+			isValid = true;
+		} break;
+		default: break;
+	}
+
+	if (!isValid || reader.hasFailed) {
+		return false;
+	}
+
+	// a site only counts once the whole entry was read
+	if (kind == LogEntryKind::site) {
+		pReader->siteCount++;
+	} else if (kind == LogEntryKind::record) {
+		pReader->cycles = outEntry->cycles;
+	}
+	pReader->offset = reader.offset;
+	return true;
+}
+
+void Console::appendLogLine(
+	pstd::StringBuilder* pBuilder,
+	LogLevel level,
+	const pstd::String& file,
+	uint32_t line,
+	const pstd::String& format,
+	const LogArgType* argTypes,
+	const LogArg* args
+) {
+	ASSERT(pBuilder);
+	ASSERT(level < LogLevel::count);
+
+	pstd::append(pBuilder, g_LogLevelStrings[level]);
+	if (file.size > 0) {
+		pstd::appendf(pBuilder, "[%m:%u] ", pstd::getFileName(file), line);
+	}
+
+	pstd::String rest{ format };
+	uint32_t argIndex{};
+	uint32_t percentIndex{};
+	while (pstd::findAnyOf(rest, pstd::createString("%"), &percentIndex)) {
+		ASSERT(percentIndex + 1 < rest.size);
+
+		pstd::append(
+			pBuilder,
+			pstd::String{ .buffer = rest.buffer, .size = percentIndex }
+		);
+
+		char specifier{ rest.buffer[percentIndex + 1] };
+		if (specifier == '%') {
+			pstd::append(pBuilder, '%');
+		} else {
+			appendLogArg(
+				pBuilder, specifier, argTypes[argIndex], args[argIndex]
+			);
+			argIndex++;
+		}
+
+		uint32_t consumedSize{ percentIndex + 2 };
+		rest = pstd::String{ .buffer = rest.buffer + consumedSize,
+							 .size = rest.size - consumedSize };
+	}
+	pstd::append(pBuilder, rest);
+}
+
+bool Console::getLogFormatMatchesArgs(
+	const pstd::String& format,
+	const LogArgType* argTypes,
+	uint32_t argCount
+) {
+	uint32_t argIndex{};
+	for (uint32_t i{}; i < format.size; i++) {
+		if (format.buffer[i] != '%') {
+			continue;
+		}
+		if (i + 1 == format.size) {
+			return false;
+		}
+
+		char specifier{ format.buffer[i + 1] };
+		i++;
+		if (specifier == '%') {
+			continue;
+		}
+		if (argIndex == argCount) {
+			return false;
+		}
+
+		LogArgType argType{ argTypes[argIndex] };
+		bool isInteger{ argType == LogArgType::int64 ||
+						argType == LogArgType::uint64 };
+		bool matches{};
+		switch (specifier) {
+			case 'i':
+			case 'u': {
+				matches = isInteger;
+			} break;
+			case 'f': {
+				matches = argType != LogArgType::string;
+			} break;
+			case 'm': {
+				matches = argType == LogArgType::string;
+			} break;
+			default: break;
+		}
+		if (!matches) {
+			return false;
+		}
+		argIndex++;
+	}
+
+	return argIndex == argCount;
+}
+
+namespace {
+	void putBytes(EntryWriter* pWriter, const void* src, uint32_t size) {
+		if (pWriter->isFull || pWriter->capacity - pWriter->size < size) {
+			pWriter->isFull = true;
+			return;
+		}
+
+		pstd::memCpy(pWriter->dst + pWriter->size, src, size);
+		pWriter->size += size;
+	}
+
+	void putByte(EntryWriter* pWriter, uint8_t val) {
+		if (pWriter->isFull || pWriter->size == pWriter->capacity) {
+			pWriter->isFull = true;
+			return;
+		}
+
+		pWriter->dst[pWriter->size] = val;
+		pWriter->size++;
+	}
+
+	void putUInt32(EntryWriter* pWriter, uint32_t val) {
+		if (pWriter->isFull || pWriter->capacity - pWriter->size < 4) {
+			pWriter->isFull = true;
+			return;
+		}
+
+		pstd::storeUInt32(pWriter->dst + pWriter->size, val);
+		pWriter->size += 4;
+	}
+
+	void putUInt64(EntryWriter* pWriter, uint64_t val) {
+		if (pWriter->isFull || pWriter->capacity - pWriter->size < 8) {
+			pWriter->isFull = true;
+			return;
+		}
+
+		pstd::storeUInt64(pWriter->dst + pWriter->size, val);
+		pWriter->size += 8;
+	}
+
+	void putVarint(EntryWriter* pWriter, uint64_t val) {
+		if (pWriter->isFull ||
+			pWriter->capacity - pWriter->size < MAX_VARINT_SIZE) {
+			// might still fit, the slow way
+			while (val >= 0x80) {
+				putByte(pWriter, ncast<uint8_t>(val | 0x80));
+				val >>= 7;
+			}
+			putByte(pWriter, ncast<uint8_t>(val));
+			return;
+		}
+
+		uint8_t* dst{ pWriter->dst + pWriter->size };
+		uint32_t size{};
+		while (val >= 0x80) {
+			dst[size] = ncast<uint8_t>(val | 0x80);
+			val >>= 7;
+			size++;
+		}
+		dst[size] = ncast<uint8_t>(val);
+		pWriter->size += size + 1;
+	}
+
+	void putZigzag(EntryWriter* pWriter, int64_t val) {
+		putVarint(
+			pWriter,
+			(ncast<uint64_t>(val) << 1) ^ ncast<uint64_t>(val >> 63)
+		);
+	}
+
+	void putString(EntryWriter* pWriter, const pstd::String& string) {
+		putVarint(pWriter, string.size);
+		putBytes(pWriter, string.buffer, string.size);
+	}
+
+	uint32_t finishEntry(const EntryWriter& writer) {
+		return writer.isFull ? 0 : writer.size;
+	}
+
+	uint8_t getByte(EntryReader* pReader) {
+		if (pReader->hasFailed || pReader->offset == pReader->size) {
+			pReader->hasFailed = true;
+			return 0;
+		}
+
+		uint8_t val{ pReader->src[pReader->offset] };
+		pReader->offset++;
+		return val;
+	}
+
+	uint32_t getUInt32(EntryReader* pReader) {
+		if (pReader->hasFailed || pReader->size - pReader->offset < 4) {
+			pReader->hasFailed = true;
+			return 0;
+		}
+
+		uint32_t val{ pstd::loadUInt32(pReader->src + pReader->offset) };
+		pReader->offset += 4;
+		return val;
+	}
+
+	uint64_t getUInt64(EntryReader* pReader) {
+		if (pReader->hasFailed || pReader->size - pReader->offset < 8) {
+			pReader->hasFailed = true;
+			return 0;
+		}
+
+		uint64_t val{ pstd::loadUInt64(pReader->src + pReader->offset) };
+		pReader->offset += 8;
+		return val;
+	}
+
+	uint64_t getVarint(EntryReader* pReader) {
+		uint64_t val{};
+		for (uint32_t shift{}; shift < 7 * MAX_VARINT_SIZE; shift += 7) {
+			uint8_t byte{ getByte(pReader) };
+			val |= ncast<uint64_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0) {
+				return val;
+			}
+		}
+
+		pReader->hasFailed = true;
+		return 0;
+	}
+
+	int64_t getZigzag(EntryReader* pReader) {
+		uint64_t val{ getVarint(pReader) };
+		return ncast<int64_t>((val >> 1) ^ (0 - (val & 1)));
+	}
+
+	pstd::String getString(EntryReader* pReader) {
+		uint64_t size{ getVarint(pReader) };
+		if (pReader->hasFailed || pReader->size - pReader->offset < size) {
+			pReader->hasFailed = true;
+			return {};
+		}
+
+		pstd::String string{
+			.buffer = rcast<const char*>(pReader->src + pReader->offset),
+			.size = ncast<uint32_t>(size),
+		};
+		pReader->offset += ncast<uint32_t>(size);
+		return string;
+	}
+
+	bool readSite(
+		LogFileReader* pReader, EntryReader* pEntryReader, LogEntry* outEntry
+	) {
+		// ids count up from 0 in the order sites are written
+		uint64_t id{ getVarint(pEntryReader) };
+		if (id != pReader->siteCount ||
+			id >= pReader->header.maxSiteCount) {
+			return false;
+		}
+
+		uint8_t level{ getByte(pEntryReader) };
+		uint64_t line{ getVarint(pEntryReader) };
+		uint64_t argCount{ getVarint(pEntryReader) };
+		if (level >= ncast<uint8_t>(LogLevel::count) ||
+			argCount > MAX_LOG_ARGS ||
+			pEntryReader->size - pEntryReader->offset < argCount) {
+			return false;
+		}
+
+		auto* argTypes{ rcast<const LogArgType*>(
+			pEntryReader->src + pEntryReader->offset
+		) };
+		pEntryReader->offset += ncast<uint32_t>(argCount);
+		for (uint32_t i{}; i < argCount; i++) {
+			if (argTypes[i] >= LogArgType::count) {
+				return false;
+			}
+		}
+
+		LogFileSite site{
+			.level = ncast<LogLevel>(level),
+			.line = ncast<uint32_t>(line),
+			.file = getString(pEntryReader),
+			.format = getString(pEntryReader),
+			.argTypes = argTypes,
+			.argCount = ncast<uint32_t>(argCount),
+		};
+		if (pEntryReader->hasFailed ||
+			!Console::getLogFormatMatchesArgs(
+				site.format, argTypes, site.argCount
+			)) {
+			return false;
+		}
+
+		pReader->sites[id] = site;
+		outEntry->pSite = &pReader->sites[id];
+		return true;
+	}
+
+	bool readRecord(
+		LogFileReader* pReader, EntryReader* pEntryReader, LogEntry* outEntry
+	) {
+		uint64_t siteId{ getVarint(pEntryReader) };
+		if (siteId >= pReader->siteCount) {
+			return false;
+		}
+
+		const LogFileSite& site{ pReader->sites[siteId] };
+		outEntry->pSite = &site;
+		outEntry->cycles =
+			pReader->cycles + ncast<uint64_t>(getZigzag(pEntryReader));
+
+		for (uint32_t i{}; i < site.argCount; i++) {
+			LogArg& arg{ outEntry->args[i] };
+			switch (site.argTypes[i]) {
+				case LogArgType::int64: {
+					arg.intVal = getZigzag(pEntryReader);
+				} break;
+				case LogArgType::uint64: {
+					arg.uintVal = getVarint(pEntryReader);
+				} break;
+				case LogArgType::float32: {
+					uint32_t bits{ getUInt32(pEntryReader) };
+					pstd::memCpy(&arg.floatVal, &bits, sizeof(float));
+				} break;
+				case LogArgType::float64: {
+					arg.uintVal = getUInt64(pEntryReader);
+				} break;
+				case LogArgType::string: {
+					arg.string = getString(pEntryReader);
+				} break;
+				default: {
+					return false;
+				} break;
+			}
+		}
+
+		return true;
+	}
+
+	void appendLogArg(
+		pstd::StringBuilder* pBuilder,
+		char specifier,
+		LogArgType argType,
+		const LogArg& arg
+	) {
+		if (specifier == 'm') {
+			pstd::append(pBuilder, arg.string);
+			return;
+		}
+
+		pstd::FormattedArg formatted{};
+		if (argType == LogArgType::float32) {
+			pstd::formatFloat(&formatted, arg.floatVal);
+		} else if (argType == LogArgType::float64) {
+			pstd::formatDouble(&formatted, arg.doubleVal);
+		} else if (specifier == 'f') {
+			double val{ argType == LogArgType::uint64
+							? ncast<double>(arg.uintVal)
+							: ncast<double>(arg.intVal) };
+			pstd::formatDouble(&formatted, val);
+		} else if (specifier == 'u') {
+			pstd::formatUInt64(&formatted, arg.uintVal);
+		} else {
+			pstd::formatInt64(&formatted, arg.intVal);
+		}
+
+		pstd::append(
+			pBuilder,
+			pstd::String{ .buffer = formatted.buffer, .size = formatted.size }
+		);
+	}
+}  // namespace
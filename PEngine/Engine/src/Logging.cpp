@@ -1,49 +1,1235 @@
 #include "Logging.h"
 #include "LoggingSetup.h"
+#include "LogFile.h"
+#include "FlightRecorder.h"
 
 #include "Core/PTypes.h"
 #include "Core/PArena.h"
+#include "Core/PAtomic.h"
+#include "Core/PThread.h"
+#include "Core/PTime.h"
 #include "Core/PConsole.h"
+#include "Core/PFileIO.h"
+#include "Core/PHash.h"
+#include "Core/PIntrinsics.h"
 #include "Core/PString.h"
+#include "Core/PStringBuilder.h"
+#include "Core/PAlgorithm.h"
 #include "Core/PAssert.h"
 
+using Console::LogArg;
+using Console::LogArgType;
+using Console::LogOverflow;
+using Console::LogSite;
+
 namespace {
-	constexpr uint32_t LOG_ARENA_SIZE{ 1024 };
-	char g_RawLogArray[LOG_ARENA_SIZE]{};
-	pstd::Arena g_LogArena{};
-
-	constexpr pstd::StaticArray<
-		const char*,
-		cast<size_t>(Console::LogLevel::count),
-		Console::LogLevel>
-		g_LogLevelStrings{ .data = {
-							   "", "[INFO]: ", "[WARNING] ", "[ERROR] " } };
+	// a record is this header and then its packed arguments, padded to
+	// RECORD_ALIGNMENT. integers and doubles take 8 bytes, floats 4 and
+	// strings a 4 byte size and their letters. one without a site only pads
+	// the ring out to its end, its size is all there is of it
+	struct LogRecord {
+		uint32_t size;
+		uint32_t argCount;
+		const LogSite* pSite;
+		const char* format;
+		const LogArgType* argTypes;
+		uint64_t cycles;
+	};
+
+	constexpr uint32_t RECORD_ALIGNMENT{ 8 };
+
+	// the writer wakes this often with nothing to do, and when a ring gets
+	// half full
+	constexpr uint32_t LOG_FLUSH_INTERVAL_MS{ 10 };
+
+	// the file sinks are written at least this often
+	constexpr uint32_t LOG_FILE_FLUSH_INTERVAL_MS{ 1000 };
+
+	// how often the writer logs what the rate limits suppressed
+	constexpr uint32_t LOG_LIMIT_REPORT_INTERVAL_MS{ 1000 };
+
+	// the line a site's suppressed calls are summed up in
+	constexpr const char* SUPPRESSED_FORMAT{ "repeated %u more times\n" };
+	constexpr LogArgType SUPPRESSED_ARG_TYPES[]{ LogArgType::uint64,
+												 LogArgType::count };
+
+	// direct writes before startup are cut off here
+	constexpr uint32_t DIRECT_LINE_SIZE{ 1024 };
+
+	// one per thread that logs. the thread only moves writeOffset and the
+	// writer thread only moves readOffset, both only grow and the ring
+	// holds what is between them. once its thread exits and the writer has
+	// read it to the end, the next thread to log takes it over
+	struct alignas(64) LogBuffer {
+		uint8_t* data;
+		uint32_t mask;
+		uint32_t isReleased;
+		uint64_t writeOffset;
+		uint64_t cachedReadOffset;
+		uint64_t droppedCount;
+		uint64_t blockedCount;
+
+		alignas(64) uint64_t readOffset;
+	};
+
+	// the binary log gives every distinct site, format and argument types
+	// an id the first time the writer sees them
+	struct SiteSlot {
+		const LogSite* pSite;
+		const char* format;
+		const LogArgType* argTypes;
+		uint32_t id;
+	};
+
+	// a token bucket per LOG_LIMITED site and key. it is kept as the time
+	// the bucket would be full again, which moves by limitInterval per
+	// call, and a call goes through while that is at most limitTolerance
+	// ahead of now
+	struct LimitSlot {
+		const LogSite* pSite;
+		uint64_t key;
+		uint64_t fullTime;
+		uint64_t suppressedCount;  // since the writer last reported it
+	};
+
+	struct SuppressedSite {
+		const LogSite* pSite;
+		uint64_t count;
+	};
+
+	// filled by the writer thread and handed to a sink in one go
+	struct LogBatch {
+		char* data;
+		uint32_t size;
+		uint32_t used;
+	};
+
+	struct Logger {
+		pstd::Arena arena;
+		LogBuffer* buffers;
+		uint32_t bufferCount;
+		uint32_t maxBufferCount;
+		uint32_t bufferSize;
+		LogOverflow overflow;
+		pstd::ThreadLocalKey threadKey;
+		pstd::Mutex registerMutex;
+		pstd::Signal wakeSignal;
+		pstd::ThreadHandle writerThread;
+		uint32_t isStarted;
+		uint32_t isRunning;
+
+		// only the writer thread touches these, past startup
+		bool isConsoleOn;
+		bool hasTextSinks;
+		LogBatch textBatch;	 // lines for the console, file and memory
+		pstd::Arena lineArena;
+		uint64_t writtenCount;
+		uint64_t reportedDropCount;
+		uint64_t fileFlushInterval;	 // in PTime ticks
+		uint64_t lastFileFlushTime;
+
+		// text file sink
+		pstd::FileHandle file;
+		LogBatch fileBatch;
+
+		// memory sink, copied out under memoryMutex
+		pstd::Mutex memoryMutex;
+		char* memory;
+		uint32_t memoryMask;
+		uint64_t memoryWritten;
+
+		// binary log sink
+		pstd::FileHandle binaryFile;
+		LogBatch binaryBatch;
+		SiteSlot* siteSlots;
+		uint32_t siteSlotMask;
+		uint32_t siteCount;
+		uint32_t maxSiteCount;
+		uint64_t lastCycles;
+
+		// records whose site got no id, past maxSiteCount
+		uint64_t unnamedDropCount;
+
+		// rate limits, under limitMutex
+		pstd::Mutex limitMutex;
+		LimitSlot* limitSlots;
+		uint32_t limitSlotMask;
+		uint32_t limitCount;
+		uint32_t maxLimitCount;
+		uint64_t limitInterval;	  // in PTime ticks
+		uint64_t limitTolerance;  // in PTime ticks
+		uint64_t suppressedCount;
+
+		// the writer copies out suppressed counts here before it logs them
+		SuppressedSite* suppressedSites;
+		uint64_t limitReportInterval;  // in PTime ticks
+		uint64_t lastLimitReportTime;
+
+		// log calls from threads past maxThreadCount
+		uint64_t unregisteredDropCount;
+	};
+
+	Logger g_Logger{};
+
+	// what a thread that got no buffer keeps, so it doesn't look again on
+	// every call
+	LogBuffer g_NoBuffer{};
+
+	// null for a thread that got no buffer
+	LogBuffer* getThreadBuffer();
+
+	// the thread local's exit function
+	void releaseThreadBuffer(void* pVal);
+
+	// strings are cut to maxStringSize
+	size_t calcPackedArgsSize(
+		const LogArgType* argTypes,
+		uint32_t argCount,
+		const LogArg* args,
+		uint32_t maxStringSize
+	);
+
+	void packArgs(
+		uint8_t* dst,
+		const LogArgType* argTypes,
+		uint32_t argCount,
+		const LogArg* args,
+		uint32_t maxStringSize
+	);
+
+	// strings point into the record
+	void unpackArgs(const LogRecord& record, LogArg* outArgs);
+
+	// space for a record of recordSize, after a wrap record when it doesn't
+	// fit before the end. a tail too short for a wrap record is left as it
+	// is, the reader skips any tail shorter than a record header. the
+	// outEndOffset is the write offset to commit
+	uint8_t* reserveRecord(
+		LogBuffer* pBuffer, uint32_t recordSize, uint64_t* outEndOffset
+	);
+
+	void commitRecord(LogBuffer* pBuffer, uint64_t endOffset);
+
+	void writeDirect(
+		const LogSite& site,
+		const char* format,
+		const LogArgType* argTypes,
+		const LogArg* args
+	);
+
+	LogBatch allocateBatch(uint32_t size);
+
+	// null after a warning on the console when it can't be created
+	pstd::FileHandle openSinkFile(const char* path);
+
+	bool startBinaryLog(const char* path);
+
+	uint32_t runLogWriter(void* pArg);
+
+	bool drainBuffers();
+
+	// false when it went to no sink
+	bool writeRecord(const LogRecord& record, const LogArg* args);
+
+	void writeTextRecord(const LogRecord& record, const LogArg* args);
+
+	// false when the record got no site id
+	bool writeBinaryRecord(const LogRecord& record, const LogArg* args);
+
+	// false once maxSiteCount sites have ids
+	bool findSiteId(const LogRecord& record, uint32_t* outId);
+
+	void reportDrops(uint64_t droppedCount);
+
+	// false when nothing was suppressed
+	bool reportSuppressed();
+
+	void appendClock();
+
+	void appendText(const pstd::String& text);
+
+	void flushText();
+
+	// to every text sink
+	void writeText(const pstd::String& text);
+
+	void writeMemory(const pstd::String& text);
+
+	void appendFile(const pstd::String& text);
+
+	// calls encode(dst, capacity) on the free end of the binary batch, and
+	// once more on an empty batch when it returns 0
+	template<typename F>
+	bool appendBinaryEntry(F encode);
+
+	void flushFile(pstd::FileHandle file, LogBatch* pBatch);
+
+	uint32_t alignRecordSize(size_t size) {
+		return ncast<uint32_t>(
+			(size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1)
+		);
+	}
 }  // namespace
 
-void Console::startup() {
-	g_LogArena = pstd::Arena{ .block = rcast<uint8_t*>(g_RawLogArray),
-							  .size = LOG_ARENA_SIZE };
+uint64_t Console::g_LogFilter{ ~0ull };
+
+void Console::startup(
+	pstd::AllocationRegistry* pAllocRegistry, const LogConfig& config
+) {
+	ASSERT(pAllocRegistry);
+	ASSERT(!pstd::atomicLoad(&g_Logger.isStarted));
+	ASSERT(pstd::calcNextPowerOfTwo(config.threadBufferSize) ==
+		   config.threadBufferSize);
+	ASSERT(config.threadBufferSize >= 4 * 1024);
+	ASSERT(config.maxThreadCount > 0);
+	// a record is at most half a ring and its line or binary entry is at
+	// most a little larger, so one always fits in an empty batch
+	ASSERT(config.batchSize >= config.threadBufferSize);
+	ASSERT((!config.filePath && !config.binaryPath) ||
+		   config.fileBatchSize >= config.threadBufferSize);
+	ASSERT(!config.binaryPath || config.maxSiteCount > 0);
+	ASSERT(config.maxLimitedCount > 0);
+	ASSERT(config.limitBurst > 0 && config.limitPerSecond > 0);
+	ASSERT(config.memorySize == 0 ||
+		   pstd::calcNextPowerOfTwo(config.memorySize) == config.memorySize);
+
+	for (uint32_t i{}; i < cast<uint32_t>(LogCategory::count); i++) {
+		auto category{ ncast<LogCategory>(i) };
+		setLogLevel(category, config.minLevels[category]);
+	}
+
+	uint32_t siteSlotCount{
+		config.binaryPath ? ncast<uint32_t>(pstd::calcNextPowerOfTwo(
+								config.maxSiteCount * 2ull
+							))
+						  : 0
+	};
+	auto limitSlotCount{ ncast<uint32_t>(
+		pstd::calcNextPowerOfTwo(config.maxLimitedCount * 2ull)
+	) };
+	size_t arenaSize{ config.maxThreadCount *
+						  (sizeof(LogBuffer) + config.threadBufferSize) +
+					  config.batchSize + config.threadBufferSize +
+					  config.memorySize + alignof(LogBuffer) +
+					  limitSlotCount * sizeof(LimitSlot) +
+					  config.maxLimitedCount * sizeof(SuppressedSite) +
+					  alignof(LimitSlot) + alignof(SuppressedSite) };
+	if (config.filePath) {
+		arenaSize += config.fileBatchSize;
+	}
+	if (config.binaryPath) {
+		arenaSize += config.fileBatchSize + siteSlotCount * sizeof(SiteSlot) +
+			alignof(SiteSlot);
+	}
+
+	uint64_t timeFrequency{ pstd::getTimeFrequency() };
+	uint64_t limitInterval{ timeFrequency / config.limitPerSecond };
+	g_Logger = Logger{
+		.arena = pstd::allocateArena(pAllocRegistry, arenaSize),
+		.maxBufferCount = config.maxThreadCount,
+		.bufferSize = config.threadBufferSize,
+		.overflow = config.overflow,
+		.threadKey = pstd::createThreadLocal(releaseThreadBuffer),
+		.wakeSignal = pstd::createSignal(),
+		.isConsoleOn = config.isConsoleOn,
+		.fileFlushInterval = timeFrequency * LOG_FILE_FLUSH_INTERVAL_MS / 1000,
+		.lastFileFlushTime = pstd::getTime(),
+		.maxSiteCount = config.maxSiteCount,
+		.limitSlotMask = limitSlotCount - 1,
+		.maxLimitCount = config.maxLimitedCount,
+		.limitInterval = limitInterval,
+		.limitTolerance = limitInterval * (config.limitBurst - 1),
+		.limitReportInterval =
+			timeFrequency * LOG_LIMIT_REPORT_INTERVAL_MS / 1000,
+		.lastLimitReportTime = pstd::getTime(),
+	};
+
+	g_Logger.buffers =
+		pstd::alloc<LogBuffer>(&g_Logger.arena, config.maxThreadCount);
+	for (uint32_t i{}; i < config.maxThreadCount; i++) {
+		g_Logger.buffers[i] = LogBuffer{
+			.data =
+				pstd::alloc<uint8_t>(&g_Logger.arena, config.threadBufferSize),
+			.mask = config.threadBufferSize - 1,
+		};
+	}
+	g_Logger.textBatch = allocateBatch(config.batchSize);
+	g_Logger.lineArena = pstd::Arena{
+		.block = pstd::alloc<char>(&g_Logger.arena, config.threadBufferSize),
+		.size = config.threadBufferSize,
+	};
+
+	g_Logger.limitSlots =
+		pstd::alloc<LimitSlot>(&g_Logger.arena, limitSlotCount);
+	g_Logger.suppressedSites =
+		pstd::alloc<SuppressedSite>(&g_Logger.arena, config.maxLimitedCount);
+
+	if (config.memorySize > 0) {
+		g_Logger.memory = pstd::alloc<char>(&g_Logger.arena, config.memorySize);
+		g_Logger.memoryMask = config.memorySize - 1;
+	}
+
+	if (config.filePath) {
+		g_Logger.fileBatch = allocateBatch(config.fileBatchSize);
+		g_Logger.file = openSinkFile(config.filePath);
+	}
+
+	if (config.binaryPath) {
+		g_Logger.binaryBatch = allocateBatch(config.fileBatchSize);
+		g_Logger.siteSlots =
+			pstd::alloc<SiteSlot>(&g_Logger.arena, siteSlotCount);
+		g_Logger.siteSlotMask = siteSlotCount - 1;
+		startBinaryLog(config.binaryPath);
+	}
+
+	// a file that couldn't be created doesn't leave the log nowhere to go
+	if (!g_Logger.file && !g_Logger.binaryFile && !g_Logger.memory) {
+		g_Logger.isConsoleOn = true;
+	}
+	g_Logger.hasTextSinks =
+		g_Logger.isConsoleOn || g_Logger.file || g_Logger.memory;
+
+	g_Logger.isRunning = true;
+	g_Logger.writerThread = pstd::createThread(runLogWriter, nullptr);
+	pstd::atomicStore(&g_Logger.isStarted, 1u);
 }
 
-pstd::Arena Console::getLogArena() {
-	if (g_LogArena.block == nullptr) {
-		Console::startup();
+void Console::shutdown(pstd::AllocationRegistry* pAllocRegistry) {
+	ASSERT(pAllocRegistry);
+	if (!pstd::atomicLoad(&g_Logger.isStarted)) {
+		return;
 	}
-	return g_LogArena;
+
+	// new log calls go straight to the console, the writer drains the rings
+	// one last time before it returns
+	pstd::atomicStore(&g_Logger.isStarted, 0u);
+	pstd::atomicStore(&g_Logger.isRunning, 0u);
+	pstd::raiseSignal(g_Logger.wakeSignal);
+	pstd::joinThread(g_Logger.writerThread);
+
+	if (g_Logger.file) {
+		pstd::closeFile(g_Logger.file);
+	}
+	if (g_Logger.binaryFile) {
+		pstd::closeFile(g_Logger.binaryFile);
+	}
+	pstd::destroySignal(g_Logger.wakeSignal);
+	pstd::destroyThreadLocal(g_Logger.threadKey);
+	pstd::freeArena(pAllocRegistry, &g_Logger.arena);
+	g_Logger = Logger{};
 }
 
-void Console::log(const Console::LogLevel logLevel, const pstd::String& msg) {
-	ASSERT(logLevel <= LogLevel::error);
-	if (g_LogArena.block == nullptr) {
-		Console::startup();
+Console::LogStats Console::getLogStats() {
+	LogStats stats{
+		.writtenCount = pstd::atomicLoad(&g_Logger.writtenCount),
+		.droppedCount = pstd::atomicLoad(&g_Logger.unregisteredDropCount) +
+			pstd::atomicLoad(&g_Logger.unnamedDropCount),
+		.suppressedCount = pstd::atomicLoad(&g_Logger.suppressedCount),
+	};
+
+	uint32_t bufferCount{ pstd::atomicLoad(&g_Logger.bufferCount) };
+	for (uint32_t i{}; i < bufferCount; i++) {
+		const LogBuffer& buffer{ g_Logger.buffers[i] };
+		stats.droppedCount += pstd::atomicLoad(&buffer.droppedCount);
+		stats.blockedCount += pstd::atomicLoad(&buffer.blockedCount);
 	}
 
-	pstd::reset(&g_LogArena);
+	return stats;
+}
 
-	pstd::String logLevelString{ pstd::createString(g_LogLevelStrings[logLevel]
-	) };
-	pstd::consoleWrite(logLevelString);
-	pstd::consoleWrite(msg);
+bool Console::checkLogRate(const LogSite& site, uint64_t key) {
+	if (!pstd::atomicLoad(&g_Logger.isStarted)) {
+		return true;
+	}
+
+	const void* hashKey[]{ &site, rcast<const void*>(key) };
+	uint64_t hash{ pstd::calcHash64(hashKey, sizeof(hashKey)) };
+	uint64_t time{ pstd::getTime() };
+
+	pstd::lockExclusive(&g_Logger.limitMutex);
+	uint32_t slotIndex{ ncast<uint32_t>(hash) & g_Logger.limitSlotMask };
+	LimitSlot* pSlot{ &g_Logger.limitSlots[slotIndex] };
+	while (pSlot->pSite && (pSlot->pSite != &site || pSlot->key != key)) {
+		slotIndex = (slotIndex + 1) & g_Logger.limitSlotMask;
+		pSlot = &g_Logger.limitSlots[slotIndex];
+	}
+
+	if (!pSlot->pSite) {
+		if (g_Logger.limitCount == g_Logger.maxLimitCount) {
+			pstd::unlockExclusive(&g_Logger.limitMutex);
+			return true;
+		}
+
+		*pSlot = LimitSlot{ .pSite = &site, .key = key, .fullTime = time };
+		g_Logger.limitCount++;
+	}
+
+	uint64_t fullTime{ max(pSlot->fullTime, time) };
+	bool isAllowed{ fullTime - time <= g_Logger.limitTolerance };
+	if (isAllowed) {
+		pSlot->fullTime = fullTime + g_Logger.limitInterval;
+	} else {
+		pSlot->suppressedCount++;
+		pstd::atomicStore(
+			&g_Logger.suppressedCount, g_Logger.suppressedCount + 1
+		);
+	}
+	pstd::unlockExclusive(&g_Logger.limitMutex);
+
+	return isAllowed;
+}
+
+pstd::String Console::copyLogMemory(pstd::Arena* pArena) {
+	ASSERT(pArena);
+	if (!pstd::atomicLoad(&g_Logger.isStarted) || !g_Logger.memory) {
+		return pstd::String{};
+	}
+
+	pstd::lockExclusive(&g_Logger.memoryMutex);
+	uint32_t capacity{ g_Logger.memoryMask + 1 };
+	uint64_t written{ g_Logger.memoryWritten };
+	auto size{ ncast<uint32_t>(min(written, capacity)) };
+	uint32_t start{ ncast<uint32_t>(written - size) & g_Logger.memoryMask };
+	uint32_t firstSize{ min(size, capacity - start) };
+
+	char* buffer{ pstd::alloc<char>(pArena, size) };
+	pstd::memCpy(buffer, g_Logger.memory + start, firstSize);
+	pstd::memCpy(buffer + firstSize, g_Logger.memory, size - firstSize);
+	pstd::unlockExclusive(&g_Logger.memoryMutex);
+
+	pstd::String text{ .buffer = buffer, .size = size };
+
+	// once the ring has wrapped its oldest line is cut off
+	uint32_t newlineIndex{};
+	if (written > capacity &&
+		pstd::findAnyOf(text, pstd::createString("\n"), &newlineIndex)) {
+		text.buffer += newlineIndex + 1;
+		text.size -= newlineIndex + 1;
+	}
+
+	return text;
+}
+
+void Console::setLogLevel(LogCategory category, LogLevel minLevel) {
+	ASSERT(category < LogCategory::count);
+	ASSERT(minLevel < LogLevel::count);
+
+	uint64_t categoryBits{};
+	uint64_t enabledBits{};
+	for (uint32_t i{}; i < cast<uint32_t>(LogLevel::count); i++) {
+		auto level{ ncast<LogLevel>(i) };
+		uint64_t bit{ getLogFilterBit(category, level) };
+		categoryBits |= bit;
+		if (level >= minLevel) {
+			enabledBits |= bit;
+		}
+	}
+
+	uint64_t filter{ pstd::atomicLoad(&g_LogFilter) };
+	while (!pstd::atomicCompareExchange(
+		&g_LogFilter, &filter, (filter & ~categoryBits) | enabledBits
+	)) {
+	}
+}
+
+void Console::logRecord(
+	const LogSite& site,
+	const char* format,
+	const LogArgType* argTypes,
+	uint32_t argCount,
+	const LogArg* args
+) {
+	ASSERT(site.level < LogLevel::count);
+	ASSERT(format);
+	ASSERT(argCount <= MAX_LOG_ARGS);
+
+	uint64_t cycles{ pstd::readCycleCounter() };
+	FlightRecorder::recordLog(site, format, argTypes, argCount, args, cycles);
+
+	if (!pstd::atomicLoad(&g_Logger.isStarted)) {
+		writeDirect(site, format, argTypes, args);
+		return;
+	}
+
+	LogBuffer* pBuffer{ getThreadBuffer() };
+	if (!pBuffer) {
+		return;
+	}
+
+	// a record takes at most half the ring, long strings are cut off and
+	// share what the numbers leave
+	size_t maxArgsSize{ g_Logger.bufferSize / 2 - sizeof(LogRecord) };
+	uint32_t maxStringSize{ UINT32_MAX };
+	size_t argsSize{
+		calcPackedArgsSize(argTypes, argCount, args, maxStringSize)
+	};
+	if (argsSize > maxArgsSize) {
+		uint32_t stringCount{};
+		for (uint32_t i{}; i < argCount; i++) {
+			stringCount += argTypes[i] == LogArgType::string;
+		}
+		ASSERT(stringCount > 0);
+
+		size_t fixedSize{ calcPackedArgsSize(argTypes, argCount, args, 0) };
+		maxStringSize =
+			ncast<uint32_t>((maxArgsSize - fixedSize) / stringCount);
+		argsSize = calcPackedArgsSize(argTypes, argCount, args, maxStringSize);
+	}
 
-	pstd::reset(&g_LogArena);
+	uint32_t recordSize{ alignRecordSize(sizeof(LogRecord) + argsSize) };
+	uint64_t endOffset{};
+	uint8_t* pRecordMemory{ reserveRecord(pBuffer, recordSize, &endOffset) };
+	if (!pRecordMemory) {
+		return;
+	}
+
+	auto* pRecord{ rcast<LogRecord*>(pRecordMemory) };
+	*pRecord = LogRecord{
+		.size = recordSize,
+		.argCount = argCount,
+		.pSite = &site,
+		.format = format,
+		.argTypes = argTypes,
+		.cycles = cycles,
+	};
+	packArgs(
+		rcast<uint8_t*>(pRecord + 1), argTypes, argCount, args, maxStringSize
+	);
+
+	commitRecord(pBuffer, endOffset);
 }
+
+namespace {
+	LogBuffer* getThreadBuffer() {
+		auto* pBuffer{
+			rcast<LogBuffer*>(pstd::getThreadLocal(g_Logger.threadKey))
+		};
+		if (pBuffer == &g_NoBuffer) {
+			pstd::atomicAdd(&g_Logger.unregisteredDropCount, 1);
+			return nullptr;
+		}
+		if (pBuffer) {
+			return pBuffer;
+		}
+
+		// a released buffer the writer has read to the end comes first, then
+		// a new one, then one the writer still has records to read from
+		pstd::lockExclusive(&g_Logger.registerMutex);
+		LogBuffer* pUndrained{};
+		for (uint32_t i{}; i < g_Logger.bufferCount && !pBuffer; i++) {
+			LogBuffer* pReleased{ &g_Logger.buffers[i] };
+			if (!pstd::atomicLoad(&pReleased->isReleased)) {
+				continue;
+			}
+
+			if (pstd::atomicLoad(&pReleased->readOffset) ==
+				pReleased->writeOffset) {
+				pBuffer = pReleased;
+			} else if (!pUndrained) {
+				pUndrained = pReleased;
+			}
+		}
+
+		uint32_t bufferIndex{ g_Logger.bufferCount };
+		if (!pBuffer && bufferIndex < g_Logger.maxBufferCount) {
+			pBuffer = &g_Logger.buffers[bufferIndex];
+			pstd::atomicStore(&g_Logger.bufferCount, bufferIndex + 1);
+		} else if (!pBuffer) {
+			pBuffer = pUndrained;
+		}
+		if (pBuffer) {
+			pstd::atomicStore(&pBuffer->isReleased, 0u);
+		}
+		pstd::unlockExclusive(&g_Logger.registerMutex);
+
+		// the exited thread's records are all read before this one adds any
+		while (pBuffer &&
+			   pstd::atomicLoad(&pBuffer->readOffset) != pBuffer->writeOffset) {
+			pstd::raiseSignal(g_Logger.wakeSignal);
+			pstd::yieldThread();
+		}
+
+		if (!pBuffer) {
+			pstd::setThreadLocal(g_Logger.threadKey, &g_NoBuffer);
+			pstd::atomicAdd(&g_Logger.unregisteredDropCount, 1);
+			return nullptr;
+		}
+
+		pstd::setThreadLocal(g_Logger.threadKey, pBuffer);
+		return pBuffer;
+	}
+
+	void releaseThreadBuffer(void* pVal) {
+		auto* pBuffer{ rcast<LogBuffer*>(pVal) };
+		if (pBuffer != &g_NoBuffer) {
+			pstd::atomicStore(&pBuffer->isReleased, 1u);
+		}
+	}
+
+	size_t calcPackedArgsSize(
+		const LogArgType* argTypes,
+		uint32_t argCount,
+		const LogArg* args,
+		uint32_t maxStringSize
+	) {
+		size_t size{};
+		for (uint32_t i{}; i < argCount; i++) {
+			if (argTypes[i] == LogArgType::float32) {
+				size += sizeof(float);
+			} else if (argTypes[i] == LogArgType::string) {
+				size += sizeof(uint32_t) +
+					min(args[i].string.size, maxStringSize);
+			} else {
+				size += sizeof(uint64_t);
+			}
+		}
+
+		return size;
+	}
+
+	void packArgs(
+		uint8_t* dst,
+		const LogArgType* argTypes,
+		uint32_t argCount,
+		const LogArg* args,
+		uint32_t maxStringSize
+	) {
+		for (uint32_t i{}; i < argCount; i++) {
+			if (argTypes[i] == LogArgType::float32) {
+				pstd::storeUInt32(dst, pstd::loadUInt32(&args[i]));
+				dst += sizeof(float);
+			} else if (argTypes[i] == LogArgType::string) {
+				const pstd::String& string{ args[i].string };
+				uint32_t size{ min(string.size, maxStringSize) };
+				pstd::storeUInt32(dst, size);
+				pstd::memCpy(dst + sizeof(uint32_t), string.buffer, size);
+				dst += sizeof(uint32_t) + size;
+			} else {
+				pstd::storeUInt64(dst, pstd::loadUInt64(&args[i]));
+				dst += sizeof(uint64_t);
+			}
+		}
+	}
+
+	void unpackArgs(const LogRecord& record, LogArg* outArgs) {
+		auto* src{ rcast<const uint8_t*>(&record + 1) };
+		for (uint32_t i{}; i < record.argCount; i++) {
+			if (record.argTypes[i] == LogArgType::float32) {
+				pstd::storeUInt32(&outArgs[i], pstd::loadUInt32(src));
+				src += sizeof(float);
+			} else if (record.argTypes[i] == LogArgType::string) {
+				outArgs[i].string = pstd::String{
+					.buffer = rcast<const char*>(src + sizeof(uint32_t)),
+					.size = pstd::loadUInt32(src),
+				};
+				src += sizeof(uint32_t) + outArgs[i].string.size;
+			} else {
+				pstd::storeUInt64(&outArgs[i], pstd::loadUInt64(src));
+				src += sizeof(uint64_t);
+			}
+		}
+	}
+
+	uint8_t* reserveRecord(
+		LogBuffer* pBuffer, uint32_t recordSize, uint64_t* outEndOffset
+	) {
+		uint32_t capacity{ pBuffer->mask + 1 };
+		uint64_t writeOffset{ pBuffer->writeOffset };
+		uint32_t position{ ncast<uint32_t>(writeOffset) & pBuffer->mask };
+		uint32_t sizeToEnd{ capacity - position };
+		uint32_t neededSize{
+			recordSize <= sizeToEnd ? recordSize : sizeToEnd + recordSize
+		};
+		uint64_t endOffset{ writeOffset + neededSize };
+
+		// the read offset is only loaded again when the cached one says the
+		// ring is full, most calls don't touch the writer's cache line
+		if (endOffset - pBuffer->cachedReadOffset > capacity) {
+			pBuffer->cachedReadOffset = pstd::atomicLoad(&pBuffer->readOffset);
+		}
+
+		if (endOffset - pBuffer->cachedReadOffset > capacity) {
+			if (g_Logger.overflow == LogOverflow::drop) {
+				pstd::atomicStore(
+					&pBuffer->droppedCount, pBuffer->droppedCount + 1
+				);
+				return nullptr;
+			}
+
+			pstd::atomicStore(
+				&pBuffer->blockedCount, pBuffer->blockedCount + 1
+			);
+			do {
+				pstd::raiseSignal(g_Logger.wakeSignal);
+				pstd::yieldThread();
+				pBuffer->cachedReadOffset =
+					pstd::atomicLoad(&pBuffer->readOffset);
+			} while (endOffset - pBuffer->cachedReadOffset > capacity);
+		}
+
+		if (recordSize > sizeToEnd) {
+			if (sizeToEnd >= sizeof(LogRecord)) {
+				auto* pWrap{ rcast<LogRecord*>(pBuffer->data + position) };
+				pWrap->size = sizeToEnd;
+				pWrap->pSite = nullptr;
+			}
+			position = 0;
+		}
+
+		*outEndOffset = endOffset;
+		return pBuffer->data + position;
+	}
+
+	void commitRecord(LogBuffer* pBuffer, uint64_t endOffset) {
+		uint64_t halfCapacity{ (pBuffer->mask + 1ull) / 2 };
+		uint64_t usedBefore{ pBuffer->writeOffset - pBuffer->cachedReadOffset };
+
+		pstd::atomicStore(&pBuffer->writeOffset, endOffset);
+
+		// only the record that crosses half full wakes the writer early
+		if (usedBefore <= halfCapacity &&
+			endOffset - pBuffer->cachedReadOffset > halfCapacity) {
+			pstd::raiseSignal(g_Logger.wakeSignal);
+		}
+	}
+
+	void writeDirect(
+		const LogSite& site,
+		const char* format,
+		const LogArgType* argTypes,
+		const LogArg* args
+	) {
+		char line[DIRECT_LINE_SIZE];
+		pstd::Arena lineArena{ .block = line, .size = DIRECT_LINE_SIZE };
+		pstd::StringBuilder builder{ pstd::createStringBuilder(&lineArena) };
+
+		Console::appendLogLine(
+			&builder,
+			site.level,
+			pstd::createString(site.file),
+			site.line,
+			pstd::createString(format),
+			argTypes,
+			args
+		);
+
+		pstd::consoleWrite(pstd::finishString(&builder));
+	}
+
+	LogBatch allocateBatch(uint32_t size) {
+		return LogBatch{
+			.data = pstd::alloc<char>(&g_Logger.arena, size),
+			.size = size,
+		};
+	}
+
+	pstd::FileHandle openSinkFile(const char* path) {
+		pstd::FileHandle file{ pstd::openFile(
+			path,
+			pstd::FileAccess::write,
+			pstd::FileShare::read,
+			pstd::FileCreate::createAlways
+		) };
+		if (!file) {
+			// the logger isn't started yet, this goes to the console
+			Console::log(
+				Console::LEVEL_LOG_SITES[LogLevel::warn],
+				"couldn't create %m, not logging to it\n",
+				path
+			);
+		}
+
+		return file;
+	}
+
+	bool startBinaryLog(const char* path) {
+		g_Logger.binaryFile = openSinkFile(path);
+		if (!g_Logger.binaryFile) {
+			return false;
+		}
+
+		Console::LogFileHeader header{
+			.magic = Console::LOG_FILE_MAGIC,
+			.version = Console::LOG_FILE_VERSION,
+			.timeFrequency = pstd::getTimeFrequency(),
+			.maxSiteCount = g_Logger.maxSiteCount,
+		};
+		appendBinaryEntry([&](uint8_t* dst, uint32_t capacity) {
+			return Console::encodeLogFileHeader(dst, capacity, header);
+		});
+		appendClock();
+
+		return true;
+	}
+
+	uint32_t runLogWriter(void* pArg) {
+		while (true) {
+			// read before draining, so the last pass sees everything logged
+			// before shutdown
+			bool isRunning{ pstd::atomicLoad(&g_Logger.isRunning) != 0 };
+			bool hasDrained{ drainBuffers() };
+
+			uint64_t time{ pstd::getTime() };
+			if (time - g_Logger.lastLimitReportTime >=
+					g_Logger.limitReportInterval ||
+				!isRunning) {
+				hasDrained |= reportSuppressed();
+				g_Logger.lastLimitReportTime = time;
+			}
+
+			// every batch of records ends on a clock, so the decoder can
+			// time records up to the last one written
+			if (g_Logger.binaryFile && (hasDrained || !isRunning)) {
+				appendClock();
+			}
+			flushText();
+
+			if (time - g_Logger.lastFileFlushTime >=
+					g_Logger.fileFlushInterval ||
+				!isRunning) {
+				flushFile(g_Logger.file, &g_Logger.fileBatch);
+				flushFile(g_Logger.binaryFile, &g_Logger.binaryBatch);
+				g_Logger.lastFileFlushTime = time;
+			}
+
+			if (!isRunning) {
+				break;
+			}
+			if (!hasDrained) {
+				pstd::waitSignal(g_Logger.wakeSignal, LOG_FLUSH_INTERVAL_MS);
+			}
+		}
+
+		return 0;
+	}
+
+	bool drainBuffers() {
+		bool hasDrained{};
+		uint64_t droppedCount{
+			pstd::atomicLoad(&g_Logger.unregisteredDropCount)
+		};
+
+		uint32_t bufferCount{ pstd::atomicLoad(&g_Logger.bufferCount) };
+		for (uint32_t i{}; i < bufferCount; i++) {
+			LogBuffer* pBuffer{ &g_Logger.buffers[i] };
+			uint64_t readOffset{ pBuffer->readOffset };
+			uint64_t writeOffset{ pstd::atomicLoad(&pBuffer->writeOffset) };
+			hasDrained |= readOffset != writeOffset;
+
+			while (readOffset != writeOffset) {
+				uint32_t position{ ncast<uint32_t>(readOffset) &
+								   pBuffer->mask };
+				uint32_t sizeToEnd{ pBuffer->mask + 1 - position };
+				if (sizeToEnd < sizeof(LogRecord)) {
+					readOffset += sizeToEnd;
+					continue;
+				}
+
+				auto* pRecord{
+					rcast<const LogRecord*>(pBuffer->data + position)
+				};
+				readOffset += pRecord->size;
+				if (!pRecord->pSite) {
+					continue;
+				}
+
+				LogArg args[Console::MAX_LOG_ARGS];
+				unpackArgs(*pRecord, args);
+				if (writeRecord(*pRecord, args)) {
+					pstd::atomicStore(
+						&g_Logger.writtenCount, g_Logger.writtenCount + 1
+					);
+				}
+			}
+
+			// the batch holds copies, the space can go back right away
+			pstd::atomicStore(&pBuffer->readOffset, readOffset);
+			droppedCount += pstd::atomicLoad(&pBuffer->droppedCount);
+		}
+
+		droppedCount += g_Logger.unnamedDropCount;
+		if (droppedCount != g_Logger.reportedDropCount) {
+			reportDrops(droppedCount - g_Logger.reportedDropCount);
+			g_Logger.reportedDropCount = droppedCount;
+		}
+
+		return hasDrained;
+	}
+
+	bool writeRecord(const LogRecord& record, const LogArg* args) {
+		bool isWritten{ g_Logger.hasTextSinks };
+		if (g_Logger.hasTextSinks) {
+			writeTextRecord(record, args);
+		}
+		if (g_Logger.binaryFile) {
+			isWritten |= writeBinaryRecord(record, args);
+		}
+
+		return isWritten;
+	}
+
+	void writeTextRecord(const LogRecord& record, const LogArg* args) {
+		// a copy, so every line starts at the front of the arena
+		pstd::Arena lineArena{ g_Logger.lineArena };
+		pstd::StringBuilder builder{ pstd::createStringBuilder(&lineArena) };
+
+		const LogSite& site{ *record.pSite };
+		Console::appendLogLine(
+			&builder,
+			site.level,
+			pstd::createString(site.file),
+			site.line,
+			pstd::createString(record.format),
+			record.argTypes,
+			args
+		);
+		appendText(pstd::finishString(&builder));
+	}
+
+	bool writeBinaryRecord(const LogRecord& record, const LogArg* args) {
+		uint32_t siteId{};
+		if (!findSiteId(record, &siteId)) {
+			pstd::atomicStore(
+				&g_Logger.unnamedDropCount, g_Logger.unnamedDropCount + 1
+			);
+			return false;
+		}
+
+		auto cycleDelta{ ncast<int64_t>(record.cycles - g_Logger.lastCycles) };
+		bool isWritten{ appendBinaryEntry([&](uint8_t* dst, uint32_t capacity) {
+			return Console::encodeLogRecord(
+				dst,
+				capacity,
+				siteId,
+				cycleDelta,
+				record.argTypes,
+				record.argCount,
+				args
+			);
+		}) };
+		ASSERT(isWritten);
+
+		g_Logger.lastCycles = record.cycles;
+		return true;
+	}
+
+	bool findSiteId(const LogRecord& record, uint32_t* outId) {
+		const void* key[]{ record.pSite, record.format, record.argTypes };
+		uint64_t hash{ pstd::calcHash64(key, sizeof(key)) };
+
+		uint32_t slotIndex{ ncast<uint32_t>(hash) & g_Logger.siteSlotMask };
+		while (g_Logger.siteSlots[slotIndex].pSite) {
+			const SiteSlot& slot{ g_Logger.siteSlots[slotIndex] };
+			if (slot.pSite == record.pSite && slot.format == record.format &&
+				slot.argTypes == record.argTypes) {
+				*outId = slot.id;
+				return true;
+			}
+			slotIndex = (slotIndex + 1) & g_Logger.siteSlotMask;
+		}
+
+		if (g_Logger.siteCount == g_Logger.maxSiteCount) {
+			return false;
+		}
+
+		// the site goes in front of its first record
+		uint32_t id{ g_Logger.siteCount };
+		bool isWritten{ appendBinaryEntry([&](uint8_t* dst, uint32_t capacity) {
+			return Console::encodeLogSite(
+				dst,
+				capacity,
+				id,
+				*record.pSite,
+				record.format,
+				record.argTypes,
+				record.argCount
+			);
+		}) };
+		if (!isWritten) {
+			return false;
+		}
+
+		g_Logger.siteSlots[slotIndex] = SiteSlot{
+			.pSite = record.pSite,
+			.format = record.format,
+			.argTypes = record.argTypes,
+			.id = id,
+		};
+		g_Logger.siteCount++;
+
+		*outId = id;
+		return true;
+	}
+
+	void reportDrops(uint64_t droppedCount) {
+		if (g_Logger.binaryFile) {
+			appendBinaryEntry([&](uint8_t* dst, uint32_t capacity) {
+				return Console::encodeLogDropped(dst, capacity, droppedCount);
+			});
+		}
+		if (!g_Logger.hasTextSinks) {
+			return;
+		}
+
+		constexpr LogArgType argTypes[]{ LogArgType::uint64 };
+		LogArg args[1];
+		args[0].uintVal = droppedCount;
+
+		pstd::Arena lineArena{ g_Logger.lineArena };
+		pstd::StringBuilder builder{ pstd::createStringBuilder(&lineArena) };
+		Console::appendLogLine(
+			&builder,
+			LogLevel::warn,
+			pstd::String{},
+			0,
+			pstd::createString("%u log records dropped\n"),
+			argTypes,
+			args
+		);
+		appendText(pstd::finishString(&builder));
+	}
+
+	bool reportSuppressed() {
+		// copied out first, so log calls only wait on the copy
+		uint32_t suppressedSiteCount{};
+		pstd::lockExclusive(&g_Logger.limitMutex);
+		for (uint32_t i{}; i <= g_Logger.limitSlotMask; i++) {
+			LimitSlot* pSlot{ &g_Logger.limitSlots[i] };
+			if (pSlot->suppressedCount == 0) {
+				continue;
+			}
+
+			g_Logger.suppressedSites[suppressedSiteCount++] = SuppressedSite{
+				.pSite = pSlot->pSite,
+				.count = pSlot->suppressedCount,
+			};
+			pSlot->suppressedCount = 0;
+		}
+		pstd::unlockExclusive(&g_Logger.limitMutex);
+
+		for (uint32_t i{}; i < suppressedSiteCount; i++) {
+			const SuppressedSite& suppressedSite{ g_Logger.suppressedSites[i] };
+			LogRecord record{
+				.argCount = 1,
+				.pSite = suppressedSite.pSite,
+				.format = SUPPRESSED_FORMAT,
+				.argTypes = SUPPRESSED_ARG_TYPES,
+				.cycles = pstd::readCycleCounter(),
+			};
+			LogArg args[1];
+			args[0].uintVal = suppressedSite.count;
+
+			writeRecord(record, args);
+		}
+
+		return suppressedSiteCount > 0;
+	}
+
+	void appendClock() {
+		uint64_t cycles{ pstd::readCycleCounter() };
+		uint64_t time{ pstd::getTime() };
+
+		appendBinaryEntry([&](uint8_t* dst, uint32_t capacity) {
+			return Console::encodeLogClock(dst, capacity, cycles, time);
+		});
+	}
+
+	void appendText(const pstd::String& text) {
+		LogBatch* pBatch{ &g_Logger.textBatch };
+		if (pBatch->used + text.size > pBatch->size) {
+			flushText();
+		}
+
+		if (text.size > pBatch->size) {
+			writeText(text);
+			return;
+		}
+
+		pstd::memCpy(pBatch->data + pBatch->used, text.buffer, text.size);
+		pBatch->used += text.size;
+	}
+
+	void flushText() {
+		LogBatch* pBatch{ &g_Logger.textBatch };
+		if (pBatch->used == 0) {
+			return;
+		}
+
+		writeText(pstd::String{ .buffer = pBatch->data, .size = pBatch->used }
+		);
+		pBatch->used = 0;
+	}
+
+	void writeText(const pstd::String& text) {
+		if (g_Logger.isConsoleOn) {
+			pstd::consoleWrite(text);
+		}
+		if (g_Logger.memory) {
+			writeMemory(text);
+		}
+		if (g_Logger.file) {
+			appendFile(text);
+		}
+	}
+
+	void writeMemory(const pstd::String& text) {
+		// only the tail of text that is larger than the ring is kept
+		uint32_t capacity{ g_Logger.memoryMask + 1 };
+		uint32_t size{ min(text.size, capacity) };
+		const char* src{ text.buffer + text.size - size };
+
+		pstd::lockExclusive(&g_Logger.memoryMutex);
+		uint32_t start{ ncast<uint32_t>(
+							g_Logger.memoryWritten + text.size - size
+						) &
+						g_Logger.memoryMask };
+		uint32_t firstSize{ min(size, capacity - start) };
+		pstd::memCpy(g_Logger.memory + start, src, firstSize);
+		pstd::memCpy(g_Logger.memory, src + firstSize, size - firstSize);
+		g_Logger.memoryWritten += text.size;
+		pstd::unlockExclusive(&g_Logger.memoryMutex);
+	}
+
+	void appendFile(const pstd::String& text) {
+		LogBatch* pBatch{ &g_Logger.fileBatch };
+		if (pBatch->used + text.size > pBatch->size) {
+			flushFile(g_Logger.file, pBatch);
+		}
+
+		if (text.size > pBatch->size) {
+			pstd::writeFile(g_Logger.file, text.buffer, text.size);
+			return;
+		}
+
+		pstd::memCpy(pBatch->data + pBatch->used, text.buffer, text.size);
+		pBatch->used += text.size;
+	}
+
+	template<typename F>
+	bool appendBinaryEntry(F encode) {
+		LogBatch* pBatch{ &g_Logger.binaryBatch };
+		for (uint32_t attempt{}; attempt < 2; attempt++) {
+			uint32_t size{ encode(
+				rcast<uint8_t*>(pBatch->data + pBatch->used),
+				pBatch->size - pBatch->used
+			) };
+			if (size > 0) {
+				pBatch->used += size;
+				return true;
+			}
+
+			flushFile(g_Logger.binaryFile, pBatch);
+		}
+
+		return false;
+	}
+
+	void flushFile(pstd::FileHandle file, LogBatch* pBatch) {
+		if (!file || pBatch->used == 0) {
+			return;
+		}
+
+		pstd::writeFile(file, pBatch->data, pBatch->used);
+		pBatch->used = 0;
+	}
+}  // namespace
@@ -1,5 +1,16 @@
 #pragma once
+#include "Logging.h"
+#include "Core/PMemory.h"
 
 namespace Console {
-	void startup();
-}
+	// starts the writer thread, log calls from then on only copy into
+	// their thread's ring
+	void startup(
+		pstd::AllocationRegistry* pAllocRegistry,
+		const LogConfig& config = DEFAULT_LOG_CONFIG
+	);
+
+	// writes out what is still in the rings and stops the writer thread.
+	// threads that log must be done before this
+	void shutdown(pstd::AllocationRegistry* pAllocRegistry);
+}  // namespace Console
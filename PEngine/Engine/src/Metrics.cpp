@@ -0,0 +1,533 @@
+#include "Metrics.h"
+
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PAtomic.h"
+#include "Core/PThread.h"
+#include "Core/PTime.h"
+#include "Core/PFileIO.h"
+#include "Core/PHistogram.h"
+#include "Core/PMemory.h"
+#include "Core/PString.h"
+#include "Core/PAlgorithm.h"
+#include "Core/PAssert.h"
+
+using Metrics::CounterId;
+using Metrics::GaugeId;
+using Metrics::HistogramId;
+using Metrics::MAX_METRIC_NAME_SIZE;
+using Metrics::MetricKind;
+using Metrics::SnapshotHeader;
+using Metrics::SnapshotMetric;
+
+namespace {
+	constexpr uint32_t CACHE_LINE_SIZE{ 64 };
+
+	constexpr uint32_t KIND_COUNT{ cast<uint32_t>(MetricKind::count) };
+
+	struct MetricName {
+		char text[MAX_METRIC_NAME_SIZE + 1];
+	};
+
+	// only the thread writes its shard. each block starts on a cache line
+	// and the next thread's starts on a later one. once the thread exits
+	// the shard is released and the next thread to register adds to its
+	// totals
+	struct ThreadShard {
+		uint64_t* counters;
+		pstd::Histogram* histograms;
+		uint32_t isReleased;
+	};
+
+	struct alignas(CACHE_LINE_SIZE) Gauge {
+		uint64_t value;
+	};
+
+	// mutex guards the names and thread count, registering takes it
+	// exclusive and publishing shared. mergedHistogram is the publisher's
+	struct MetricsState {
+		pstd::Arena arena;
+		pstd::ThreadLocalKey threadKey;
+		pstd::Mutex mutex;
+
+		MetricName* names[KIND_COUNT];
+		uint32_t nameCounts[KIND_COUNT];
+		uint32_t maxNameCounts[KIND_COUNT];
+
+		ThreadShard* shards;
+		uint32_t threadCount;
+		uint32_t maxThreadCount;
+		uint64_t droppedCount;
+		Gauge* gauges;
+
+		pstd::MappedFile snapshotFile;
+		pstd::Histogram* mergedHistogram;
+		pstd::Signal stopSignal;
+		pstd::ThreadHandle publisherThread;
+		uint32_t publishIntervalMs;
+		uint32_t isStarted;
+	};
+
+	MetricsState g_Metrics{};
+
+	// threads past maxThreadCount keep this one, so they don't look for a
+	// shard again on every bump
+	ThreadShard g_NoShard{};
+
+	// 0 when the kind's table is full
+	uint32_t registerMetric(MetricKind kind, const char* name);
+
+	// null before startup, and for a thread that got no shard, which
+	// counts the bump as dropped
+	ThreadShard* getThreadShard();
+	ThreadShard* registerThread();
+
+	// the thread local's exit function
+	void releaseThreadShard(void* pVal);
+
+	uint32_t runPublisher(void* pArg);
+
+	void publishSnapshot();
+
+	size_t calcSnapshotSize(uint32_t maxMetricCount);
+
+	size_t roundUpToCacheLine(size_t size);
+}  // namespace
+
+bool Metrics::startup(
+	pstd::AllocationRegistry* pAllocRegistry, const Config& config
+) {
+	ASSERT(pAllocRegistry);
+	ASSERT(!pstd::atomicLoad(&g_Metrics.isStarted));
+	ASSERT(config.maxCounterCount > 0);
+	ASSERT(config.maxThreadCount > 0);
+	ASSERT(!config.path || config.publishIntervalMs > 0);
+
+	size_t counterBlockSize{
+		roundUpToCacheLine(config.maxCounterCount * sizeof(uint64_t))
+	};
+	size_t histogramBlockSize{ roundUpToCacheLine(
+		config.maxHistogramCount * sizeof(pstd::Histogram)
+	) };
+	size_t shardsSize{ config.maxThreadCount *
+					   (counterBlockSize + histogramBlockSize) };
+	uint32_t maxMetricCount{ config.maxCounterCount + config.maxGaugeCount +
+							 config.maxHistogramCount };
+
+	g_Metrics = MetricsState{
+		.arena = pstd::allocateArena(
+			pAllocRegistry,
+			maxMetricCount * sizeof(MetricName) +
+				config.maxThreadCount * sizeof(ThreadShard) + shardsSize +
+				config.maxGaugeCount * sizeof(Gauge) +
+				sizeof(pstd::Histogram) + 8 * CACHE_LINE_SIZE
+		),
+		.threadKey = pstd::createThreadLocal(releaseThreadShard),
+		.maxNameCounts{
+			config.maxCounterCount,
+			config.maxGaugeCount,
+			config.maxHistogramCount,
+		},
+		.maxThreadCount = config.maxThreadCount,
+		.publishIntervalMs = config.publishIntervalMs,
+	};
+
+	for (uint32_t i{}; i < KIND_COUNT; i++) {
+		if (g_Metrics.maxNameCounts[i] > 0) {
+			g_Metrics.names[i] = pstd::alloc<MetricName>(
+				&g_Metrics.arena, g_Metrics.maxNameCounts[i]
+			);
+		}
+	}
+
+	g_Metrics.shards =
+		pstd::alloc<ThreadShard>(&g_Metrics.arena, config.maxThreadCount);
+	auto* shardBlocks{ rcast<uint8_t*>(
+		pstd::alloc(&g_Metrics.arena, shardsSize, CACHE_LINE_SIZE)
+	) };
+	pstd::memZero(shardBlocks, shardsSize);
+	for (uint32_t i{}; i < config.maxThreadCount; i++) {
+		g_Metrics.shards[i] = ThreadShard{
+			.counters = rcast<uint64_t*>(shardBlocks),
+			.histograms =
+				rcast<pstd::Histogram*>(shardBlocks + counterBlockSize),
+		};
+		shardBlocks += counterBlockSize + histogramBlockSize;
+	}
+
+	if (config.maxGaugeCount > 0) {
+		g_Metrics.gauges =
+			pstd::alloc<Gauge>(&g_Metrics.arena, config.maxGaugeCount);
+		pstd::memZero(
+			g_Metrics.gauges, config.maxGaugeCount * sizeof(Gauge)
+		);
+	}
+
+	bool isPublishing{};
+	if (config.path) {
+		g_Metrics.snapshotFile = pstd::createMappedFile(
+			config.path, calcSnapshotSize(maxMetricCount)
+		);
+		isPublishing = g_Metrics.snapshotFile.data != nullptr;
+	}
+	if (isPublishing) {
+		// the file starts zeroed, which is an empty snapshot
+		*rcast<SnapshotHeader*>(g_Metrics.snapshotFile.data) = SnapshotHeader{
+			.magic = METRICS_FILE_MAGIC,
+			.version = METRICS_FILE_VERSION,
+			.timeFrequency = pstd::getTimeFrequency(),
+			.maxMetricCount = maxMetricCount,
+		};
+		g_Metrics.mergedHistogram = pstd::alloc<pstd::Histogram>(
+			&g_Metrics.arena
+		);
+		g_Metrics.stopSignal = pstd::createSignal();
+	}
+
+	pstd::atomicStore(&g_Metrics.isStarted, 1u);
+	if (isPublishing) {
+		g_Metrics.publisherThread = pstd::createThread(runPublisher, nullptr);
+	}
+
+	return isPublishing || !config.path;
+}
+
+void Metrics::shutdown(pstd::AllocationRegistry* pAllocRegistry) {
+	ASSERT(pAllocRegistry);
+	if (!pstd::atomicLoad(&g_Metrics.isStarted)) {
+		return;
+	}
+
+	if (g_Metrics.publisherThread) {
+		pstd::raiseSignal(g_Metrics.stopSignal);
+		pstd::joinThread(g_Metrics.publisherThread);
+		pstd::destroySignal(g_Metrics.stopSignal);
+
+		publishSnapshot();
+		pstd::closeMappedFile(&g_Metrics.snapshotFile);
+	}
+
+	pstd::atomicStore(&g_Metrics.isStarted, 0u);
+	pstd::destroyThreadLocal(g_Metrics.threadKey);
+	pstd::freeArena(pAllocRegistry, &g_Metrics.arena);
+	g_Metrics = MetricsState{};
+}
+
+CounterId Metrics::registerCounter(const char* name) {
+	return ncast<CounterId>(registerMetric(MetricKind::counter, name));
+}
+
+GaugeId Metrics::registerGauge(const char* name) {
+	return ncast<GaugeId>(registerMetric(MetricKind::gauge, name));
+}
+
+HistogramId Metrics::registerHistogram(const char* name) {
+	return ncast<HistogramId>(registerMetric(MetricKind::histogram, name));
+}
+
+void Metrics::addToCounter(CounterId id, uint64_t delta) {
+	if (id == CounterId::invalid) {
+		return;
+	}
+
+	ThreadShard* pShard{ getThreadShard() };
+	if (!pShard || !pShard->counters) {
+		return;
+	}
+
+	// the only writer, the store just has to be whole for the publisher
+	uint64_t* pCounter{ &pShard->counters[cast<uint32_t>(id) - 1] };
+	pstd::atomicStore(pCounter, *pCounter + delta);
+}
+
+void Metrics::setGauge(GaugeId id, int64_t value) {
+	if (id == GaugeId::invalid || !pstd::atomicLoad(&g_Metrics.isStarted)) {
+		return;
+	}
+
+	pstd::atomicStore(
+		&g_Metrics.gauges[cast<uint32_t>(id) - 1].value,
+		ncast<uint64_t>(value)
+	);
+}
+
+void Metrics::addToGauge(GaugeId id, int64_t delta) {
+	if (id == GaugeId::invalid || !pstd::atomicLoad(&g_Metrics.isStarted)) {
+		return;
+	}
+
+	pstd::atomicAdd(
+		&g_Metrics.gauges[cast<uint32_t>(id) - 1].value,
+		ncast<uint64_t>(delta)
+	);
+}
+
+void Metrics::recordValue(HistogramId id, uint64_t value) {
+	if (id == HistogramId::invalid) {
+		return;
+	}
+
+	ThreadShard* pShard{ getThreadShard() };
+	if (!pShard || !pShard->histograms) {
+		return;
+	}
+
+	pstd::addValue(&pShard->histograms[cast<uint32_t>(id) - 1], value);
+}
+
+uint64_t Metrics::readCounter(CounterId id) {
+	if (id == CounterId::invalid || !pstd::atomicLoad(&g_Metrics.isStarted)) {
+		return 0;
+	}
+
+	uint64_t total{};
+	pstd::lockShared(&g_Metrics.mutex);
+	for (uint32_t i{}; i < g_Metrics.threadCount; i++) {
+		total += pstd::atomicLoad(
+			&g_Metrics.shards[i].counters[cast<uint32_t>(id) - 1]
+		);
+	}
+	pstd::unlockShared(&g_Metrics.mutex);
+
+	return total;
+}
+
+int64_t Metrics::readGauge(GaugeId id) {
+	if (id == GaugeId::invalid || !pstd::atomicLoad(&g_Metrics.isStarted)) {
+		return 0;
+	}
+
+	return ncast<int64_t>(
+		pstd::atomicLoad(&g_Metrics.gauges[cast<uint32_t>(id) - 1].value)
+	);
+}
+
+bool Metrics::openSnapshot(const pstd::String& data, Snapshot* outSnapshot) {
+	ASSERT(outSnapshot);
+
+	if (data.size < sizeof(SnapshotHeader)) {
+		return false;
+	}
+
+	SnapshotHeader header{};
+	pstd::memCpy(&header, data.buffer, sizeof(header));
+	if (header.magic != METRICS_FILE_MAGIC ||
+		header.version != METRICS_FILE_VERSION ||
+		header.metricCount > header.maxMetricCount) {
+		return false;
+	}
+
+	size_t size{ calcSnapshotSize(header.maxMetricCount) };
+	if (data.size < size) {
+		return false;
+	}
+
+	uint64_t endSequence{};
+	pstd::memCpy(
+		&endSequence,
+		data.buffer + size - sizeof(endSequence),
+		sizeof(endSequence)
+	);
+	if (header.sequence % 2 != 0 || header.sequence != endSequence) {
+		return false;
+	}
+
+	*outSnapshot = Snapshot{ .data = data, .header = header };
+	return true;
+}
+
+void Metrics::readSnapshotMetric(
+	const Snapshot& snapshot, uint32_t index, SnapshotMetric* outMetric
+) {
+	ASSERT(outMetric);
+	ASSERT(index < snapshot.header.metricCount);
+
+	pstd::memCpy(
+		outMetric,
+		snapshot.data.buffer + sizeof(SnapshotHeader) +
+			ncast<size_t>(index) * sizeof(SnapshotMetric),
+		sizeof(SnapshotMetric)
+	);
+	outMetric->name[MAX_METRIC_NAME_SIZE] = '\0';
+}
+
+namespace {
+	uint32_t registerMetric(MetricKind kind, const char* name) {
+		ASSERT(name);
+		if (!pstd::atomicLoad(&g_Metrics.isStarted)) {
+			return 0;
+		}
+
+		pstd::String nameString{ pstd::createString(name) };
+		nameString.size = min(nameString.size, MAX_METRIC_NAME_SIZE);
+		auto kindIndex{ cast<uint32_t>(kind) };
+
+		pstd::lockExclusive(&g_Metrics.mutex);
+		MetricName* names{ g_Metrics.names[kindIndex] };
+		uint32_t nameCount{ g_Metrics.nameCounts[kindIndex] };
+
+		uint32_t id{};
+		for (uint32_t i{}; i < nameCount && id == 0; i++) {
+			if (pstd::stringsMatch(
+					pstd::createString(names[i].text), nameString
+				)) {
+				id = i + 1;
+			}
+		}
+		if (id == 0 && nameCount < g_Metrics.maxNameCounts[kindIndex]) {
+			names[nameCount] = MetricName{};
+			pstd::memCpy(
+				names[nameCount].text, nameString.buffer, nameString.size
+			);
+			g_Metrics.nameCounts[kindIndex] = nameCount + 1;
+			id = nameCount + 1;
+		}
+		pstd::unlockExclusive(&g_Metrics.mutex);
+
+		return id;
+	}
+
+	ThreadShard* getThreadShard() {
+		if (!pstd::atomicLoad(&g_Metrics.isStarted)) {
+			return nullptr;
+		}
+
+		auto* pShard{
+			rcast<ThreadShard*>(pstd::getThreadLocal(g_Metrics.threadKey))
+		};
+		if (!pShard) {
+			pShard = registerThread();
+		}
+		if (pShard == &g_NoShard) {
+			pstd::atomicAdd(&g_Metrics.droppedCount, 1);
+			return nullptr;
+		}
+		return pShard;
+	}
+
+	ThreadShard* registerThread() {
+		ThreadShard* pShard{};
+
+		// counters and histograms only add up, so what the exited thread
+		// bumped stays in the totals
+		pstd::lockExclusive(&g_Metrics.mutex);
+		for (uint32_t i{}; i < g_Metrics.threadCount && !pShard; i++) {
+			if (pstd::atomicLoad(&g_Metrics.shards[i].isReleased)) {
+				pShard = &g_Metrics.shards[i];
+				pstd::atomicStore(&pShard->isReleased, 0u);
+			}
+		}
+		if (!pShard && g_Metrics.threadCount < g_Metrics.maxThreadCount) {
+			pShard = &g_Metrics.shards[g_Metrics.threadCount++];
+		}
+		pstd::unlockExclusive(&g_Metrics.mutex);
+
+		if (!pShard) {
+			pShard = &g_NoShard;
+		}
+		pstd::setThreadLocal(g_Metrics.threadKey, pShard);
+		return pShard;
+	}
+
+	void releaseThreadShard(void* pVal) {
+		auto* pShard{ rcast<ThreadShard*>(pVal) };
+		if (pShard != &g_NoShard) {
+			pstd::atomicStore(&pShard->isReleased, 1u);
+		}
+	}
+
+	uint32_t runPublisher(void* pArg) {
+		while (!pstd::waitSignal(
+			g_Metrics.stopSignal, g_Metrics.publishIntervalMs
+		)) {
+			publishSnapshot();
+		}
+
+		return 0;
+	}
+
+	void publishSnapshot() {
+		auto* data{ rcast<uint8_t*>(g_Metrics.snapshotFile.data) };
+		auto* pHeader{ rcast<SnapshotHeader*>(data) };
+		auto* metrics{
+			rcast<SnapshotMetric*>(data + sizeof(SnapshotHeader))
+		};
+		auto* pEndSequence{ rcast<uint64_t*>(
+			data + calcSnapshotSize(pHeader->maxMetricCount) -
+			sizeof(uint64_t)
+		) };
+
+		pstd::lockShared(&g_Metrics.mutex);
+
+		// both ends are odd while the metrics are written. a reader that
+		// sees any of the new metrics sees the odd end after them
+		uint64_t sequence{ pstd::atomicAdd(&pHeader->sequence, 1) + 2 };
+		pstd::atomicStore(pEndSequence, sequence - 1);
+		pstd::releaseFence();
+		pHeader->time = pstd::getTime();
+
+		uint32_t metricCount{};
+		for (uint32_t kindIndex{}; kindIndex < KIND_COUNT; kindIndex++) {
+			auto kind{ ncast<MetricKind>(kindIndex) };
+			for (uint32_t i{}; i < g_Metrics.nameCounts[kindIndex]; i++) {
+				SnapshotMetric& metric{ metrics[metricCount++] };
+				metric = SnapshotMetric{ .kind = kind };
+				pstd::memCpy(
+					metric.name,
+					g_Metrics.names[kindIndex][i].text,
+					sizeof(metric.name)
+				);
+
+				if (kind == MetricKind::counter) {
+					for (uint32_t j{}; j < g_Metrics.threadCount; j++) {
+						metric.value +=
+							pstd::atomicLoad(&g_Metrics.shards[j].counters[i]);
+					}
+				} else if (kind == MetricKind::gauge) {
+					metric.value = pstd::atomicLoad(&g_Metrics.gauges[i].value);
+				} else {
+					// threads keep recording into theirs meanwhile, which
+					// can leave a value or two out. their totalCount is read
+					// after their buckets, so it can count values the
+					// buckets don't have. the total is taken from the
+					// merged octaves instead
+					pstd::Histogram* pMerged{ g_Metrics.mergedHistogram };
+					pstd::memZero(pMerged, sizeof(pstd::Histogram));
+					for (uint32_t j{}; j < g_Metrics.threadCount; j++) {
+						pstd::mergeHistogram(
+							pMerged, g_Metrics.shards[j].histograms[i]
+						);
+					}
+					pMerged->totalCount = 0;
+					for (uint64_t octaveCount : pMerged->octaveCounts) {
+						pMerged->totalCount += octaveCount;
+					}
+					metric.value = pMerged->totalCount;
+					metric.mean = pstd::calcMean(*pMerged);
+					metric.p50 = pstd::calcPercentile(*pMerged, 50.0);
+					metric.p95 = pstd::calcPercentile(*pMerged, 95.0);
+					metric.p99 = pstd::calcPercentile(*pMerged, 99.0);
+					metric.maximum = pstd::calcPercentile(*pMerged, 100.0);
+				}
+			}
+		}
+		pHeader->metricCount = metricCount;
+		pHeader->droppedCount = pstd::atomicLoad(&g_Metrics.droppedCount);
+
+		pstd::unlockShared(&g_Metrics.mutex);
+
+		pstd::atomicStore(pEndSequence, sequence);
+		pstd::atomicStore(&pHeader->sequence, sequence);
+	}
+
+	size_t calcSnapshotSize(uint32_t maxMetricCount) {
+		return sizeof(SnapshotHeader) +
+			ncast<size_t>(maxMetricCount) * sizeof(SnapshotMetric) +
+			sizeof(uint64_t);
+	}
+
+	size_t roundUpToCacheLine(size_t size) {
+		size_t mask{ CACHE_LINE_SIZE - 1 };
+		return (size + mask) & ~mask;
+	}
+}  // namespace
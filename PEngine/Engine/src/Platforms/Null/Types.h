@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Events.h"
+#include "Platforms/Window.h"
+
+#include "Core/PCircularBuffer.h"
+
+// a platform without a window, for running the engine headless. each
+// update queues eventsPerFrame key events, the load a window's message pump
+// would put on the engine. they're letter presses and releases, never TAB,
+// so the engine keeps running until the caller stops updating it
+
+namespace Platform {
+	struct NullConfig {
+		uint32_t eventsPerFrame;
+	};
+
+	constexpr NullConfig DEFAULT_NULL_CONFIG{
+		.eventsPerFrame = 0,
+	};
+
+	// takes effect at the next startup
+	void setNullConfig(const NullConfig& config);
+
+	struct State {
+		bool isRunning;
+		uint32_t eventsPerFrame;
+		uint64_t eventCount;
+		static constexpr size_t eventBufferCapacity{ 1024 };
+		pstd::CircularBuffer<Event> eventBuffer;
+	};
+}  // namespace Platform
@@ -0,0 +1,76 @@
+#include "Platforms/Window.h"
+
+#include "Core/PCircularBuffer.h"
+#include "Core/PArena.h"
+#include "Core/PAssert.h"
+
+#include "Events.h"
+#include "Platforms/Null/Types.h"
+
+#include <new>
+
+namespace {
+	// the letters the synthetic key events cycle through
+	constexpr uint32_t LETTER_COUNT{ 26 };
+
+	Platform::NullConfig g_NullConfig{ Platform::DEFAULT_NULL_CONFIG };
+}  // namespace
+
+void Platform::setNullConfig(const NullConfig& config) {
+	ASSERT(config.eventsPerFrame <= State::eventBufferCapacity);
+
+	g_NullConfig = config;
+}
+
+size_t Platform::getSizeofState() {
+	size_t stateTypeSize{ sizeof(State) };
+	size_t bufferSize{ sizeof(Event) * State::eventBufferCapacity };
+	size_t padding{ 16 };  // for alignment
+	size_t totalSize{ stateTypeSize + bufferSize + padding };
+	return totalSize;
+}
+
+Platform::State* Platform::startup(
+	pstd::Arena* pPersistArena,
+	const char* windowName,
+	const int windowWidth,
+	const int windowHeight
+) {
+	State* state{ pstd::alloc<State>(pPersistArena) };
+	Event* eventBufferBlock{
+		pstd::alloc<Event>(pPersistArena, State::eventBufferCapacity)
+	};
+
+	return new (state) State{
+		.isRunning = true,
+		.eventsPerFrame = g_NullConfig.eventsPerFrame,
+		.eventBuffer = { .block = eventBufferBlock,
+						 .size = sizeof(Event) * State::eventBufferCapacity },
+	};
+}
+
+void Platform::shutdown(Platform::State* state) {
+	state->isRunning = false;
+}
+
+void Platform::update(State* state) {
+	for (uint32_t i{}; i < state->eventsPerFrame; i++) {
+		uint64_t eventIndex{ state->eventCount++ };
+		InputAction action{ eventIndex % 2 == 0 ? InputAction::PRESSED
+												: InputAction::RELEASED };
+		auto code{ ncast<InputCode>(
+			'A' + ncast<uint32_t>((eventIndex / 2) % LETTER_COUNT)
+		) };
+		Event event{ .type = EventType::key,
+					 .keyEvent = { .action = action, .code = code } };
+		pstd::pushBackOverwrite(&state->eventBuffer, event);
+	}
+}
+
+bool Platform::isRunning(Platform::State* state) {
+	return state->isRunning;
+}
+
+bool Platform::popEvent(Platform::State* state, Event* outEvent) {
+	return pstd::popBack(&state->eventBuffer, outEvent);
+}
@@ -4,6 +4,7 @@
 #include "Core/PMemory.h"
 #include "Core/PAlgorithm.h"
 #include "Core/PArray.h"
+#include "Core/PUnicode.h"
 
 #include "Events.h"
 #include "Base.h"
@@ -42,13 +43,26 @@ Platform::State* Platform::startup(
 
 	HINSTANCE hInstance{ GetModuleHandle(0) };
 
-	const char windowClassName[]{ "window class" };
+	const wchar_t windowClassName[]{ L"window class" };
 
-	WNDCLASS windowClass{ .lpfnWndProc = windowProc,
-						  .hInstance = hInstance,
-						  .lpszClassName = windowClassName };
+	// a window registered through the W api takes its title as utf-16, the
+	// A one would run it through the ansi code page
+	WNDCLASSW windowClass{ .lpfnWndProc = windowProc,
+						   .hInstance = hInstance,
+						   .lpszClassName = windowClassName };
 
-	RegisterClass(&windowClass);
+	RegisterClassW(&windowClass);
+
+	wchar_t wideWindowName[256]{};
+	uint32_t windowNameSize{};
+	bool nameConverted{ pstd::convertUtf8ToUtf16(
+		rcast<char16_t*>(wideWindowName),
+		256 - 1,
+		pstd::createString(windowName),
+		&windowNameSize
+	) };
+	ASSERT(nameConverted);
+	wideWindowName[windowNameSize] = L'\0';
 
 	bool windowIsFullscreen{ false };
 
@@ -78,10 +92,10 @@ Platform::State* Platform::startup(
 
 	// the window data pointer passed here cant be local since it will be
 	// refrenced after this function in windowProc
-	HWND hwnd{ CreateWindowExA(
+	HWND hwnd{ CreateWindowExW(
 		0,
 		windowClassName,
-		windowName,
+		wideWindowName,
 		windowStyle,
 		CW_USEDEFAULT,
 		CW_USEDEFAULT,
@@ -115,9 +129,9 @@ void Platform::shutdown(Platform::State* state) {
 void Platform::update(State* state) {
 	MSG msg{};
 	bool windowRunning{ state->windowData.isRunning };
-	while (PeekMessageA(&msg, 0, 0, 0, true) != 0 && windowRunning) {
+	while (PeekMessageW(&msg, 0, 0, 0, true) != 0 && windowRunning) {
 		TranslateMessage(&msg);
-		DispatchMessage(&msg);
+		DispatchMessageW(&msg);
 	}
 }
 
@@ -232,7 +246,7 @@ namespace {
 				pstd::pushBackOverwrite(&windowData->eventBuffer, event);
 			} break;
 			default: {
-				res = DefWindowProc(hwnd, uMsg, wParam, lParam);
+				res = DefWindowProcW(hwnd, uMsg, wParam, lParam);
 			}
 		}
 
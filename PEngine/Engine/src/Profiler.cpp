@@ -0,0 +1,695 @@
+#include "Profiler.h"
+#include "FlightRecorder.h"
+
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PAtomic.h"
+#include "Core/PThread.h"
+#include "Core/PTime.h"
+#include "Core/PFileIO.h"
+#include "Core/PIntrinsics.h"
+#include "Core/PString.h"
+#include "Core/PStringBuilder.h"
+#include "Core/PAlgorithm.h"
+#include "Core/PAssert.h"
+
+namespace Profiler {
+	struct Zone {
+		const char* name;
+		uint64_t beginCycles;
+		uint64_t endCycles;
+		uint64_t frameIndex;
+	};
+
+	// zones go in at writeCount, wrapping around. depth counts the scopes
+	// that are open on the thread. with perf counters each zone's events
+	// go in zoneCounters at the same place as the zone, and beginCounters
+	// holds what they were as the open zones began, one per depth
+	struct alignas(64) ThreadZones {
+		Zone* zones;
+		pstd::PerfCounters* zoneCounters;
+		pstd::PerfCounters* beginCounters;
+		uint64_t writeCount;
+		uint32_t depth;
+		uint32_t index;
+		uint32_t isReleased;
+	};
+}  // namespace Profiler
+
+using Profiler::MAX_COUNTED_DEPTH;
+using Profiler::ThreadZones;
+using Profiler::Zone;
+
+namespace {
+	// the trace is written out in chunks of about this size
+	constexpr uint32_t OUTPUT_CHUNK_SIZE{ 64 * 1024 };
+
+	// longer zone names are cut off, which keeps a zone's line within
+	// MAX_ZONE_LINE_SIZE even with every letter escaped
+	constexpr uint32_t MAX_ZONE_NAME_SIZE{ 256 };
+	constexpr uint32_t MAX_ZONE_LINE_SIZE{ 1024 };
+
+	// the cycle counter is timed against PTime's clock for at least this long
+	constexpr uint64_t MIN_CALIBRATION_MS{ 10 };
+
+	// page faults are only counted for the whole process, a zone's count
+	// has every other thread's faults over the same time in it
+	constexpr const char* PERF_COUNTER_NAMES[]{
+		"threadCycles",
+		"instructions",
+		"cacheMisses",
+		"branchMisses",
+		"processPageFaults",
+	};
+	static_assert(
+		sizeof(PERF_COUNTER_NAMES) / sizeof(*PERF_COUNTER_NAMES) ==
+		cast<size_t>(pstd::PerfCounter::count)
+	);
+
+	// availableCounters has a bit per pstd::PerfCounter the zones count, it
+	// is 0 without perf counters
+	struct ProfilerState {
+		pstd::Arena arena;
+		ThreadZones* threads;
+		uint32_t threadCount;
+		uint32_t maxThreadCount;
+		uint32_t zoneCount;
+		uint32_t availableCounters;
+		uint64_t frameIndex;
+		pstd::ThreadLocalKey threadKey;
+		pstd::Mutex registerMutex;
+		uint64_t startCycles;
+		uint64_t startTime;
+		uint32_t isStarted;
+	};
+
+	ProfilerState g_Profiler{};
+
+	// threads past maxThreadCount keep this one, so they don't look for a
+	// ring again on every zone
+	ThreadZones g_NoZones{};
+
+	// the zones of one name that ended in a frame, added up
+	struct ScopeTotal {
+		const char* name;
+		uint64_t zoneCount;
+		uint64_t cycles;
+		pstd::PerfCounters counters;
+	};
+
+	struct TraceOutput {
+		pstd::FileHandle file;
+		pstd::Arena arena;
+		pstd::StringBuilder builder;
+		bool hasFailed;
+	};
+
+	// null when the thread table is full
+	ThreadZones* registerThread();
+
+	// the thread local's exit function
+	void releaseThread(void* pVal);
+
+	// puts the events since the zone at writeSlot began in its counters
+	void countZoneEvents(ThreadZones* pThread, uint64_t writeSlot);
+
+	// cycles per second since startup
+	double calibrateCycleCounter();
+
+	// pCounters is null without perf counters
+	void appendZone(
+		pstd::StringBuilder* pBuilder,
+		const Zone& zone,
+		const pstd::PerfCounters* pCounters,
+		uint32_t threadIndex,
+		double cyclesPerSecond
+	);
+
+	void addToScopeTotal(
+		ScopeTotal* totals,
+		uint32_t* pTotalCount,
+		const Zone& zone,
+		const pstd::PerfCounters& counters
+	);
+
+	void writeScopeTotals(
+		TraceOutput* pOutput,
+		const ScopeTotal* totals,
+		uint32_t totalCount,
+		uint64_t frameIndex,
+		uint32_t threadIndex
+	);
+
+	// as microseconds with 3 decimals, which is what the trace format wants
+	void appendNanoseconds(pstd::StringBuilder* pBuilder, uint64_t nanoseconds);
+
+	void appendEscaped(pstd::StringBuilder* pBuilder, const char* cString);
+
+	// in quotes, with the quotes in it doubled
+	void appendCsvField(pstd::StringBuilder* pBuilder, const char* cString);
+
+	void flushOutput(TraceOutput* pOutput, bool force);
+}  // namespace
+
+uint32_t Profiler::g_IsProfilerOn{};
+
+void Profiler::startup(
+	pstd::AllocationRegistry* pAllocRegistry, const Config& config
+) {
+	ASSERT(pAllocRegistry);
+	ASSERT(!pstd::atomicLoad(&g_Profiler.isStarted));
+	ASSERT(config.zonesPerThread > 0);
+	ASSERT(
+		pstd::calcNextPowerOfTwo(config.zonesPerThread) ==
+		config.zonesPerThread
+	);
+	ASSERT(config.maxThreadCount > 0);
+
+	size_t zonesSize{ ncast<size_t>(config.maxThreadCount) *
+					  config.zonesPerThread * sizeof(Zone) };
+	size_t countersSize{};
+	if (config.hasPerfCounters) {
+		countersSize = ncast<size_t>(config.maxThreadCount) *
+						   (config.zonesPerThread + MAX_COUNTED_DEPTH) *
+						   sizeof(pstd::PerfCounters) +
+					   alignof(pstd::PerfCounters);
+	}
+	g_Profiler = ProfilerState{
+		.arena = pstd::allocateArena(
+			pAllocRegistry,
+			config.maxThreadCount * sizeof(ThreadZones) +
+				alignof(ThreadZones) + zonesSize + alignof(Zone) +
+				countersSize
+		),
+		.maxThreadCount = config.maxThreadCount,
+		.zoneCount = config.zonesPerThread,
+		.availableCounters = config.hasPerfCounters
+								 ? pstd::getAvailablePerfCounters()
+								 : 0,
+		.threadKey = pstd::createThreadLocal(releaseThread),
+		.startCycles = pstd::readCycleCounter(),
+		.startTime = pstd::getTime(),
+	};
+	g_Profiler.threads = pstd::alloc<ThreadZones>(
+		&g_Profiler.arena, config.maxThreadCount
+	);
+
+	Zone* zones{ pstd::alloc<Zone>(
+		&g_Profiler.arena,
+		ncast<size_t>(config.maxThreadCount) * config.zonesPerThread
+	) };
+	for (uint32_t i{}; i < config.maxThreadCount; i++) {
+		g_Profiler.threads[i] = ThreadZones{
+			.zones = zones + ncast<size_t>(i) * config.zonesPerThread,
+			.index = i,
+		};
+	}
+
+	if (config.hasPerfCounters) {
+		pstd::PerfCounters* counters{ pstd::alloc<pstd::PerfCounters>(
+			&g_Profiler.arena,
+			ncast<size_t>(config.maxThreadCount) *
+				(config.zonesPerThread + MAX_COUNTED_DEPTH)
+		) };
+		for (uint32_t i{}; i < config.maxThreadCount; i++) {
+			ThreadZones& thread{ g_Profiler.threads[i] };
+			thread.zoneCounters = counters;
+			thread.beginCounters = counters + config.zonesPerThread;
+			counters += config.zonesPerThread + MAX_COUNTED_DEPTH;
+		}
+	}
+
+	pstd::atomicStore(&g_Profiler.isStarted, 1u);
+}
+
+void Profiler::shutdown(pstd::AllocationRegistry* pAllocRegistry) {
+	ASSERT(pAllocRegistry);
+	if (!pstd::atomicLoad(&g_Profiler.isStarted)) {
+		return;
+	}
+
+	pstd::atomicStore(&g_IsProfilerOn, 0u);
+	pstd::atomicStore(&g_Profiler.isStarted, 0u);
+	pstd::destroyThreadLocal(g_Profiler.threadKey);
+	pstd::freeArena(pAllocRegistry, &g_Profiler.arena);
+	g_Profiler = ProfilerState{};
+}
+
+void Profiler::setProfilerOn(bool isOn) {
+	if (!pstd::atomicLoad(&g_Profiler.isStarted)) {
+		return;
+	}
+
+	pstd::atomicStore(&g_IsProfilerOn, isOn ? 1u : 0u);
+}
+
+void Profiler::markFrame(uint64_t frameIndex) {
+	if (!pstd::atomicLoad(&g_Profiler.isStarted)) {
+		return;
+	}
+
+	pstd::atomicStore(&g_Profiler.frameIndex, frameIndex);
+}
+
+ThreadZones* Profiler::beginZone() {
+	auto* pThread{
+		rcast<ThreadZones*>(pstd::getThreadLocal(g_Profiler.threadKey))
+	};
+	if (pThread == &g_NoZones) {
+		return nullptr;
+	}
+	if (!pThread) {
+		pThread = registerThread();
+		if (!pThread) {
+			return nullptr;
+		}
+	}
+
+	// before the caller reads the cycle counter, so the zone's cycles
+	// leave out the read
+	if (pThread->beginCounters && pThread->depth < MAX_COUNTED_DEPTH) {
+		pstd::readPerfCounters(&pThread->beginCounters[pThread->depth]);
+	}
+
+	pThread->depth++;
+	return pThread;
+}
+
+void Profiler::endZone(
+	ThreadZones* pThread, const char* name, uint64_t beginCycles
+) {
+	uint64_t endCycles{ pstd::readCycleCounter() };
+
+	uint64_t writeCount{ pThread->writeCount };
+	uint64_t writeSlot{ writeCount & (g_Profiler.zoneCount - 1) };
+	pThread->zones[writeSlot] = Zone{
+		.name = name,
+		.beginCycles = beginCycles,
+		.endCycles = endCycles,
+		.frameIndex = pstd::atomicLoad(&g_Profiler.frameIndex),
+	};
+	if (pThread->zoneCounters) {
+		countZoneEvents(pThread, writeSlot);
+	}
+	pstd::atomicStore(&pThread->writeCount, writeCount + 1);
+
+	pThread->depth--;
+	if (pThread->depth == 0) {
+		FlightRecorder::recordZone(
+			pstd::createString(name), beginCycles, endCycles
+		);
+	}
+}
+
+bool Profiler::exportChromeTrace(
+	pstd::AllocationRegistry* pAllocRegistry, const char* path
+) {
+	ASSERT(pAllocRegistry);
+	ASSERT(path);
+	if (!pstd::atomicLoad(&g_Profiler.isStarted)) {
+		return false;
+	}
+
+	double cyclesPerSecond{ calibrateCycleCounter() };
+
+	TraceOutput output{ .file = pstd::openFile(
+							path,
+							pstd::FileAccess::write,
+							pstd::FileShare::read,
+							pstd::FileCreate::createAlways
+						) };
+	if (!output.file) {
+		return false;
+	}
+	output.arena = pstd::allocateArena(
+		pAllocRegistry, OUTPUT_CHUNK_SIZE + MAX_ZONE_LINE_SIZE
+	);
+	output.builder = pstd::createStringBuilder(&output.arena);
+
+	// every event line ends in a comma but the last, which names the process
+	pstd::append(
+		&output.builder, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+	);
+
+	uint32_t threadCount{ pstd::atomicLoad(&g_Profiler.threadCount) };
+	for (uint32_t threadIndex{}; threadIndex < threadCount; threadIndex++) {
+		ThreadZones& thread{ g_Profiler.threads[threadIndex] };
+		pstd::appendf(
+			&output.builder,
+			"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+			"\"args\":{\"name\":\"thread %u\"}},\n",
+			threadIndex,
+			threadIndex
+		);
+
+		uint64_t writeCount{ pstd::atomicLoad(&thread.writeCount) };
+		uint64_t zoneCount{ min(writeCount, g_Profiler.zoneCount) };
+		for (uint64_t i{ writeCount - zoneCount }; i < writeCount; i++) {
+			uint64_t slot{ i & (g_Profiler.zoneCount - 1) };
+			Zone zone{ thread.zones[slot] };
+			pstd::PerfCounters counters{};
+			if (thread.zoneCounters) {
+				counters = thread.zoneCounters[slot];
+			}
+
+			// the thread may have gone around its ring meanwhile, and it
+			// could be writing the slot after its last zone
+			uint64_t currentCount{ pstd::atomicLoad(&thread.writeCount) };
+			if (currentCount - i >= g_Profiler.zoneCount) {
+				continue;
+			}
+
+			appendZone(
+				&output.builder,
+				zone,
+				thread.zoneCounters ? &counters : nullptr,
+				threadIndex,
+				cyclesPerSecond
+			);
+			flushOutput(&output, false);
+		}
+	}
+
+	pstd::append(
+		&output.builder,
+		"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+		"\"args\":{\"name\":\"PEngine\"}}\n]}\n"
+	);
+	flushOutput(&output, true);
+
+	pstd::closeFile(output.file);
+	pstd::freeArena(pAllocRegistry, &output.arena);
+	return !output.hasFailed;
+}
+
+bool Profiler::exportScopeCounters(
+	pstd::AllocationRegistry* pAllocRegistry, const char* path
+) {
+	ASSERT(pAllocRegistry);
+	ASSERT(path);
+	if (!pstd::atomicLoad(&g_Profiler.isStarted)) {
+		return false;
+	}
+
+	TraceOutput output{ .file = pstd::openFile(
+							path,
+							pstd::FileAccess::write,
+							pstd::FileShare::read,
+							pstd::FileCreate::createAlways
+						) };
+	if (!output.file) {
+		return false;
+	}
+	output.arena = pstd::allocateArena(
+		pAllocRegistry, OUTPUT_CHUNK_SIZE + MAX_ZONE_LINE_SIZE
+	);
+	output.builder = pstd::createStringBuilder(&output.arena);
+
+	// a frame's zones could all have different names
+	pstd::Arena totalsArena{ pstd::allocateArena(
+		pAllocRegistry, g_Profiler.zoneCount * sizeof(ScopeTotal)
+	) };
+	ScopeTotal* totals{
+		pstd::alloc<ScopeTotal>(&totalsArena, g_Profiler.zoneCount)
+	};
+
+	pstd::append(&output.builder, "frame,thread,scope,zones,cycles");
+	for (uint32_t i{}; i < cast<uint32_t>(pstd::PerfCounter::count); i++) {
+		if (g_Profiler.availableCounters & (1u << i)) {
+			pstd::appendf(&output.builder, ",%m", PERF_COUNTER_NAMES[i]);
+		}
+	}
+	pstd::append(&output.builder, '\n');
+
+	// a thread's zones are in the order they ended, so each frame's are
+	// together
+	uint32_t threadCount{ pstd::atomicLoad(&g_Profiler.threadCount) };
+	for (uint32_t threadIndex{}; threadIndex < threadCount; threadIndex++) {
+		ThreadZones& thread{ g_Profiler.threads[threadIndex] };
+		uint32_t totalCount{};
+		uint64_t frameIndex{};
+
+		uint64_t writeCount{ pstd::atomicLoad(&thread.writeCount) };
+		uint64_t zoneCount{ min(writeCount, g_Profiler.zoneCount) };
+		for (uint64_t i{ writeCount - zoneCount }; i < writeCount; i++) {
+			uint64_t slot{ i & (g_Profiler.zoneCount - 1) };
+			Zone zone{ thread.zones[slot] };
+			pstd::PerfCounters counters{};
+			if (thread.zoneCounters) {
+				counters = thread.zoneCounters[slot];
+			}
+
+			uint64_t currentCount{ pstd::atomicLoad(&thread.writeCount) };
+			if (currentCount - i >= g_Profiler.zoneCount) {
+				continue;
+			}
+
+			if (totalCount > 0 && zone.frameIndex != frameIndex) {
+				writeScopeTotals(
+					&output, totals, totalCount, frameIndex, threadIndex
+				);
+				totalCount = 0;
+			}
+			frameIndex = zone.frameIndex;
+			addToScopeTotal(totals, &totalCount, zone, counters);
+		}
+
+		writeScopeTotals(
+			&output, totals, totalCount, frameIndex, threadIndex
+		);
+	}
+	flushOutput(&output, true);
+
+	pstd::closeFile(output.file);
+	pstd::freeArena(pAllocRegistry, &totalsArena);
+	pstd::freeArena(pAllocRegistry, &output.arena);
+	return !output.hasFailed;
+}
+
+namespace {
+	ThreadZones* registerThread() {
+		ThreadZones* pThread{};
+
+		// the exited thread closed all its zones, the next one goes on
+		// writing after them
+		pstd::lockExclusive(&g_Profiler.registerMutex);
+		uint32_t threadIndex{ g_Profiler.threadCount };
+		for (uint32_t i{}; i < threadIndex && !pThread; i++) {
+			if (pstd::atomicLoad(&g_Profiler.threads[i].isReleased)) {
+				pThread = &g_Profiler.threads[i];
+				pstd::atomicStore(&pThread->isReleased, 0u);
+			}
+		}
+		if (!pThread && threadIndex < g_Profiler.maxThreadCount) {
+			pThread = &g_Profiler.threads[threadIndex];
+			pstd::atomicStore(&g_Profiler.threadCount, threadIndex + 1);
+		}
+		pstd::unlockExclusive(&g_Profiler.registerMutex);
+
+		pstd::setThreadLocal(
+			g_Profiler.threadKey, pThread ? pThread : &g_NoZones
+		);
+		return pThread;
+	}
+
+	void releaseThread(void* pVal) {
+		auto* pThread{ rcast<ThreadZones*>(pVal) };
+		if (pThread != &g_NoZones) {
+			pstd::atomicStore(&pThread->isReleased, 1u);
+		}
+	}
+
+	void countZoneEvents(ThreadZones* pThread, uint64_t writeSlot) {
+		pstd::PerfCounters& counters{ pThread->zoneCounters[writeSlot] };
+		uint32_t depth{ pThread->depth - 1 };
+		if (depth >= MAX_COUNTED_DEPTH) {
+			counters = pstd::PerfCounters{};
+			return;
+		}
+
+		pstd::readPerfCounters(&counters);
+		const pstd::PerfCounters& beginCounters{
+			pThread->beginCounters[depth]
+		};
+		for (uint32_t i{}; i < cast<uint32_t>(pstd::PerfCounter::count);
+			 i++) {
+			counters.values[i] -= beginCounters.values[i];
+		}
+	}
+
+	double calibrateCycleCounter() {
+		uint64_t frequency{ pstd::getTimeFrequency() };
+		uint64_t minTicks{ frequency * MIN_CALIBRATION_MS / 1000 };
+
+		uint64_t time{ pstd::getTime() };
+		uint64_t cycles{ pstd::readCycleCounter() };
+		while (time - g_Profiler.startTime < minTicks) {
+			pstd::cpuPause();
+			time = pstd::getTime();
+			cycles = pstd::readCycleCounter();
+		}
+
+		double seconds{ ncast<double>(time - g_Profiler.startTime) /
+						ncast<double>(frequency) };
+		return ncast<double>(cycles - g_Profiler.startCycles) / seconds;
+	}
+
+	void appendZone(
+		pstd::StringBuilder* pBuilder,
+		const Zone& zone,
+		const pstd::PerfCounters* pCounters,
+		uint32_t threadIndex,
+		double cyclesPerSecond
+	) {
+		// a thread can read the counter a little behind the one startup read
+		uint64_t beginCycles{ max(zone.beginCycles, g_Profiler.startCycles) };
+		uint64_t endCycles{ max(zone.endCycles, beginCycles) };
+		double nanosecondsPerCycle{ 1000000000.0 / cyclesPerSecond };
+
+		pstd::append(pBuilder, "{\"name\":\"");
+		appendEscaped(pBuilder, zone.name);
+		pstd::appendf(
+			pBuilder,
+			"\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":",
+			threadIndex
+		);
+		appendNanoseconds(
+			pBuilder,
+			ncast<uint64_t>(
+				ncast<double>(beginCycles - g_Profiler.startCycles) *
+				nanosecondsPerCycle
+			)
+		);
+		pstd::append(pBuilder, ",\"dur\":");
+		appendNanoseconds(
+			pBuilder,
+			ncast<uint64_t>(
+				ncast<double>(endCycles - beginCycles) * nanosecondsPerCycle
+			)
+		);
+
+		if (pCounters) {
+			char separator{ '{' };
+			pstd::append(pBuilder, ",\"args\":");
+			for (uint32_t i{}; i < cast<uint32_t>(pstd::PerfCounter::count);
+				 i++) {
+				if (g_Profiler.availableCounters & (1u << i)) {
+					pstd::append(pBuilder, separator);
+					pstd::appendf(
+						pBuilder,
+						"\"%m\":%u",
+						PERF_COUNTER_NAMES[i],
+						pCounters->values[i]
+					);
+					separator = ',';
+				}
+			}
+			pstd::append(pBuilder, separator == '{' ? "{}" : "}");
+		}
+		pstd::append(pBuilder, "},\n");
+	}
+
+	void addToScopeTotal(
+		ScopeTotal* totals,
+		uint32_t* pTotalCount,
+		const Zone& zone,
+		const pstd::PerfCounters& counters
+	) {
+		// scopes are mostly found by their literal, the names are compared
+		// for literals the compiler didn't merge
+		ScopeTotal* pTotal{};
+		for (uint32_t i{}; i < *pTotalCount && !pTotal; i++) {
+			if (totals[i].name == zone.name ||
+				pstd::stringsMatch(totals[i].name, zone.name)) {
+				pTotal = &totals[i];
+			}
+		}
+		if (!pTotal) {
+			pTotal = &totals[(*pTotalCount)++];
+			*pTotal = ScopeTotal{ .name = zone.name };
+		}
+
+		pTotal->zoneCount++;
+		pTotal->cycles +=
+			zone.endCycles - min(zone.beginCycles, zone.endCycles);
+		for (uint32_t i{}; i < cast<uint32_t>(pstd::PerfCounter::count);
+			 i++) {
+			pTotal->counters.values[i] += counters.values[i];
+		}
+	}
+
+	void writeScopeTotals(
+		TraceOutput* pOutput,
+		const ScopeTotal* totals,
+		uint32_t totalCount,
+		uint64_t frameIndex,
+		uint32_t threadIndex
+	) {
+		pstd::StringBuilder* pBuilder{ &pOutput->builder };
+		for (uint32_t i{}; i < totalCount; i++) {
+			const ScopeTotal& total{ totals[i] };
+			pstd::appendf(pBuilder, "%u,%u,", frameIndex, threadIndex);
+			appendCsvField(pBuilder, total.name);
+			pstd::appendf(pBuilder, ",%u,%u", total.zoneCount, total.cycles);
+			for (uint32_t j{}; j < cast<uint32_t>(pstd::PerfCounter::count);
+				 j++) {
+				if (g_Profiler.availableCounters & (1u << j)) {
+					pstd::appendf(pBuilder, ",%u", total.counters.values[j]);
+				}
+			}
+			pstd::append(pBuilder, '\n');
+			flushOutput(pOutput, false);
+		}
+	}
+
+	void appendNanoseconds(
+		pstd::StringBuilder* pBuilder, uint64_t nanoseconds
+	) {
+		uint64_t fraction{ nanoseconds % 1000 };
+		pstd::appendf(pBuilder, "%u.", nanoseconds / 1000);
+		for (uint32_t i{ pstd::calcDigitCount(fraction) }; i < 3; i++) {
+			pstd::append(pBuilder, '0');
+		}
+		pstd::appendf(pBuilder, "%u", fraction);
+	}
+
+	void appendEscaped(pstd::StringBuilder* pBuilder, const char* cString) {
+		for (uint32_t i{}; i < MAX_ZONE_NAME_SIZE && cString[i]; i++) {
+			char letter{ cString[i] };
+			if (letter == '"' || letter == '\\') {
+				pstd::append(pBuilder, '\\');
+			} else if (ncast<uint8_t>(letter) < ' ') {
+				letter = ' ';
+			}
+			pstd::append(pBuilder, letter);
+		}
+	}
+
+	void appendCsvField(pstd::StringBuilder* pBuilder, const char* cString) {
+		pstd::append(pBuilder, '"');
+		for (uint32_t i{}; i < MAX_ZONE_NAME_SIZE && cString[i]; i++) {
+			char letter{ cString[i] };
+			if (letter == '"') {
+				pstd::append(pBuilder, '"');
+			} else if (ncast<uint8_t>(letter) < ' ') {
+				letter = ' ';
+			}
+			pstd::append(pBuilder, letter);
+		}
+		pstd::append(pBuilder, '"');
+	}
+
+	void flushOutput(TraceOutput* pOutput, bool force) {
+		if (pOutput->builder.size < OUTPUT_CHUNK_SIZE && !force) {
+			return;
+		}
+
+		pstd::String text{ pstd::finishString(&pOutput->builder) };
+		if (!pstd::writeFile(pOutput->file, text.buffer, text.size)) {
+			pOutput->hasFailed = true;
+		}
+
+		pOutput->arena.offset = 0;
+		pOutput->builder = pstd::createStringBuilder(&pOutput->arena);
+	}
+}  // namespace
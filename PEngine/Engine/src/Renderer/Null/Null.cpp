@@ -0,0 +1,32 @@
+#include "Renderer/Renderer.h"
+
+#include "Core/PArena.h"
+#include "Core/PAssert.h"
+#include "Platforms/Window.h"
+
+#include <new>
+
+// a renderer that draws nothing, for running the engine without a GPU
+
+namespace Renderer {
+	struct State {
+		const Platform::State* pPlatformState;
+	};
+}  // namespace Renderer
+
+size_t Renderer::getSizeofState() {
+	return sizeof(State);
+}
+
+Renderer::State* Renderer::startup(
+	pstd::Arena* pPersistArena,
+	pstd::Arena scratchArena,
+	const Platform::State& platformState
+) {
+	ASSERT(pPersistArena);
+
+	State* state{ pstd::alloc<State>(pPersistArena) };
+	return new (state) State{ .pPlatformState = &platformState };
+}
+
+void Renderer::shutdown(State* state) {}
@@ -31,9 +31,24 @@ namespace {
 				severityString = "[VULKAN ??]";
 				break;
 		}
-		if (messageSeverity > VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT) {
-			Console::log(
-				Console::LogLevel::none,
+		// the layers can repeat a message thousands of times a frame, each
+		// message id gets its own rate limit
+		auto messageKey{ ncast<uint32_t>(pCallbackData->messageIdNumber) };
+		if (messageSeverity >= VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) {
+			LOG_LIMITED(
+				validation,
+				Console::LogLevel::error,
+				messageKey,
+				"%m %m\n",
+				severityString,
+				pCallbackData->pMessage
+			);
+		} else if (messageSeverity >
+				   VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT) {
+			LOG_LIMITED(
+				validation,
+				Console::LogLevel::warn,
+				messageKey,
 				"%m %m\n",
 				severityString,
 				pCallbackData->pMessage
@@ -95,7 +110,7 @@ VkDebugUtilsMessengerEXT createDebugMessenger(VkInstance instance) {
 		instance, &debugUtilsMessengerCI, nullptr, &debugMessenger
 	) };
 	if (res != VK_SUCCESS) {
-		LOG_WARN("couldnt create debug messenger %i\n", (int)res);
+		LOG_WARN(renderer, "couldnt create debug messenger %i\n", (int)res);
 	}
 
 	return debugMessenger;
@@ -45,11 +45,11 @@ pstd::Array<const char*> findValidationLayers(pstd::Arena* pPersistArena) {
 		}
 	}
 	for (int i{}; i < requiredLayers.count; i++) {
-		LOG_ERROR("could not find %m\n", requiredLayers[i]);
+		LOG_ERROR(renderer, "could not find %m\n", requiredLayers[i]);
 	}
 
 	for (int i{}; i < foundLayers.count; i++) {
-		LOG_INFO("found %m\n", foundLayers[i]);
+		LOG_INFO(renderer, "found %m\n", foundLayers[i]);
 	}
 
 	return foundLayers;
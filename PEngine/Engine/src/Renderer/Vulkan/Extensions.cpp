@@ -5,6 +5,7 @@
 #include "Core/PArena.h"
 #include "Core/PMemory.h"
 #include "Core/PContainer.h"
+#include "Core/PIntern.h"
 #include "Logging.h"
 
 #include <vulkan/vulkan.h>
@@ -47,19 +48,19 @@ pstd::Array<const char*> takeFoundExtensions(
 	) };
 
 	for (int i{}; i < pRequiredExtensions->count; i++) {
-		LOG_ERROR("could not find %m\n", (*pRequiredExtensions)[i]);
+		LOG_ERROR(renderer, "could not find %m\n", (*pRequiredExtensions)[i]);
 	}
 	if (pOptionalExtensions) {
 		for (int i{}; i < pOptionalExtensions->count; i++) {
-			LOG_WARN("could not find %m\n", (*pOptionalExtensions)[i]);
+			LOG_WARN(renderer, "could not find %m\n", (*pOptionalExtensions)[i]);
 		}
 	}
 
 	for (int i{}; i < foundRequiredExtensions.count; i++) {
-		LOG_INFO("found %m\n", foundRequiredExtensions[i]);
+		LOG_INFO(renderer, "found %m\n", foundRequiredExtensions[i]);
 	}
 	for (int i{}; i < foundOptionalExtensions.count; i++) {
-		LOG_INFO("found %m\n", foundOptionalExtensions[i]);
+		LOG_INFO(renderer, "found %m\n", foundOptionalExtensions[i]);
 	}
 
 	if (foundOptionalExtensions.count > 0) {
@@ -90,27 +91,38 @@ namespace {
 			pPersistArena, largestArrayViewCount, 0
 		) };
 
+		// ids stay parallel to the names, both lose the same index
+		auto queriedIds{ pstd::createArray<pstd::StringId>(
+			&scratchArena, pExtensionNamesToQuery->count
+		) };
+		for (size_t i{}; i < queriedIds.count; i++) {
+			queriedIds[i] = pstd::internString(
+				pstd::createString((*pExtensionNamesToQuery)[i])
+			);
+		}
+
 		for (uint32_t i{}; i < largestArrayViewCount; i++) {
 			if (pExtensionNamesToQuery->count == 0) {
 				break;
 			}
 
-			const char* avaliableExtension{
-				availableExtensions[i].extensionName
-			};
-
-			auto matchFunction{ [&](const char* queriedExtension) {
-				return pstd::stringsMatch(queriedExtension, avaliableExtension);
-			} };
+			// a name that was never interned can't be one of the queried ones
+			pstd::StringId avaliableId{ pstd::findStringId(
+				pstd::createHashedString(
+					pstd::createString(availableExtensions[i].extensionName)
+				)
+			) };
+			if (avaliableId == pstd::StringId::invalid) {
+				continue;
+			}
 
 			size_t foundIndex{};
-			if (pstd::find(
-					*pExtensionNamesToQuery, matchFunction, &foundIndex
-				)) {
+			if (pstd::find(queriedIds, avaliableId, &foundIndex)) {
 				pstd::pushBack(
 					&matchedNames, (*pExtensionNamesToQuery)[foundIndex]
 				);
 				pstd::compactRemove(pExtensionNamesToQuery, foundIndex);
+				pstd::compactRemove(&queriedIds, foundIndex);
 			}
 		}
 
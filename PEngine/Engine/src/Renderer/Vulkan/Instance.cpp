@@ -76,7 +76,7 @@ VkInstance createInstance(pstd::ArenaPair scratchArenas) {
 	VkInstance instance{};
 	VkResult res{ vkCreateInstance(&vkInstanceCI, nullptr, &instance) };
 	if (res != VK_SUCCESS) {
-		LOG_ERROR("could not create vulkan instance: %i", (int)res);
+		LOG_ERROR(renderer, "could not create vulkan instance: %i", (int)res);
 	}
 
 	return instance;
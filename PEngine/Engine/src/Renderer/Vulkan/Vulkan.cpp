@@ -12,6 +12,7 @@
 #include "Core/PArray.h"
 #include "Core/PString.h"
 #include "Logging.h"
+#include "Profiler.h"
 #include "Platforms/VulkanSurface.h"
 
 #include <vulkan/vulkan.h>
@@ -23,6 +24,8 @@ Renderer::State* Renderer::startup(
 	pstd::Arena scratchArena,
 	const Platform::State& platformState
 ) {
+	PROFILE_FUNCTION();
+
 	VkInstance instance{ createInstance({ *pPersistArena, scratchArena }) };
 
 	VkDebugUtilsMessengerEXT debugMessenger{ createDebugMessenger(instance) };
@@ -43,7 +46,7 @@ Renderer::State* Renderer::startup(
 	fragShaderPath =
 		pstd::makeConcatted(&scratchArena, exePath, fragShaderPath);
 
-	LOG_INFO(fragShaderPath);
+	LOG_INFO(renderer, fragShaderPath);
 
 	pstd::FileHandle fragShaderFile{ pstd::openFile(
 		&scratchArena,
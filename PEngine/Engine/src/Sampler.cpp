@@ -0,0 +1,525 @@
+#include "Sampler.h"
+
+#include "Core/PTypes.h"
+#include "Core/PArena.h"
+#include "Core/PAtomic.h"
+#include "Core/PThread.h"
+#include "Core/PFileIO.h"
+#include "Core/PHash.h"
+#include "Core/PIntrinsics.h"
+#include "Core/PMemory.h"
+#include "Core/PString.h"
+#include "Core/PStringBuilder.h"
+#include "Core/PAlgorithm.h"
+#include "Core/PAssert.h"
+
+using Sampler::MAX_FRAME_COUNT;
+
+namespace {
+	constexpr uint32_t MAX_MODULE_NAME_SIZE{ 63 };
+
+	// the folded stacks are written out in chunks of about this size, a
+	// line at most takes MAX_FRAME_COUNT frames of MAX_FRAME_TEXT_SIZE
+	constexpr uint32_t OUTPUT_CHUNK_SIZE{ 64 * 1024 };
+	constexpr uint32_t MAX_FRAME_TEXT_SIZE{ MAX_MODULE_NAME_SIZE + 32 };
+	constexpr uint32_t MAX_LINE_SIZE{ MAX_FRAME_COUNT * MAX_FRAME_TEXT_SIZE +
+									  64 };
+
+	// addresses in none of the loaded modules
+	constexpr uint32_t NO_MODULE{ UINT32_MAX };
+
+	// the modules already loaded at startup that the walk can go through
+	constexpr uint32_t MAX_LOADED_MODULE_COUNT{ 256 };
+
+	struct Module {
+		char name[MAX_MODULE_NAME_SIZE + 1];
+		uintptr_t base;
+		size_t size;
+		uint32_t generation;
+		bool isLoaded;
+	};
+
+	struct SampledThread {
+		pstd::ThreadHandle handle;
+		bool isActive;
+	};
+
+	struct ModuleFrame {
+		uint32_t moduleIndex;
+		uint32_t offset;
+	};
+
+	// frameCount frames from firstFrame in the frame pool, innermost first
+	struct Stack {
+		uint64_t hash;
+		uint64_t count;
+		uint32_t threadIndex;
+		uint32_t frameCount;
+		uint32_t firstFrame;
+	};
+
+	// mutex guards everything below it, the sampler thread holds it while
+	// it samples
+	struct SamplerState {
+		pstd::Arena arena;
+		Sampler::Config config;
+		pstd::ThreadLocalKey threadKey;
+		pstd::Signal stopSignal;
+		pstd::ThreadHandle samplerThread;
+		pstd::DllHandle* loadedModules;
+		uint32_t loadedModuleCount;
+
+		pstd::Mutex mutex;
+		SampledThread* threads;
+		uint32_t threadCount;
+		Module* modules;
+		uint32_t moduleCount;
+		pstd::UnwindTable* unwindTables;
+		uint32_t unwindTableCount;
+		Stack* stacks;
+		uint32_t stackCount;
+		uint32_t stackMask;
+		ModuleFrame* frames;
+		uint32_t frameCount;
+		uint64_t droppedCount;
+		uint32_t isStarted;
+	};
+
+	SamplerState g_Sampler{};
+
+	struct FoldedOutput {
+		pstd::FileHandle file;
+		pstd::Arena arena;
+		pstd::StringBuilder builder;
+		bool hasFailed;
+	};
+
+	uint32_t runSampler(void* pArg);
+
+	// the mutex has to be held
+	void countStack(
+		uint32_t threadIndex, const uintptr_t* addresses, uint32_t count
+	);
+
+	ModuleFrame findModuleFrame(uintptr_t address);
+
+	void appendStack(pstd::StringBuilder* pBuilder, const Stack& stack);
+
+	void appendHex(pstd::StringBuilder* pBuilder, uint64_t val);
+
+	void flushOutput(FoldedOutput* pOutput, bool force);
+}  // namespace
+
+void Sampler::startup(
+	pstd::AllocationRegistry* pAllocRegistry, const Config& config
+) {
+	ASSERT(pAllocRegistry);
+	ASSERT(!pstd::atomicLoad(&g_Sampler.isStarted));
+	ASSERT(config.intervalMs > 0);
+	ASSERT(config.maxFrameCount > 0);
+	ASSERT(config.maxFrameCount <= MAX_FRAME_COUNT);
+	ASSERT(config.maxThreadCount > 0);
+	ASSERT(config.maxModuleCount > 0);
+	ASSERT(config.maxStackCount > 0);
+	ASSERT(config.maxFrameTotal > 0);
+
+	// the stack table stays at most half full
+	auto stackSlotCount{
+		ncast<uint32_t>(pstd::calcNextPowerOfTwo(config.maxStackCount) * 2)
+	};
+	uint32_t unwindTableCapacity{ MAX_LOADED_MODULE_COUNT +
+								  config.maxModuleCount };
+	g_Sampler = SamplerState{
+		.arena = pstd::allocateArena(
+			pAllocRegistry,
+			config.maxThreadCount * sizeof(SampledThread) +
+				config.maxModuleCount * sizeof(Module) +
+				MAX_LOADED_MODULE_COUNT * sizeof(pstd::DllHandle) +
+				unwindTableCapacity * sizeof(pstd::UnwindTable) +
+				stackSlotCount * sizeof(Stack) +
+				config.maxFrameTotal * sizeof(ModuleFrame) + 6 * 64
+		),
+		.config = config,
+		.threadKey = pstd::createThreadLocal(),
+		.stopSignal = pstd::createSignal(),
+		.stackMask = stackSlotCount - 1,
+	};
+	g_Sampler.threads =
+		pstd::alloc<SampledThread>(&g_Sampler.arena, config.maxThreadCount);
+	g_Sampler.modules =
+		pstd::alloc<Module>(&g_Sampler.arena, config.maxModuleCount);
+	g_Sampler.stacks = pstd::alloc<Stack>(&g_Sampler.arena, stackSlotCount);
+	g_Sampler.frames =
+		pstd::alloc<ModuleFrame>(&g_Sampler.arena, config.maxFrameTotal);
+	pstd::memZero(g_Sampler.stacks, stackSlotCount * sizeof(Stack));
+
+	// the unwind tables are read here and in addModule, so the walk never
+	// asks the loader while a thread is suspended. the modules loaded now
+	// are held until shutdown, for theirs to stay good
+	g_Sampler.loadedModules = pstd::alloc<pstd::DllHandle>(
+		&g_Sampler.arena, MAX_LOADED_MODULE_COUNT
+	);
+	g_Sampler.unwindTables =
+		pstd::alloc<pstd::UnwindTable>(&g_Sampler.arena, unwindTableCapacity);
+	g_Sampler.loadedModuleCount = pstd::acquireLoadedModules(
+		g_Sampler.loadedModules, MAX_LOADED_MODULE_COUNT
+	);
+	for (uint32_t i{}; i < g_Sampler.loadedModuleCount; i++) {
+		g_Sampler.unwindTables[i] =
+			pstd::getUnwindTable(g_Sampler.loadedModules[i]);
+	}
+	g_Sampler.unwindTableCount = g_Sampler.loadedModuleCount;
+
+	pstd::atomicStore(&g_Sampler.isStarted, 1u);
+	g_Sampler.samplerThread = pstd::createThread(runSampler, nullptr);
+}
+
+void Sampler::shutdown(pstd::AllocationRegistry* pAllocRegistry) {
+	ASSERT(pAllocRegistry);
+	if (!pstd::atomicLoad(&g_Sampler.isStarted)) {
+		return;
+	}
+
+	pstd::atomicStore(&g_Sampler.isStarted, 0u);
+	pstd::raiseSignal(g_Sampler.stopSignal);
+	pstd::joinThread(g_Sampler.samplerThread);
+
+	for (uint32_t i{}; i < g_Sampler.threadCount; i++) {
+		ASSERT(!g_Sampler.threads[i].isActive);
+	}
+	for (uint32_t i{}; i < g_Sampler.loadedModuleCount; i++) {
+		pstd::unloadDll(g_Sampler.loadedModules[i]);
+	}
+
+	pstd::destroySignal(g_Sampler.stopSignal);
+	pstd::destroyThreadLocal(g_Sampler.threadKey);
+	pstd::freeArena(pAllocRegistry, &g_Sampler.arena);
+	g_Sampler = SamplerState{};
+}
+
+void Sampler::registerThread() {
+	if (!pstd::atomicLoad(&g_Sampler.isStarted)) {
+		return;
+	}
+	ASSERT(!pstd::getThreadLocal(g_Sampler.threadKey));
+
+	pstd::lockExclusive(&g_Sampler.mutex);
+	if (g_Sampler.threadCount < g_Sampler.config.maxThreadCount) {
+		SampledThread* pThread{ &g_Sampler.threads[g_Sampler.threadCount++] };
+		*pThread = SampledThread{
+			.handle = pstd::openCurrentThread(),
+			.isActive = true,
+		};
+		pstd::setThreadLocal(g_Sampler.threadKey, pThread);
+	}
+	pstd::unlockExclusive(&g_Sampler.mutex);
+}
+
+void Sampler::unregisterThread() {
+	if (!pstd::atomicLoad(&g_Sampler.isStarted)) {
+		return;
+	}
+
+	auto* pThread{
+		rcast<SampledThread*>(pstd::getThreadLocal(g_Sampler.threadKey))
+	};
+	if (!pThread) {
+		return;
+	}
+
+	// the slot stays, the stacks counted for it still point at its index
+	pstd::lockExclusive(&g_Sampler.mutex);
+	pThread->isActive = false;
+	pstd::closeThreadHandle(pThread->handle);
+	pThread->handle = nullptr;
+	pstd::unlockExclusive(&g_Sampler.mutex);
+
+	pstd::setThreadLocal(g_Sampler.threadKey, nullptr);
+}
+
+void Sampler::addModule(const char* name, pstd::DllHandle handle) {
+	ASSERT(name);
+	ASSERT(handle);
+	if (!pstd::atomicLoad(&g_Sampler.isStarted)) {
+		return;
+	}
+
+	pstd::String nameString{ pstd::createString(name) };
+	nameString.size = min(nameString.size, MAX_MODULE_NAME_SIZE);
+
+	pstd::lockExclusive(&g_Sampler.mutex);
+	if (g_Sampler.moduleCount < g_Sampler.config.maxModuleCount) {
+		// the generation counts the loads of modules with this name
+		uint32_t generation{ 1 };
+		for (uint32_t i{}; i < g_Sampler.moduleCount; i++) {
+			const Module& module{ g_Sampler.modules[i] };
+			generation += pstd::stringsMatch(
+				pstd::createString(module.name), nameString
+			);
+		}
+
+		Module& module{ g_Sampler.modules[g_Sampler.moduleCount++] };
+		module = Module{
+			.base = rcast<uintptr_t>(handle),
+			.size = pstd::getModuleSize(handle),
+			.generation = generation,
+			.isLoaded = true,
+		};
+		pstd::memCpy(module.name, nameString.buffer, nameString.size);
+	}
+
+	// the exe and anything else loaded at startup has its table already
+	uint32_t tableCapacity{ MAX_LOADED_MODULE_COUNT +
+							g_Sampler.config.maxModuleCount };
+	bool hasTable{};
+	for (uint32_t i{}; i < g_Sampler.unwindTableCount && !hasTable; i++) {
+		hasTable = g_Sampler.unwindTables[i].base == rcast<uintptr_t>(handle);
+	}
+	if (!hasTable && g_Sampler.unwindTableCount < tableCapacity) {
+		g_Sampler.unwindTables[g_Sampler.unwindTableCount++] =
+			pstd::getUnwindTable(handle);
+	}
+	pstd::unlockExclusive(&g_Sampler.mutex);
+}
+
+void Sampler::removeModule(pstd::DllHandle handle) {
+	ASSERT(handle);
+	if (!pstd::atomicLoad(&g_Sampler.isStarted)) {
+		return;
+	}
+
+	// the module stays in the table for the stacks already counted
+	pstd::lockExclusive(&g_Sampler.mutex);
+	for (uint32_t i{}; i < g_Sampler.moduleCount; i++) {
+		Module& module{ g_Sampler.modules[i] };
+		if (module.isLoaded && module.base == rcast<uintptr_t>(handle)) {
+			module.isLoaded = false;
+		}
+	}
+
+	// its table goes, the walk stops at the module once it is unloaded
+	for (uint32_t i{}; i < g_Sampler.unwindTableCount; i++) {
+		if (g_Sampler.unwindTables[i].base == rcast<uintptr_t>(handle)) {
+			g_Sampler.unwindTables[i] =
+				g_Sampler.unwindTables[--g_Sampler.unwindTableCount];
+			break;
+		}
+	}
+	pstd::unlockExclusive(&g_Sampler.mutex);
+}
+
+bool Sampler::exportFoldedStacks(
+	pstd::AllocationRegistry* pAllocRegistry, const char* path
+) {
+	ASSERT(pAllocRegistry);
+	ASSERT(path);
+	if (!pstd::atomicLoad(&g_Sampler.isStarted)) {
+		return false;
+	}
+
+	FoldedOutput output{ .file = pstd::openFile(
+							 path,
+							 pstd::FileAccess::write,
+							 pstd::FileShare::read,
+							 pstd::FileCreate::createAlways
+						 ) };
+	if (!output.file) {
+		return false;
+	}
+	output.arena = pstd::allocateArena(
+		pAllocRegistry, OUTPUT_CHUNK_SIZE + MAX_LINE_SIZE
+	);
+	output.builder = pstd::createStringBuilder(&output.arena);
+
+	pstd::lockExclusive(&g_Sampler.mutex);
+	for (uint32_t i{}; i <= g_Sampler.stackMask; i++) {
+		const Stack& stack{ g_Sampler.stacks[i] };
+		if (stack.count == 0) {
+			continue;
+		}
+
+		appendStack(&output.builder, stack);
+		flushOutput(&output, false);
+	}
+
+	if (g_Sampler.droppedCount > 0) {
+		pstd::appendf(
+			&output.builder, "[dropped] %u\n", g_Sampler.droppedCount
+		);
+	}
+	pstd::unlockExclusive(&g_Sampler.mutex);
+
+	flushOutput(&output, true);
+	pstd::closeFile(output.file);
+	pstd::freeArena(pAllocRegistry, &output.arena);
+	return !output.hasFailed;
+}
+
+namespace {
+	uint32_t runSampler(void*) {
+		uintptr_t addresses[MAX_FRAME_COUNT];
+
+		while (!pstd::waitSignal(
+			g_Sampler.stopSignal, g_Sampler.config.intervalMs
+		)) {
+			pstd::lockExclusive(&g_Sampler.mutex);
+			for (uint32_t i{}; i < g_Sampler.threadCount; i++) {
+				const SampledThread& thread{ g_Sampler.threads[i] };
+				if (!thread.isActive) {
+					continue;
+				}
+
+				// the thread is running again by the time it is counted
+				uint32_t count{ pstd::captureThreadStack(
+					thread.handle,
+					g_Sampler.unwindTables,
+					g_Sampler.unwindTableCount,
+					addresses,
+					g_Sampler.config.maxFrameCount
+				) };
+				if (count > 0) {
+					countStack(i, addresses, count);
+				}
+			}
+			pstd::unlockExclusive(&g_Sampler.mutex);
+		}
+
+		return 0;
+	}
+
+	void countStack(
+		uint32_t threadIndex, const uintptr_t* addresses, uint32_t count
+	) {
+		ModuleFrame frames[MAX_FRAME_COUNT];
+		for (uint32_t i{}; i < count; i++) {
+			// return addresses point past the call, one back is inside it
+			frames[i] = findModuleFrame(addresses[i] - (i > 0 ? 1 : 0));
+		}
+		uint64_t hash{
+			pstd::calcHash64(frames, count * sizeof(ModuleFrame), threadIndex)
+		};
+
+		for (uint32_t slot{ ncast<uint32_t>(hash) & g_Sampler.stackMask };;
+			 slot = (slot + 1) & g_Sampler.stackMask) {
+			Stack& stack{ g_Sampler.stacks[slot] };
+			if (stack.count == 0) {
+				if (g_Sampler.stackCount >= g_Sampler.config.maxStackCount ||
+					g_Sampler.config.maxFrameTotal - g_Sampler.frameCount <
+						count) {
+					g_Sampler.droppedCount++;
+					return;
+				}
+
+				pstd::memCpy(
+					&g_Sampler.frames[g_Sampler.frameCount],
+					frames,
+					count * sizeof(ModuleFrame)
+				);
+				stack = Stack{
+					.hash = hash,
+					.count = 1,
+					.threadIndex = threadIndex,
+					.frameCount = count,
+					.firstFrame = g_Sampler.frameCount,
+				};
+				g_Sampler.frameCount += count;
+				g_Sampler.stackCount++;
+				return;
+			}
+
+			if (stack.hash != hash || stack.threadIndex != threadIndex ||
+				stack.frameCount != count) {
+				continue;
+			}
+
+			const ModuleFrame* stackFrames{
+				&g_Sampler.frames[stack.firstFrame]
+			};
+			bool isSame{ true };
+			for (uint32_t i{}; i < count && isSame; i++) {
+				isSame = stackFrames[i].moduleIndex == frames[i].moduleIndex &&
+					stackFrames[i].offset == frames[i].offset;
+			}
+			if (isSame) {
+				stack.count++;
+				return;
+			}
+		}
+	}
+
+	ModuleFrame findModuleFrame(uintptr_t address) {
+		for (uint32_t i{}; i < g_Sampler.moduleCount; i++) {
+			const Module& module{ g_Sampler.modules[i] };
+			if (module.isLoaded && address - module.base < module.size) {
+				return ModuleFrame{
+					.moduleIndex = i,
+					.offset = ncast<uint32_t>(address - module.base),
+				};
+			}
+		}
+
+		return ModuleFrame{ .moduleIndex = NO_MODULE };
+	}
+
+	void appendStack(pstd::StringBuilder* pBuilder, const Stack& stack) {
+		pstd::appendf(pBuilder, "thread %u", stack.threadIndex);
+
+		// outermost first, runs of frames in no module become one
+		const ModuleFrame* frames{ &g_Sampler.frames[stack.firstFrame] };
+		bool wasUnknown{};
+		for (uint32_t i{ stack.frameCount }; i-- > 0;) {
+			const ModuleFrame& frame{ frames[i] };
+			if (frame.moduleIndex == NO_MODULE) {
+				if (!wasUnknown) {
+					pstd::append(pBuilder, ";[unknown]");
+				}
+				wasUnknown = true;
+				continue;
+			}
+			wasUnknown = false;
+
+			const Module& module{ g_Sampler.modules[frame.moduleIndex] };
+			pstd::appendf(
+				pBuilder, ";%m#%u+", module.name, module.generation
+			);
+			appendHex(pBuilder, frame.offset);
+		}
+
+		pstd::appendf(pBuilder, " %u\n", stack.count);
+	}
+
+	void appendHex(pstd::StringBuilder* pBuilder, uint64_t val) {
+		constexpr char digits[]{ "0123456789abcdef" };
+
+		char text[2 + 16];
+		uint32_t start{ sizeof(text) };
+		do {
+			text[--start] = digits[val & 0xf];
+			val >>= 4;
+		} while (val != 0);
+		text[--start] = 'x';
+		text[--start] = '0';
+
+		pstd::append(
+			pBuilder,
+			pstd::String{
+				.buffer = text + start,
+				.size = ncast<uint32_t>(sizeof(text) - start),
+			}
+		);
+	}
+
+	void flushOutput(FoldedOutput* pOutput, bool force) {
+		if (pOutput->builder.size < OUTPUT_CHUNK_SIZE && !force) {
+			return;
+		}
+
+		pstd::String text{ pstd::finishString(&pOutput->builder) };
+		if (!pstd::writeFile(pOutput->file, text.buffer, text.size)) {
+			pOutput->hasFailed = true;
+		}
+
+		pOutput->arena.offset = 0;
+		pOutput->builder = pstd::createStringBuilder(&pOutput->arena);
+	}
+}  // namespace
@@ -0,0 +1,318 @@
+#include "SyntheticGame.h"
+
+#include "Engine.h"
+#include "Logging.h"
+#include "LoggingSetup.h"
+#include "FrameStats.h"
+#include "Metrics.h"
+#include "Game.h"
+#include "Platforms/Null/Types.h"
+#include "Core/PArena.h"
+#include "Core/PMemory.h"
+#include "Core/PFileIO.h"
+#include "Core/PParse.h"
+#include "Core/PConsole.h"
+#include "Core/PString.h"
+#include "Core/PStringBuilder.h"
+#include "Core/PIntern.h"
+
+// runs the engine loop headless, on the null platform and renderer, with
+// SyntheticGame as the game, and writes each phase's frame time
+// percentiles and the memory high-water marks as JSON.
+//
+// PEngineFrameBench [--frames <count>] [--warmup <count>]
+//                   [--entities <count>] [--events <count>]
+//                   [--out <json file>] [--label <text>]
+//
+// --events is the key events the platform queues each frame. the warmup
+// frames aren't timed. the percentiles cover every timed frame, see
+// FrameStats.h. without --out the JSON goes to the console
+
+namespace {
+	constexpr size_t SCRATCH_SIZE{ 1024 * 1024 };
+	constexpr size_t OUTPUT_SIZE{ 16 * 1024 };
+
+	// every timed frame keeps a slot in the FrameStats window, a few
+	// uint64_t, so this keeps it to tens of MB
+	constexpr uint32_t MAX_FRAME_COUNT{ 1024 * 1024 };
+
+	struct BenchConfig {
+		uint32_t frameCount;
+		uint32_t warmupFrameCount;
+		uint32_t entityCount;
+		uint32_t eventsPerFrame;
+	};
+
+	constexpr BenchConfig DEFAULT_BENCH_CONFIG{
+		.frameCount = 4096,
+		.warmupFrameCount = 64,
+		.entityCount = SyntheticGame::DEFAULT_CONFIG.entityCount,
+		.eventsPerFrame = 16,
+	};
+
+	// the value after flag, empty without the flag
+	pstd::String findArgValue(
+		const pstd::Array<pstd::String>& args, const char* flag
+	);
+
+	// leaves pCount as it is without the flag. false when the value isn't a
+	// count from 1 to maxCount
+	bool parseCountArg(
+		const pstd::Array<pstd::String>& args,
+		const char* flag,
+		uint32_t maxCount,
+		uint32_t* pCount
+	);
+
+	// a frame as the runtime's loop has it, without the hot reload check.
+	// false once the engine or the game stops running
+	bool runFrame(PE::State* pEngineState, Game::State* pGameState);
+
+	// a JSON string, with quotes and backslashes escaped
+	void appendJsonString(
+		pstd::StringBuilder* pBuilder, const pstd::String& text
+	);
+
+	void appendPhaseStats(
+		pstd::StringBuilder* pBuilder,
+		const char* name,
+		const FrameStats::PhaseStats& stats,
+		bool isFirst
+	);
+}  // namespace
+
+int main() {
+	pstd::AllocationRegistry allocationRegistry{ pstd::createAllocationRegistry(
+	) };
+	pstd::Arena scratchArena{
+		pstd::allocateArena(&allocationRegistry, SCRATCH_SIZE)
+	};
+
+	pstd::Array<pstd::String> args{ pstd::getCommandLineArgs(&scratchArena) };
+	pstd::String outPath{ findArgValue(args, "--out") };
+	pstd::String label{ findArgValue(args, "--label") };
+
+	BenchConfig config{ DEFAULT_BENCH_CONFIG };
+	if (!parseCountArg(
+			args, "--frames", MAX_FRAME_COUNT, &config.frameCount
+		) ||
+		!parseCountArg(
+			args, "--warmup", UINT32_MAX, &config.warmupFrameCount
+		) ||
+		!parseCountArg(args, "--entities", UINT32_MAX, &config.entityCount
+		) ||
+		!parseCountArg(
+			args,
+			"--events",
+			Platform::State::eventBufferCapacity,
+			&config.eventsPerFrame
+		)) {
+		pstd::consoleWrite(pstd::formatString(
+			&scratchArena,
+			"--frames, --warmup, --entities and --events need a count "
+			"above 0, at most %u frames and %u events\n",
+			MAX_FRAME_COUNT,
+			Platform::State::eventBufferCapacity
+		));
+		return 1;
+	}
+
+	Metrics::startup(&allocationRegistry);
+	Console::startup(&allocationRegistry);
+	pstd::startupStringInterner(&allocationRegistry);
+
+	pstd::Arena engineArena{ pstd::allocateArena(
+		&allocationRegistry, PE::getSizeofState() + SCRATCH_SIZE
+	) };
+	Platform::setNullConfig(
+		Platform::NullConfig{ .eventsPerFrame = config.eventsPerFrame }
+	);
+	PE::State* engineState{ PE::startup(&engineArena, scratchArena) };
+
+	SyntheticGame::setConfig(
+		SyntheticGame::Config{ .entityCount = config.entityCount }
+	);
+	Game::State* gameState{ Game::startup() };
+
+	// FrameStats does nothing before startup, so the warmup isn't timed.
+	// the window holds every timed frame, so its percentiles are the run's
+	bool isRunning{ true };
+	for (uint32_t i{}; isRunning && i < config.warmupFrameCount; i++) {
+		isRunning = runFrame(engineState, gameState);
+	}
+	FrameStats::startup(
+		&allocationRegistry,
+		FrameStats::Config{ .windowFrameCount = config.frameCount }
+	);
+	for (uint32_t i{}; isRunning && i < config.frameCount; i++) {
+		isRunning = runFrame(engineState, gameState);
+	}
+
+	int exitCode{};
+	if (!isRunning) {
+		LOG_ERROR(general, "the engine stopped before the last frame\n");
+		exitCode = 1;
+	}
+
+	const FrameStats::Summary& summary{ *FrameStats::getSummary() };
+	SyntheticGame::MemoryStats gameMemory{
+		SyntheticGame::getMemoryStats(gameState)
+	};
+	pstd::MemoryUsage processMemory{ pstd::getProcessMemoryUsage() };
+
+	pstd::Arena outputArena{
+		pstd::allocateArena(&allocationRegistry, OUTPUT_SIZE)
+	};
+	pstd::StringBuilder builder{ pstd::createStringBuilder(&outputArena) };
+	pstd::append(&builder, "{\n\t\"label\": ");
+	appendJsonString(&builder, label);
+	pstd::appendf(
+		&builder,
+		",\n\t\"frames\": %u,\n\t\"warmupFrames\": %u,\n"
+		"\t\"entities\": %u,\n\t\"eventsPerFrame\": %u,\n\t\"phases\": [",
+		summary.frameCount,
+		config.warmupFrameCount,
+		config.entityCount,
+		config.eventsPerFrame
+	);
+	for (uint32_t i{}; i < cast<uint32_t>(FrameStats::Phase::count); i++) {
+		auto phase{ ncast<FrameStats::Phase>(i) };
+		appendPhaseStats(
+			&builder,
+			FrameStats::getPhaseName(phase),
+			summary.phases[phase],
+			i == 0
+		);
+	}
+	appendPhaseStats(&builder, "frame", summary.frame, false);
+	pstd::appendf(
+		&builder,
+		"\n\t],\n\t\"memory\": { \"engineArenaBytes\": %u, "
+		"\"gameArenaBytes\": %u, \"gameFrameArenaPeakBytes\": %u, "
+		"\"peakCommittedBytes\": %u, \"peakResidentBytes\": %u }\n}\n",
+		engineArena.offset,
+		gameMemory.persistArenaSize,
+		gameMemory.frameArenaPeakSize,
+		processMemory.peakCommittedSize,
+		processMemory.peakResidentSize
+	);
+	pstd::String json{ pstd::finishString(&builder) };
+
+	if (outPath.size > 0) {
+		pstd::FileHandle outFile{ pstd::openFile(
+			&scratchArena,
+			outPath,
+			pstd::FileAccess::write,
+			pstd::FileShare::read,
+			pstd::FileCreate::createAlways
+		) };
+		if (!outFile || !pstd::writeFile(outFile, json.buffer, json.size)) {
+			LOG_ERROR(general, "couldn't write the JSON to %m\n", outPath);
+			exitCode = 1;
+		}
+		if (outFile) {
+			pstd::closeFile(outFile);
+		}
+	} else {
+		pstd::consoleWrite(json);
+	}
+
+	pstd::freeArena(&allocationRegistry, &outputArena);
+
+	Game::shutdown(gameState);
+	PE::shutdown(engineState);
+
+	FrameStats::shutdown(&allocationRegistry);
+	pstd::shutdownStringInterner(&allocationRegistry);
+	Metrics::shutdown(&allocationRegistry);
+	Console::shutdown(&allocationRegistry);
+	return exitCode;
+}
+
+namespace {
+	pstd::String findArgValue(
+		const pstd::Array<pstd::String>& args, const char* flag
+	) {
+		for (size_t i{ 1 }; i + 1 < args.count; i++) {
+			if (pstd::stringsMatch(args[i], pstd::createString(flag))) {
+				return args[i + 1];
+			}
+		}
+
+		return pstd::String{};
+	}
+
+	bool parseCountArg(
+		const pstd::Array<pstd::String>& args,
+		const char* flag,
+		uint32_t maxCount,
+		uint32_t* pCount
+	) {
+		pstd::String text{ findArgValue(args, flag) };
+		if (text.size == 0) {
+			return true;
+		}
+
+		uint64_t count{};
+		if (!pstd::parseUInt(text, &count) || count == 0 ||
+			count > maxCount) {
+			return false;
+		}
+		*pCount = ncast<uint32_t>(count);
+		return true;
+	}
+
+	bool runFrame(PE::State* pEngineState, Game::State* pGameState) {
+		bool isRunning{ true };
+		FrameStats::beginFrame();
+
+		{
+			FrameStats::PhaseScope phaseScope{
+				FrameStats::Phase::engineUpdate
+			};
+			isRunning &= PE::update(pEngineState);
+		}
+
+		{
+			FrameStats::PhaseScope phaseScope{ FrameStats::Phase::gameUpdate };
+			isRunning &= Game::update(pGameState);
+		}
+
+		FrameStats::endFrame();
+		return isRunning;
+	}
+
+	void appendJsonString(
+		pstd::StringBuilder* pBuilder, const pstd::String& text
+	) {
+		pstd::append(pBuilder, '"');
+		for (uint32_t i{}; i < text.size; i++) {
+			char letter{ text.buffer[i] };
+			if (letter == '"' || letter == '\\') {
+				pstd::append(pBuilder, '\\');
+			}
+			pstd::append(pBuilder, letter);
+		}
+		pstd::append(pBuilder, '"');
+	}
+
+	void appendPhaseStats(
+		pstd::StringBuilder* pBuilder,
+		const char* name,
+		const FrameStats::PhaseStats& stats,
+		bool isFirst
+	) {
+		pstd::appendf(
+			pBuilder,
+			"%m\n\t\t{ \"name\": \"%m\", \"meanNs\": %u, \"p50Ns\": %u, "
+			"\"p95Ns\": %u, \"p99Ns\": %u, \"maxNs\": %u }",
+			isFirst ? "" : ",",
+			name,
+			stats.mean,
+			stats.p50,
+			stats.p95,
+			stats.p99,
+			stats.maximum
+		);
+	}
+}  // namespace
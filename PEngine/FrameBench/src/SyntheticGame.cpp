@@ -0,0 +1,184 @@
+#include "SyntheticGame.h"
+
+#include "Game.h"
+#include "Core/PArena.h"
+#include "Core/PMemory.h"
+#include "Core/PVector.h"
+#include "Core/PMath.h"
+#include "Core/PAlgorithm.h"
+#include "Core/PAssert.h"
+
+#include <new>
+
+using SyntheticGame::Config;
+using SyntheticGame::MemoryStats;
+
+namespace {
+	// a fixed step, so every run does the same work
+	constexpr float TIME_STEP{ 1.f / 60.f };
+
+	// entities stay within [-BOX_EXTENT, BOX_EXTENT] on each axis
+	constexpr float BOX_EXTENT{ 100.f };
+	constexpr float MAX_SPEED{ 20.f };
+
+	constexpr float FOCUS_ORBIT{ 50.f };
+	constexpr float FOCUS_RADIUS{ 40.f };
+	constexpr float FOCUS_TURN{ 0.01f };  // radians per update
+
+	Config g_Config{ SyntheticGame::DEFAULT_CONFIG };
+
+	float randomFloat(uint64_t* pState, float low, float high);
+	pstd::Vec3 randomVec3(uint64_t* pState, float extent);
+
+	// flips the velocity on each axis the position went past the box on
+	void bounce(pstd::Vec3* pPosition, pstd::Vec3* pVelocity);
+}  // namespace
+
+namespace Game {
+	// nearTotal is a sum over the gathered entities, so the work can't be
+	// left out
+	struct State {
+		pstd::AllocationRegistry allocRegistry;
+		pstd::Arena persistArena;
+		pstd::Arena frameArena;
+		pstd::Vec3* positions;
+		pstd::Vec3* velocities;
+		uint32_t entityCount;
+		uint64_t updateCount;
+		uint32_t frameArenaPeakSize;
+		float nearTotal;
+	};
+}  // namespace Game
+
+void SyntheticGame::setConfig(const Config& config) {
+	ASSERT(config.entityCount > 0);
+
+	g_Config = config;
+}
+
+MemoryStats SyntheticGame::getMemoryStats(const Game::State* state) {
+	ASSERT(state);
+
+	return MemoryStats{
+		.persistArenaSize = state->persistArena.offset,
+		.frameArenaSize = state->frameArena.size,
+		.frameArenaPeakSize = state->frameArenaPeakSize,
+	};
+}
+
+GAME_API Game::State* Game::startup() {
+	uint32_t entityCount{ g_Config.entityCount };
+
+	pstd::AllocationRegistry allocRegistry{ pstd::createAllocationRegistry() };
+	size_t persistSize{ sizeof(Game::State) + alignof(Game::State) +
+						2 * (entityCount * sizeof(pstd::Vec3) +
+							 alignof(pstd::Vec3)) };
+	pstd::Arena persistArena{
+		pstd::allocateArena(&allocRegistry, persistSize)
+	};
+	pstd::Arena frameArena{ pstd::allocateArena(
+		&allocRegistry, entityCount * sizeof(uint32_t) + alignof(uint32_t)
+	) };
+
+	Game::State* gameState{ pstd::alloc<Game::State>(&persistArena) };
+	auto* positions{ pstd::alloc<pstd::Vec3>(&persistArena, entityCount) };
+	auto* velocities{ pstd::alloc<pstd::Vec3>(&persistArena, entityCount) };
+
+	uint64_t randomState{ 1 };
+	for (uint32_t i{}; i < entityCount; i++) {
+		positions[i] = randomVec3(&randomState, BOX_EXTENT);
+		velocities[i] = randomVec3(&randomState, MAX_SPEED);
+	}
+
+	Game::State* statePtr{ new (gameState) Game::State{
+		.allocRegistry = allocRegistry,
+		.persistArena = persistArena,
+		.frameArena = frameArena,
+		.positions = positions,
+		.velocities = velocities,
+		.entityCount = entityCount,
+	} };
+	return statePtr;
+}
+
+GAME_API bool Game::update(State* state) {
+	pstd::reset(&state->frameArena);
+
+	for (uint32_t i{}; i < state->entityCount; i++) {
+		state->positions[i] +=
+			pstd::calcScaled(state->velocities[i], TIME_STEP);
+		bounce(&state->positions[i], &state->velocities[i]);
+	}
+
+	float angle{ ncast<float>(state->updateCount) * FOCUS_TURN };
+	pstd::Vec3 focus{
+		.x = pstd::cosf(angle) * FOCUS_ORBIT,
+		.z = pstd::sinf(angle) * FOCUS_ORBIT,
+	};
+
+	auto* nearIndices{
+		pstd::alloc<uint32_t>(&state->frameArena, state->entityCount)
+	};
+	uint32_t nearCount{};
+	for (uint32_t i{}; i < state->entityCount; i++) {
+		if (pstd::calcDistance(state->positions[i], focus) < FOCUS_RADIUS) {
+			nearIndices[nearCount++] = i;
+		}
+	}
+
+	for (uint32_t i{}; i < nearCount; i++) {
+		uint32_t entity{ nearIndices[i] };
+		state->nearTotal += pstd::dot(
+			state->velocities[entity], focus - state->positions[entity]
+		);
+	}
+
+	state->frameArenaPeakSize =
+		max(state->frameArenaPeakSize, state->frameArena.offset);
+	state->updateCount++;
+	return true;
+}
+
+GAME_API void Game::shutdown(State* state) {
+	// the state is in the persist arena, so that goes last
+	pstd::AllocationRegistry allocRegistry{ state->allocRegistry };
+	pstd::Arena persistArena{ state->persistArena };
+	pstd::freeArena(&allocRegistry, &state->frameArena);
+	pstd::freeArena(&allocRegistry, &persistArena);
+}
+
+namespace {
+	float randomFloat(uint64_t* pState, float low, float high) {
+		// splitmix64, its top 24 bits are a float in [0, 1)
+		*pState += 0x9e3779b97f4a7c15ull;
+		uint64_t bits{ *pState };
+		bits = (bits ^ (bits >> 30)) * 0xbf58476d1ce4e5b9ull;
+		bits = (bits ^ (bits >> 27)) * 0x94d049bb133111ebull;
+		bits ^= bits >> 31;
+
+		float unit{ ncast<float>(bits >> 40) / ncast<float>(1u << 24) };
+		return low + (high - low) * unit;
+	}
+
+	pstd::Vec3 randomVec3(uint64_t* pState, float extent) {
+		return pstd::Vec3{
+			.x = randomFloat(pState, -extent, extent),
+			.y = randomFloat(pState, -extent, extent),
+			.z = randomFloat(pState, -extent, extent),
+		};
+	}
+
+	void bounce(pstd::Vec3* pPosition, pstd::Vec3* pVelocity) {
+		for (uint32_t axis{}; axis < 3; axis++) {
+			float& position{ (*pPosition)[axis] };
+			float& velocity{ (*pVelocity)[axis] };
+			if (position > BOX_EXTENT) {
+				position = BOX_EXTENT;
+				velocity = -velocity;
+			} else if (position < -BOX_EXTENT) {
+				position = -BOX_EXTENT;
+				velocity = -velocity;
+			}
+		}
+	}
+}  // namespace
@@ -0,0 +1,30 @@
+#pragma once
+#include "Game.h"
+#include "Core/PTypes.h"
+
+// a game module for PEngineFrameBench, linked in rather than loaded. each
+// update moves entityCount entities through a box, bouncing them off its
+// walls, and gathers the ones near a point circling it into a list in the
+// frame arena, which is reset every update
+
+namespace SyntheticGame {
+	struct Config {
+		uint32_t entityCount;
+	};
+
+	constexpr Config DEFAULT_CONFIG{
+		.entityCount = 4096,
+	};
+
+	// takes effect at the next Game::startup
+	void setConfig(const Config& config);
+
+	// in bytes. frameArenaPeakSize is the most a single update used
+	struct MemoryStats {
+		size_t persistArenaSize;
+		size_t frameArenaSize;
+		size_t frameArenaPeakSize;
+	};
+
+	MemoryStats getMemoryStats(const Game::State* state);
+}  // namespace SyntheticGame
@@ -0,0 +1,434 @@
+#include "Logging.h"
+#include "LogFile.h"
+#include "FlightRecorder.h"
+#include "Metrics.h"
+#include "Core/PArena.h"
+#include "Core/PMemory.h"
+#include "Core/PFileIO.h"
+#include "Core/PIntrinsics.h"
+#include "Core/PConsole.h"
+#include "Core/PString.h"
+#include "Core/PStringBuilder.h"
+
+// turns a binary log into the text the console would have shown, each
+// line led by its time in seconds since the logger started. a flight
+// recording is dumped the same way, ordered by time, with the thread that
+// wrote each entry and the frame markers and profiler zones in between. a
+// metrics file gets its last snapshot printed, a line per metric.
+//
+// LogDecoder <binary log | flight recording | metrics> [text file]
+
+namespace {
+	// decoded text is written out in chunks of about this size
+	constexpr uint32_t OUTPUT_CHUNK_SIZE{ 64 * 1024 };
+	constexpr uint32_t MAX_LINE_SIZE{ 1024 * 1024 };
+
+	constexpr uint32_t MICROSECONDS_DIGITS{ 6 };
+
+	// cycles per second from the first and last clock entries
+	struct LogClock {
+		uint64_t firstCycles;
+		uint64_t firstTime;
+		double cyclesPerSecond;
+	};
+
+	struct Output {
+		pstd::FileHandle file;
+		pstd::Arena arena;
+		pstd::StringBuilder builder;
+	};
+
+	// both return the exit code
+	int decodeLog(
+		pstd::AllocationRegistry* pAllocRegistry,
+		const pstd::String& data,
+		Output* pOutput
+	);
+
+	int dumpRecording(
+		pstd::AllocationRegistry* pAllocRegistry,
+		const pstd::String& data,
+		Output* pOutput
+	);
+
+	int dumpMetrics(const pstd::String& data, Output* pOutput);
+
+	LogClock readClock(Console::LogFileReader reader);
+
+	void appendTime(
+		pstd::StringBuilder* pBuilder, const LogClock& clock, uint64_t cycles
+	);
+
+	void flushOutput(Output* pOutput, bool force);
+}  // namespace
+
+int main() {
+	pstd::AllocationRegistry allocationRegistry{ pstd::createAllocationRegistry(
+	) };
+	pstd::Arena scratchArena{
+		pstd::allocateArena(&allocationRegistry, 64 * 1024)
+	};
+
+	pstd::Array<pstd::String> args{ pstd::getCommandLineArgs(&scratchArena) };
+	if (args.count < 2) {
+		pstd::consoleWrite(
+			"usage: LogDecoder <binary log | flight recording | metrics> "
+			"[text file]\n"
+		);
+		return 1;
+	}
+
+	pstd::FileHandle logFile{ pstd::openFile(
+		&scratchArena,
+		args[1],
+		pstd::FileAccess::read,
+		pstd::FileShare::readwrite,
+		pstd::FileCreate::openExisting
+	) };
+	if (!logFile) {
+		pstd::consoleWrite("couldn't open the file\n");
+		return 1;
+	}
+
+	pstd::Arena dataArena{ pstd::allocateArena(
+		&allocationRegistry, pstd::getFileSize(logFile) + 1
+	) };
+	pstd::String data{ pstd::readFile(&dataArena, logFile) };
+	pstd::closeFile(logFile);
+
+	Output output{
+		.arena = pstd::allocateArena(
+			&allocationRegistry, OUTPUT_CHUNK_SIZE + MAX_LINE_SIZE
+		),
+	};
+	output.builder = pstd::createStringBuilder(&output.arena);
+	if (args.count > 2) {
+		output.file = pstd::openFile(
+			&scratchArena,
+			args[2],
+			pstd::FileAccess::write,
+			pstd::FileShare::read,
+			pstd::FileCreate::createAlways
+		);
+		if (!output.file) {
+			pstd::consoleWrite("couldn't create the text file\n");
+			return 1;
+		}
+	}
+
+	uint32_t magic{};
+	if (data.size >= sizeof(uint32_t)) {
+		magic = pstd::loadUInt32(data.buffer);
+	}
+
+	int exitCode{};
+	if (magic == FlightRecorder::RECORDER_FILE_MAGIC) {
+		exitCode = dumpRecording(&allocationRegistry, data, &output);
+	} else if (magic == Metrics::METRICS_FILE_MAGIC) {
+		exitCode = dumpMetrics(data, &output);
+	} else {
+		exitCode = decodeLog(&allocationRegistry, data, &output);
+	}
+
+	flushOutput(&output, true);
+	if (output.file) {
+		pstd::closeFile(output.file);
+	}
+
+	return exitCode;
+}
+
+namespace {
+	int decodeLog(
+		pstd::AllocationRegistry* pAllocRegistry,
+		const pstd::String& data,
+		Output* pOutput
+	) {
+		Console::LogFileHeader header{};
+		if (!Console::readLogFileHeader(data, &header)) {
+			pstd::consoleWrite("not a binary log of this version\n");
+			return 1;
+		}
+
+		pstd::Arena siteArena{ pstd::allocateArena(
+			pAllocRegistry,
+			header.maxSiteCount * sizeof(Console::LogFileSite) +
+				alignof(Console::LogFileSite)
+		) };
+		Console::LogFileReader reader{};
+		if (!Console::openLogFile(&siteArena, data, &reader)) {
+			pstd::consoleWrite("couldn't allocate the site table\n");
+			return 1;
+		}
+
+		LogClock clock{ readClock(reader) };
+		uint64_t lastCycles{ clock.firstCycles };
+
+		Console::LogEntry entry{};
+		while (Console::readLogEntry(&reader, &entry)) {
+			if (entry.kind == Console::LogEntryKind::record) {
+				const Console::LogFileSite& site{ *entry.pSite };
+				appendTime(&pOutput->builder, clock, entry.cycles);
+				Console::appendLogLine(
+					&pOutput->builder,
+					site.level,
+					site.file,
+					site.line,
+					site.format,
+					site.argTypes,
+					entry.args
+				);
+				lastCycles = entry.cycles;
+			} else if (entry.kind == Console::LogEntryKind::dropped) {
+				constexpr Console::LogArgType argTypes[]{
+					Console::LogArgType::uint64
+				};
+				Console::LogArg droppedArgs[1];
+				droppedArgs[0].uintVal = entry.droppedCount;
+
+				appendTime(&pOutput->builder, clock, lastCycles);
+				Console::appendLogLine(
+					&pOutput->builder,
+					LogLevel::warn,
+					pstd::String{},
+					0,
+					pstd::createString("%u log records dropped\n"),
+					argTypes,
+					droppedArgs
+				);
+			}
+
+			flushOutput(pOutput, false);
+		}
+
+		int exitCode{};
+		if (reader.offset < data.size) {
+			pstd::appendf(
+				&pOutput->builder,
+				"the log is cut off or corrupt after byte %u\n",
+				reader.offset
+			);
+			exitCode = 1;
+		}
+
+		return exitCode;
+	}
+
+	int dumpRecording(
+		pstd::AllocationRegistry* pAllocRegistry,
+		const pstd::String& data,
+		Output* pOutput
+	) {
+		// every entry takes at least 16 bytes of the recording and 36 of the
+		// entry table and the sort
+		pstd::Arena recordingArena{ pstd::allocateArena(
+			pAllocRegistry, data.size / 16 * 36 + 64
+		) };
+		FlightRecorder::Recording recording{};
+		if (!FlightRecorder::openRecording(&recordingArena, data, &recording)) {
+			pstd::consoleWrite("not a flight recording of this version\n");
+			return 1;
+		}
+
+		if (recording.header.droppedCount > 0) {
+			pstd::appendf(
+				&pOutput->builder,
+				"%u entries from threads past maxThreadCount were dropped\n",
+				recording.header.droppedCount
+			);
+		}
+
+		LogClock clock{
+			.firstCycles = recording.firstCycles,
+			.cyclesPerSecond = recording.cyclesPerSecond,
+		};
+
+		FlightRecorder::Entry entry{};
+		for (uint32_t i{}; i < recording.entryCount; i++) {
+			FlightRecorder::readEntry(recording, i, &entry);
+			appendTime(&pOutput->builder, clock, entry.cycles);
+			pstd::appendf(&pOutput->builder, "[t%u] ", entry.threadIndex);
+
+			switch (entry.kind) {
+				case FlightRecorder::EntryKind::log: {
+					Console::appendLogLine(
+						&pOutput->builder,
+						entry.level,
+						entry.file,
+						entry.line,
+						entry.format,
+						entry.argTypes,
+						entry.args
+					);
+				} break;
+				case FlightRecorder::EntryKind::frame: {
+					pstd::appendf(
+						&pOutput->builder, "frame %u\n", entry.frameIndex
+					);
+				} break;
+				case FlightRecorder::EntryKind::zone: {
+					pstd::appendf(
+						&pOutput->builder,
+						"zone %m, %u cycles\n",
+						entry.name,
+						entry.endCycles - entry.cycles
+					);
+				} break;
+				default: {
+				} break;
+			}
+
+			flushOutput(pOutput, false);
+		}
+
+		return 0;
+	}
+
+	int dumpMetrics(const pstd::String& data, Output* pOutput) {
+		// the process may still be publishing, a copy made while it was
+		// writing doesn't open
+		Metrics::Snapshot snapshot{};
+		if (!Metrics::openSnapshot(data, &snapshot)) {
+			pstd::consoleWrite(
+				"not a metrics snapshot of this version, or it was being "
+				"written, try again\n"
+			);
+			return 1;
+		}
+
+		const Metrics::SnapshotHeader& header{ snapshot.header };
+		double seconds{};
+		if (header.timeFrequency > 0) {
+			seconds = ncast<double>(header.time) /
+				ncast<double>(header.timeFrequency);
+		}
+		pstd::appendf(
+			&pOutput->builder,
+			"snapshot %u, published at %f s\n",
+			header.sequence / 2,
+			seconds
+		);
+		if (header.droppedCount > 0) {
+			pstd::appendf(
+				&pOutput->builder,
+				"%u bumps from threads past maxThreadCount were dropped\n",
+				header.droppedCount
+			);
+		}
+
+		Metrics::SnapshotMetric metric{};
+		for (uint32_t i{}; i < header.metricCount; i++) {
+			Metrics::readSnapshotMetric(snapshot, i, &metric);
+			switch (metric.kind) {
+				case Metrics::MetricKind::counter: {
+					pstd::appendf(
+						&pOutput->builder,
+						"counter %m: %u\n",
+						metric.name,
+						metric.value
+					);
+				} break;
+				case Metrics::MetricKind::gauge: {
+					pstd::appendf(
+						&pOutput->builder,
+						"gauge %m: %i\n",
+						metric.name,
+						ncast<int64_t>(metric.value)
+					);
+				} break;
+				case Metrics::MetricKind::histogram: {
+					pstd::appendf(
+						&pOutput->builder,
+						"histogram %m: %u values, mean %u, p50 %u, p95 %u, "
+						"p99 %u, max %u\n",
+						metric.name,
+						metric.value,
+						metric.mean,
+						metric.p50,
+						metric.p95,
+						metric.p99,
+						metric.maximum
+					);
+				} break;
+				default: {
+				} break;
+			}
+
+			flushOutput(pOutput, false);
+		}
+
+		return 0;
+	}
+
+	LogClock readClock(Console::LogFileReader reader) {
+		LogClock clock{};
+		uint64_t lastCycles{};
+		uint64_t lastTime{};
+		bool hasClock{};
+
+		Console::LogEntry entry{};
+		while (Console::readLogEntry(&reader, &entry)) {
+			if (entry.kind != Console::LogEntryKind::clock) {
+				continue;
+			}
+			if (!hasClock) {
+				clock.firstCycles = entry.cycles;
+				clock.firstTime = entry.time;
+				hasClock = true;
+			}
+			lastCycles = entry.cycles;
+			lastTime = entry.time;
+		}
+
+		// without two clocks apart in time, lines get no time
+		if (lastTime > clock.firstTime && reader.header.timeFrequency > 0) {
+			double seconds{ ncast<double>(lastTime - clock.firstTime) /
+							ncast<double>(reader.header.timeFrequency) };
+			clock.cyclesPerSecond =
+				ncast<double>(lastCycles - clock.firstCycles) / seconds;
+		}
+
+		return clock;
+	}
+
+	void appendTime(
+		pstd::StringBuilder* pBuilder, const LogClock& clock, uint64_t cycles
+	) {
+		if (clock.cyclesPerSecond <= 0.0) {
+			return;
+		}
+
+		// threads can read the counter a little before the first clock
+		uint64_t elapsedCycles{
+			cycles > clock.firstCycles ? cycles - clock.firstCycles : 0
+		};
+		auto microseconds{ ncast<uint64_t>(
+			ncast<double>(elapsedCycles) / clock.cyclesPerSecond * 1000000.0
+		) };
+		uint64_t fraction{ microseconds % 1000000 };
+
+		pstd::appendf(pBuilder, "[%u.", microseconds / 1000000);
+		for (uint32_t i{ pstd::calcDigitCount(fraction) };
+			 i < MICROSECONDS_DIGITS;
+			 i++) {
+			pstd::append(pBuilder, '0');
+		}
+		pstd::appendf(pBuilder, "%u] ", fraction);
+	}
+
+	void flushOutput(Output* pOutput, bool force) {
+		if (pOutput->builder.size < OUTPUT_CHUNK_SIZE && !force) {
+			return;
+		}
+
+		pstd::String text{ pstd::finishString(&pOutput->builder) };
+		if (pOutput->file) {
+			pstd::writeFile(pOutput->file, text.buffer, text.size);
+		} else {
+			pstd::consoleWrite(text);
+		}
+
+		pOutput->arena.offset = 0;
+		pOutput->builder = pstd::createStringBuilder(&pOutput->arena);
+	}
+}  // namespace
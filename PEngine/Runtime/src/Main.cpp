@@ -1,11 +1,18 @@
 #include "Engine.h"
 #include "Logging.h"
 #include "LoggingSetup.h"
+#include "FlightRecorder.h"
+#include "Profiler.h"
+#include "Sampler.h"
+#include "FrameStats.h"
+#include "Metrics.h"
 #include "Game.h"
 #include "Core/PArena.h"
 #include "Core/PMemory.h"
 #include "Core/PFileIO.h"
 #include "Core/PString.h"
+#include "Core/PStringBuilder.h"
+#include "Core/PIntern.h"
 #include "Core/Memory.h"
 #include <Windows.h>
 
@@ -20,53 +27,180 @@ namespace {
 	GameDll loadGameDll(pstd::Arena scratchArena);
 	void unloadGameDll(GameDll dll);
 
+	// --log-file <path> writes the log to a text file and --binary-log
+	// <path> to a binary one for LogDecoder, either turns the console off.
+	// --log-level <info|warn|error> filters out every category's calls
+	// below it. the config only has to outlive Console::startup
+	Console::LogConfig makeLogConfig(pstd::Arena* pArena);
+
+	// the flight recorder writes FlightRecorder.bin next to the exe, or
+	// wherever --flight-recorder <path> says. the last run's recording is
+	// kept as <path>.prev, this run's would replace it otherwise
+	FlightRecorder::Config makeRecorderConfig(pstd::Arena* pArena);
+
+	// --profile <path> turns the profiler on from the start and writes a
+	// Chrome trace there at exit. --profile-scopes <path> does too, with
+	// perf counters, and writes each frame's scope totals there as CSV.
+	// --sample <path> samples the main thread's stacks and writes them
+	// there as folded stacks at exit. --frame-stats <path> writes the frame
+	// timing percentiles there at exit. --metrics <path> publishes the
+	// metrics there while running. null without the flag
+	const char* makeArgPath(pstd::Arena* pArena, const char* flag);
+
 	PE::State* engineState;
 }  // namespace
 
 int main() {
-	Console::startup();
-
 	pstd::AllocationRegistry allocationRegistry{ pstd::createAllocationRegistry(
 	) };
+
 	constexpr size_t scratchSize{ 1024 * 1024 };
 
 	pstd::Arena scratchArena{
 		pstd::allocateArena(&allocationRegistry, scratchSize)
 	};
 
+	// the path is needed until exit, so it stays in the scratch arena
+	const char* profilePath{ makeArgPath(&scratchArena, "--profile") };
+	const char* scopesPath{
+		makeArgPath(&scratchArena, "--profile-scopes")
+	};
+	if (profilePath || scopesPath) {
+		Profiler::Config config{ Profiler::DEFAULT_CONFIG };
+		config.hasPerfCounters = scopesPath != nullptr;
+		Profiler::startup(&allocationRegistry, config);
+		Profiler::setProfilerOn(true);
+	}
+
+	const char* samplePath{ makeArgPath(&scratchArena, "--sample") };
+	if (samplePath) {
+		Sampler::startup(&allocationRegistry);
+		Sampler::addModule("Runtime", pstd::getExeModule());
+		Sampler::registerThread();
+	}
+
+	const char* frameStatsPath{
+		makeArgPath(&scratchArena, "--frame-stats")
+	};
+	FrameStats::startup(&allocationRegistry);
+
+	Metrics::Config metricsConfig{ Metrics::DEFAULT_CONFIG };
+	metricsConfig.path = makeArgPath(&scratchArena, "--metrics");
+	if (!Metrics::startup(&allocationRegistry, metricsConfig)) {
+		LOG_WARN(
+			general,
+			"couldn't map %m, the metrics won't be published\n",
+			metricsConfig.path
+		);
+	}
+	Metrics::CounterId frameCounter{ Metrics::registerCounter("frames") };
+
+	pstd::Arena recorderConfigArena{ scratchArena };
+	FlightRecorder::startup(
+		&allocationRegistry, makeRecorderConfig(&recorderConfigArena)
+	);
+
+	pstd::Arena logConfigArena{ scratchArena };
+	Console::startup(&allocationRegistry, makeLogConfig(&logConfigArena));
+	pstd::startupStringInterner(&allocationRegistry);
+
 	pstd::Arena engineArena{ pstd::allocateArena(
 		&allocationRegistry, PE::getSizeofState() + scratchSize
 	) };
 
 	engineState = PE::startup(&engineArena, scratchArena);
+	Metrics::setGauge(
+		Metrics::registerGauge("engine arena bytes"),
+		ncast<int64_t>(engineArena.offset)
+	);
 
 	GameDll gameDll{ loadGameDll(scratchArena) };
 	Game::State* gameState{ gameDll.api.startup() };
 
-	pstd::String originalDllPath{ pstd::formatString(
-		&scratchArena,
+	pstd::StringBuilder pathBuilder{ pstd::createStringBuilder(&scratchArena
+	) };
+	pstd::appendf(
+		&pathBuilder,
 		"%mGame.%m",
 		makeExeDirectoryPath(&scratchArena),
 		pstd::getDllExtensionName()
-	) };
+	);
+	pstd::String originalDllPath{ pstd::finishString(&pathBuilder, true) };
 
 	bool isRunning{ true };
-	const char* originalDllPathCString{
-		pstd::createCString(&scratchArena, originalDllPath)
-	};
+	uint64_t frameIndex{};
 	while (isRunning) {
-		if (pstd::getLastFileWriteTime(originalDllPathCString) !=
-			gameDll.lastWriteTime) {
-			unloadGameDll(gameDll);
-			gameDll = loadGameDll(scratchArena);
+		Profiler::markFrame(frameIndex);
+		PROFILE_SCOPE("frame");
+		FlightRecorder::recordFrame(frameIndex++);
+		FrameStats::beginFrame();
+		Metrics::addToCounter(frameCounter);
+
+		{
+			PROFILE_SCOPE("hot reload check");
+			FrameStats::PhaseScope phaseScope{
+				FrameStats::Phase::hotReloadCheck
+			};
+			if (pstd::getLastFileWriteTime(originalDllPath.buffer) !=
+				gameDll.lastWriteTime) {
+				unloadGameDll(gameDll);
+				gameDll = loadGameDll(scratchArena);
+			}
+		}
+
+		{
+			FrameStats::PhaseScope phaseScope{
+				FrameStats::Phase::engineUpdate
+			};
+			isRunning &= PE::update(engineState);
+		}
+
+		{
+			PROFILE_SCOPE("Game::update");
+			FrameStats::PhaseScope phaseScope{ FrameStats::Phase::gameUpdate };
+			isRunning &= gameDll.api.update(gameState);
 		}
 
-		isRunning &= PE::update(engineState);
-		isRunning &= gameDll.api.update(gameState);
+		FrameStats::endFrame();
 	}
 
 	gameDll.api.shutdown(gameState);
 	PE::shutdown(engineState);
+
+	if (samplePath) {
+		Sampler::unregisterThread();
+		if (!Sampler::exportFoldedStacks(&allocationRegistry, samplePath)) {
+			LOG_WARN(
+				general, "couldn't write the samples to %m\n", samplePath
+			);
+		}
+		Sampler::shutdown(&allocationRegistry);
+	}
+
+	if (profilePath &&
+		!Profiler::exportChromeTrace(&allocationRegistry, profilePath)) {
+		LOG_WARN(general, "couldn't write the profile to %m\n", profilePath);
+	}
+	if (scopesPath &&
+		!Profiler::exportScopeCounters(&allocationRegistry, scopesPath)) {
+		LOG_WARN(
+			general, "couldn't write the scope totals to %m\n", scopesPath
+		);
+	}
+	Profiler::shutdown(&allocationRegistry);
+
+	if (frameStatsPath &&
+		!FrameStats::exportStats(&allocationRegistry, frameStatsPath)) {
+		LOG_WARN(
+			general, "couldn't write the frame stats to %m\n", frameStatsPath
+		);
+	}
+	FrameStats::shutdown(&allocationRegistry);
+	pstd::shutdownStringInterner(&allocationRegistry);
+	Metrics::shutdown(&allocationRegistry);
+
+	Console::shutdown(&allocationRegistry);
+	FlightRecorder::shutdown(&allocationRegistry);
 }
 
 namespace {
@@ -74,43 +208,33 @@ namespace {
 	GameDll loadGameDll(pstd::Arena scratchArena) {
 		static uint32_t loadedDllSlot{};
 
-		constexpr pstd::String originalDllName{ pstd::createString("Game") };
-
-		pstd::String loadedDllPath{ pstd::formatString(
-			&scratchArena,
-			"%mGame_Loaded_%u.%m",
-			makeExeDirectoryPath(&scratchArena),
-			loadedDllSlot,
-			pstd::getDllExtensionName()
-		) };
+		pstd::String exeDirectory{ makeExeDirectoryPath(&scratchArena) };
+		pstd::String dllExtension{ pstd::getDllExtensionName() };
 
 		uint32_t unloadedDllSlot{ (loadedDllSlot + 1) % 2 };
 
-		pstd::String toLoadDllPath{ pstd::formatString(
-			&scratchArena,
+		pstd::StringBuilder pathBuilder{ pstd::createStringBuilder(&scratchArena
+		) };
+		pstd::appendf(
+			&pathBuilder,
 			"%mGame_Loaded_%u.%m",
-			makeExeDirectoryPath(&scratchArena),
+			exeDirectory,
 			unloadedDllSlot,
-			pstd::getDllExtensionName()
-		) };
+			dllExtension
+		);
+		pstd::String toLoadDllPath{ pstd::finishString(&pathBuilder, true) };
 
-		pstd::String originalDllPath{ pstd::formatString(
-			&scratchArena,
-			"%mGame.%m",
-			makeExeDirectoryPath(&scratchArena),
-			pstd::getDllExtensionName()
-		) };
+		pstd::appendf(&pathBuilder, "%mGame.%m", exeDirectory, dllExtension);
+		pstd::String originalDllPath{ pstd::finishString(&pathBuilder, true) };
 
-		pstd::copyFile(
-			pstd::createCString(&scratchArena, toLoadDllPath),
-			pstd::createCString(&scratchArena, originalDllPath),
-			true
-		);
+		pstd::copyFile(toLoadDllPath.buffer, originalDllPath.buffer, true);
 
-		pstd::DllHandle gameHandle{
-			pstd::loadDll(pstd::createCString(&scratchArena, toLoadDllPath))
-		};
+		pstd::DllHandle gameHandle{ pstd::loadDll(toLoadDllPath.buffer) };
 		loadedDllSlot = unloadedDllSlot;
+		if (gameHandle) {
+			Sampler::addModule("Game", gameHandle);
+			Metrics::addToCounter(Metrics::registerCounter("game loads"));
+		}
 
 		Game::API gameAPI{
 			.startup = (Game::API::Startup
@@ -119,7 +243,12 @@ namespace {
 				(Game::API::Update)pstd::findDllFunction(gameHandle, "update"),
 			.shutdown = (Game::API::Shutdown
 			)pstd::findDllFunction(gameHandle, "shutdown"),
+			.setFrameStats = (Game::API::SetFrameStats
+			)pstd::findDllFunction(gameHandle, "setFrameStats"),
 		};
+		if (gameAPI.setFrameStats) {
+			gameAPI.setFrameStats(FrameStats::getSummary());
+		}
 
 		bool isValid{ gameAPI.shutdown && gameAPI.update && gameAPI.shutdown };
 
@@ -132,7 +261,90 @@ namespace {
 	}
 	void unloadGameDll(GameDll dll) {
 		if (dll.handle) {
+			Sampler::removeModule(dll.handle);
 			pstd::unloadDll(dll.handle);
 		}
 	}
+
+	Console::LogConfig makeLogConfig(pstd::Arena* pArena) {
+		Console::LogConfig config{ Console::DEFAULT_LOG_CONFIG };
+
+		constexpr const char* levelNames[]{ "none", "info", "warn", "error" };
+
+		pstd::Array<pstd::String> args{ pstd::getCommandLineArgs(pArena) };
+		for (size_t i{ 1 }; i + 1 < args.count; i++) {
+			const pstd::String& arg{ args[i] };
+			const pstd::String& value{ args[i + 1] };
+
+			if (pstd::stringsMatch(arg, pstd::createString("--log-file"))) {
+				config.filePath = pstd::createCString(pArena, value);
+				config.isConsoleOn = false;
+			} else if (pstd::stringsMatch(
+						   arg, pstd::createString("--binary-log")
+					   )) {
+				config.binaryPath = pstd::createCString(pArena, value);
+				config.isConsoleOn = false;
+			} else if (pstd::stringsMatch(
+						   arg, pstd::createString("--log-level")
+					   )) {
+				for (uint32_t level{}; level < cast<uint32_t>(LogLevel::count);
+					 level++) {
+					if (!pstd::stringsMatch(
+							value, pstd::createString(levelNames[level])
+						)) {
+						continue;
+					}
+					for (size_t category{};
+						 category < config.minLevels.count;
+						 category++) {
+						config.minLevels.data[category] =
+							ncast<LogLevel>(level);
+					}
+				}
+			}
+		}
+
+		return config;
+	}
+
+	FlightRecorder::Config makeRecorderConfig(pstd::Arena* pArena) {
+		FlightRecorder::Config config{ FlightRecorder::DEFAULT_CONFIG };
+
+		pstd::String path{};
+		pstd::Array<pstd::String> args{ pstd::getCommandLineArgs(pArena) };
+		for (size_t i{ 1 }; i + 1 < args.count; i++) {
+			if (pstd::stringsMatch(
+					args[i], pstd::createString("--flight-recorder")
+				)) {
+				path = args[i + 1];
+			}
+		}
+
+		pstd::String exeDirectory{ makeExeDirectoryPath(pArena) };
+		pstd::StringBuilder pathBuilder{ pstd::createStringBuilder(pArena) };
+		if (path.size > 0) {
+			pstd::appendf(&pathBuilder, "%m", path);
+		} else {
+			pstd::appendf(&pathBuilder, "%mFlightRecorder.bin", exeDirectory);
+		}
+		pstd::String recordingPath{ pstd::finishString(&pathBuilder, true) };
+
+		pstd::appendf(&pathBuilder, "%m.prev", recordingPath);
+		pstd::String backupPath{ pstd::finishString(&pathBuilder, true) };
+		pstd::copyFile(backupPath.buffer, recordingPath.buffer, true);
+
+		config.path = recordingPath.buffer;
+		return config;
+	}
+
+	const char* makeArgPath(pstd::Arena* pArena, const char* flag) {
+		pstd::Array<pstd::String> args{ pstd::getCommandLineArgs(pArena) };
+		for (size_t i{ 1 }; i + 1 < args.count; i++) {
+			if (pstd::stringsMatch(args[i], pstd::createString(flag))) {
+				return pstd::createCString(pArena, args[i + 1]);
+			}
+		}
+
+		return nullptr;
+	}
 }  // namespace
@@ -0,0 +1,38 @@
+#include "Tests.h"
+
+#include "Core/PArray.h"
+#include "Core/PMemory.h"
+
+namespace {
+	// pushes a non-byte type past several pages, so each commit has to
+	// land where the last one ended
+	void testDArrayPushBackCommits(Tests::Context* pContext);
+}  // namespace
+
+void Tests::runArrayTests(Context* pContext) {
+	testDArrayPushBackCommits(pContext);
+}
+
+namespace {
+	void testDArrayPushBackCommits(Tests::Context* pContext) {
+		constexpr uint32_t COUNT{ 64 * 1024 };
+
+		pstd::DArray<uint32_t> array{
+			pstd::createDArray<uint32_t>(pContext->pAllocRegistry, 0, COUNT)
+		};
+		for (uint32_t i{}; i < COUNT; i++) {
+			pstd::pushBack(&array, i * 3);
+		}
+
+		CHECK(array.count == COUNT);
+		CHECK(array.commitSize >= COUNT * sizeof(uint32_t));
+
+		bool isIntact{ true };
+		for (uint32_t i{}; i < COUNT; i++) {
+			isIntact &= array[i] == i * 3;
+		}
+		CHECK(isIntact);
+
+		pstd::heapFree(pContext->pAllocRegistry, array.data);
+	}
+}  // namespace
@@ -0,0 +1,171 @@
+#include "Tests.h"
+
+#include "FlightRecorder.h"
+#include "Logging.h"
+#include "Core/PArena.h"
+#include "Core/PFileIO.h"
+#include "Core/PIntrinsics.h"
+#include "Core/PMemory.h"
+#include "Core/PString.h"
+#include "Core/PStringBuilder.h"
+#include "Core/PThread.h"
+
+namespace {
+	constexpr uint32_t BLOCK_SIZE{ 16 * 1024 };
+	constexpr uint32_t LONG_STRING_SIZE{ 20000 };
+	constexpr uint32_t ROUND_COUNT{ 8 };
+
+	const char* makeRecordingPath(pstd::Arena* pArena);
+
+	// reads the recording back into pArena, false when it can't
+	bool openTestRecording(
+		pstd::Arena* pArena,
+		const char* path,
+		FlightRecorder::Recording* outRecording
+	);
+
+	// a string argument longer than a block is cut off to fit it, and the
+	// entry after it still goes in
+	void testRecordLongString(Tests::Context* pContext);
+
+	// a thread that exits leaves its slot to the next one
+	void testReleasedThreads(Tests::Context* pContext);
+}  // namespace
+
+void Tests::runFlightRecorderTests(Context* pContext) {
+	testRecordLongString(pContext);
+	testReleasedThreads(pContext);
+}
+
+namespace {
+	const char* makeRecordingPath(pstd::Arena* pArena) {
+		pstd::StringBuilder pathBuilder{ pstd::createStringBuilder(pArena) };
+		pstd::appendf(
+			&pathBuilder,
+			"%mTestRecording.bin",
+			pstd::makeExeDirectoryPath(pArena)
+		);
+		return pstd::finishString(&pathBuilder, true).buffer;
+	}
+
+	bool openTestRecording(
+		pstd::Arena* pArena,
+		const char* path,
+		FlightRecorder::Recording* outRecording
+	) {
+		pstd::FileHandle file{ pstd::openFile(
+			path,
+			pstd::FileAccess::read,
+			pstd::FileShare::read,
+			pstd::FileCreate::openExisting
+		) };
+		if (!file) {
+			return false;
+		}
+		pstd::String data{ pstd::readFile(pArena, file) };
+		pstd::closeFile(file);
+
+		return FlightRecorder::openRecording(pArena, data, outRecording);
+	}
+
+	void testRecordLongString(Tests::Context* pContext) {
+		pstd::Arena arena{ pstd::allocateArena(
+			pContext->pAllocRegistry, LONG_STRING_SIZE + 256 * 1024
+		) };
+		const char* path{ makeRecordingPath(&arena) };
+
+		FlightRecorder::Config config{
+			.path = path,
+			.size = 4 * BLOCK_SIZE,
+			.blockSize = BLOCK_SIZE,
+			.maxThreadCount = 1,
+		};
+		if (!CHECK(FlightRecorder::startup(pContext->pAllocRegistry, config))) {
+			pstd::freeArena(pContext->pAllocRegistry, &arena);
+			return;
+		}
+
+		char* letters{ pstd::alloc<char>(&arena, LONG_STRING_SIZE) };
+		pstd::memSet(letters, 'x', LONG_STRING_SIZE);
+
+		Console::LogSite site{
+			.level = Console::LogLevel::info,
+			.file = __FILE__,
+			.line = __LINE__,
+		};
+		Console::LogArgType argType{ Console::LogArgType::string };
+		Console::LogArg arg{};
+		arg.string =
+			pstd::String{ .buffer = letters, .size = LONG_STRING_SIZE };
+		FlightRecorder::recordLog(
+			site, "%m", &argType, 1, &arg, pstd::readCycleCounter()
+		);
+
+		argType = Console::LogArgType::uint64;
+		arg = Console::LogArg{};
+		arg.uintVal = 7;
+		FlightRecorder::recordLog(
+			site, "%u", &argType, 1, &arg, pstd::readCycleCounter()
+		);
+		FlightRecorder::shutdown(pContext->pAllocRegistry);
+
+		FlightRecorder::Recording recording{};
+		CHECK(openTestRecording(&arena, path, &recording));
+		if (CHECK(recording.entryCount == 2)) {
+			FlightRecorder::Entry entry{};
+			FlightRecorder::readEntry(recording, 0, &entry);
+			const pstd::String& string{ entry.args[0].string };
+			CHECK(entry.argCount == 1);
+			CHECK(string.size > 0 && string.size < LONG_STRING_SIZE);
+			CHECK(string.size > BLOCK_SIZE - 256);
+
+			bool isIntact{ true };
+			for (uint32_t i{}; i < string.size; i++) {
+				isIntact &= string.buffer[i] == 'x';
+			}
+			CHECK(isIntact);
+
+			FlightRecorder::readEntry(recording, 1, &entry);
+			CHECK(entry.argCount == 1 && entry.args[0].uintVal == 7);
+		}
+
+		pstd::freeArena(pContext->pAllocRegistry, &arena);
+	}
+
+	void testReleasedThreads(Tests::Context* pContext) {
+		pstd::Arena arena{
+			pstd::allocateArena(pContext->pAllocRegistry, 256 * 1024)
+		};
+		const char* path{ makeRecordingPath(&arena) };
+
+		// every thread claims a block of its own, the header takes one more
+		FlightRecorder::Config config{
+			.path = path,
+			.size = (ROUND_COUNT + 1) * BLOCK_SIZE,
+			.blockSize = BLOCK_SIZE,
+			.maxThreadCount = 1,
+		};
+		if (!CHECK(FlightRecorder::startup(pContext->pAllocRegistry, config))) {
+			pstd::freeArena(pContext->pAllocRegistry, &arena);
+			return;
+		}
+
+		// task 0 runs on this thread and records nothing, the other task
+		// gets a new thread every round
+		for (uint32_t i{}; i < ROUND_COUNT; i++) {
+			pstd::runParallel(2, [i](uint32_t taskIndex) {
+				if (taskIndex == 1) {
+					FlightRecorder::recordFrame(i);
+				}
+			});
+		}
+		FlightRecorder::shutdown(pContext->pAllocRegistry);
+
+		FlightRecorder::Recording recording{};
+		CHECK(openTestRecording(&arena, path, &recording));
+		CHECK(recording.header.droppedCount == 0);
+		CHECK(recording.entryCount == ROUND_COUNT);
+
+		pstd::freeArena(pContext->pAllocRegistry, &arena);
+	}
+}  // namespace
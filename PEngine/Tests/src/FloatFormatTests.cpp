@@ -0,0 +1,102 @@
+#include "Tests.h"
+
+#include "Core/PString.h"
+#include "Core/PParse.h"
+#include "Core/PMemory.h"
+
+namespace {
+	// the float patterns every run covers are this far apart, a prime so
+	// they land on all sorts of exponents and mantissas. --exhaustive
+	// covers every one of the 2^32
+	constexpr uint32_t SAMPLE_STRIDE{ 4099 };
+
+	float makeFloat(uint32_t bits);
+
+	// writeFloat's text for bits reads back as the same bits, or as a nan
+	// for a nan
+	bool roundTripsFloat(uint32_t bits);
+
+	bool writesFloatAs(float val, const char* expected);
+
+	void testFloatText(Tests::Context* pContext);
+
+	// stops at the first pattern that doesn't read back
+	void testFloatRoundTrip(Tests::Context* pContext);
+}  // namespace
+
+void Tests::runFloatFormatTests(Context* pContext) {
+	testFloatText(pContext);
+	testFloatRoundTrip(pContext);
+}
+
+namespace {
+	float makeFloat(uint32_t bits) {
+		float val{};
+		pstd::memCpy(&val, &bits, sizeof(val));
+		return val;
+	}
+
+	bool roundTripsFloat(uint32_t bits) {
+		float val{ makeFloat(bits) };
+
+		char text[pstd::MAX_DECIMAL_CHARS];
+		uint32_t size{ pstd::writeFloat(text, val) };
+
+		float parsed{};
+		uint32_t parsedSize{};
+		if (!pstd::parseFloat(
+				pstd::String{ .buffer = text, .size = size },
+				&parsed,
+				&parsedSize
+			) ||
+			parsedSize != size) {
+			return false;
+		}
+
+		uint32_t parsedBits{};
+		pstd::memCpy(&parsedBits, &parsed, sizeof(parsedBits));
+		if (val != val) {
+			return parsed != parsed;
+		}
+		return parsedBits == bits;
+	}
+
+	bool writesFloatAs(float val, const char* expected) {
+		char text[pstd::MAX_DECIMAL_CHARS];
+		uint32_t size{ pstd::writeFloat(text, val) };
+		return pstd::stringsMatch(
+			pstd::String{ .buffer = text, .size = size },
+			pstd::createString(expected)
+		);
+	}
+
+	void testFloatText(Tests::Context* pContext) {
+		CHECK(writesFloatAs(0.1f, "0.1"));
+		CHECK(writesFloatAs(2.0f, "2.0"));
+		CHECK(writesFloatAs(-0.0f, "-0.0"));
+		CHECK(writesFloatAs(1e16f, "1e+16"));
+		CHECK(writesFloatAs(1.5e-5f, "1.5e-05"));
+		CHECK(writesFloatAs(makeFloat(0x7f800000), "inf"));
+		CHECK(writesFloatAs(makeFloat(0xff800000), "-inf"));
+		CHECK(writesFloatAs(makeFloat(0x7fc00000), "nan"));
+	}
+
+	void testFloatRoundTrip(Tests::Context* pContext) {
+		uint32_t stride{ pContext->isExhaustive ? 1 : SAMPLE_STRIDE };
+
+		// a 64 bit counter, so the loop can step past the last pattern
+		bool isPassing{ true };
+		for (uint64_t bits{}; bits <= UINT32_MAX && isPassing;
+			 bits += stride) {
+			isPassing = CHECK(roundTripsFloat(ncast<uint32_t>(bits)));
+		}
+
+		// the patterns at the ends of each range the stride can skip
+		CHECK(roundTripsFloat(0x00000001));	 // smallest subnormal
+		CHECK(roundTripsFloat(0x007fffff));	 // largest subnormal
+		CHECK(roundTripsFloat(0x00800000));	 // smallest normal
+		CHECK(roundTripsFloat(0x7f7fffff));	 // largest normal
+		CHECK(roundTripsFloat(0xff7fffff));
+		CHECK(roundTripsFloat(0x7fc00000));	 // quiet nan
+	}
+}  // namespace
@@ -0,0 +1,79 @@
+#include "Tests.h"
+
+#include "Core/PIntern.h"
+#include "Core/PString.h"
+
+namespace {
+	// a full table turns new strings away, the ones already in it keep
+	// their ids
+	void testFullTable(Tests::Context* pContext);
+
+	// so does a table whose text arena can't fit the string
+	void testFullText(Tests::Context* pContext);
+}  // namespace
+
+void Tests::runInternTests(Context* pContext) {
+	testFullTable(pContext);
+	testFullText(pContext);
+}
+
+namespace {
+	void testFullTable(Tests::Context* pContext) {
+		pstd::StringInterner interner{
+			pstd::createStringInterner(pContext->pAllocRegistry, 1024, 2)
+		};
+
+		pstd::StringId first{
+			pstd::internString(&interner, pstd::createString("first"))
+		};
+		pstd::StringId second{
+			pstd::internString(&interner, pstd::createString("second"))
+		};
+		CHECK(first != pstd::StringId::invalid);
+		CHECK(second != pstd::StringId::invalid && second != first);
+
+		CHECK(
+			pstd::internString(&interner, pstd::createString("third")) ==
+			pstd::StringId::invalid
+		);
+		CHECK(
+			pstd::internString(&interner, pstd::createString("first")) ==
+			first
+		);
+		CHECK(interner.count == 2);
+
+		pstd::destroyStringInterner(pContext->pAllocRegistry, &interner);
+	}
+
+	void testFullText(Tests::Context* pContext) {
+		pstd::StringInterner interner{
+			pstd::createStringInterner(pContext->pAllocRegistry, 8, 4)
+		};
+
+		// room for the table and about 8 bytes of text
+		uint32_t textSize{
+			pstd::getAvailableCount<char>(interner.textArena)
+		};
+		pstd::String longString{ pstd::createString(
+			"a string longer than the text the interner has room for"
+		) };
+		CHECK(longString.size >= textSize);
+		CHECK(
+			pstd::internString(&interner, longString) ==
+			pstd::StringId::invalid
+		);
+		CHECK(interner.count == 0);
+
+		pstd::StringId shortId{
+			pstd::internString(&interner, pstd::createString("abc"))
+		};
+		if (CHECK(shortId != pstd::StringId::invalid)) {
+			CHECK(pstd::stringsMatch(
+				pstd::getInternedString(interner, shortId),
+				pstd::createString("abc")
+			));
+		}
+
+		pstd::destroyStringInterner(pContext->pAllocRegistry, &interner);
+	}
+}  // namespace
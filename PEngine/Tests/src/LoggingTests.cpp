@@ -0,0 +1,53 @@
+#include "Tests.h"
+
+#include "Logging.h"
+#include "LoggingSetup.h"
+#include "Core/PThread.h"
+#include "Core/PTime.h"
+
+namespace {
+	constexpr uint32_t ROUND_COUNT{ 8 };
+
+	// threads that come and go take over the buffers of the ones that
+	// exited, log calls are only dropped past maxThreadCount at once
+	void testReleasedBuffers(Tests::Context* pContext);
+}  // namespace
+
+void Tests::runLoggingTests(Context* pContext) {
+	testReleasedBuffers(pContext);
+}
+
+namespace {
+	void testReleasedBuffers(Tests::Context* pContext) {
+		Console::LogConfig config{ Console::DEFAULT_LOG_CONFIG };
+		config.maxThreadCount = 2;
+		config.isConsoleOn = false;
+		config.memorySize = 64 * 1024;
+		Console::startup(pContext->pAllocRegistry, config);
+
+		// task 0 runs on this thread, the other task gets a new thread
+		// every round
+		for (uint32_t i{}; i < ROUND_COUNT; i++) {
+			pstd::runParallel(2, [](uint32_t taskIndex) {
+				Console::log(
+					Console::LEVEL_LOG_SITES[Console::LogLevel::info],
+					"task %u\n",
+					taskIndex
+				);
+			});
+		}
+
+		// the writer gets a second to catch up
+		uint64_t deadline{ pstd::getTime() + pstd::getTimeFrequency() };
+		Console::LogStats stats{ Console::getLogStats() };
+		while (stats.writtenCount < 2 * ROUND_COUNT &&
+			   pstd::getTime() < deadline) {
+			pstd::yieldThread();
+			stats = Console::getLogStats();
+		}
+		CHECK(stats.writtenCount == 2 * ROUND_COUNT);
+		CHECK(stats.droppedCount == 0);
+
+		Console::shutdown(pContext->pAllocRegistry);
+	}
+}  // namespace
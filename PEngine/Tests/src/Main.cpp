@@ -0,0 +1,62 @@
+#include "Tests.h"
+
+#include "Core/PArena.h"
+#include "Core/PMemory.h"
+#include "Core/PFileIO.h"
+#include "Core/PConsole.h"
+#include "Core/PString.h"
+
+// runs every group of tests and returns 1 when any check failed.
+//
+// PEngineTests [--exhaustive]
+//
+// --exhaustive also runs the tests too slow for every build
+
+namespace {
+	bool hasArg(const pstd::Array<pstd::String>& args, const char* flag);
+}  // namespace
+
+int main() {
+	pstd::AllocationRegistry allocationRegistry{ pstd::createAllocationRegistry(
+	) };
+	pstd::Arena scratchArena{
+		pstd::allocateArena(&allocationRegistry, 64 * 1024)
+	};
+
+	pstd::Array<pstd::String> args{ pstd::getCommandLineArgs(&scratchArena) };
+
+	Tests::Context context{
+		.pAllocRegistry = &allocationRegistry,
+		.isExhaustive = hasArg(args, "--exhaustive"),
+	};
+	Tests::runArrayTests(&context);
+	Tests::runFloatFormatTests(&context);
+	Tests::runUnicodeTests(&context);
+	Tests::runFlightRecorderTests(&context);
+	Tests::runLoggingTests(&context);
+	Tests::runMetricsTests(&context);
+	Tests::runInternTests(&context);
+
+	pstd::String summary{ pstd::formatString(
+		&scratchArena,
+		"%u of %u checks failed\n",
+		context.failureCount,
+		context.checkCount
+	) };
+	pstd::consoleWrite(summary);
+
+	pstd::freeArena(&allocationRegistry, &scratchArena);
+	return context.failureCount > 0 ? 1 : 0;
+}
+
+namespace {
+	bool hasArg(const pstd::Array<pstd::String>& args, const char* flag) {
+		for (size_t i{ 1 }; i < args.count; i++) {
+			if (pstd::stringsMatch(args[i], pstd::createString(flag))) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+}  // namespace
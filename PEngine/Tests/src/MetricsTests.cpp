@@ -0,0 +1,89 @@
+#include "Tests.h"
+
+#include "Metrics.h"
+#include "Core/PArena.h"
+#include "Core/PAtomic.h"
+#include "Core/PFileIO.h"
+#include "Core/PString.h"
+#include "Core/PStringBuilder.h"
+#include "Core/PThread.h"
+
+namespace {
+	constexpr uint32_t ROUND_COUNT{ 8 };
+
+	// threads that come and go take over the shards of the ones that
+	// exited, bumps are only dropped past maxThreadCount at once and the
+	// snapshot counts them
+	void testReleasedShards(Tests::Context* pContext);
+}  // namespace
+
+void Tests::runMetricsTests(Context* pContext) {
+	testReleasedShards(pContext);
+}
+
+namespace {
+	void testReleasedShards(Tests::Context* pContext) {
+		pstd::Arena arena{
+			pstd::allocateArena(pContext->pAllocRegistry, 256 * 1024)
+		};
+
+		pstd::StringBuilder pathBuilder{ pstd::createStringBuilder(&arena) };
+		pstd::appendf(
+			&pathBuilder,
+			"%mTestMetrics.bin",
+			pstd::makeExeDirectoryPath(&arena)
+		);
+		const char* path{ pstd::finishString(&pathBuilder, true).buffer };
+
+		Metrics::Config config{ Metrics::DEFAULT_CONFIG };
+		config.path = path;
+		config.maxThreadCount = 2;
+		if (!CHECK(Metrics::startup(pContext->pAllocRegistry, config))) {
+			pstd::freeArena(pContext->pAllocRegistry, &arena);
+			return;
+		}
+		Metrics::CounterId id{ Metrics::registerCounter("test.bumps") };
+
+		// task 0 runs on this thread, the other task gets a new thread
+		// every round
+		for (uint32_t i{}; i < ROUND_COUNT; i++) {
+			pstd::runParallel(2, [id](uint32_t taskIndex) {
+				Metrics::addToCounter(id);
+			});
+		}
+		CHECK(Metrics::readCounter(id) == 2 * ROUND_COUNT);
+
+		// the three tasks wait for each other, so one of the new threads
+		// gets no shard
+		uint32_t bumpedCount{};
+		pstd::runParallel(3, [id, &bumpedCount](uint32_t taskIndex) {
+			Metrics::addToCounter(id);
+			pstd::atomicAdd(&bumpedCount, 1u);
+			while (pstd::atomicLoad(&bumpedCount) < 3) {
+				pstd::yieldThread();
+			}
+		});
+		CHECK(Metrics::readCounter(id) == 2 * ROUND_COUNT + 2);
+		Metrics::shutdown(pContext->pAllocRegistry);
+
+		pstd::FileHandle file{ pstd::openFile(
+			path,
+			pstd::FileAccess::read,
+			pstd::FileShare::read,
+			pstd::FileCreate::openExisting
+		) };
+		if (!CHECK(file)) {
+			pstd::freeArena(pContext->pAllocRegistry, &arena);
+			return;
+		}
+		pstd::String data{ pstd::readFile(&arena, file) };
+		pstd::closeFile(file);
+
+		Metrics::Snapshot snapshot{};
+		if (CHECK(Metrics::openSnapshot(data, &snapshot))) {
+			CHECK(snapshot.header.droppedCount == 1);
+		}
+
+		pstd::freeArena(pContext->pAllocRegistry, &arena);
+	}
+}  // namespace
@@ -0,0 +1,34 @@
+#include "Tests.h"
+
+#include "Core/PArena.h"
+#include "Core/PConsole.h"
+#include "Core/PString.h"
+#include "Core/PAssert.h"
+
+namespace {
+	constexpr uint32_t MAX_LINE_SIZE{ 512 };
+}  // namespace
+
+bool Tests::check(
+	Context* pContext,
+	bool isPassing,
+	const char* file,
+	uint32_t line,
+	const char* expression
+) {
+	ASSERT(pContext);
+
+	pContext->checkCount++;
+	if (isPassing) {
+		return true;
+	}
+
+	pContext->failureCount++;
+	char buffer[MAX_LINE_SIZE];
+	pstd::Arena arena{ .block = buffer, .size = MAX_LINE_SIZE };
+	pstd::String text{ pstd::formatString(
+		&arena, "%m(%u): failed CHECK(%m)\n", file, line, expression
+	) };
+	pstd::consoleWrite(text);
+	return false;
+}
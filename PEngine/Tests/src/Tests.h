@@ -0,0 +1,39 @@
+#pragma once
+#include "Core/PTypes.h"
+#include "Core/PMemory.h"
+
+// the test harness. a group of tests is a function that checks what it
+// tests with CHECK, a failed check is reported with its file and line and
+// the group carries on. PEngineTests returns 1 when any check failed.
+//
+// tests too slow for every run only run with --exhaustive
+
+namespace Tests {
+	struct Context {
+		pstd::AllocationRegistry* pAllocRegistry;
+		uint64_t checkCount;
+		uint64_t failureCount;
+		bool isExhaustive;
+	};
+
+	// false when the check failed
+	bool check(
+		Context* pContext,
+		bool isPassing,
+		const char* file,
+		uint32_t line,
+		const char* expression
+	);
+
+	void runArrayTests(Context* pContext);
+	void runFloatFormatTests(Context* pContext);
+	void runUnicodeTests(Context* pContext);
+	void runFlightRecorderTests(Context* pContext);
+	void runLoggingTests(Context* pContext);
+	void runMetricsTests(Context* pContext);
+	void runInternTests(Context* pContext);
+}  // namespace Tests
+
+// expects a Context* named pContext in scope
+#define CHECK(expression) \
+	Tests::check(pContext, (expression), __FILE__, __LINE__, #expression)
@@ -0,0 +1,52 @@
+#include "Tests.h"
+
+#include "Core/PUnicode.h"
+#include "Core/PString.h"
+
+namespace {
+	// validateUtf8 rejects text and puts the error at offset
+	bool failsAt(const char* text, uint32_t offset);
+
+	void testValidateUtf8(Tests::Context* pContext);
+
+	void testValidateUtf8CutShort(Tests::Context* pContext);
+}  // namespace
+
+void Tests::runUnicodeTests(Context* pContext) {
+	testValidateUtf8(pContext);
+	testValidateUtf8CutShort(pContext);
+}
+
+namespace {
+	bool failsAt(const char* text, uint32_t offset) {
+		uint32_t errorOffset{ UINT32_MAX };
+		return !pstd::validateUtf8(pstd::createString(text), &errorOffset) &&
+			errorOffset == offset;
+	}
+
+	void testValidateUtf8(Tests::Context* pContext) {
+		CHECK(pstd::validateUtf8(pstd::createString("")));
+		CHECK(pstd::validateUtf8(pstd::createString("h\xC3\xA9llo")));
+		CHECK(pstd::validateUtf8(pstd::createString("\xF0\x9F\x98\x80")));
+
+		CHECK(failsAt("abc\xE2\x28\xA1", 3));
+		CHECK(failsAt("abc\xC0\xAF", 3));	   // overlong
+		CHECK(failsAt("abc\xED\xA0\x80", 3));  // surrogate
+		CHECK(failsAt("abc\xF4\x90\x80\x80", 3));  // past 0x10FFFF
+		CHECK(failsAt("\x80", 0));
+	}
+
+	void testValidateUtf8CutShort(Tests::Context* pContext) {
+		CHECK(failsAt("abc\xE2\x82", 5));
+		CHECK(failsAt("abc\xE2", 4));
+		CHECK(failsAt("\xF0\x9F\x98", 3));
+
+		// past the first 16 bytes, where the blocks are checked
+		CHECK(failsAt("0123456789abcdef0123456789abcdef\xE2\x82", 34));
+
+		// what is there already can't start a valid sequence
+		CHECK(failsAt("abc\xE0\x80", 3));
+		CHECK(failsAt("abc\xE2\x41", 3));
+		CHECK(failsAt("abc\xF5", 3));
+	}
+}  // namespace